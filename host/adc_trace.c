@@ -0,0 +1,74 @@
+#include "adc_trace.h"
+#include <math.h>
+
+// Hash integer (splitmix64) sebagai derau yang dapat diulang per indeks
+static uint64_t mix(uint64_t z)
+{
+    z += 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+uint16_t adc_trace_sample(const adc_trace_cfg_t *cfg, uint64_t index, uint32_t rate_hz)
+{
+    double t_us = (double)index * 1e6 / rate_hz;
+    double mv = cfg->floor_mv + ((double)cfg->v0_mv - cfg->floor_mv) * exp(-t_us / cfg->tau_us);
+    int32_t code = (int32_t)lround(mv * 4095.0 / cfg->full_scale_mv);
+    if (cfg->noise_lsb > 0)
+        code += (int32_t)(mix(index ^ ((uint64_t)cfg->seed << 32)) % (2 * cfg->noise_lsb + 1)) -
+                (int32_t)cfg->noise_lsb;
+    if (cfg->spike_period > 0 && index % cfg->spike_period == cfg->spike_period - 1)
+        code += cfg->spike_lsb;
+    if (code < 0)
+        code = 0;
+    if (code > 4095)
+        code = 4095;
+    return (uint16_t)code;
+}
+
+uint64_t adc_trace_crossing_us(const adc_trace_cfg_t *cfg, uint32_t mv)
+{
+    if (cfg->v0_mv <= mv)
+        return 0;
+    if (mv <= cfg->floor_mv)
+        return UINT64_MAX;
+    return (uint64_t)llround(cfg->tau_us * log(((double)cfg->v0_mv - cfg->floor_mv) / ((double)mv - cfg->floor_mv)));
+}
+
+// Arus tanpa derau dalam LSB dari tengah skala, t sejak tepi naik
+static double pulse_current(const adc_pulse_cfg_t *cfg, double t_ns)
+{
+    double tau = cfg->tau_ns > 0 ? cfg->tau_ns : 1;
+    if (t_ns < cfg->pulse_ns)
+        return cfg->peak_lsb * (1.0 - exp(-t_ns / tau));
+    double end = cfg->peak_lsb * (1.0 - exp(-(double)cfg->pulse_ns / tau));
+    return end * exp(-(t_ns - cfg->pulse_ns) / tau);
+}
+
+static uint16_t clamp_code(int32_t code)
+{
+    if (code < 0)
+        return 0;
+    if (code > 4095)
+        return 4095;
+    return (uint16_t)code;
+}
+
+void adc_pulse_burst(const adc_pulse_cfg_t *cfg, uint32_t pulse, uint32_t event, uint32_t count,
+                     uint16_t *samples)
+{
+    uint64_t key = ((uint64_t)cfg->seed << 40) ^ ((uint64_t)pulse << 9) ^ ((uint64_t)event << 8);
+    for (uint32_t j = 0; j < count; j++)
+    {
+        double i = pulse_current(cfg, (double)cfg->lag_ns + (double)j * cfg->sample_ns);
+        int32_t code;
+        if (j % 2 == 0)
+            code = ADC_PULSE_MID + (int32_t)lround(event ? -i : i);
+        else
+            code = (int32_t)cfg->v_idle_lsb - (int32_t)lround(i * cfg->v_sag_lsb / (cfg->peak_lsb ? cfg->peak_lsb : 1));
+        if (cfg->noise_lsb > 0)
+            code += (int32_t)(mix(key + j) % (2 * cfg->noise_lsb + 1)) - (int32_t)cfg->noise_lsb;
+        samples[j] = clamp_code(code);
+    }
+}
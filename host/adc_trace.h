@@ -0,0 +1,60 @@
+#ifndef ADC_TRACE_H
+#define ADC_TRACE_H
+
+/**
+ * Sumber jejak ADC pengganti untuk pemantau bank kapasitor dan tangkapan
+ * arus/tegangan per pulsa.
+ *
+ * Tegangan bank meluruh eksponensial (RC resistor buang) dari v0 menuju
+ * floor, dikodekan 12 bit seperti ADC RP2040 dengan derau seragam dan
+ * lonjakan EMI satu sampel. Setiap sampel hanya bergantung pada indeksnya
+ * (derau dari hash indeks), jadi jejak yang sama dapat dibaca dalam potongan
+ * berapa pun, oleh mgc_sim discharge maupun shim bank_adc di mgc_app.
+ */
+
+#include <stdint.h>
+
+typedef struct
+{
+    uint32_t full_scale_mv; // Tegangan bank pada kode 4095
+    uint32_t v0_mv;
+    uint32_t floor_mv;      // Asimtot; di atas ambang aman = resistor buang putus
+    uint32_t tau_us;        // R x C jalur buang
+    uint32_t noise_lsb;     // Derau seragam +-noise_lsb
+    uint32_t spike_period;  // Satu sampel lonjakan tiap N sampel (0: tidak ada)
+    int32_t spike_lsb;      // Tinggi lonjakan (negatif: ke arah 0 V)
+    uint32_t seed;
+} adc_trace_cfg_t;
+
+uint16_t adc_trace_sample(const adc_trace_cfg_t *cfg, uint64_t index, uint32_t rate_hz);
+
+// Waktu tegangan tanpa derau turun ke 'mv'; UINT64_MAX bila tidak pernah
+uint64_t adc_trace_crossing_us(const adc_trace_cfg_t *cfg, uint32_t mv);
+
+// Beban R-L di belakang elektroda: arus naik 1 - e^(-t/tau) selama pulsa
+// lalu meluruh, positif untuk event A (CH1/CH4) dan negatif untuk event C
+// (CH2/CH3) di sekitar tengah skala sensor arus. Tegangan beban turun
+// sebanding |arus| (resistansi sumber). Sampel ke-j burst diambil
+// lag_ns + j x sample_ns setelah tepi, berselang-seling arus/tegangan
+// seperti ADC round-robin lib/pulse_capture.c.
+typedef struct
+{
+    uint32_t pulse_ns;
+    uint32_t tau_ns;
+    uint32_t lag_ns;     // Tepi -> akhir konversi pertama
+    uint32_t sample_ns;  // Satu konversi (2000 ns pada 500 kS/s)
+    uint32_t peak_lsb;   // Arus jenuh, dari tengah skala
+    uint32_t v_idle_lsb; // Tegangan beban tanpa arus
+    uint32_t v_sag_lsb;  // Turun tegangan pada arus jenuh
+    uint32_t noise_lsb;
+    uint32_t seed;
+} adc_pulse_cfg_t;
+
+#define ADC_PULSE_MID 2048
+
+// 'count' sampel (arus, tegangan, ...) burst event 'event' (0: A, 1: C)
+// periode 'pulse'; derau dari hash (pulse, event, indeks)
+void adc_pulse_burst(const adc_pulse_cfg_t *cfg, uint32_t pulse, uint32_t event, uint32_t count,
+                     uint16_t *samples);
+
+#endif
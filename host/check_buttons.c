@@ -0,0 +1,176 @@
+/**
+ * lib/button_debounce.c: jejak pantulan/EMI sintetis (mgc_sim buttons)
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "button_debounce.h"
+#include "mgc_checks.h"
+
+typedef struct
+{
+    uint32_t t_us;
+    bool pressed;
+} button_edge_t;
+
+#define TRACE_MAX_EVENTS 256
+
+typedef struct
+{
+    button_event_t ev[TRACE_MAX_EVENTS];
+    uint64_t t_us[TRACE_MAX_EVENTS];
+    int count;
+    int presses, repeats, releases;
+} button_trace_t;
+
+// Tiru firmware: tepi dari interupsi GPIO, debounce_poll() dari alarm pada
+// debounce_deadline()
+static void run_button_trace(const button_edge_t *edges, size_t n, uint64_t end_us,
+                             bool repeat, button_trace_t *out)
+{
+    debounce_t d;
+    debounce_init(&d, 0, repeat);
+    memset(out, 0, sizeof(*out));
+
+    size_t i = 0;
+    for (;;)
+    {
+        uint64_t deadline = debounce_deadline(&d);
+        uint64_t next_edge = i < n ? edges[i].t_us : UINT64_MAX;
+        if (deadline && deadline <= next_edge && deadline <= end_us)
+        {
+            button_event_t ev;
+            while (debounce_poll(&d, deadline, &ev) && out->count < TRACE_MAX_EVENTS)
+            {
+                out->ev[out->count] = ev;
+                out->t_us[out->count++] = deadline;
+                out->presses += ev.type == BUTTON_EV_PRESS;
+                out->repeats += ev.type == BUTTON_EV_REPEAT;
+                out->releases += ev.type == BUTTON_EV_RELEASE;
+            }
+            continue;
+        }
+        if (next_edge <= end_us)
+        {
+            debounce_edge(&d, edges[i].pressed, next_edge);
+            i++;
+            continue;
+        }
+        break;
+    }
+}
+
+int cmd_buttons(void)
+{
+    static const button_edge_t clean[] = {{1000, true}, {201000, false}};
+    static const button_edge_t bouncy[] = {
+        {1000, true}, {1300, false}, {1700, true}, {2000, false}, {2600, true}, {3500, false}, {3600, true},
+        {150000, false}, {150400, true}, {151000, false}, {151900, true}, {152000, false}};
+    static const button_edge_t long_bounce[] = {
+        {1000, true}, {4000, false}, {7000, true}, {10000, false}, {13000, true}, {16000, false},
+        {19000, true}, {22000, false}, {25000, true}, {28000, false}, {31000, true}};
+    static button_edge_t emi[20];
+    for (int i = 0; i < 10; i++)
+    {
+        // Lonjakan 20 us tiap 2 ms (tepi pelepasan bank kapasitor)
+        emi[2 * i] = (button_edge_t){1000 + 2000u * i, true};
+        emi[2 * i + 1] = (button_edge_t){1020 + 2000u * i, false};
+    }
+    static const button_edge_t hold[] = {{1000, true}, {6001000, false}};
+
+    static const struct
+    {
+        const char *name;
+        const button_edge_t *edges;
+        size_t n;
+        bool repeat;
+        int presses, repeats, releases;
+        uint32_t max_latency_us; // Tepi stabil terakhir -> PRESS
+    } cases[] = {
+        {"Tekan bersih 200 ms", clean, 2, true, 1, 0, 1, DEBOUNCE_SETTLE_US},
+        {"Pantulan 2.6 ms saat tekan dan lepas", bouncy, 12, true, 1, 0, 1, DEBOUNCE_SETTLE_US},
+        {"Pantulan 30 ms (kontak aus)", long_bounce, 11, false, 1, 0, 0, DEBOUNCE_SETTLE_US},
+        {"Lonjakan EMI 20 us x10", emi, 20, true, 0, 0, 0, 0},
+        {"SELECT ditahan 6 s (tanpa repeat)", hold, 2, false, 1, 0, 1, DEBOUNCE_SETTLE_US},
+    };
+    int failures = 0;
+    button_trace_t tr;
+
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++)
+    {
+        run_button_trace(cases[c].edges, cases[c].n, 7000000, cases[c].repeat, &tr);
+        // Latensi diukur dari tepi terakhir sebelum PRESS
+        uint32_t latency = 0;
+        for (int e = 0; e < tr.count; e++)
+        {
+            if (tr.ev[e].type != BUTTON_EV_PRESS)
+                continue;
+            uint32_t last_edge = 0;
+            for (size_t k = 0; k < cases[c].n && cases[c].edges[k].t_us <= tr.t_us[e]; k++)
+                last_edge = cases[c].edges[k].t_us;
+            latency = (uint32_t)(tr.t_us[e] - last_edge);
+        }
+        bool ok = tr.presses == cases[c].presses && tr.repeats == cases[c].repeats &&
+                  tr.releases == cases[c].releases && latency <= cases[c].max_latency_us;
+        printf("%-38s: PRESS %d, REPEAT %d, RELEASE %d, latensi %5u us  %s\n",
+               cases[c].name, tr.presses, tr.repeats, tr.releases, latency, ok ? "OK" : "GAGAL");
+        failures += !ok;
+    }
+
+    // UP ditahan 6 s: langkah harus naik x1 -> x10 -> x100 tanpa mundur
+    run_button_trace(hold, 2, 7000000, true, &tr);
+    int steps[3] = {0, 0, 0};
+    bool ordered = true;
+    uint16_t prev_step = 1;
+    for (int e = 0; e < tr.count; e++)
+    {
+        if (tr.ev[e].type != BUTTON_EV_REPEAT)
+            continue;
+        uint16_t st = tr.ev[e].step;
+        steps[st == 1 ? 0 : st == 10 ? 1 : 2]++;
+        ordered &= st >= prev_step;
+        prev_step = st;
+    }
+    bool ok = ordered && steps[0] == BUTTON_REPEAT_X10_AFTER &&
+              steps[1] == BUTTON_REPEAT_X100_AFTER - BUTTON_REPEAT_X10_AFTER && steps[2] > 0;
+    printf("%-38s: REPEAT x1 %d, x10 %d, x100 %d  %s\n", "UP ditahan 6 s", steps[0], steps[1],
+           steps[2], ok ? "OK" : "GAGAL");
+    failures += !ok;
+
+    // Waktu menyapu lebarPulsa 100 -> 50000 ns dengan menahan UP
+    static const button_edge_t hold_long[] = {{0, true}};
+    run_button_trace(hold_long, 1, 200000000, true, &tr);
+    long value = 100;
+    uint64_t reached_us = 0;
+    for (int e = 0; e < tr.count && !reached_us; e++)
+    {
+        value += 100L * tr.ev[e].step;
+        if (value >= 50000)
+            reached_us = tr.t_us[e];
+    }
+    // Driver lama: repeat tetap 200 ms setelah 500 ms, langkah 100 ns
+    double legacy_s = 0.5 + (50000 - 100) / 100 * 0.2;
+    printf("Sapu lebar pulsa 100 -> 50000 ns: %.1f s (sebelumnya %.1f s)\n",
+           reached_us / 1e6, legacy_s);
+    failures += reached_us == 0;
+
+    // Antrean: urutan FIFO terjaga dan event berlebih dibuang, bukan ditimpa
+    button_queue_t q;
+    button_queue_init(&q);
+    for (int i = 0; i < BUTTON_QUEUE_SIZE + 4; i++)
+    {
+        button_event_t ev = {(uint8_t)(i % 3), BUTTON_EV_REPEAT, (uint16_t)i};
+        button_queue_push(&q, &ev);
+    }
+    button_event_t ev;
+    int popped = 0;
+    bool fifo = true;
+    while (button_queue_pop(&q, &ev))
+        fifo &= ev.step == popped++;
+    ok = fifo && popped == BUTTON_QUEUE_SIZE && q.dropped == 4;
+    printf("%-38s: %d diambil, %u dibuang  %s\n", "Antrean event penuh", popped, q.dropped,
+           ok ? "OK" : "GAGAL");
+    failures += !ok;
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,279 @@
+/**
+ * Tangkapan per pulsa: lib/capture_frame.c dan ring ISR -> core 0
+ * (mgc_sim capture)
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "adc_trace.h"
+#include "capture_frame.h"
+#include "mgc_checks.h"
+#include "remote_proto.h"
+#include "sg_run.h"
+#include "signal_timing.h"
+#include "signal_generator.pio.h"
+
+// Anggaran kirim per jalan TASK_USB main.c (CAPTURE_TX_BUDGET)
+#define CAPTURE_SIM_BUDGET 512
+#define CAPTURE_SAMPLE_NS 2000 // CAPTURE_SAMPLE_US di lib/pulse_capture.h
+
+typedef struct
+{
+    const char *name;
+    uint32_t freq_hz, pulse_ns, phase_ns, pairs, noise_lsb;
+    uint32_t loop_us; // Jarak putaran loop core 0 (WFE 1 ms, atau tertahan)
+    bool c_busy; // Event C tiba selama burst A: hilang setiap periode
+    bool full;   // Pengiriman tidak mengejar: ring penuh
+} capture_case_t;
+
+typedef struct
+{
+    uint32_t sent, bytes, bad, seq_errors;
+    uint64_t last_tick_us;
+} capture_sink_t;
+
+static adc_pulse_cfg_t capture_model(uint32_t pulse_ns, uint32_t noise_lsb, uint32_t seed)
+{
+    return (adc_pulse_cfg_t){pulse_ns, 20000, 2500, CAPTURE_SAMPLE_NS, 1500, 3600, 400, noise_lsb, seed};
+}
+
+// Putaran loop core 0: kirim bingkai sampai anggaran habis, lalu decode
+// setiap bingkai seperti klien host dan periksa urutan serta sampelnya
+static void capture_consume(capture_ring_t *r, remote_t *remote, const adc_pulse_cfg_t *model,
+                            capture_sink_t *sink, uint32_t *next_frame)
+{
+    static uint8_t payload[CAPTURE_PAYLOAD_MAX], frame[REMOTE_CAPTURE_FRAME_MAX], msg[REMOTE_CAPTURE_MSG_MAX];
+    static capture_slot_t got;
+    static uint16_t want[CAPTURE_MAX_SAMPLES];
+    uint32_t budget = 0;
+    const capture_slot_t *s;
+    while (budget < CAPTURE_SIM_BUDGET && (s = capture_ring_peek(r)) != NULL)
+    {
+        size_t len = capture_encode(s, payload);
+        capture_ring_release(r);
+        size_t n = remote_capture(remote, payload, len, frame);
+        budget += (uint32_t)n;
+        sink->bytes += (uint32_t)n;
+        sink->sent++;
+
+        size_t msg_len;
+        bool ok = remote_decode_capture(frame + 1, n - 2, msg, &msg_len) && msg[0] == REMOTE_EV_CAPTURE &&
+                  capture_decode(msg + 2, msg_len - 2, &got);
+        if (ok)
+        {
+            adc_pulse_burst(model, got.pulse, got.event, got.pairs * CAPTURE_CHANNELS, want);
+            ok = memcmp(got.samples, want, got.pairs * CAPTURE_CHANNELS * sizeof(uint16_t)) == 0;
+            uint32_t frame_no = got.pulse * 2 + got.event;
+            if (frame_no < *next_frame)
+                sink->seq_errors++;
+            *next_frame = frame_no + 1;
+        }
+        sink->bad += !ok;
+    }
+}
+
+// Satu detik proses: produsen dengan aturan lib/pulse_capture.c (burst
+// pairs x 4 us, tepi saat burst berjalan hilang, slot terbit di akhir burst)
+// dan konsumen tiap cc->loop_us
+static void capture_pipeline(const capture_case_t *cc, capture_ring_t *r, capture_sink_t *sink)
+{
+    static remote_t remote;
+    adc_pulse_cfg_t model = capture_model(cc->pulse_ns, cc->noise_lsb, cc->freq_hz);
+    uint64_t period_ns = 1000000000ull / cc->freq_hz;
+    uint64_t burst_ns = (uint64_t)cc->pairs * CAPTURE_CHANNELS * CAPTURE_SAMPLE_NS;
+    uint64_t events = 2ull * cc->freq_hz;
+    uint64_t busy_until = 0, pending_at = UINT64_MAX, tick = cc->loop_us * 1000ull;
+    uint32_t next_frame = 0;
+
+    remote_init(&remote, NULL);
+    capture_ring_init(r);
+    memset(sink, 0, sizeof(*sink));
+    for (uint64_t e = 0;;)
+    {
+        uint64_t t_event = e < events ? (e / 2) * period_ns + (e % 2 ? cc->phase_ns : 0) : UINT64_MAX;
+        if (t_event == UINT64_MAX && pending_at == UINT64_MAX && capture_ring_peek(r) == NULL)
+            break;
+        if (pending_at <= t_event && pending_at <= tick)
+        {
+            capture_ring_commit(r);
+            pending_at = UINT64_MAX;
+        }
+        else if (tick <= t_event)
+        {
+            capture_consume(r, &remote, &model, sink, &next_frame);
+            tick += cc->loop_us * 1000ull;
+        }
+        else
+        {
+            uint32_t pulse = (uint32_t)(e / 2), event = (uint32_t)(e % 2);
+            e++;
+            if (t_event < busy_until)
+            {
+                r->dropped_busy++;
+                continue;
+            }
+            capture_slot_t *s = capture_ring_claim(r);
+            if (s == NULL)
+                continue;
+            uint32_t dropped = capture_ring_dropped(r);
+            *s = (capture_slot_t){pulse, (uint32_t)(t_event / 1000u), (uint8_t)event, (uint8_t)cc->pairs,
+                                  (uint16_t)(dropped > 0xffff ? 0xffff : dropped)};
+            adc_pulse_burst(&model, pulse, event, cc->pairs * CAPTURE_CHANNELS, s->samples);
+            busy_until = pending_at = t_event + burst_ns;
+        }
+    }
+    sink->last_tick_us = tick / 1000u;
+}
+
+int cmd_capture(void)
+{
+    uint32_t failures = 0;
+
+    // IRQ tangkapan dari signal_generator_counted: satu flag per event A/C
+    // setiap periode, tepat satu siklus SM setelah tepi naik CH1/CH2, dan
+    // lebar pulsa tetap N + 3 siklus PIO dengan Y = N - PULSE_EXTRA
+    static const uint32_t freqs[] = {1000, 700, 37};
+    static const uint32_t params[][2] = {{100, 200}, {3500, 10000}, {50000, 60000}};
+    uint32_t clocks[2] = {125000000u, 250000000u};
+    uint32_t runs = 0, irq_fail = 0;
+    uint64_t lag_min = UINT64_MAX, lag_max = 0;
+    for (int c = 0; c < 2; c++)
+    {
+        sg_sys_clk_hz = clocks[c];
+        for (uint32_t fi = 0; fi < sizeof(freqs) / sizeof(freqs[0]); fi++)
+            for (uint32_t pi = 0; pi < sizeof(params) / sizeof(params[0]); pi++)
+            {
+                timing_request_t req = {freqs[fi], params[pi][0], params[pi][1]};
+                uint32_t div;
+                timing_plan_t plan;
+                if (timing_compile_auto(&req, sg_sys_clk_hz, sg_event_overhead(SG_PROGRAM_STATIC), &div,
+                                        &plan) != TIMING_OK ||
+                    (div & 0xff) != 0)
+                    continue;
+                const uint32_t periods = 3;
+                uint32_t sm_cycle = div >> 8;
+                sg_stop_t out;
+                uint64_t max_cycles = (uint64_t)(periods + 2) * plan.period_cycles * sm_cycle;
+                bool ok = sg_simulate_periods(SG_PROGRAM_STATIC, plan.delay, 4, div, periods, max_cycles, &out) &&
+                          out.capture_a == periods && out.capture_c == periods &&
+                          out.capture_lag_min == sm_cycle && out.capture_lag_max == sm_cycle &&
+                          out.ch1.pulses == periods &&
+                          out.ch1.high_cycles == (uint64_t)periods * plan.event_cycles[0] * sm_cycle;
+                if (!ok)
+                {
+                    printf("GAGAL IRQ tangkapan %u Hz %u/%u ns @ %u MHz: A %u C %u, jarak %llu..%llu\n",
+                           req.freq_hz, req.pulse_width_ns, req.phase_ns, sg_sys_clk_hz / 1000000u, out.capture_a,
+                           out.capture_c, (unsigned long long)out.capture_lag_min,
+                           (unsigned long long)out.capture_lag_max);
+                    irq_fail++;
+                }
+                runs++;
+                if (out.capture_lag_min / sm_cycle < lag_min)
+                    lag_min = out.capture_lag_min / sm_cycle;
+                if (out.capture_lag_max / sm_cycle > lag_max)
+                    lag_max = out.capture_lag_max / sm_cycle;
+            }
+    }
+    sg_sys_clk_hz = SG_SYS_CLK_HZ;
+
+    // Pulsa terpendek yang masih diterima: N = PULSE_EXTRA (Y = 0)
+    uint32_t shortest[4] = {signal_generator_counted_PULSE_EXTRA, 5, signal_generator_counted_PULSE_EXTRA, 20};
+    sg_stop_t out;
+    bool short_ok = sg_simulate_periods(SG_PROGRAM_STATIC, shortest, 4, 256, 2, 1000, &out) && out.capture_a == 2 &&
+                    out.capture_c == 2 &&
+                    out.ch1.high_cycles == 2ull * (shortest[0] + signal_generator_counted_EVENT_OVERHEAD);
+    irq_fail += !short_ok;
+    printf("IRQ tangkapan: %u jalan, tepi -> flag %llu..%llu siklus SM, pulsa N = %u: %s\n", runs,
+           (unsigned long long)lag_min, (unsigned long long)lag_max, signal_generator_counted_PULSE_EXTRA,
+           irq_fail == 0 ? "OK" : "GAGAL");
+    failures += irq_fail;
+
+    // Kode delta pulang-pergi lewat bingkai REMOTE_EV_CAPTURE
+    static const struct
+    {
+        const char *name;
+        uint32_t pairs, noise;
+    } codecs[] = {
+        {"1 pasangan", 1, 3},        {"16 pasangan tanpa derau", 16, 0}, {"16 pasangan derau 3", 16, 3},
+        {"64 pasangan derau 3", 64, 3}, {"64 pasangan derau 40", 64, 40}, {"64 pasangan derau 2000", 64, 2000},
+    };
+    static capture_slot_t slot, back;
+    static uint8_t payload[CAPTURE_PAYLOAD_MAX], frame[REMOTE_CAPTURE_FRAME_MAX], msg[REMOTE_CAPTURE_MSG_MAX];
+    static remote_t remote;
+    remote_init(&remote, NULL);
+    printf("%-26s %6s %6s %6s %s\n", "kode delta", "mentah", "kode", "bingkai", "hasil");
+    for (uint32_t i = 0; i < sizeof(codecs) / sizeof(codecs[0]); i++)
+    {
+        adc_pulse_cfg_t model = capture_model(3500, codecs[i].noise, i);
+        slot = (capture_slot_t){1234567u + i, 98765u, (uint8_t)(i & 1), (uint8_t)codecs[i].pairs, (uint16_t)(i * 7)};
+        adc_pulse_burst(&model, slot.pulse, slot.event, codecs[i].pairs * CAPTURE_CHANNELS, slot.samples);
+        size_t len = capture_encode(&slot, payload);
+        size_t n = remote_capture(&remote, payload, len, frame);
+        size_t msg_len;
+        bool ok = len <= CAPTURE_PAYLOAD_MAX && n <= REMOTE_CAPTURE_FRAME_MAX &&
+                  remote_decode_capture(frame + 1, n - 2, msg, &msg_len) && msg[0] == REMOTE_EV_CAPTURE &&
+                  msg_len - 2 == len && capture_decode(msg + 2, msg_len - 2, &back) && back.pulse == slot.pulse &&
+                  back.t_us == slot.t_us && back.event == slot.event && back.pairs == slot.pairs &&
+                  back.dropped == slot.dropped &&
+                  memcmp(back.samples, slot.samples, codecs[i].pairs * CAPTURE_CHANNELS * sizeof(uint16_t)) == 0;
+        // Payload terpotong atau kelebihan satu byte harus ditolak
+        ok = ok && !capture_decode(payload, len - 1, &back) && !capture_decode(payload, len + 1, &back);
+        size_t raw = CAPTURE_HEADER_BYTES + codecs[i].pairs * CAPTURE_CHANNELS * sizeof(uint16_t);
+        printf("%-26s %6zu %6zu %6zu %s\n", codecs[i].name, raw, len, n, ok ? "OK" : "GAGAL");
+        failures += !ok;
+    }
+    // Bingkai tangkapan lebih panjang dari pesan perintah: remote_decode()
+    // (buffer REMOTE_MSG_MAX) menolaknya tanpa menulis melewati buffer
+    size_t n = remote_capture(&remote, payload, CAPTURE_PAYLOAD_MAX, frame);
+    size_t msg_len;
+    bool reject = n - 2 > REMOTE_FRAME_MAX - 2 && !remote_decode(frame + 1, n - 2, msg, &msg_len);
+    printf("Bingkai %zu byte ditolak remote_decode(): %s\n", n, reject ? "OK" : "GAGAL");
+    failures += !reject;
+
+    // Aliran satu detik: produsen ISR -> ring -> loop core 0 -> CDC
+    static const capture_case_t cases[] = {
+        {"1 kHz 3.5/10 us x2", 1000, 3500, 10000, 2, 3, 1000, false, false},
+        {"1 kHz 3.5/10 us x16", 1000, 3500, 10000, 16, 3, 1000, true, false},
+        {"100 Hz 50/60 us x8", 100, 50000, 60000, 8, 3, 1000, false, false},
+        {"1 kHz 100/300 us x64", 1000, 100000, 300000, 64, 3, 1000, false, false},
+        {"1 kHz 100/300 us x64 derau", 1000, 100000, 300000, 64, 400, 1000, false, false},
+        // Loop tertahan (flush LCD, flash): 10 bingkai per putaran, ring 8
+        {"1 kHz x64 derau, loop 5 ms", 1000, 100000, 300000, 64, 400, 5000, false, true},
+        {"1 kHz x16, loop 5 ms", 1000, 100000, 300000, 16, 3, 5000, false, true},
+        {"1 kHz x16, loop 3 ms", 1000, 100000, 300000, 16, 3, 3000, false, false},
+    };
+    static capture_ring_t ring;
+    printf("%-28s %6s %6s %6s %6s %8s %s\n", "aliran (anggaran 512 B/ms)", "tangkap", "kirim", "sibuk", "penuh",
+           "kB/s", "hasil");
+    for (uint32_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        const capture_case_t *cc = &cases[i];
+        capture_sink_t sink;
+        capture_pipeline(cc, &ring, &sink);
+        uint32_t events = 2 * cc->freq_hz;
+        bool ok = ring.captured + capture_ring_dropped(&ring) == events && sink.sent == ring.captured &&
+                  sink.bad == 0 && sink.seq_errors == 0 &&
+                  ring.dropped_busy == (cc->c_busy ? cc->freq_hz : 0) && (ring.dropped_full > 0) == cc->full;
+        printf("%-28s %6u %6u %6u %6u %8.1f %s\n", cc->name, ring.captured, sink.sent, ring.dropped_busy,
+               ring.dropped_full, sink.bytes / (double)sink.last_tick_us * 1000.0, ok ? "OK" : "GAGAL");
+        failures += !ok;
+    }
+
+    // Biaya kode per bingkai terbesar di host (core 0 menjalankan hal yang sama)
+    adc_pulse_cfg_t model = capture_model(100000, 3, 1);
+    adc_pulse_burst(&model, 0, 0, CAPTURE_MAX_SAMPLES, slot.samples);
+    slot.pairs = CAPTURE_MAX_PAIRS;
+    uint32_t rounds = 20000;
+    size_t sink_bytes = 0;
+    double t0 = now_ns();
+    for (uint32_t i = 0; i < rounds; i++)
+    {
+        size_t len = capture_encode(&slot, payload);
+        sink_bytes += remote_capture(&remote, payload, len, frame);
+    }
+    double t1 = now_ns();
+    printf("Kode + bingkai %u pasangan: %.0f ns/bingkai di host (%.1f byte rata-rata)\n", CAPTURE_MAX_PAIRS,
+           (t1 - t0) / rounds, (double)sink_bytes / rounds);
+    printf("Hasil: %s\n", failures == 0 ? "OK" : "GAGAL");
+    return failures == 0 ? 0 : 1;
+}
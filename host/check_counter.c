@@ -0,0 +1,94 @@
+/**
+ * pulse_counter.pio dan lib/pulse_stats.c (mgc_sim counter)
+ */
+
+#include <stdio.h>
+#include "mgc_checks.h"
+#include "pulse_stats.h"
+#include "sg_run.h"
+#include "signal_timing.h"
+
+int cmd_counter(void)
+{
+    uint32_t clocks[2] = {125000000u, 250000000u};
+    uint32_t failures = 0, runs = 0;
+    double worst_on = 0, worst_period = 0;
+
+    for (int c = 0; c < 2; c++)
+    {
+        sg_sys_clk_hz = clocks[c];
+        // 700 Hz: periode ganjil dalam siklus (fase loop 2 siklus bergeser)
+        for (uint32_t f = 700; f <= 1000; f += 300)
+            for (uint32_t pw = 100; pw <= 50000; pw += 25000)
+                for (uint32_t ph = pw + 100; ph <= pw + 10000; ph += 9900)
+                    for (int prog = 0; prog < 2; prog++)
+                    {
+                        sg_program_t program = prog ? SG_PROGRAM_PATTERN : SG_PROGRAM_STATIC;
+                        wave_opts_t opts = {program, false, 0};
+                        uint32_t delays[4];
+                        timing_status_t status;
+                        uint32_t div = compute_delays(&opts, f, pw, ph, delays, &status);
+                        if (status != TIMING_OK)
+                            continue;
+
+                        // Hentikan di tengah pulsa CH1 ke-6 seperti STOP/durasi
+                        // habis: pulsa terpotong tetap terhitung. +8 siklus
+                        // menutup latensi awal program (pull pertama).
+                        uint64_t period = (uint64_t)sg_sys_clk_hz / f;
+                        uint64_t run = period * 5 + 8 + (uint64_t)pw * sg_sys_clk_hz / 2000000000u;
+                        uint32_t counter_div = pulse_stats_counter_div(run * 1000 / sg_sys_clk_hz + 1,
+                                                                       sg_sys_clk_hz);
+                        pulse_raw_t raw;
+                        sg_truth_t truth;
+                        sg_simulate_counted(program, delays, div, run, counter_div, &raw, &truth);
+
+                        pulse_report_t rep;
+                        pulse_stats_decode(&raw, sg_sys_clk_hz, counter_div, &rep);
+                        uint32_t expected = pulse_stats_expected(run * 1000000000ull / sg_sys_clk_hz,
+                                                                 1000000000u / f, 1);
+
+                        // Resolusi: waktu ON +-0.5 siklus per pulsa (plus pulsa
+                        // yang terpotong), rentang +-1 siklus total
+                        double ns_per_cycle = 1e9 / sg_sys_clk_hz;
+                        double true_on = truth.high_cycles * ns_per_cycle;
+                        double true_period = truth.pulses > 1 ? (truth.last_rise - truth.first_rise) *
+                                                                    ns_per_cycle / (truth.pulses - 1)
+                                                              : 0;
+                        double e_on = rep.on_time_ns - true_on;
+                        double e_period = rep.mean_period_ns - true_period;
+                        double on_limit = (truth.pulses / 2.0 + 1) * ns_per_cycle;
+                        double period_limit = truth.pulses > 1 ? ns_per_cycle / (truth.pulses - 1) + 1 : 0;
+                        // Batas yang dipakai uji mandiri tidak boleh lebih sempit
+                        double period_bound = pulse_stats_period_error_ns(truth.pulses, sg_sys_clk_hz, counter_div);
+                        bool ok = rep.pulses == truth.pulses && rep.pulses == expected &&
+                                  e_on <= on_limit && e_on >= -on_limit &&
+                                  e_period <= period_limit && e_period >= -period_limit &&
+                                  e_period <= period_bound && e_period >= -period_bound;
+                        if (!ok)
+                            printf("GAGAL %u Hz %u/%u ns @ %u Hz %s: pulsa %u/%u (diharapkan %u), "
+                                   "ON %+.1f ns, periode %+.1f ns\n",
+                                   f, pw, ph, sg_sys_clk_hz, prog ? "pola" : "statis", rep.pulses,
+                                   truth.pulses, expected, e_on, e_period);
+                        if (e_on * e_on > worst_on * worst_on)
+                            worst_on = e_on;
+                        if (e_period * e_period > worst_period * worst_period)
+                            worst_period = e_period;
+                        failures += !ok;
+                        runs++;
+                    }
+    }
+    sg_sys_clk_hz = SG_SYS_CLK_HZ;
+
+    // Divider penghitung: 30 detik (maks. UI) muat tanpa divider di 250 MHz
+    uint32_t d125 = pulse_stats_counter_div(30000, 125000000u);
+    uint32_t d250 = pulse_stats_counter_div(30000, 250000000u);
+    uint32_t d600 = pulse_stats_counter_div(600000, 250000000u);
+    bool div_ok = d125 == 1 && d250 == 1 && d600 == 18;
+    printf("Divider penghitung: 30 s @ 125 MHz = %u, 30 s @ 250 MHz = %u, 600 s @ 250 MHz = %u %s\n",
+           d125, d250, d600, div_ok ? "OK" : "GAGAL");
+    failures += !div_ok;
+
+    printf("Telemetri: %u jalan, galat terburuk waktu ON %+.1f ns total, periode rata-rata %+.2f ns, %u gagal\n",
+           runs, worst_on, worst_period, failures);
+    return failures == 0 ? 0 : 1;
+}
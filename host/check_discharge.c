@@ -0,0 +1,135 @@
+/**
+ * lib/bank_monitor.c atas jejak ADC tiruan (mgc_sim discharge)
+ */
+
+#include <stdio.h>
+#include "adc_trace.h"
+#include "bank_monitor.h"
+#include "mgc_checks.h"
+
+// Segmen terpanjang dari ring DMA (lib/bank_adc.h)
+#define BANK_SIM_CHUNK_MAX 4096
+
+#define DISCHARGE_SAFE_MV 36000
+#define DISCHARGE_HOLD_US 100000
+#define DISCHARGE_TAU_US 1000
+#define DISCHARGE_TIMEOUT_MS 5000
+
+typedef struct
+{
+    const char *name;
+    adc_trace_cfg_t trace;
+    bank_state_t expect;
+} discharge_case_t;
+
+// Alirkan jejak ke pemantau dalam segmen 'chunk' sampel seperti bank_adc_next()
+static bank_state_t run_discharge(const adc_trace_cfg_t *trace, uint32_t rate, uint32_t chunk, bank_monitor_t *m)
+{
+    static uint16_t buf[BANK_SIM_CHUNK_MAX];
+    bank_monitor_cfg_t cfg = {
+        .full_scale_mv = trace->full_scale_mv,
+        .safe_mv = DISCHARGE_SAFE_MV,
+        .sample_rate_hz = rate,
+        .tau_us = DISCHARGE_TAU_US,
+        .hold_us = DISCHARGE_HOLD_US,
+        .timeout_ms = DISCHARGE_TIMEOUT_MS,
+    };
+    bank_monitor_init(m, &cfg);
+    bank_monitor_start(m);
+    uint64_t index = 0;
+    while (m->state == BANK_DISCHARGING)
+    {
+        for (uint32_t i = 0; i < chunk; i++)
+            buf[i] = adc_trace_sample(trace, index + i, rate);
+        bank_monitor_feed(m, buf, chunk);
+        index += chunk;
+    }
+    return m->state;
+}
+
+int cmd_discharge(void)
+{
+    static const char *state_name[] = {"IDLE", "MENGOSONGKAN", "AMAN", "BATAS WAKTU"};
+    static const discharge_case_t cases[] = {
+        {"RC bersih", {660000, 400000, 0, 200000, 0, 0, 0, 1}, BANK_SAFE},
+        {"derau +-3 LSB", {660000, 400000, 0, 200000, 3, 0, 0, 2}, BANK_SAFE},
+        {"derau +-12 LSB", {660000, 400000, 0, 200000, 12, 0, 0, 3}, BANK_SAFE},
+        {"EMI ke 0 V /1000 sampel", {660000, 400000, 0, 200000, 3, 1000, -4095, 4}, BANK_SAFE},
+        {"EMI ke atas /500 sampel", {660000, 400000, 0, 200000, 3, 500, 1500, 5}, BANK_SAFE},
+        {"RC cepat (tau 20 ms)", {660000, 400000, 0, 20000, 3, 0, 0, 6}, BANK_SAFE},
+        {"sudah aman", {660000, 12000, 0, 200000, 3, 0, 0, 7}, BANK_SAFE},
+        {"resistor putus", {660000, 400000, 100000, 200000, 3, 0, 0, 8}, BANK_TIMEOUT},
+    };
+    static const uint32_t rates[] = {500000, 200000, 50000};
+    uint32_t failures = 0;
+
+    printf("Ambang %u mV, hold %u ms, tau filter %u us, batas waktu %u ms\n", DISCHARGE_SAFE_MV,
+           DISCHARGE_HOLD_US / 1000, DISCHARGE_TAU_US, DISCHARGE_TIMEOUT_MS);
+    printf("%-24s %7s %3s %12s %10s %10s %8s %s\n", "jejak", "S/s", "k", "status", "silang ms", "selesai ms",
+           "akhir mV", "hasil");
+    for (uint32_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++)
+    {
+        const discharge_case_t *dc = &cases[c];
+        for (uint32_t r = 0; r < sizeof(rates) / sizeof(rates[0]); r++)
+        {
+            uint32_t rate = rates[r];
+            bank_monitor_t m, m_odd;
+            bank_state_t state = run_discharge(&dc->trace, rate, BANK_SIM_CHUNK_MAX, &m);
+            // Hasil tidak boleh bergantung pada potongan segmen ring
+            run_discharge(&dc->trace, rate, 37, &m_odd);
+            bool ok = state == dc->expect && m_odd.state == state && m_odd.done_sample == m.done_sample;
+
+            uint64_t cross = adc_trace_crossing_us(&dc->trace, DISCHARGE_SAFE_MV);
+            uint64_t done = bank_monitor_elapsed_us(&m);
+            if (state == BANK_SAFE)
+            {
+                // Paling cepat: silang + hold (EMI tidak boleh mengakhiri lebih
+                // awal). Paling lambat: ditambah beberapa kali tau filter efektif
+                // dan 1 LSB derau pada kemiringan kurva di ambang. Lonjakan ke
+                // atas menaikkan terfilter spike/2^k dan mereset hold sampai
+                // kurva turun sejauh itu (kemiringan di ambang = safe/tau).
+                uint64_t tau_f = ((uint64_t)1000000u << m.shift) / rate;
+                uint64_t lo = cross + DISCHARGE_HOLD_US;
+                uint64_t hi = lo + 4 * tau_f + 2000;
+                if (dc->trace.spike_lsb > 0)
+                {
+                    uint64_t bump_mv = (uint64_t)dc->trace.spike_lsb * dc->trace.full_scale_mv / BANK_ADC_MAX >> m.shift;
+                    hi += bump_mv * dc->trace.tau_us / DISCHARGE_SAFE_MV;
+                }
+                lo = lo > 2000 ? lo - 2000 : 0;
+                ok = ok && done >= lo && done <= hi;
+            }
+            else
+                ok = ok && done == (uint64_t)DISCHARGE_TIMEOUT_MS * 1000u;
+            if (!ok)
+                failures++;
+
+            char cross_str[16];
+            if (cross == UINT64_MAX)
+                snprintf(cross_str, sizeof(cross_str), "-");
+            else
+                snprintf(cross_str, sizeof(cross_str), "%.1f", cross / 1000.0);
+            printf("%-24s %7u %3u %12s %10s %10.1f %8u %s\n", dc->name, rate, m.shift, state_name[state],
+                   cross_str, done / 1000.0, bank_monitor_mv(&m), ok ? "OK" : "GAGAL");
+        }
+    }
+
+    // Biaya filter per sampel: 500 kS/s harus jauh di bawah anggaran core 0
+    adc_trace_cfg_t bench = {660000, 400000, 100000, 200000, 3, 0, 0, 9};
+    static uint16_t buf[BANK_SIM_CHUNK_MAX];
+    for (uint32_t i = 0; i < BANK_SIM_CHUNK_MAX; i++)
+        buf[i] = adc_trace_sample(&bench, 100000 + i, 500000);
+    bank_monitor_cfg_t cfg = {660000, DISCHARGE_SAFE_MV, 500000, DISCHARGE_TAU_US, DISCHARGE_HOLD_US, 0};
+    bank_monitor_t m;
+    bank_monitor_init(&m, &cfg);
+    bank_monitor_start(&m);
+    uint32_t rounds = 2000;
+    double t0 = now_ns();
+    for (uint32_t i = 0; i < rounds; i++)
+        bank_monitor_feed(&m, buf, BANK_SIM_CHUNK_MAX);
+    double t1 = now_ns();
+    printf("Filter + ambang: %.2f ns/sampel di host (%u sampel)\n", (t1 - t0) / ((double)rounds * BANK_SIM_CHUNK_MAX),
+           rounds * BANK_SIM_CHUNK_MAX);
+    printf("Hasil: %s\n", failures == 0 ? "OK" : "GAGAL");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,135 @@
+/**
+ * lib/param_store.c di atas emulator NOR flash (mgc_sim flash)
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "flash_emu.h"
+#include "mgc_checks.h"
+#include "param_store.h"
+
+// Payload uji: nilai berbeda per simpan agar rekaman lama dan baru dapat
+// dibedakan
+typedef struct
+{
+    uint32_t serial;
+    uint32_t slot;
+    uint32_t check;
+} flash_payload_t;
+
+static flash_payload_t flash_payload(uint32_t slot, uint32_t serial)
+{
+    flash_payload_t p = {serial, slot, serial * 2654435761u ^ slot};
+    return p;
+}
+
+static bool flash_slot_is(const param_store_t *st, uint32_t slot, uint32_t serial)
+{
+    flash_payload_t got, want = flash_payload(slot, serial);
+    return param_store_read(st, slot, &got, sizeof(got)) == (int)sizeof(got) &&
+           memcmp(&got, &want, sizeof(got)) == 0;
+}
+
+#define FLASH_SECTORS 4
+
+int cmd_flash(void)
+{
+    static flash_emu_t emu, snapshot;
+    param_store_t st;
+    int failures = 0;
+    const uint32_t saves = 10000;
+
+    // Ketahanan: 10000 simpan slot 0 ditambah simpan preset sesekali
+    flash_emu_init(&emu, FLASH_SECTORS, 0xff);
+    param_store_mount(&st, &emu.flash);
+    uint32_t serial[PARAM_SLOTS] = {0};
+    bool ok = true;
+    for (uint32_t i = 1; i <= saves; i++)
+    {
+        uint32_t slot = i % 50 == 0 ? 1 + (i / 50) % (PARAM_SLOTS - 1) : 0;
+        serial[slot] = i;
+        flash_payload_t p = flash_payload(slot, i);
+        ok &= param_store_write(&st, slot, &p, sizeof(p));
+        if (i % 97 == 0)
+        {
+            // Boot ulang: hasil scan harus sama dengan yang terakhir ditulis
+            param_store_mount(&st, &emu.flash);
+            for (uint32_t s = 0; s < PARAM_SLOTS; s++)
+                ok &= serial[s] ? flash_slot_is(&st, s, serial[s]) : !param_store_has(&st, s);
+        }
+    }
+    uint32_t max_erase = 0;
+    printf("%u simpan (%u sektor, %u rekaman/sektor, %d slot):\n", saves, FLASH_SECTORS,
+           PARAM_PAGES_PER_SECTOR - 1, PARAM_SLOTS);
+    printf("  skema lama : %5u erase pada satu sektor\n", saves);
+    printf("  log        : erase per sektor");
+    for (uint32_t s = 0; s < FLASH_SECTORS; s++)
+    {
+        printf(" %u", emu.erases[s]);
+        if (emu.erases[s] > max_erase)
+            max_erase = emu.erases[s];
+        ok &= param_store_erase_count(&st, s) == emu.erases[s];
+    }
+    printf(" (maks %u, %.1fx lebih sedikit), isi %s\n", max_erase, (double)saves / max_erase,
+           ok ? "OK" : "SALAH");
+    failures += !ok;
+
+    // Putus daya di setiap titik selama satu simpan, termasuk simpan yang
+    // menyalin rekaman hidup dan menghapus sektor. Setelah boot ulang slot
+    // yang ditulis berisi nilai lama atau baru, slot lain utuh, dan simpan
+    // berikutnya berhasil.
+    uint32_t scenarios = 0, got_new = 0, torn_ok = 0;
+    for (uint32_t prior = 0; prior < 3 * PARAM_PAGES_PER_SECTOR; prior++)
+    {
+        flash_emu_init(&snapshot, FLASH_SECTORS, 0xa5); // Flash bekas: sampah, bukan 0xFF
+        param_store_mount(&st, &snapshot.flash);
+        uint32_t base_serial[PARAM_SLOTS] = {0};
+        for (uint32_t s = 1; s < PARAM_SLOTS; s++)
+        {
+            flash_payload_t p = flash_payload(s, 1000 + s);
+            param_store_write(&st, s, &p, sizeof(p));
+            base_serial[s] = 1000 + s;
+        }
+        for (uint32_t i = 1; i <= prior + 1; i++)
+        {
+            flash_payload_t p = flash_payload(0, i);
+            param_store_write(&st, 0, &p, sizeof(p));
+            base_serial[0] = i;
+        }
+
+        for (int64_t cut = 0; cut < PARAM_SECTOR_SIZE + PARAM_SLOTS * PARAM_PAGE_SIZE + 2 * PARAM_PAGE_SIZE;
+             cut += 61)
+        {
+            emu = snapshot;
+            emu.flash.ctx = &emu;
+            emu.flash.base = emu.mem;
+            param_store_mount(&st, &emu.flash);
+            flash_emu_cut_after(&emu, cut);
+            flash_payload_t p = flash_payload(0, 5000);
+            param_store_write(&st, 0, &p, sizeof(p));
+            flash_emu_power_on(&emu);
+
+            param_store_mount(&st, &emu.flash);
+            bool is_new = flash_slot_is(&st, 0, 5000);
+            bool good = is_new || flash_slot_is(&st, 0, base_serial[0]);
+            for (uint32_t s = 1; s < PARAM_SLOTS; s++)
+                good &= flash_slot_is(&st, s, base_serial[s]);
+            p = flash_payload(0, 6000);
+            good &= param_store_write(&st, 0, &p, sizeof(p));
+            param_store_mount(&st, &emu.flash);
+            good &= flash_slot_is(&st, 0, 6000);
+
+            scenarios++;
+            got_new += is_new;
+            torn_ok += good;
+            if (!good)
+                printf("  GAGAL: %u simpan sebelumnya, putus setelah %lld byte\n", prior, (long long)cut);
+        }
+    }
+    ok = torn_ok == scenarios;
+    printf("Putus daya saat simpan: %u skenario, %u pulih (%u sudah berisi nilai baru)  %s\n",
+           scenarios, torn_ok, got_new, ok ? "OK" : "GAGAL");
+    failures += !ok;
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,227 @@
+/**
+ * lib/channel_group.c di atas shim (mgc_app group): skew start grup kanal
+ *
+ * Delapan kanal lewat API grup yang sebenarnya (SM, program, DMA ring dan
+ * pin sinkron diklaim/diatur channel_group_*), tanpa app_init() sehingga
+ * kedua blok PIO kosong. Tepi setiap kanal dibandingkan eksak dengan
+ * tabelnya; event pertama menentukan latensi start per kanal.
+ */
+
+#include <stdio.h>
+#include "shim.h"
+#include "hardware/clocks.h"
+#include "channel_group.h"
+#include "pattern_engine.pio.h"
+
+// Harness mencetak ke stdout, bukan ke aliran CDC firmware
+#undef printf
+
+#define GROUP_CHANNELS 8
+#define GROUP_SYNC_PIN 26
+#define GROUP_MAX_LOG 4096
+
+typedef struct
+{
+    uint64_t cycle[GROUP_MAX_LOG];
+    uint8_t pins[GROUP_MAX_LOG];
+    uint32_t n;
+} group_log_t;
+
+static channel_group_t group;
+static pattern_t patterns[GROUP_CHANNELS];
+static group_log_t logs[GROUP_CHANNELS];
+
+static void group_on_edge(void *ctx, uint64_t sys_cycle, uint32_t old_pins, uint32_t new_pins)
+{
+    (void)ctx;
+    for (uint i = 0; i < group.count; i++)
+    {
+        const channel_t *c = &group.ch[i];
+        uint32_t mask = ((1u << c->pin_count) - 1) << c->pin_base;
+        if (!((old_pins ^ new_pins) & mask))
+            continue;
+        group_log_t *log = &logs[i];
+        if (log->n < GROUP_MAX_LOG)
+        {
+            log->cycle[log->n] = sys_cycle;
+            log->pins[log->n] = (uint8_t)((new_pins & mask) >> c->pin_base);
+        }
+        log->n++;
+    }
+}
+
+// Pola kanal: pasangan elektroda dan kanal tunggal dengan frekuensi berbeda
+static const struct
+{
+    uint32_t pin_base, pin_count, freq_hz, pulse_ns, gap_ns;
+} spec[GROUP_CHANNELS] = {
+    {6, 4, 100, 1000, 2000}, // Preset bipolar CH1..CH4 (9, 0, 6, 0)
+    {10, 2, 250, 2000, 500},
+    {12, 2, 1000, 500, 500},
+    {14, 1, 333, 3000, 0},
+    {16, 2, 400, 800, 0}, // Bertingkat 01, 11, 00: 3 event -> dipecah jadi 4
+    {18, 2, 50, 20000, 1000},
+    {20, 1, 1000, 200, 0},
+    {21, 4, 500, 600, 300}, // Bergiliran keempat pin
+};
+
+static void group_patterns(void)
+{
+    for (int i = 0; i < GROUP_CHANNELS; i++)
+    {
+        pattern_t *p = &patterns[i];
+        if (i == 0)
+        {
+            timing_request_t req = {spec[i].freq_hz, spec[i].pulse_ns, spec[i].pulse_ns + spec[i].gap_ns};
+            pattern_bipolar(p, &req);
+            continue;
+        }
+        pattern_init(p, spec[i].freq_hz);
+        if (spec[i].pin_count == 1)
+        {
+            pattern_add(p, 0x1, spec[i].pulse_ns);
+        }
+        else if (spec[i].gap_ns == 0)
+        {
+            pattern_add(p, 0x1, spec[i].pulse_ns);
+            pattern_add(p, 0x3, spec[i].pulse_ns);
+        }
+        else
+        {
+            for (uint32_t b = 0; b < spec[i].pin_count; b++)
+            {
+                pattern_add(p, (uint8_t)(1u << b), spec[i].pulse_ns);
+                pattern_add(p, 0x0, spec[i].gap_ns);
+            }
+        }
+        pattern_add(p, 0x0, 0);
+    }
+}
+
+// Bandingkan log kanal 'i' dengan tabelnya tanpa toleransi satu siklus pun,
+// mulai dari semua pin LOW; 't0' = siklus event pertama di log
+static bool group_compare(uint i, uint32_t periods, uint64_t *t0)
+{
+    const channel_t *c = &group.ch[i];
+    const group_log_t *log = &logs[i];
+    uint64_t div = group.clkdiv_fixed >> 8;
+    uint64_t now = 0;
+    uint8_t prev = 0;
+    uint32_t n = 0;
+
+    if (log->n == 0)
+        return false;
+    *t0 = log->cycle[0];
+    for (uint32_t p = 0; p < periods; p++)
+        for (uint32_t w = 0; w < c->length; w++)
+        {
+            uint8_t mask = pattern_word_mask(group.tables[i][w]);
+            if (mask != prev)
+            {
+                if (n >= log->n || n >= GROUP_MAX_LOG)
+                    return false;
+                if (log->cycle[n] - *t0 != now || log->pins[n] != mask)
+                {
+                    printf("  kanal %u tepi %u: %llu siklus pin %x, diharapkan %llu pin %x\n", i, n,
+                           (unsigned long long)(log->cycle[n] - *t0), log->pins[n], (unsigned long long)now,
+                           mask);
+                    return false;
+                }
+                n++;
+            }
+            prev = mask;
+            now += ((uint64_t)pattern_word_count(group.tables[i][w]) + pattern_engine_EVENT_OVERHEAD) * div;
+        }
+    return true;
+}
+
+int cmd_group(void)
+{
+    shim_flash_attach(NULL);
+    group_patterns();
+
+    if (channel_group_init(&group, GROUP_SYNC_PIN, GROUP_CHANNELS) != TIMING_OK)
+    {
+        printf("GAGAL channel_group_init\n");
+        return 1;
+    }
+    uint64_t longest_ns = 0;
+    for (int i = 0; i < GROUP_CHANNELS; i++)
+    {
+        timing_status_t status =
+            channel_group_add(&group, spec[i].pin_base, spec[i].pin_count, &patterns[i]);
+        if (status != TIMING_OK)
+        {
+            printf("GAGAL kanal %d: %s\n", i, timing_status_str(status));
+            return 1;
+        }
+    }
+    uint32_t sys_clk_hz = clock_get_hz(clk_sys);
+    printf("clkdiv %u:\n", group.clkdiv_fixed >> 8);
+    for (uint i = 0; i < group.count; i++)
+    {
+        const channel_t *c = &group.ch[i];
+        uint64_t ns = timing_cycles_to_ns(c->period_cycles, sys_clk_hz, group.clkdiv_fixed);
+        printf("  kanal %u: PIO%u SM%u GP%u-%u, %u event, periode %llu ns\n", i, pio_get_index(c->pio), c->sm,
+               c->pin_base, c->pin_base + c->pin_count - 1, c->length, (unsigned long long)ns);
+        longest_ns = ns > longest_ns ? ns : longest_ns;
+    }
+
+    shim_pio_edges(group_on_edge, NULL);
+    channel_group_start(&group);
+    sleep_us(2 * longest_ns / 1000 + longest_ns / 2000);
+    channel_group_stop(&group);
+    shim_pio_edges(NULL, NULL);
+
+    // Dengan prolog sinkron: 0 siklus di blok yang sama dan antar blok
+    // (clkdiv 1 untuk seluruh ruang UI)
+    bool ok = true;
+    uint64_t min_all = UINT64_MAX, max_all = 0, skew_block = 0;
+    for (uint b = 0; b < 2; b++)
+    {
+        uint64_t min_b = UINT64_MAX, max_b = 0;
+        for (uint i = 0; i < group.count; i++)
+        {
+            if (pio_get_index(group.ch[i].pio) != b)
+                continue;
+            uint64_t period = (uint64_t)group.ch[i].period_cycles * (group.clkdiv_fixed >> 8);
+            uint64_t t0;
+            uint64_t run = (uint64_t)(2 * longest_ns + longest_ns / 2) * sys_clk_hz / 1000000000u;
+            if (!group_compare(i, (uint32_t)(run / period) - 1, &t0))
+            {
+                printf("  kanal %u: tepi tidak sesuai tabel\n", i);
+                ok = false;
+                continue;
+            }
+            min_b = t0 < min_b ? t0 : min_b;
+            max_b = t0 > max_b ? t0 : max_b;
+        }
+        if (max_b < min_b)
+            continue;
+        if (max_b - min_b > skew_block)
+            skew_block = max_b - min_b;
+        min_all = min_b < min_all ? min_b : min_all;
+        max_all = max_b > max_all ? max_b : max_all;
+    }
+    uint64_t skew_all = max_all >= min_all ? max_all - min_all : 0;
+    ok = ok && skew_block == 0 && skew_all == 0;
+    printf("  sinkron: skew per blok %llu, antar blok %llu siklus %s\n", (unsigned long long)skew_block,
+           (unsigned long long)skew_all, ok ? "OK" : "GAGAL");
+
+    // Setelah stop semua pin kanal LOW, dan release mengembalikan SM/DMA
+    for (uint i = 0; i < group.count; i++)
+        for (uint k = 0; k < group.ch[i].pin_count; k++)
+            if (gpio_get(group.ch[i].pin_base + k))
+            {
+                printf("  GAGAL GP%u masih HIGH setelah stop\n", group.ch[i].pin_base + k);
+                ok = false;
+            }
+    channel_group_release(&group);
+    if (channel_group_init(&group, GROUP_SYNC_PIN, GROUP_CHANNELS) != TIMING_OK)
+    {
+        printf("  GAGAL SM tidak kembali setelah release\n");
+        ok = false;
+    }
+    printf("Hasil: %s\n", ok ? "OK" : "GAGAL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,178 @@
+/**
+ * lib/lcd_frame.c dan lib/lcd_queue.c di atas model I2C + HD44780 (mgc_sim lcd)
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "lcd_frame.h"
+#include "lcd_model.h"
+#include "lcd_queue.h"
+#include "mgc_checks.h"
+
+typedef struct
+{
+    bool clear; // Layar lama memanggil lcd_clear() sebelum menggambar
+    const char *line0, *line1;
+} lcd_screen_t;
+
+static void legacy_draw(lcd_model_t *m, const lcd_screen_t *s)
+{
+    if (s->clear)
+        lcd_model_legacy_clear(m);
+    lcd_model_legacy_set_cursor(m, 0, 0);
+    lcd_model_legacy_string(m, s->line0);
+    lcd_model_legacy_set_cursor(m, 1, 0);
+    lcd_model_legacy_string(m, s->line1);
+}
+
+static void fb_draw(lcd_model_t *m, lcd_frame_t *f, const lcd_screen_t *s)
+{
+    uint8_t buf[LCD_FRAME_MAX_BYTES];
+    lcd_frame_clear(f);
+    lcd_frame_print(f, 0, 0, s->line0);
+    lcd_frame_print(f, 1, 0, s->line1);
+    size_t n = lcd_frame_encode_dirty(f, LCD_PCF_BACKLIGHT, buf);
+    if (n)
+        lcd_model_write(m, buf, n);
+}
+
+static bool screen_matches(const lcd_model_t *m, const lcd_screen_t *s)
+{
+    char row[LCD_COLS + 1], want[LCD_COLS + 1];
+    const char *lines[2] = {s->line0, s->line1};
+    for (int r = 0; r < LCD_ROWS; r++)
+    {
+        lcd_model_row(m, r, row);
+        snprintf(want, sizeof(want), "%-16s", lines[r]);
+        if (strcmp(row, want) != 0)
+            return false;
+    }
+    return true;
+}
+
+static void print_lcd_cost(const char *driver, uint32_t baud, const lcd_model_t *m, bool ok)
+{
+    printf("  %-12s %3u kHz: %4u transaksi, %4u byte, bus %8.1f us, total %8.1f us, "
+           "pelanggaran %u, isi %s\n",
+           driver, baud / 1000, m->transactions, m->bytes, m->bus_ns / 1000.0,
+           (m->bus_ns + m->sleep_ns) / 1000.0, m->timing_violations, ok ? "OK" : "SALAH");
+}
+
+// Backend asinkron: UP ditahan dengan pembaruan layar tiap 100 us (lebih
+// cepat dari satu batch di bus) ditambah satu perintah mentah Clear Display.
+// Konsumen meniru interupsi STOP_DET: batch berikutnya diambil begitu bus
+// dan jeda eksekusi selesai.
+static int lcd_async_case(void)
+{
+    const int updates = 50;
+    const uint64_t interval_ns = 100000;
+    lcd_model_t m;
+    lcd_queue_t q;
+    uint8_t buf[LCD_FRAME_MAX_BYTES];
+    char line[LCD_COLS + 1];
+
+    lcd_model_init(&m, 400000);
+    lcd_queue_init(&q);
+    lcd_queue_cmd(&q, 0x01); // Clear Display: menunggu alarm 1.6 ms
+
+    uint32_t batches = 0;
+    int produced = 0;
+    for (uint64_t t = 0; produced < updates || lcd_queue_depth(&q) != 0; t += 1000)
+    {
+        if (produced < updates && t >= produced * interval_ns)
+        {
+            lcd_queue_clear(&q);
+            lcd_queue_print(&q, 0, 0, "SET FREKUENSI");
+            snprintf(line, sizeof(line), "%d Hz ", 100 + 10 * produced);
+            lcd_queue_print(&q, 1, 0, line);
+            produced++;
+        }
+        if (m.now_ns <= t)
+        {
+            uint32_t wait_us;
+            size_t n = lcd_queue_next_batch(&q, LCD_PCF_BACKLIGHT, buf, &wait_us);
+            if (n)
+            {
+                lcd_model_write(&m, buf, n);
+                lcd_model_sleep_us(&m, wait_us);
+                batches++;
+            }
+        }
+    }
+
+    lcd_screen_t last = {false, "SET FREKUENSI", line};
+    bool ok = screen_matches(&m, &last);
+    printf("Antrean asinkron: %d pembaruan tiap %llu us + Clear Display\n",
+           updates, (unsigned long long)(interval_ns / 1000));
+    print_lcd_cost("antrean", m.baud_hz, &m, ok);
+    printf("  %u batch, kedalaman puncak %u sel/perintah, perintah dibuang %u\n",
+           batches, q.high_water, q.raw_dropped);
+    return !ok || m.timing_violations;
+}
+
+int cmd_lcd(void)
+{
+    // Transisi layar yang sering terjadi di main.c
+    static const struct
+    {
+        const char *name;
+        lcd_screen_t from, to;
+    } cases[] = {
+        {"Menu FREKUENSI -> LEBAR PULSA",
+         {true, "FREKUENSI", "100 Hz"}, {true, "LEBAR PULSA", "3.5 uS"}},
+        {"SET FREKUENSI 100 -> 110 Hz (UP)",
+         {true, "SET FREKUENSI", "100 Hz "}, {true, "SET FREKUENSI", "110 Hz "}},
+        {"SET LEBAR PULSA tanpa perubahan",
+         {true, "SET LEBAR PULSA", "3.5 uS "}, {true, "SET LEBAR PULSA", "3.5 uS "}},
+        {"Layar proses (tik 200 ms)",
+         {false, "BERJALAN SEL=STP", " 1.2s SISA  1.8s"}, {false, "BERJALAN SEL=STP", " 1.4s SISA  1.6s"}},
+    };
+    int failures = 0;
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        printf("%s\n", cases[i].name);
+
+        // Driver lama pada bus 100 kHz seperti sebelumnya
+        lcd_model_t m;
+        lcd_model_init(&m, 100000);
+        legacy_draw(&m, &cases[i].from);
+        lcd_model_reset_stats(&m);
+        m.timing_violations = 0;
+        legacy_draw(&m, &cases[i].to);
+        bool ok = screen_matches(&m, &cases[i].to);
+        print_lcd_cost("lama", m.baud_hz, &m, ok);
+        failures += !ok || m.timing_violations;
+
+        uint32_t bauds[2] = {100000, 400000};
+        for (int b = 0; b < 2; b++)
+        {
+            lcd_frame_t f;
+            lcd_model_init(&m, bauds[b]);
+            lcd_frame_init(&f);
+            fb_draw(&m, &f, &cases[i].from);
+            lcd_model_reset_stats(&m);
+            m.timing_violations = 0;
+            fb_draw(&m, &f, &cases[i].to);
+            ok = screen_matches(&m, &cases[i].to);
+            print_lcd_cost("framebuffer", m.baud_hz, &m, ok);
+            failures += !ok || m.timing_violations;
+        }
+    }
+
+    // Layar penuh dari DDRAM tak dikenal harus benar dan tanpa pelanggaran
+    lcd_model_t m;
+    lcd_frame_t f;
+    lcd_model_init(&m, 400000);
+    lcd_frame_init(&f);
+    lcd_screen_t full = {false, "0123456789ABCDEF", "fedcba9876543210"};
+    fb_draw(&m, &f, &full);
+    bool ok = screen_matches(&m, &full) && m.bytes <= LCD_FRAME_MAX_BYTES;
+    printf("Layar penuh dari DDRAM tak dikenal\n");
+    print_lcd_cost("framebuffer", m.baud_hz, &m, ok);
+    failures += !ok || m.timing_violations;
+
+    failures += lcd_async_case();
+
+    return failures == 0 ? 0 : 1;
+}
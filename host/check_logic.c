@@ -0,0 +1,314 @@
+/**
+ * lib/logic_analysis.c dan logic_analyzer.pio (mgc_sim logic)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "logic_analysis.h"
+#include "mgc_checks.h"
+#include "pio_unroll.h"
+#include "pulse_stats.h"
+#include "sg_run.h"
+#include "signal_timing.h"
+#include "signal_generator.pio.h"
+
+// Buffer tangkapan firmware (LOGIC_BUFFER_WORDS di lib/logic_analyzer.h)
+#define LOGIC_SIM_WORDS 8192
+#define LOGIC_SIM_SAMPLES (LOGIC_SIM_WORDS * LOGIC_SAMPLES_PER_WORD)
+
+static uint32_t logic_words[LOGIC_SIM_WORDS];
+static logic_rle_t logic_rle;
+
+// Tambahkan 'n' sampel status 'pins' mulai sampel 'at' (buffer nol)
+static uint32_t logic_put(uint32_t at, uint32_t pins, uint32_t n)
+{
+    for (uint32_t i = at; i < at + n && i < LOGIC_SIM_SAMPLES; i++)
+        logic_words[i / LOGIC_SAMPLES_PER_WORD] |= pins << ((i % LOGIC_SAMPLES_PER_WORD) * LOGIC_CHANNELS);
+    return at + n;
+}
+
+// Jejak sintetis clkdiv 1 di 125 MHz seperti tangkapan berpicu:
+// 'periods' periode A/0/C/0 dengan lebar dalam sampel, sampel 0
+// LOGIC_TRIGGER_LAG_SAMPLES sesudah tepi naik CH1 pertama. 'c_pins' dan
+// 'gap_pins' mengganti status C / jeda A->C untuk menyuntik kesalahan.
+static logic_capture_t logic_synth(uint32_t periods, const uint32_t cycles[4], uint32_t c_pins, uint32_t gap_pins)
+{
+    memset(logic_words, 0, sizeof(logic_words));
+    uint32_t at = 0;
+    for (uint32_t p = 0; p < periods; p++)
+    {
+        at = logic_put(at, LOGIC_STATE_A, cycles[0] - (p == 0 ? LOGIC_TRIGGER_LAG_SAMPLES : 0));
+        at = logic_put(at, gap_pins, cycles[1]);
+        at = logic_put(at, c_pins, cycles[2]);
+        at = logic_put(at, 0, cycles[3]);
+    }
+    at = logic_put(at, LOGIC_STATE_A, cycles[0] / 2); // Periode berikutnya terpotong
+    return (logic_capture_t){logic_words, at, 125000000u, true};
+}
+
+// Sampel -> RLE -> sampel harus identik (untuk sampel yang tercakup run)
+static bool logic_roundtrip(const logic_capture_t *cap)
+{
+    logic_rle_encode(cap, &logic_rle);
+    for (uint32_t k = 0; k < logic_rle.count; k++)
+    {
+        uint32_t end = k + 1 < logic_rle.count ? logic_rle.run[k + 1].start : logic_rle.samples;
+        for (uint32_t i = logic_rle.run[k].start; i < end; i++)
+        {
+            uint32_t p = (cap->words[i / LOGIC_SAMPLES_PER_WORD] >> ((i % LOGIC_SAMPLES_PER_WORD) * 4)) & 0xf;
+            if (p != logic_rle.run[k].pins || (i == logic_rle.run[k].start && k > 0 && p == logic_rle.run[k - 1].pins))
+                return false;
+        }
+    }
+    return logic_rle.count > 0 && logic_rle.run[0].start == 0;
+}
+
+// VCD dalam potongan 'chunk' byte; false bila potongan tidak maju
+static size_t logic_vcd_text(const logic_capture_t *cap, size_t chunk, char *out, size_t cap_bytes)
+{
+    logic_vcd_t v;
+    logic_vcd_init(&v, &logic_rle, cap);
+    size_t n = 0;
+    while (!logic_vcd_done(&v))
+    {
+        size_t want = chunk < cap_bytes - n ? chunk : cap_bytes - n;
+        size_t got = logic_vcd_next(&v, out + n, want);
+        if (got == 0)
+            return 0;
+        n += got;
+    }
+    return n;
+}
+
+// Baca ulang VCD: setiap "#t" setelah $dumpvars harus sama dengan awal run
+// berikutnya (waktu dan status keempat kanal), lalu "#t" akhir tangkapan
+static bool logic_vcd_matches(const logic_capture_t *cap, const char *text, size_t len)
+{
+    const char *p = strstr(text, "$enddefinitions $end\n");
+    if (!p)
+        return false;
+    p += strlen("$enddefinitions $end\n");
+    const char *end = text + len;
+    uint32_t k = 0, pins = 0;
+    unsigned long long t = 0;
+    bool have_t = false;
+    while (p < end)
+    {
+        const char *nl = memchr(p, '\n', (size_t)(end - p));
+        if (!nl)
+            return false;
+        if (*p == '#')
+        {
+            // Status run sebelumnya lengkap saat waktu berikutnya muncul
+            if (have_t && (k >= logic_rle.count || logic_rle.run[k].pins != pins ||
+                           t != timing_cycles_to_ns(logic_rle.run[k].start, cap->sys_clk_hz, TIMING_CLKDIV_ONE)))
+                return false;
+            k += have_t;
+            t = strtoull(p + 1, NULL, 10);
+            have_t = true;
+        }
+        else if ((*p == '0' || *p == '1') && p[1] >= '!' && p[1] <= '$')
+        {
+            uint32_t bit = 1u << (p[1] - '!');
+            pins = *p == '1' ? pins | bit : pins & ~bit;
+        }
+        p = nl + 1;
+    }
+    return k == logic_rle.count && t == timing_cycles_to_ns(logic_rle.samples, cap->sys_clk_hz, TIMING_CLKDIV_ONE);
+}
+
+// Satu proses seperti uji mandiri firmware: program terurai bila muat,
+// selain itu signal_generator_counted; penganalisis berpicu pada clkdiv 1,
+// periode dari tepi naik CH1 seperti penghitung pulsa firmware, dan hasilnya
+// dianalisis dengan toleransi finishSelfTest()
+static bool logic_pio_run(const timing_request_t *req, uint32_t periods, logic_capture_t *cap,
+                          pulse_report_t *counter, logic_result_t *r, bool *unrolled)
+{
+    static unroll_program_t u;
+    timing_plan_t plan;
+    uint32_t div = TIMING_CLKDIV_ONE;
+    *unrolled = unroll_compile(req, sg_sys_clk_hz, sg_unroll_budget(), &plan, &u) == TIMING_OK;
+    if (!*unrolled && (sg_counted_status(req, sg_sys_clk_hz) != TIMING_OK ||
+                       timing_compile_auto(req, sg_sys_clk_hz, signal_generator_counted_EVENT_OVERHEAD, &div,
+                                           &plan) != TIMING_OK))
+        return false;
+
+    uint64_t period_sys = (uint64_t)plan.period_cycles * div / TIMING_CLKDIV_ONE;
+    memset(logic_words, 0, sizeof(logic_words));
+    sg_logic_t logic = {logic_words, LOGIC_SIM_WORDS, true, 0};
+    sg_stop_t out;
+    uint64_t limit = ((uint64_t)periods + 2) * period_sys;
+    sg_attach_logic(&logic);
+    bool ok = *unrolled ? sg_simulate_unrolled(&u, periods, limit, &out, NULL)
+                        : sg_simulate_periods(SG_PROGRAM_STATIC, plan.delay, 4, div, periods, limit, &out);
+    sg_attach_logic(NULL);
+    if (!ok)
+        return false;
+
+    *cap = (logic_capture_t){logic_words, logic.filled * LOGIC_SAMPLES_PER_WORD, sg_sys_clk_hz, true};
+    *counter = (pulse_report_t){.pulses = out.ch1.pulses};
+    if (out.ch1.pulses >= 2)
+        counter->mean_period_ns = (uint32_t)(timing_cycles_to_ns(out.ch1.last_rise - out.ch1.first_rise,
+                                                                  sg_sys_clk_hz, TIMING_CLKDIV_ONE) /
+                                             (out.ch1.pulses - 1));
+    uint32_t sample_ps = timing_resolution_ps(sg_sys_clk_hz, TIMING_CLKDIV_ONE);
+    uint32_t engine_ns = (timing_resolution_ps(sg_sys_clk_hz, div) + 999) / 1000;
+    logic_expect_t e = {
+        .expect_ns = {req->pulse_width_ns, req->pulse_width_ns, req->phase_ns - req->pulse_width_ns,
+                      (1000000000u + req->freq_hz / 2) / req->freq_hz},
+        .tolerance_ns = engine_ns + (sample_ps + 999) / 1000,
+        .period_tolerance_ns = engine_ns + pulse_stats_period_error_ns(out.ch1.pulses, sg_sys_clk_hz, 1),
+    };
+    logic_rle_encode(cap, &logic_rle);
+    return logic_analyze(&logic_rle, cap, counter, &e, r);
+}
+
+int cmd_logic(int argc, char **argv)
+{
+    const char *vcd_path = NULL;
+    for (int i = 0; i < argc; i++)
+        if (strncmp(argv[i], "vcd=", 4) == 0)
+            vcd_path = argv[i] + 4;
+    static char vcd[256 * 1024], vcd_small[256 * 1024];
+    uint32_t failures = 0;
+    logic_result_t r;
+
+    // 50 kHz 3500/9200 ns di 125 MHz: 438/712/438/912 siklus; pulsa
+    // pertama (run 0, dari tepi picu) diukur, pulsa terpotong di akhir tidak.
+    // Periode dari penghitung: 4 tepi naik, rata-rata 2500 siklus.
+    static const uint32_t good[4] = {438, 712, 438, 912};
+    const pulse_report_t counter = {.pulses = 4, .expected = 4, .mean_period_ns = 20000};
+    logic_expect_t e = {{3500, 3500, 5700, 20000}, 16, 16};
+    logic_capture_t cap = logic_synth(3, good, LOGIC_STATE_C, 0);
+    bool base = logic_roundtrip(&cap) && logic_analyze(&logic_rle, &cap, &counter, &e, &r) &&
+                r.span[LOGIC_PULSE_A].count == 3 && r.span[LOGIC_PULSE_A].min_ns == 3504 &&
+                r.span[LOGIC_PULSE_A].max_ns == 3504 && r.span[LOGIC_PERIOD].count == 3 &&
+                r.span[LOGIC_DEAD_TIME].count == 3 &&
+                r.span[LOGIC_DEAD_TIME].min_ns == 5696 && r.sample_ps == 8000;
+    printf("Jejak sintetis 50 kHz: %u run, A %u..%u ns, dead %u ns, periode %u ns  %s\n", logic_rle.count,
+           r.span[LOGIC_PULSE_A].min_ns, r.span[LOGIC_PULSE_A].max_ns, r.span[LOGIC_DEAD_TIME].min_ns,
+           r.span[LOGIC_PERIOD].min_ns, base ? "OK" : "GAGAL");
+    failures += !base;
+
+    // Kesalahan yang disuntikkan harus gagal dengan alasan yang tepat
+    static const uint32_t wide[4] = {441, 709, 438, 912}; // A 24 ns lebih lebar
+    cap = logic_synth(3, wide, LOGIC_STATE_C, 0);
+    logic_rle_encode(&cap, &logic_rle);
+    bool width = !logic_analyze(&logic_rle, &cap, &counter, &e, &r) && !r.span[LOGIC_PULSE_A].ok &&
+                 r.span[LOGIC_PULSE_C].ok && r.span[LOGIC_PERIOD].ok && r.bad_states == 0;
+    cap = logic_synth(3, good, LOGIC_STATE_C, 0);
+    logic_rle_encode(&cap, &logic_rle);
+    const pulse_report_t slow = {.pulses = 4, .expected = 4, .mean_period_ns = 20040}; // Penghitung: periode salah
+    bool period = !logic_analyze(&logic_rle, &cap, &slow, &e, &r) && !r.span[LOGIC_PERIOD].ok &&
+                  r.span[LOGIC_PULSE_A].ok && r.span[LOGIC_DEAD_TIME].ok;
+    cap = logic_synth(3, good, LOGIC_STATE_C, 0x1); // CH1 tetap HIGH di jeda
+    logic_rle_encode(&cap, &logic_rle);
+    bool state = !logic_analyze(&logic_rle, &cap, &counter, &e, &r) && r.bad_states == 3 && r.first_bad == 437;
+    uint32_t bad_states = r.bad_states;
+    cap = logic_synth(3, good, 0, 0); // C hilang
+    logic_rle_encode(&cap, &logic_rle);
+    bool order = !logic_analyze(&logic_rle, &cap, &counter, &e, &r) && r.bad_order == 3 &&
+                 r.span[LOGIC_PULSE_C].count == 0;
+    printf("Kesalahan: A lebar -> %s, periode +40 ns -> %s, status 0001 -> %u status salah, C hilang -> %u urutan "
+           "salah  %s\n",
+           width ? "LEBAR A SALAH" : "?", period ? "PERIODE SALAH" : "?", bad_states, r.bad_order,
+           width && period && state && order ? "OK" : "GAGAL");
+    failures += !(width && period && state && order);
+
+    // RLE pulang-pergi pada jejak acak penuh, lalu ring run penuh
+    memset(logic_words, 0, sizeof(logic_words));
+    static const uint8_t states[3] = {0, LOGIC_STATE_A, LOGIC_STATE_C};
+    uint32_t seed = 12345, at = 0, p = 0;
+    while (at < LOGIC_SIM_SAMPLES)
+    {
+        seed = seed * 1103515245u + 12345u;
+        p = (p + 1 + (seed >> 30) % 2) % 3;
+        at = logic_put(at, states[p], 20 + (seed >> 16) % 300);
+    }
+    cap = (logic_capture_t){logic_words, LOGIC_SIM_SAMPLES, 125000000u, false};
+    bool rle = logic_roundtrip(&cap) && !logic_rle.truncated && logic_rle.samples == LOGIC_SIM_SAMPLES;
+    uint32_t runs = logic_rle.count;
+    memset(logic_words, 0, sizeof(logic_words));
+    for (at = 0; at < 3000;)
+        at = logic_put(at + 1, LOGIC_STATE_A, 1);
+    cap.samples = 3000;
+    bool full = logic_roundtrip(&cap) && logic_rle.truncated && logic_rle.count == LOGIC_RUNS_MAX &&
+                logic_rle.samples == LOGIC_RUNS_MAX;
+    printf("RLE: %u run dari %u sampel pulang-pergi, run penuh terpotong di sampel %u  %s\n", runs,
+           LOGIC_SIM_SAMPLES, logic_rle.samples, rle && full ? "OK" : "GAGAL");
+    failures += !(rle && full);
+
+    // VCD: potongan sekecil satu baris sama dengan satu potongan besar, dan
+    // dibaca ulang menjadi run yang sama
+    cap = logic_synth(3, good, LOGIC_STATE_C, 0);
+    logic_rle_encode(&cap, &logic_rle);
+    size_t n_big = logic_vcd_text(&cap, sizeof(vcd), vcd, sizeof(vcd));
+    size_t n_small = logic_vcd_text(&cap, LOGIC_VCD_LINE_MAX, vcd_small, sizeof(vcd_small));
+    bool vcd_ok = n_big > 0 && n_big == n_small && memcmp(vcd, vcd_small, n_big) == 0 &&
+                  logic_vcd_matches(&cap, vcd, n_big) && strncmp(vcd, "$comment 7718 sampel 8.000 ns $end\n", 35) == 0;
+    printf("VCD: %zu byte untuk %u run, potongan %u byte identik, dibaca ulang  %s\n", n_big, logic_rle.count,
+           LOGIC_VCD_LINE_MAX, vcd_ok ? "OK" : "GAGAL");
+    failures += !vcd_ok;
+
+    // Simulator PIO: generator + logic_analyzer.pio pada dua clk_sys; setiap
+    // proses harus lulus terhadap parameternya sendiri
+    static const uint32_t runs_req[][3] = {
+        {50, 50000, 60000}, {250, 3500, 9200}, {1000, 3500, 10000}, {20000, 3500, 9200}, {100000, 1000, 3000},
+        {500000, 500, 1000},
+    };
+    static const uint32_t clocks[] = {125000000u, 250000000u};
+    uint32_t pio_fail = 0;
+    double t_rle = 0, t_analyze = 0;
+    uint64_t bench_samples = 0;
+    for (int c = 0; c < 2; c++)
+    {
+        sg_sys_clk_hz = clocks[c];
+        for (uint32_t i = 0; i < sizeof(runs_req) / sizeof(runs_req[0]); i++)
+        {
+            timing_request_t req = {runs_req[i][0], runs_req[i][1], runs_req[i][2]};
+            bool unrolled;
+            pulse_report_t rep;
+            bool ok = logic_pio_run(&req, 3, &cap, &rep, &r, &unrolled);
+            size_t n = ok ? logic_vcd_text(&cap, LOGIC_VCD_LINE_MAX, vcd, sizeof(vcd)) : 0;
+            ok = ok && n > 0 && logic_vcd_matches(&cap, vcd, n);
+            printf("  %6u Hz %5u/%5u ns @ %u MHz %-8s %5u run: A %u..%u, dead %u..%u, periode %u ns  %s\n",
+                   req.freq_hz, req.pulse_width_ns, req.phase_ns, sg_sys_clk_hz / 1000000u,
+                   unrolled ? "terurai" : "loop", logic_rle.count, r.span[LOGIC_PULSE_A].min_ns,
+                   r.span[LOGIC_PULSE_A].max_ns, r.span[LOGIC_DEAD_TIME].min_ns, r.span[LOGIC_DEAD_TIME].max_ns,
+                   r.span[LOGIC_PERIOD].min_ns, ok ? "OK" : "GAGAL");
+            pio_fail += !ok;
+            if (vcd_path && ok && c == 0 && req.freq_hz == 20000)
+            {
+                FILE *f = fopen(vcd_path, "w");
+                if (f)
+                {
+                    fwrite(vcd, 1, n, f);
+                    fclose(f);
+                    printf("  VCD ditulis ke %s\n", vcd_path);
+                }
+            }
+
+            // Biaya pasca-proses core 0 per sampel (host)
+            const int rounds = 20;
+            double t0 = now_ns();
+            for (int k = 0; k < rounds; k++)
+                logic_rle_encode(&cap, &logic_rle);
+            double t1 = now_ns();
+            for (int k = 0; k < rounds; k++)
+                logic_analyze(&logic_rle, &cap, &rep, &(logic_expect_t){{0}, 0, 0}, &r);
+            double t2 = now_ns();
+            t_rle += t1 - t0;
+            t_analyze += t2 - t1;
+            bench_samples += (uint64_t)cap.samples * rounds;
+        }
+    }
+    sg_sys_clk_hz = SG_SYS_CLK_HZ;
+    printf("Simulator PIO: %u proses gagal  %s\n", pio_fail, pio_fail == 0 ? "OK" : "GAGAL");
+    failures += pio_fail;
+    printf("RLE %.2f ns/sampel, analisis %.2f ns/sampel di host\n", t_rle / bench_samples,
+           t_analyze / bench_samples);
+
+    printf("Hasil: %s\n", failures == 0 ? "OK" : "GAGAL");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,173 @@
+/**
+ * lib/pattern.c: tabel pola dialirkan ke pattern_engine (mgc_sim pattern)
+ */
+
+#include <stdio.h>
+#include "mgc_checks.h"
+#include "pattern.h"
+#include "sg_run.h"
+#include "signal_timing.h"
+
+static bool check_pattern_edges(const pattern_table_t *t, uint32_t clkdiv_fixed, uint32_t periods)
+{
+    static sg_pin_log_t log;
+    static uint64_t cycle[SG_MAX_LOG];
+    static uint8_t pins[SG_MAX_LOG];
+    uint64_t period = (uint64_t)t->period_cycles * (clkdiv_fixed >> 8);
+    uint32_t n = sg_expected_edges(t, clkdiv_fixed, periods, cycle, pins);
+
+    // Jalankan sedikit lebih lama dari 'periods' agar tepi terakhir tercatat
+    uint64_t t0;
+    return sg_simulate_table(t->words, t->length, clkdiv_fixed, period * periods + period / 2 + 1000, &log) &&
+           sg_compare_edges(&log, cycle, pins, n, &t0);
+}
+
+int cmd_pattern(void)
+{
+    static pattern_t p;
+    static pattern_table_t t;
+    uint32_t overhead = sg_event_overhead(SG_PROGRAM_PATTERN);
+    uint32_t failures = 0;
+
+    // Topologi yang tidak dapat dibentuk signal_generator tanpa program baru
+    printf("%-28s %6s %6s %8s %12s %s\n", "pola", "langkah", "event", "tabel", "periode ns", "hasil");
+    for (int c = 0; c < 6; c++)
+    {
+        const char *name = "";
+        switch (c)
+        {
+        case 0:
+            name = "unipolar CH1 100 Hz";
+            pattern_init(&p, 100);
+            pattern_add(&p, 0x1, 2000);
+            pattern_add(&p, 0x0, 0);
+            break;
+        case 1:
+            name = "bergiliran CH1..CH4 1 kHz";
+            pattern_init(&p, 1000);
+            for (uint8_t ch = 0; ch < 4; ch++)
+            {
+                pattern_add(&p, (uint8_t)(1u << ch), 500);
+                pattern_add(&p, 0x0, 200);
+            }
+            break;
+        case 2:
+            name = "bipolar asimetris 250 Hz";
+            pattern_init(&p, 250);
+            pattern_add(&p, 0x9, 1000);
+            pattern_add(&p, 0x0, 500);
+            pattern_add(&p, 0x6, 4000);
+            pattern_add(&p, 0x0, 0);
+            break;
+        case 3:
+            name = "burst 5x bipolar 10 Hz";
+            pattern_init(&p, 10);
+            for (int i = 0; i < 5; i++)
+            {
+                pattern_add(&p, 0x9, 300);
+                pattern_add(&p, 0x0, 100);
+                pattern_add(&p, 0x6, 300);
+                pattern_add(&p, 0x0, 10000);
+            }
+            pattern_add(&p, 0x0, 0);
+            break;
+        case 4:
+            name = "tanpa periode, mask berulang";
+            pattern_init(&p, 0);
+            pattern_add(&p, 0x3, 800);
+            pattern_add(&p, 0x3, 800); // Digabung dengan langkah sebelumnya
+            pattern_add(&p, 0xc, 1200);
+            pattern_add(&p, 0x0, 1600);
+            break;
+        default:
+            name = "tangga 200 langkah 2 Hz";
+            pattern_init(&p, 2);
+            for (uint32_t i = 0; i < 199; i++)
+                pattern_add(&p, (uint8_t)(i % 16), 1000 + 40 * i);
+            pattern_add(&p, 0x0, 0);
+            break;
+        }
+
+        uint32_t div;
+        timing_status_t st = pattern_compile_auto(&p, sg_sys_clk_hz, overhead, &div, &t);
+        bool ok = st == TIMING_OK && check_pattern_edges(&t, div, 3);
+        printf("%-28s %6u %6u %6u B %12llu %s (clkdiv %u)\n", name, p.count, t.length,
+               t.length * 4u, (unsigned long long)timing_cycles_to_ns(t.period_cycles, sg_sys_clk_hz, div),
+               ok ? "OK" : timing_status_str(st), div >> 8);
+        failures += !ok;
+    }
+
+    // Preset bipolar dari pembangun = gelombang program statis, untuk
+    // sebagian ruang UI (sapu penuh: mgc_sim sweep pattern)
+    uint32_t preset_checked = 0, preset_failed = 0;
+    for (uint32_t f = 10; f <= 1000; f += 90)
+        for (uint32_t pw = 100; pw <= 50000; pw += 4900)
+            for (uint32_t ph = pw + 100; ph <= 10000; ph += 1300)
+            {
+                timing_request_t req = {f, pw, ph};
+                timing_plan_t plan;
+                uint32_t div;
+                if (timing_compile_auto(&req, sg_sys_clk_hz, overhead, &div, &plan) != TIMING_OK)
+                    continue;
+                bool ok = pattern_bipolar(&p, &req) == TIMING_OK &&
+                          pattern_compile(&p, sg_sys_clk_hz, div, overhead, &t) == TIMING_OK &&
+                          t.length == 4 && t.period_cycles == plan.period_cycles &&
+                          pattern_word_count(t.words[0]) == plan.delay[0] &&
+                          pattern_word_count(t.words[2]) == plan.delay[2] &&
+                          check_pattern_edges(&t, div, 2);
+                // Varian pasangan dua pin: waktu sama, mask 1 lalu 2
+                ok = ok && pattern_bipolar_pair(&p, &req) == TIMING_OK &&
+                     pattern_compile(&p, sg_sys_clk_hz, div, overhead, &t) == TIMING_OK && t.length == 4 &&
+                     t.period_cycles == plan.period_cycles && pattern_word_mask(t.words[0]) == 0x1 &&
+                     pattern_word_mask(t.words[2]) == 0x2 && pattern_word_count(t.words[2]) == plan.delay[2];
+                preset_checked++;
+                preset_failed += !ok;
+            }
+    printf("Preset bipolar: %u titik UI, %u gagal (periode dan lebar pulsa = program statis)\n",
+           preset_checked, preset_failed);
+    failures += preset_failed;
+
+    // Validasi pembangun
+    typedef struct
+    {
+        const char *what;
+        timing_status_t got, want;
+    } pattern_case_t;
+    pattern_case_t cases[6];
+    pattern_init(&p, 0);
+    cases[0] = (pattern_case_t){"pola kosong", pattern_compile(&p, sg_sys_clk_hz, 256, overhead, &t),
+                                  TIMING_ERR_PATTERN};
+    pattern_add(&p, 0x1, 10);
+    pattern_add(&p, 0x0, 1000);
+    cases[1] = (pattern_case_t){"event < overhead", pattern_compile(&p, sg_sys_clk_hz, 256, overhead, &t),
+                                  TIMING_ERR_EVENT_TOO_SHORT};
+    pattern_init(&p, 1000000);
+    pattern_add(&p, 0x1, 990);
+    pattern_add(&p, 0x0, 0);
+    cases[2] = (pattern_case_t){"periode pendek", pattern_compile(&p, sg_sys_clk_hz, 256, overhead, &t),
+                                  TIMING_ERR_PERIOD_TOO_SHORT};
+    pattern_init(&p, 0);
+    pattern_add(&p, 0x1, 3000000000u); // 375 juta siklus pada 125 MHz
+    pattern_add(&p, 0x0, 100);
+    cases[3] = (pattern_case_t){"N > 28 bit", pattern_compile(&p, sg_sys_clk_hz, 256, overhead, &t),
+                                  TIMING_ERR_RANGE};
+    uint32_t div;
+    cases[4] = (pattern_case_t){"N > 28 bit (auto)", pattern_compile_auto(&p, sg_sys_clk_hz, overhead, &div, &t),
+                                  TIMING_OK};
+    bool rejected = !pattern_add(&p, 0x10, 1000);
+    cases[5] = (pattern_case_t){"mask di luar GP6-9", rejected ? TIMING_ERR_PATTERN : TIMING_OK,
+                                  TIMING_ERR_PATTERN};
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        bool ok = cases[i].got == cases[i].want;
+        printf("%-20s : %-16s %s\n", cases[i].what, timing_status_str(cases[i].got), ok ? "OK" : "GAGAL");
+        failures += !ok;
+    }
+    if (div != 2 * TIMING_CLKDIV_ONE)
+    {
+        printf("GAGAL clkdiv auto %u, diharapkan 512\n", div);
+        failures++;
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,222 @@
+/**
+ * lib/remote_proto.c terhadap perangkat tiruan (mgc_sim remote)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mgc_checks.h"
+#include "remote_dev.h"
+#include "remote_proto.h"
+#include "sg_run.h"
+#include "signal_timing.h"
+
+typedef struct
+{
+    remote_dev_t dev;
+    remote_t remote;
+    uint8_t reply[REMOTE_MSG_MAX]; // Pesan balasan terakhir (tanpa CRC)
+    size_t reply_len;
+    uint32_t replies;
+    uint32_t bad_replies;
+} remote_bench_t;
+
+static void remote_bench_init(remote_bench_t *rb)
+{
+    memset(rb, 0, sizeof(*rb));
+    remote_dev_init(&rb->dev);
+    remote_init(&rb->remote, &rb->dev.ops);
+}
+
+// Umpankan byte ke perangkat; balasan terakhir didekode ke rb->reply
+static void remote_bench_bytes(remote_bench_t *rb, const uint8_t *buf, size_t len)
+{
+    uint8_t out[REMOTE_FRAME_MAX];
+    for (size_t i = 0; i < len; i++)
+    {
+        size_t n = remote_feed(&rb->remote, buf[i], out);
+        if (n == 0)
+            continue;
+        rb->replies++;
+        if (n < 2 || out[0] != 0 || out[n - 1] != 0 ||
+            !remote_decode(out + 1, n - 2, rb->reply, &rb->reply_len))
+            rb->bad_replies++;
+    }
+}
+
+// Kirim satu perintah dan periksa hasil balasan; data balasan di rb->reply + 3
+static bool remote_call(remote_bench_t *rb, uint8_t cmd, uint8_t seq, const uint8_t *payload, size_t len,
+                        remote_result_t want)
+{
+    uint8_t frame[REMOTE_FRAME_MAX];
+    size_t n = remote_encode(cmd, seq, payload, len, frame);
+    uint32_t before = rb->replies;
+    remote_bench_bytes(rb, frame, n);
+    return rb->replies == before + 1 && rb->bad_replies == 0 && rb->reply_len >= 3 &&
+           rb->reply[0] == (cmd | REMOTE_REPLY) && rb->reply[1] == seq && rb->reply[2] == want;
+}
+
+static bool remote_set(remote_bench_t *rb, remote_param_t id, int32_t value, remote_result_t want)
+{
+    uint8_t p[5] = {(uint8_t)id, (uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16),
+                    (uint8_t)(value >> 24)};
+    return remote_call(rb, REMOTE_CMD_SET, (uint8_t)(id + 10), p, sizeof(p), want);
+}
+
+static int32_t remote_reply_i32(const remote_bench_t *rb)
+{
+    const uint8_t *p = rb->reply + 4;
+    return (int32_t)(p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24));
+}
+
+int cmd_remote(void)
+{
+    uint32_t failures = 0;
+
+    // COBS: panjang 0..600 dengan kepadatan nol berbeda, termasuk blok 254
+    srand(1);
+    uint32_t cobs_cases = 0, cobs_bad = 0;
+    for (size_t len = 0; len <= 600; len++)
+    {
+        for (int density = 0; density < 3; density++)
+        {
+            uint8_t src[600], enc[610], dec[610];
+            for (size_t i = 0; i < len; i++)
+                src[i] = density == 0 ? (uint8_t)(1 + rand() % 255) : density == 1 ? (uint8_t)rand() : 0;
+            size_t n = cobs_encode(src, len, enc);
+            bool ok = n <= len + len / 254 + 1 && memchr(enc, 0, n) == NULL &&
+                      cobs_decode(enc, n, dec) == len && memcmp(src, dec, len) == 0;
+            cobs_bad += !ok;
+            cobs_cases++;
+        }
+    }
+    printf("COBS                  : %u kasus, %u gagal\n", cobs_cases, cobs_bad);
+    failures += cobs_bad != 0;
+
+    // Setiap perintah terhadap perangkat tiruan
+    remote_bench_t rb;
+    remote_bench_init(&rb);
+    typedef struct
+    {
+        const char *what;
+        bool ok;
+    } remote_case_t;
+    remote_case_t cases[16];
+    int nc = 0;
+    uint8_t ping[REMOTE_PAYLOAD_MAX - 1];
+    for (size_t i = 0; i < sizeof(ping); i++)
+        ping[i] = (uint8_t)(i * 37); // Termasuk 0x00, 0x0a dan 0x0d
+    cases[nc++] = (remote_case_t){"ping 39 byte", remote_call(&rb, REMOTE_CMD_PING, 1, ping, sizeof(ping), REMOTE_OK) &&
+                                                      rb.reply_len == 3 + sizeof(ping) &&
+                                                      memcmp(rb.reply + 3, ping, sizeof(ping)) == 0};
+    int32_t values[REMOTE_PARAM_COUNT] = {250, 12000, 2, 10000, 1};
+    bool set_ok = true;
+    for (int id = 0; id < REMOTE_PARAM_COUNT; id++)
+    {
+        set_ok = set_ok && remote_set(&rb, (remote_param_t)id, values[id], REMOTE_OK) &&
+                 remote_reply_i32(&rb) == values[id];
+        uint8_t p = (uint8_t)id;
+        set_ok = set_ok && remote_call(&rb, REMOTE_CMD_GET, 2, &p, 1, REMOTE_OK) && rb.reply[3] == id &&
+                 remote_reply_i32(&rb) == values[id];
+    }
+    cases[nc++] = (remote_case_t){"set/get 5 field", set_ok};
+    cases[nc++] = (remote_case_t){"set di luar rentang", remote_set(&rb, REMOTE_PARAM_FREQ_HZ, 600000, REMOTE_ERR_RANGE) &&
+                                                             rb.dev.param[REMOTE_PARAM_FREQ_HZ] == 250};
+    uint8_t bad_id = REMOTE_PARAM_COUNT;
+    cases[nc++] = (remote_case_t){"id tidak dikenal", remote_call(&rb, REMOTE_CMD_GET, 3, &bad_id, 1, REMOTE_ERR_PARAM)};
+    cases[nc++] = (remote_case_t){"panjang salah", remote_call(&rb, REMOTE_CMD_GET, 4, NULL, 0, REMOTE_ERR_LEN)};
+    cases[nc++] = (remote_case_t){"perintah tidak dikenal", remote_call(&rb, 0x3f, 5, NULL, 0, REMOTE_ERR_CMD)};
+
+    // Fasa < pulsa ditolak perencana seperti di menu
+    remote_set(&rb, REMOTE_PARAM_PULSE_NS, 12000, REMOTE_OK);
+    remote_set(&rb, REMOTE_PARAM_PHASE_NS, 5000, REMOTE_OK);
+    cases[nc++] = (remote_case_t){"start ditolak", remote_call(&rb, REMOTE_CMD_START, 6, NULL, 0, REMOTE_ERR_TIMING) &&
+                                                      rb.reply_len == 4 && rb.reply[3] == TIMING_ERR_PHASE_LT_PULSE};
+    remote_set(&rb, REMOTE_PARAM_PHASE_NS, 10000, REMOTE_OK);
+    remote_set(&rb, REMOTE_PARAM_PULSE_NS, 1000, REMOTE_OK);
+
+    // Jalan 2 detik pada 250 Hz: telemetri akhir 500 pulsa
+    uint8_t interval[2] = {100, 0};
+    cases[nc++] = (remote_case_t){"stream 100 ms", remote_call(&rb, REMOTE_CMD_STREAM, 7, interval, 2, REMOTE_OK) &&
+                                                       rb.remote.stream_ms == 100};
+    cases[nc++] = (remote_case_t){"start", remote_call(&rb, REMOTE_CMD_START, 8, NULL, 0, REMOTE_OK) && rb.dev.running};
+    cases[nc++] = (remote_case_t){"set saat berjalan", remote_set(&rb, REMOTE_PARAM_FREQ_HZ, 100, REMOTE_ERR_BUSY)};
+    remote_dev_advance(&rb.dev, 750);
+    remote_status_t st;
+    bool status_ok = remote_call(&rb, REMOTE_CMD_STATUS, 9, NULL, 0, REMOTE_OK) &&
+                     remote_get_status(rb.reply + 3, rb.reply_len - 3, &st) && st.state == 2 &&
+                     st.elapsed_ms == 750 && st.duration_ms == 2000;
+    cases[nc++] = (remote_case_t){"status berjalan", status_ok};
+    bool ended = remote_dev_advance(&rb.dev, 2500);
+    uint8_t tele[REMOTE_FRAME_MAX], msg[REMOTE_MSG_MAX];
+    rb.dev.ops.status(rb.dev.ops.ctx, &st);
+    size_t tn = remote_telemetry(&rb.remote, &st, tele);
+    size_t msg_len;
+    remote_status_t got;
+    bool tele_ok = ended && remote_decode(tele + 1, tn - 2, msg, &msg_len) && msg[0] == REMOTE_EV_TELEMETRY &&
+                   remote_get_status(msg + 2, msg_len - 2, &got) && got.state == 3 && got.pulses == 500 &&
+                   got.expected == 500 && got.elapsed_ms == 2000 && got.on_time_ns == 500000u;
+    cases[nc++] = (remote_case_t){"telemetri akhir", tele_ok};
+    cases[nc++] = (remote_case_t){"abort saat diam", remote_call(&rb, REMOTE_CMD_ABORT, 10, NULL, 0, REMOTE_ERR_BUSY)};
+    remote_call(&rb, REMOTE_CMD_START, 11, NULL, 0, REMOTE_OK);
+    remote_dev_advance(&rb.dev, 2600);
+    cases[nc++] = (remote_case_t){"abort", remote_call(&rb, REMOTE_CMD_ABORT, 12, NULL, 0, REMOTE_OK) &&
+                                               rb.dev.state == 4 && rb.dev.last.pulses == 25};
+    for (int i = 0; i < nc; i++)
+    {
+        printf("%-22s: %s\n", cases[i].what, cases[i].ok ? "OK" : "GAGAL");
+        failures += !cases[i].ok;
+    }
+
+    // Setiap bit bingkai SET dibalik: tidak boleh ada balasan maupun perubahan
+    uint8_t set_msg[5] = {REMOTE_PARAM_FREQ_HZ, 0xe8, 0x03, 0, 0}; // 1000 Hz
+    uint8_t frame[REMOTE_FRAME_MAX];
+    size_t fn = remote_encode(REMOTE_CMD_SET, 20, set_msg, sizeof(set_msg), frame);
+    uint32_t flips = 0, accepted = 0;
+    for (size_t i = 1; i + 1 < fn; i++)
+    {
+        for (int b = 0; b < 8; b++)
+        {
+            uint8_t bad[REMOTE_FRAME_MAX];
+            memcpy(bad, frame, fn);
+            bad[i] ^= (uint8_t)(1u << b);
+            uint32_t before = rb.replies;
+            remote_bench_bytes(&rb, bad, fn);
+            accepted += rb.replies != before;
+            flips++;
+        }
+    }
+    bool corrupt_ok = accepted == 0 && rb.dev.param[REMOTE_PARAM_FREQ_HZ] == 250;
+    printf("Bit rusak             : %u bingkai, %u diterima %s\n", flips, accepted, corrupt_ok ? "OK" : "GAGAL");
+    failures += !corrupt_ok;
+
+    // Teks printf, sampah panjang dan bingkai rapat dalam satu aliran yang
+    // dipotong per 1..7 byte seperti paket USB
+    uint8_t stream[1024];
+    size_t sn = 0;
+    const char *text = "Konfigurasi PIO: Freq=250 Hz\r\n";
+    memcpy(stream + sn, text, strlen(text));
+    sn += strlen(text);
+    for (int i = 0; i < 200; i++)
+        stream[sn++] = (uint8_t)(1 + i % 250);
+    for (uint8_t seq = 30; seq < 36; seq++)
+    {
+        // Bingkai klien tanpa pembatas depan: pembatas belakang bingkai
+        // sebelumnya sudah menutup
+        size_t n = remote_encode(REMOTE_CMD_PING, seq, &seq, 1, stream + sn);
+        memmove(stream + sn, stream + sn + (seq > 30), n - (seq > 30));
+        sn += n - (seq > 30);
+    }
+    uint32_t before = rb.replies, dropped = rb.remote.dropped;
+    for (size_t off = 0, step = 1; off < sn; off += step, step = step % 7 + 1)
+        remote_bench_bytes(&rb, stream + off, off + step <= sn ? step : sn - off);
+    bool mixed_ok = rb.replies - before == 6 && rb.bad_replies == 0 && rb.remote.dropped - dropped == 1 &&
+                    rb.reply[1] == 35;
+    printf("Aliran campuran       : %u balasan, %u potongan dibuang %s\n", rb.replies - before,
+           rb.remote.dropped - dropped, mixed_ok ? "OK" : "GAGAL");
+    failures += !mixed_ok;
+
+    printf("Bingkai maks. %u byte, %u pesan valid, %u potongan dibuang\n", REMOTE_FRAME_MAX, rb.remote.frames,
+           rb.remote.dropped);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,176 @@
+/**
+ * lib/scheduler.c dengan jam virtual (mgc_sim sched)
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "mgc_checks.h"
+#include "remote_proto.h"
+#include "scheduler.h"
+
+// Jam virtual: tugas "berjalan" dengan memajukan jam sebesar biayanya
+static sched_t sim_sched;
+static uint64_t sim_now;
+static char sim_order[64];
+static size_t sim_order_len;
+static uint32_t sim_cost[8];
+static uint64_t sim_period[8];
+
+static uint64_t sim_clock(void)
+{
+    return sim_now;
+}
+
+// Tugas generik: catat urutan, makan biaya, jadwal ulang bila periodik
+#define SIM_TASK(i)                                                         \
+    static void sim_task##i(uint64_t now)                                   \
+    {                                                                       \
+        if (sim_order_len < sizeof(sim_order) - 1)                          \
+            sim_order[sim_order_len++] = (char)('A' + i);                   \
+        sim_now += sim_cost[i];                                             \
+        if (sim_period[i])                                                  \
+            sched_at(&sim_sched, i, now + sim_period[i]);                   \
+    }
+SIM_TASK(0)
+SIM_TASK(1)
+SIM_TASK(2)
+SIM_TASK(3)
+
+static void sim_setup(sched_task_t *tasks)
+{
+    static const sched_fn_t fns[4] = {sim_task0, sim_task1, sim_task2, sim_task3};
+    static const char *const names[4] = {"tombol", "proses", "usb", "layar"};
+    for (int i = 0; i < 4; i++)
+    {
+        tasks[i] = (sched_task_t){.name = names[i], .run = fns[i]};
+        sim_cost[i] = 0;
+        sim_period[i] = 0;
+    }
+    sim_now = 0;
+    sim_order_len = 0;
+    sim_order[0] = 0;
+    sched_init(&sim_sched, tasks, 4, sim_clock);
+}
+
+// Loop seperti app_loop(): dispatch yang jatuh tempo, lalu "tidur" ke
+// tenggat berikutnya (tidak melewati 'until')
+static void sim_run_until(uint64_t until)
+{
+    while (sim_now < until)
+    {
+        for (int i = 0; i < 4 && sched_dispatch(&sim_sched); i++)
+            ;
+        uint64_t next = sched_next(&sim_sched);
+        if (next > sim_now && sim_now < until)
+            sim_now = next < until ? next : until;
+    }
+    sim_order[sim_order_len] = 0;
+}
+
+static uint32_t sim_lcg(uint32_t *state)
+{
+    *state = *state * 1664525u + 1013904223u;
+    return *state >> 8;
+}
+
+int cmd_sched(void)
+{
+    sched_task_t tasks[4];
+    uint32_t failures = 0;
+
+    // Tenggat paling awal lebih dulu; tenggat sama: indeks kecil dulu
+    sim_setup(tasks);
+    sched_at(&sim_sched, 2, 30);
+    sched_at(&sim_sched, 1, 10);
+    sched_at(&sim_sched, 0, 10);
+    sched_at(&sim_sched, 3, 20);
+    sim_run_until(100);
+    bool order = strcmp(sim_order, "ABDC") == 0 && sched_next(&sim_sched) == SCHED_NEVER;
+    printf("Urutan tenggat 10/10/20/30 -> %s  %s\n", sim_order, order ? "OK" : "GAGAL");
+    failures += !order;
+
+    // Periodik 1 ms di-blok tugas 5 ms: latensi = sisa tugas panjang,
+    // irama kembali relatif terhadap saat tugas berjalan
+    sim_setup(tasks);
+    sim_period[1] = 1000;
+    sim_cost[3] = 5000;
+    sched_at(&sim_sched, 1, 0);
+    sched_at(&sim_sched, 3, 2500);
+    sim_run_until(10000);
+    const sched_task_t *p = &tasks[1], *l = &tasks[3];
+    bool periodic = p->latency_max_us == 4500 && l->run_max_us == 5000 && l->runs == 1 && p->runs == 6 &&
+                    sim_sched.latency_max_us == 4500 && sim_sched.latency_max_task == 1;
+    printf("Periodik 1 ms + tugas 5 ms: %u jalan, latensi maks %u us (tugas %s)  %s\n", p->runs,
+           p->latency_max_us, tasks[sim_sched.latency_max_task].name, periodic ? "OK" : "GAGAL");
+    failures += !periodic;
+
+    // Post interupsi saat tugas panjang berjalan: digabung, latensi dari
+    // post pertama, dan tidur berhenti di post
+    sim_setup(tasks);
+    sim_cost[3] = 2000;
+    sched_at(&sim_sched, 3, 0);
+    sched_dispatch(&sim_sched); // t = 0 .. 2000
+    sched_post(&sim_sched, 0, 300);
+    sched_post(&sim_sched, 0, 1700);
+    bool next_now = sched_next(&sim_sched) == 300;
+    sim_run_until(5000);
+    sched_post(&sim_sched, 0, 6000);
+    sim_now = 6000;
+    uint64_t wake = sched_next(&sim_sched);
+    sim_run_until(7000);
+    const sched_task_t *b = &tasks[0];
+    bool post = next_now && wake == 6000 && b->runs == 2 && b->latency_max_us == 1700 &&
+                strcmp(sim_order, "DAA") == 0;
+    printf("Post saat tugas 2 ms: %u jalan, latensi maks %u us  %s\n", b->runs, b->latency_max_us,
+           post ? "OK" : "GAGAL");
+    failures += !post;
+
+    // Halaman REMOTE_CMD_TASKS: nama dipotong 8 byte, u64 total
+    tasks[3].name = "layar-berkala";
+    tasks[3].run_total_us = 0x123456789ull;
+    tasks[3].runs = 7;
+    uint8_t page[SCHED_PAGE_BYTES];
+    size_t n = sched_page(&sim_sched, 3, page);
+    bool enc = n == SCHED_PAGE_BYTES && memcmp(page, "layar-be", 8) == 0 && page[8] == 7 && page[16] == 0x89 &&
+               page[20] == 0x01 && sched_page(&sim_sched, 4, page) == 0;
+    printf("Halaman statistik %zu byte  %s\n", n, enc ? "OK" : "GAGAL");
+    failures += !enc;
+
+    // Beban menyerupai main.c: status proses tiap 1 ms (5 us), layar tiap
+    // 200 ms (95 us), USB tiap 100 ms (400 us); tombol acak (30 us)
+    sim_setup(tasks);
+    sim_period[1] = 1000;
+    sim_period[2] = 100000;
+    sim_period[3] = 200000;
+    sim_cost[0] = 30;
+    sim_cost[1] = 5;
+    sim_cost[2] = 400;
+    sim_cost[3] = 95;
+    for (int i = 1; i < 4; i++)
+        sched_at(&sim_sched, i, 0);
+    uint32_t seed = 1, presses = 0, old_worst = 0;
+    uint64_t t = 0, end = 10000000;
+    while ((t += 200 + sim_lcg(&seed) % 3000) < end)
+    {
+        sim_run_until(t);
+        sched_post(&sim_sched, 0, t);
+        presses++;
+        // Super-loop lama: tombol dibaca di awal putaran, putaran = kerja +
+        // sleep_ms(50), jadi event menunggu sampai putaran berikutnya
+        uint32_t loop_us = 50000 + 5 + 95 + 400 + 30;
+        uint32_t wait = loop_us - (uint32_t)(t % loop_us);
+        if (wait > old_worst)
+            old_worst = wait;
+    }
+    sim_run_until(end);
+    // Terburuk: satu jalan setiap tugas lain yang tenggatnya lebih awal
+    bool load = tasks[0].runs == presses && tasks[0].latency_max_us <= 5 + 400 + 95;
+    printf("Tombol %u kali dalam 10 s: latensi maks %u us (super-loop 50 ms: %u us)  %s\n", presses,
+           tasks[0].latency_max_us, old_worst, load ? "OK" : "GAGAL");
+    failures += !load;
+    for (int i = 0; i < 4; i++)
+        printf("  %-7s %6u jalan  rata-rata %3llu us  maks %3u us  latensi maks %3u us\n", tasks[i].name,
+               tasks[i].runs, tasks[i].runs ? (unsigned long long)(tasks[i].run_total_us / tasks[i].runs) : 0,
+               tasks[i].run_max_us, tasks[i].latency_max_us);
+    return failures == 0 ? 0 : 1;
+}
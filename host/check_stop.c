@@ -0,0 +1,190 @@
+/**
+ * Proses terhitung yang berhenti sendiri (mgc_sim stop)
+ */
+
+#include <stdio.h>
+#include "mgc_checks.h"
+#include "pattern.h"
+#include "sg_run.h"
+#include "signal_timing.h"
+
+typedef struct
+{
+    uint32_t runs, failures;
+    int64_t latency_min, latency_max; // Titik henti - batas periode, siklus PIO
+} stop_stats_t;
+
+// Satu proses terhitung: tepat 'periods' pulsa CH1 dengan lebar penuh, pin
+// LOW sejak batas periode (atau akhir event D), titik henti pada jarak tetap
+// dari batas periode. event_d: siklus PIO event terakhir yang LOW sebelum
+// batas (0 bila event terakhir tidak LOW dan kata henti yang memadamkannya).
+static void stop_check(stop_stats_t *ss, const char *name, sg_program_t program, const uint32_t *words,
+                       uint32_t length, uint32_t div, uint32_t period_cycles, uint32_t pulse_cycles,
+                       uint32_t event_d, uint32_t periods)
+{
+    sg_stop_t r;
+    uint32_t d = div >> 8;
+    uint64_t limit = ((uint64_t)periods + 2) * period_cycles * d + 1000;
+    bool ok = sg_simulate_periods(program, words, length, div, periods, limit, &r);
+
+    uint64_t boundary = r.ch1.first_rise + (uint64_t)periods * period_cycles * d;
+    int64_t latency = ((int64_t)r.stop - (int64_t)boundary) / (int64_t)d;
+    ok = ok && r.ch1.pulses == periods && r.final_pins == 0 &&
+         r.ch1.high_cycles == (uint64_t)periods * pulse_cycles * d &&
+         r.last_edge == boundary - (uint64_t)event_d * d && (program != SG_PROGRAM_STATIC || r.irq);
+    if (!ok)
+        printf("GAGAL %s x%u: pulsa %u, pin akhir %x, ON %llu/%llu, tepi akhir %lld siklus dari batas, "
+               "irq %d\n",
+               name, periods, r.ch1.pulses, r.final_pins, (unsigned long long)r.ch1.high_cycles,
+               (unsigned long long)periods * pulse_cycles * d, (long long)r.last_edge - (long long)boundary,
+               r.irq);
+    if (ss->runs == 0 || latency < ss->latency_min)
+        ss->latency_min = latency;
+    if (ss->runs == 0 || latency > ss->latency_max)
+        ss->latency_max = latency;
+    ss->runs++;
+    ss->failures += !ok;
+}
+
+// Siklus PIO per periode tabel: CH1 HIGH, dan event LOW di ujung tabel
+static void stop_table_cycles(const pattern_table_t *t, uint32_t *pulse, uint32_t *event_d)
+{
+    uint32_t overhead = sg_event_overhead(SG_PROGRAM_PATTERN);
+    bool tail = true;
+    *pulse = *event_d = 0;
+    for (uint32_t i = t->length; i-- > 0;)
+    {
+        uint32_t cycles = pattern_word_count(t->words[i]) + overhead;
+        if (pattern_word_mask(t->words[i]) & 1u)
+            *pulse += cycles;
+        tail = tail && pattern_word_mask(t->words[i]) == 0;
+        if (tail)
+            *event_d += cycles;
+    }
+}
+
+int cmd_stop(void)
+{
+    static const uint32_t counts[] = {1, 2, 7, 250};
+    static const uint32_t freqs[] = {1000, 700, 37};
+    static const uint32_t params[][2] = {{100, 200}, {3500, 10000}, {50000, 60000}};
+    static pattern_t p;
+    static pattern_table_t t;
+    uint32_t clocks[2] = {125000000u, 250000000u};
+    stop_stats_t counted = {0}, ring = {0}, custom = {0};
+    uint32_t failures = 0;
+
+    for (int c = 0; c < 2; c++)
+    {
+        sg_sys_clk_hz = clocks[c];
+        for (uint32_t fi = 0; fi < sizeof(freqs) / sizeof(freqs[0]); fi++)
+            for (uint32_t pi = 0; pi < sizeof(params) / sizeof(params[0]); pi++)
+            {
+                timing_request_t req = {freqs[fi], params[pi][0], params[pi][1]};
+                uint32_t div;
+                timing_plan_t plan;
+                if (timing_compile_auto(&req, sg_sys_clk_hz, sg_event_overhead(SG_PROGRAM_STATIC), &div,
+                                        &plan) != TIMING_OK ||
+                    (div & 0xff) != 0)
+                    continue;
+
+                // Preset bipolar pada divider yang sama, dipadatkan 2^n seperti
+                // engine_configure()
+                if (pattern_bipolar(&p, &req) != TIMING_OK ||
+                    pattern_compile(&p, sg_sys_clk_hz, div, sg_event_overhead(SG_PROGRAM_PATTERN), &t) !=
+                        TIMING_OK ||
+                    !pattern_table_pad_pow2(&t, sg_event_overhead(SG_PROGRAM_PATTERN), PATTERN_MAX_EVENTS))
+                {
+                    printf("GAGAL menyusun pola %u Hz %u/%u ns\n", req.freq_hz, req.pulse_width_ns, req.phase_ns);
+                    failures++;
+                    continue;
+                }
+
+                uint32_t pulse, event_d;
+                stop_table_cycles(&t, &pulse, &event_d);
+                for (uint32_t n = 0; n < sizeof(counts) / sizeof(counts[0]); n++)
+                {
+                    char name[48];
+                    snprintf(name, sizeof(name), "%u Hz %u/%u ns @ %u MHz", req.freq_hz, req.pulse_width_ns,
+                             req.phase_ns, sg_sys_clk_hz / 1000000u);
+                    stop_check(&counted, name, SG_PROGRAM_STATIC, plan.delay, 4, div, plan.period_cycles,
+                               plan.event_cycles[0], plan.event_cycles[3], counts[n]);
+                    stop_check(&ring, name, SG_PROGRAM_PATTERN, t.words, t.length, div, t.period_cycles,
+                               pulse, event_d, counts[n]);
+                }
+            }
+    }
+    sg_sys_clk_hz = SG_SYS_CLK_HZ;
+
+    // Pola bebas yang berakhir dengan CH2/CH3 HIGH: kata henti yang
+    // memadamkan pin tepat di batas periode
+    pattern_init(&p, 0);
+    pattern_add(&p, 0x1, 2000);
+    pattern_add(&p, 0x0, 1000);
+    pattern_add(&p, 0x6, 1500);
+    uint32_t div;
+    if (pattern_compile_auto(&p, sg_sys_clk_hz, sg_event_overhead(SG_PROGRAM_PATTERN), &div, &t) != TIMING_OK ||
+        !pattern_table_pad_pow2(&t, sg_event_overhead(SG_PROGRAM_PATTERN), PATTERN_MAX_EVENTS))
+    {
+        printf("GAGAL menyusun pola bebas\n");
+        failures++;
+    }
+    else
+    {
+        uint32_t pulse, event_d;
+        stop_table_cycles(&t, &pulse, &event_d);
+        for (uint32_t n = 0; n < sizeof(counts) / sizeof(counts[0]); n++)
+            stop_check(&custom, "pola 1/0/6", SG_PROGRAM_PATTERN, t.words, t.length, div, t.period_cycles, pulse,
+                       event_d, counts[n]);
+    }
+
+    // Durasi UI -> periode: dibulatkan ke terdekat, minimal satu
+    struct
+    {
+        uint32_t ms, sys_clk_hz, div, period_cycles, want;
+    } conv[] = {
+        {3000, 125000000u, 256, 1250000, 300},     // 100 Hz
+        {1000, 125000000u, 256, 178571, 700},      // 700 Hz, periode dibulatkan
+        {30000, 250000000u, 256, 250000, 30000},   // 1 kHz, 30 s (maks. UI)
+        {30000, 250000000u, 512, 12500000, 300},   // 10 Hz, clkdiv 2
+        {1, 125000000u, 256, 12500000, 1},         // Lebih pendek dari satu periode
+        {25, 125000000u, 256, 1250000, 3},         // 2.5 periode -> 3 (setengah dibulatkan ke atas)
+    };
+    uint32_t conv_fail = 0;
+    for (uint32_t i = 0; i < sizeof(conv) / sizeof(conv[0]); i++)
+    {
+        uint32_t got = timing_periods_for_duration(conv[i].ms, conv[i].sys_clk_hz, conv[i].div,
+                                                   conv[i].period_cycles);
+        if (got != conv[i].want)
+        {
+            printf("GAGAL durasi %u ms, periode %u siklus: %u periode (diharapkan %u)\n", conv[i].ms,
+                   conv[i].period_cycles, got, conv[i].want);
+            conv_fail++;
+        }
+    }
+    printf("Konversi durasi -> periode: %u kasus, %u gagal\n", (unsigned)(sizeof(conv) / sizeof(conv[0])),
+           conv_fail);
+    failures += conv_fail;
+
+    // Titik henti harus pada jarak tetap dari batas periode di semua kasus
+    const struct
+    {
+        const char *name;
+        stop_stats_t *ss;
+        int64_t want;
+    } rows[] = {
+        {"statis (irq wait)", &counted, -1}, // "irq wait" di siklus terakhir event D
+        {"pola bipolar (kata henti)", &ring, 3},
+        {"pola bebas (kata henti)", &custom, 3}, // Kata henti: out, out, jmp lalu stall
+    };
+    printf("%-28s %6s %6s %s\n", "program", "jalan", "gagal", "titik henti - batas periode (siklus PIO)");
+    for (uint32_t i = 0; i < sizeof(rows) / sizeof(rows[0]); i++)
+    {
+        stop_stats_t *ss = rows[i].ss;
+        bool fixed = ss->runs > 0 && ss->latency_min == rows[i].want && ss->latency_max == rows[i].want;
+        printf("%-28s %6u %6u %+lld..%+lld %s\n", rows[i].name, ss->runs, ss->failures,
+               (long long)ss->latency_min, (long long)ss->latency_max, fixed ? "OK" : "GAGAL");
+        failures += ss->failures + !fixed;
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,240 @@
+/**
+ * lib/signal_timing.c: timing_compile() terhadap referensi 128-bit (mgc_sim timing)
+ * dan biayanya terhadap jalur float lama (mgc_sim bench)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "legacy_timing.h"
+#include "mgc_checks.h"
+#include "sg_run.h"
+#include "signal_timing.h"
+
+// Referensi: pembulatan ke terdekat dengan aritmetika 128-bit
+static uint64_t ref_round(unsigned __int128 num, unsigned __int128 den)
+{
+    return (uint64_t)((num + den / 2) / den);
+}
+
+typedef struct
+{
+    uint64_t event[4];
+    uint64_t period;
+    timing_status_t status;
+} ref_plan_t;
+
+// Rencana referensi langsung dari definisinya: setiap tepi dibulatkan ke siklus
+// PIO terdekat, event dipaksa minimal sepanjang overhead
+static void ref_compile(const timing_request_t *req, uint32_t sys_clk_hz, uint32_t clkdiv_fixed,
+                        uint32_t overhead, ref_plan_t *r)
+{
+    memset(r, 0, sizeof(*r));
+    if (req->freq_hz == 0)
+    {
+        r->status = TIMING_ERR_FREQ;
+        return;
+    }
+
+    unsigned __int128 ns_den = (unsigned __int128)1000000000u * clkdiv_fixed;
+    uint64_t period = ref_round((unsigned __int128)sys_clk_hz * 256, (unsigned __int128)req->freq_hz * clkdiv_fixed);
+    uint64_t pulse = ref_round((unsigned __int128)req->pulse_width_ns * sys_clk_hz * 256, ns_den);
+    uint64_t phase = ref_round((unsigned __int128)req->phase_ns * sys_clk_hz * 256, ns_den);
+
+    r->status = req->phase_ns < req->pulse_width_ns ? TIMING_ERR_PHASE_LT_PULSE : TIMING_OK;
+    r->event[0] = r->event[2] = pulse;
+    r->event[1] = phase > pulse ? phase - pulse : 0;
+    for (int i = 0; i < 3; i++)
+    {
+        if (r->event[i] < overhead)
+        {
+            r->event[i] = overhead;
+            if (r->status == TIMING_OK)
+                r->status = TIMING_ERR_EVENT_TOO_SHORT;
+        }
+    }
+    uint64_t used = r->event[0] + r->event[1] + r->event[2];
+    if (period < used + overhead)
+    {
+        r->event[3] = overhead;
+        if (r->status == TIMING_OK)
+            r->status = TIMING_ERR_PERIOD_TOO_SHORT;
+    }
+    else
+    {
+        r->event[3] = period - used;
+    }
+    r->period = used + r->event[3];
+}
+
+static int check_plan(const char *what, const timing_request_t *req, uint32_t sys_clk_hz,
+                      uint32_t clkdiv_fixed, uint32_t overhead, timing_status_t want_status)
+{
+    timing_plan_t plan;
+    ref_plan_t ref;
+    timing_status_t st = timing_compile(req, sys_clk_hz, clkdiv_fixed, overhead, &plan);
+    ref_compile(req, sys_clk_hz, clkdiv_fixed, overhead, &ref);
+
+    if (st != want_status || st != ref.status)
+    {
+        printf("GAGAL %s: %u Hz %u ns %u ns -> status %s, diharapkan %s\n", what,
+               req->freq_hz, req->pulse_width_ns, req->phase_ns,
+               timing_status_str(st), timing_status_str(want_status));
+        return 1;
+    }
+    if (st == TIMING_ERR_FREQ)
+        return 0;
+
+    // Nilai N dan durasi harus sama dengan referensi, juga untuk rencana
+    // terdekat saat status != TIMING_OK
+    for (int i = 0; i < 4; i++)
+    {
+        if (plan.event_cycles[i] != ref.event[i] || plan.delay[i] + overhead != ref.event[i])
+        {
+            printf("GAGAL %s: %u Hz %u ns %u ns event %c = %u (N=%u), diharapkan %llu\n", what,
+                   req->freq_hz, req->pulse_width_ns, req->phase_ns, 'A' + i,
+                   plan.event_cycles[i], plan.delay[i], (unsigned long long)ref.event[i]);
+            return 1;
+        }
+    }
+    if (plan.period_cycles != ref.period)
+    {
+        printf("GAGAL %s: periode %u, diharapkan %llu\n", what, plan.period_cycles,
+               (unsigned long long)ref.period);
+        return 1;
+    }
+    return 0;
+}
+
+int cmd_timing(void)
+{
+    uint32_t clkdiv = timing_clkdiv_for_resolution(SG_SYS_CLK_HZ, 100);
+    uint32_t failures = 0, checked = 0, feasible = 0;
+
+    // 125 MHz dan resolusi 100 ns -> 12.5 (3200/256)
+    if (clkdiv != 3200)
+    {
+        printf("GAGAL clkdiv 100 ns = %u, diharapkan 3200\n", clkdiv);
+        failures++;
+    }
+    if (timing_clkdiv_for_resolution(SG_SYS_CLK_HZ, 1) != TIMING_CLKDIV_ONE ||
+        timing_clkdiv_for_resolution(SG_SYS_CLK_HZ, 1000000000u) != TIMING_CLKDIV_MAX)
+    {
+        printf("GAGAL batas clkdiv\n");
+        failures++;
+    }
+
+    // Seluruh ruang parameter UI, kedua program
+    for (int p = 0; p < 2; p++)
+    {
+        uint32_t overhead = sg_event_overhead(p ? SG_PROGRAM_DYNAMIC : SG_PROGRAM_STATIC);
+        for (uint32_t f = 10; f <= 1000; f += 10)
+            for (uint32_t pw = 100; pw <= 50000; pw += 100)
+                for (uint32_t ph = 100; ph <= 10000; ph += 100)
+                {
+                    timing_request_t req = {f, pw, ph};
+                    ref_plan_t ref;
+                    ref_compile(&req, SG_SYS_CLK_HZ, clkdiv, overhead, &ref);
+                    failures += check_plan("sapu", &req, SG_SYS_CLK_HZ, clkdiv, overhead, ref.status);
+                    if (ref.status == TIMING_OK)
+                        feasible++;
+                    checked++;
+                }
+    }
+
+    // Kasus batas
+    struct
+    {
+        const char *what;
+        timing_request_t req;
+        uint32_t clkdiv;
+        timing_status_t want;
+    } cases[] = {
+        {"frekuensi nol", {0, 1000, 1000}, 3200, TIMING_ERR_FREQ},
+        {"pulsa < overhead", {1000, 10, 100000}, 256, TIMING_ERR_EVENT_TOO_SHORT},
+        {"dead time < overhead", {1000, 1000, 1010}, 256, TIMING_ERR_EVENT_TOO_SHORT},
+        {"periode pendek", {1000000, 400, 600}, 256, TIMING_ERR_PERIOD_TOO_SHORT},
+        {"fasa < pulsa", {100, 5000, 4000}, 3200, TIMING_ERR_PHASE_LT_PULSE},
+        {"pembulatan 0.5", {100, 450, 1050}, 3200, TIMING_OK},
+        {"frekuensi 1 Hz", {1, 4000000, 5000000}, 256, TIMING_OK},
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        failures += check_plan(cases[i].what, &cases[i].req, SG_SYS_CLK_HZ, cases[i].clkdiv,
+                               sg_event_overhead(SG_PROGRAM_DYNAMIC), cases[i].want);
+        checked++;
+    }
+
+    // Perencana resolusi: seluruh ruang UI muat dengan divider integer 1 pada
+    // 125 MHz maupun 250 MHz, dan rencananya sama dengan timing_compile()
+    uint32_t sys_clks[2] = {125000000u, 250000000u};
+    for (int c = 0; c < 2; c++)
+    {
+        uint32_t overhead = sg_event_overhead(SG_PROGRAM_STATIC);
+        for (uint32_t f = 10; f <= 1000; f += 10)
+            for (uint32_t pw = 100; pw <= 50000; pw += 100)
+                for (uint32_t ph = pw; ph <= 10000; ph += 100)
+                {
+                    timing_request_t req = {f, pw, ph};
+                    timing_plan_t plan;
+                    uint32_t div;
+                    timing_status_t st = timing_compile_auto(&req, sys_clks[c], overhead, &div, &plan);
+                    if (div != TIMING_CLKDIV_ONE)
+                    {
+                        printf("GAGAL auto: %u Hz %u ns %u ns @ %u Hz -> clkdiv %u\n",
+                               f, pw, ph, sys_clks[c], div);
+                        failures++;
+                    }
+                    failures += check_plan("auto", &req, sys_clks[c], div, overhead, st);
+                    checked++;
+                }
+    }
+    if (timing_resolution_ps(125000000u, TIMING_CLKDIV_ONE) != 8000 ||
+        timing_resolution_ps(250000000u, TIMING_CLKDIV_ONE) != 4000 ||
+        timing_resolution_ps(125000000u, 3200) != 100000)
+    {
+        printf("GAGAL timing_resolution_ps\n");
+        failures++;
+    }
+
+    printf("timing_compile: %u kasus (%u titik UI dapat dipenuhi pada resolusi 100 ns), %u gagal\n",
+           checked, feasible, failures);
+    return failures == 0 ? 0 : 1;
+}
+
+int cmd_bench(int argc, char **argv)
+{
+    uint32_t iterations = argc > 0 ? (uint32_t)strtoul(argv[0], NULL, 0) : 1000000;
+    uint32_t overhead = sg_event_overhead(SG_PROGRAM_STATIC);
+    volatile uint32_t sink = 0;
+
+    // Parameter bervariasi agar kompiler tidak dapat melipat konstanta
+    double t0 = now_ns();
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        uint32_t d[4];
+        float sys_clk_hz = SG_SYS_CLK_HZ;
+        float div = legacy_clkdiv_for_resolution(sys_clk_hz, 100.0f);
+        legacy_calculate_delays(sys_clk_hz, div, overhead, &d[0], &d[1], &d[2], &d[3],
+                                (float)(10 + i % 991), (float)(100 + i % 5000), (float)(i % 5000 + 200));
+        sink += d[3];
+    }
+    double t1 = now_ns();
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        timing_plan_t plan;
+        uint32_t div = timing_clkdiv_for_resolution(SG_SYS_CLK_HZ, 100);
+        timing_request_t req = {10 + i % 991, 100 + i % 5000, i % 5000 + 200 + 100 + i % 5000};
+        timing_compile(&req, SG_SYS_CLK_HZ, div, overhead, &plan);
+        sink += plan.delay[3];
+    }
+    double t2 = now_ns();
+
+    printf("Iterasi          : %u\n", iterations);
+    printf("Float (lama)     : %8.1f ns/panggilan\n", (t1 - t0) / iterations);
+    printf("timing_compile() : %8.1f ns/panggilan\n", (t2 - t1) / iterations);
+    printf("Catatan: host memiliki FPU; di RP2040 (Cortex-M0+, tanpa FPU) jalur float\n"
+           "memakai rutin soft-float ROM sedangkan jalur integer memakai pembagian 64-bit.\n");
+    (void)sink;
+    return 0;
+}
@@ -0,0 +1,172 @@
+/**
+ * lib/trace_log.c (mgc_sim trace)
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "mgc_checks.h"
+#include "remote_proto.h"
+#include "trace_log.h"
+
+// Penulis tiruan untuk TRACE(): satu ring, cap waktu dari jam virtual.
+// Reservasi dan pengisian dipisah di uji sela interupsi di bawah.
+static trace_ring_t sim_trace;
+static uint32_t sim_trace_us;
+
+void trace_write(const char *fmt, const trace_word_t *args, uint32_t nargs)
+{
+    uint32_t n = trace_ring_reserve(&sim_trace);
+    if (n != TRACE_FULL)
+        trace_ring_fill(&sim_trace, n, sim_trace_us, fmt, args, nargs);
+}
+
+// Kuras ring lewat bingkai REMOTE_EV_TRACE seperti service_trace(), lalu
+// format di sisi penerima. Mengembalikan jumlah rekaman, -1 bila ada bingkai
+// atau rekaman rusak.
+typedef struct
+{
+    char text[32][160];
+    uint32_t t_us[32];
+    uint32_t records, frames, dropped;
+    size_t payload_max;
+} trace_seen_t;
+
+static int sim_trace_drain(trace_seen_t *seen)
+{
+    static remote_t remote;
+    static uint8_t payload[TRACE_PAYLOAD_MAX], frame[REMOTE_CAPTURE_FRAME_MAX], msg[REMOTE_CAPTURE_MSG_MAX];
+    memset(seen, 0, sizeof(*seen));
+    size_t len;
+    while ((len = trace_encode(&sim_trace, 0, payload)) > 0)
+    {
+        size_t n = remote_trace(&remote, payload, len, frame);
+        size_t msg_len;
+        trace_reader_t rd;
+        // Bingkai berpembatas 0x00 di kedua sisi
+        if (!remote_decode_capture(frame + 1, n - 2, msg, &msg_len) || msg[0] != REMOTE_EV_TRACE ||
+            !trace_reader_init(&rd, msg + 2, msg_len - 2))
+            return -1;
+        seen->frames++;
+        seen->dropped += rd.dropped;
+        if (len > seen->payload_max)
+            seen->payload_max = len;
+        trace_record_t rec;
+        while (trace_reader_next(&rd, &rec))
+        {
+            uint32_t i = seen->records++;
+            if (i < 32)
+            {
+                trace_render((const char *)rec.fmt, rec.arg, rec.nargs, seen->text[i], sizeof(seen->text[i]));
+                seen->t_us[i] = rec.t_us;
+            }
+        }
+        if (rd.pos != rd.end)
+            return -1;
+    }
+    return (int)seen->records;
+}
+
+int cmd_trace(void)
+{
+    uint32_t failures = 0;
+    trace_seen_t seen;
+
+    // Format pulang-pergi terhadap snprintf untuk baris diagnostik main.c
+    // dan kasus tepi (tanda, lebar/presisi, 64 bit, %s, %%, %c)
+    trace_ring_init(&sim_trace);
+    char want[8][160];
+    const char *name = "IRQ mati";
+    int32_t selisih = -3;
+    uint64_t on_ns = 61000000123ull;
+    uint32_t res_ps = 4000, clkdiv = 0x1a3;
+    TRACE("Resolusi: %lu.%03lu ns (clk_sys %lu Hz, clkdiv %lu+%lu/256)", res_ps / 1000, res_ps % 1000,
+          250000000u, clkdiv >> 8, clkdiv & 0xff);
+    snprintf(want[0], sizeof(want[0]), "Resolusi: %u.%03u ns (clk_sys %u Hz, clkdiv %u+%u/256)", res_ps / 1000,
+             res_ps % 1000, 250000000u, clkdiv >> 8, clkdiv & 0xff);
+    TRACE("Dosis CH1: selisih %ld, total ON %llu ns", selisih, TRACE_U64(on_ns));
+    snprintf(want[1], sizeof(want[1]), "Dosis CH1: selisih %d, total ON %llu ns", selisih,
+             (unsigned long long)on_ns);
+    TRACE("Kinerja %s: [%-10s] [%8.3s] %%", TRACE_STR(name), TRACE_STR(name), TRACE_STR(name));
+    snprintf(want[2], sizeof(want[2]), "Kinerja %s: [%-10s] [%8.3s] %%", name, name, name);
+    // Argumen yang kurang dari format diformat sebagai 0
+    TRACE("%c%c %08lx %X %+d %5u|%-5u|", 'o', 'k', 0xdeadbeefu, 0xabcu, 42, 7u);
+    snprintf(want[3], sizeof(want[3]), "%c%c %08x %X %+d %5u|%-5u|", 'o', 'k', 0xdeadbeefu, 0xabcu, 42, 7u, 0u);
+    TRACE("Memuat parameter dari flash.");
+    snprintf(want[4], sizeof(want[4]), "Memuat parameter dari flash.");
+    int got = sim_trace_drain(&seen);
+    uint32_t mismatch = 0;
+    for (int i = 0; i < 5 && got == 5; i++)
+    {
+        if (strcmp(seen.text[i], want[i]) != 0)
+        {
+            printf("  GAGAL: \"%s\"\n     vs \"%s\"\n", seen.text[i], want[i]);
+            mismatch++;
+        }
+    }
+    bool fmt_ok = got == 5 && mismatch == 0 && seen.frames == 1;
+    printf("Format vs snprintf: %d rekaman, %u beda  %s\n", got, mismatch, fmt_ok ? "OK" : "GAGAL");
+    failures += !fmt_ok;
+
+    // Interupsi menyela penulis di antara reservasi dan pengisian: rekaman
+    // interupsi tidak dikirim sebelum rekaman yang disela terbit, urutan
+    // tetap urutan reservasi
+    trace_ring_init(&sim_trace);
+    static const trace_word_t loop_args[1] = {1};
+    uint32_t slot_loop = trace_ring_reserve(&sim_trace);
+    sim_trace_us = 20;
+    TRACE("irq %lu", 2u);
+    bool hidden = trace_ring_peek(&sim_trace) == NULL;
+    trace_ring_fill(&sim_trace, slot_loop, 10, "loop %lu", loop_args, 1);
+    got = sim_trace_drain(&seen);
+    bool preempt = hidden && got == 2 && strcmp(seen.text[0], "loop 1") == 0 &&
+                   strcmp(seen.text[1], "irq 2") == 0 && seen.t_us[0] == 10 && seen.t_us[1] == 20;
+    printf("Sela interupsi di tengah rekaman: tertahan %s, urutan \"%s\", \"%s\"  %s\n", hidden ? "ya" : "tidak",
+           got == 2 ? seen.text[0] : "?", got == 2 ? seen.text[1] : "?", preempt ? "OK" : "GAGAL");
+    failures += !preempt;
+
+    // Ring penuh: rekaman baru dibuang dan jumlahnya dilaporkan sekali di
+    // payload berikutnya; setiap payload muat di batasnya
+    trace_ring_init(&sim_trace);
+    for (uint32_t i = 0; i < TRACE_SLOTS + 5; i++)
+    {
+        sim_trace_us = i;
+        TRACE("rekaman %lu dari %lu, %lu %lu %lu %lu", i, TRACE_SLOTS + 5u, i, i, i, i);
+    }
+    got = sim_trace_drain(&seen);
+    uint32_t dropped = seen.dropped;
+    bool full = got == TRACE_SLOTS && dropped == 5 && seen.payload_max <= TRACE_PAYLOAD_MAX &&
+                strcmp(seen.text[31], "rekaman 31 dari 69, 31 31 31 31") == 0;
+    TRACE("setelah penuh");
+    int again = sim_trace_drain(&seen);
+    full = full && again == 1 && seen.dropped == 0;
+    printf("Ring %u slot penuh: %d rekaman dalam bingkai <= %zu byte, hilang %u  %s\n", TRACE_SLOTS, got,
+           (size_t)TRACE_PAYLOAD_MAX, dropped, full ? "OK" : "GAGAL");
+    failures += !full;
+
+    // Biaya di host: TRACE() lima argumen terhadap snprintf baris yang sama
+    // (firmware lama memformat dan mengirim teks di jalur mulai proses)
+    const uint32_t rounds = 2000000;
+    char line[160];
+    volatile size_t sink = 0;
+    double t0 = now_ns();
+    for (uint32_t i = 0; i < rounds; i++)
+    {
+        TRACE("Resolusi: %lu.%03lu ns (clk_sys %lu Hz, clkdiv %lu+%lu/256)", i / 1000, i % 1000, 250000000u,
+              i >> 8, i & 0xff);
+        trace_ring_release(&sim_trace); // Konsumen tiruan: ring tidak pernah penuh
+    }
+    double t1 = now_ns();
+    for (uint32_t i = 0; i < rounds; i++)
+        sink += (size_t)snprintf(line, sizeof(line), "Resolusi: %u.%03u ns (clk_sys %u Hz, clkdiv %u+%u/256)\n",
+                                 i / 1000, i % 1000, 250000000u, i >> 8, i & 0xff);
+    double t2 = now_ns();
+    // Di RP2040 kata 4 byte: t_us + jumlah + fmt + 5 argumen
+    uint32_t device_bytes = 5 + (1 + 5) * 4;
+    printf("TRACE 5 argumen: %.1f ns/rekaman, snprintf: %.1f ns/baris di host; %u byte/rekaman di RP2040 vs %zu "
+           "byte teks\n",
+           (t1 - t0) / rounds, (t2 - t1) / rounds, device_bytes, strlen(want[0]) + 1);
+    (void)sink;
+
+    printf("Hasil: %s\n", failures == 0 ? "OK" : "GAGAL");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,78 @@
+/**
+ * Picu eksternal signal_generator_counted (mgc_sim trigger)
+ */
+
+#include <stdio.h>
+#include "mgc_checks.h"
+#include "sg_run.h"
+#include "signal_timing.h"
+#include "signal_generator.pio.h"
+
+// Latensi tepi picu masuk -> tepi naik CH1 pertama untuk setiap fasa tepi
+// picu terhadap jam SM (satu siklus clk_sys per langkah, dua siklus SM).
+// Pin picu asinkron menambah paling banyak satu siklus clk_sys lagi sebelum
+// flip-flop sinkronisasi pertama, jadi jitter total = clkdiv siklus clk_sys
+// (dibulatkan ke atas). Picu keluar harus naik dan turun bersama CH1.
+int cmd_trigger(void)
+{
+    static const uint32_t divs[] = {256, 384, 1024, 2560}; // clkdiv 1, 1.5, 4, 10
+    timing_request_t req = {1000, 100000, 200000};
+    uint32_t failures = 0;
+
+    printf("Picu masuk GP%u -> CH1 GP%u, picu keluar GP%u; sinkronisasi input %u siklus clk_sys\n",
+           SG_PIN_TRIG_IN, SG_PIN_CH1, SG_PIN_TRIG_OUT, SG_TRIGGER_SYNC_CYCLES);
+    printf("%-8s %8s %8s %8s %10s %10s %s\n", "clkdiv", "lat.min", "lat.max", "jitter", "min (ns)", "maks (ns)",
+           "picu keluar");
+    for (uint32_t i = 0; i < sizeof(divs) / sizeof(divs[0]); i++)
+    {
+        uint32_t div = divs[i];
+        timing_plan_t plan;
+        if (timing_compile(&req, sg_sys_clk_hz, div, signal_generator_counted_EVENT_OVERHEAD, &plan) != TIMING_OK)
+        {
+            printf("GAGAL menyusun rencana clkdiv %u/256\n", div);
+            failures++;
+            continue;
+        }
+
+        uint32_t steps = 2 * ((div + 255) >> 8);
+        uint64_t lat_min = UINT64_MAX, lat_max = 0;
+        bool aligned = true;
+        for (uint32_t k = 0; k < steps; k++)
+        {
+            uint64_t trigger = 1000 + k;
+            sg_trigger_t r;
+            uint64_t limit = trigger + 2ull * plan.period_cycles * div / 256u;
+            if (!sg_simulate_trigger(plan.delay, div, trigger, limit, &r))
+            {
+                printf("GAGAL clkdiv %u/256, picu di siklus %llu: periode pertama tidak selesai\n", div,
+                       (unsigned long long)trigger);
+                failures++;
+                aligned = false;
+                break;
+            }
+            uint64_t lat = r.ch1_rise - trigger;
+            if (lat < lat_min)
+                lat_min = lat;
+            if (lat > lat_max)
+                lat_max = lat;
+            aligned = aligned && r.trig_rise == r.ch1_rise && r.trig_fall == r.ch1_fall;
+        }
+
+        // clkdiv bulat: latensi tepat sinkronisasi + TRIGGER_LATENCY siklus
+        // SM ditambah fasa jam SM (0..clkdiv-1 siklus clk_sys)
+        uint64_t jitter = lat_max - lat_min + 1;
+        bool ok = aligned && jitter <= (div + 255) >> 8;
+        if ((div & 0xff) == 0)
+        {
+            uint64_t want = SG_TRIGGER_SYNC_CYCLES + (uint64_t)signal_generator_counted_TRIGGER_LATENCY * (div >> 8);
+            ok = ok && lat_min == want && lat_max == want + (div >> 8) - 1;
+        }
+        printf("%-8.2f %8llu %8llu %8llu %10.1f %10.1f %s %s\n", div / 256.0, (unsigned long long)lat_min,
+               (unsigned long long)lat_max, (unsigned long long)jitter, lat_min * 1e9 / sg_sys_clk_hz,
+               (lat_max + 1) * 1e9 / sg_sys_clk_hz, aligned ? "sejajar" : "MELESET", ok ? "OK" : "GAGAL");
+        failures += !ok;
+    }
+    printf("Latensi dalam siklus clk_sys @ %u MHz; maks (ns) termasuk fasa picu asinkron\n",
+           sg_sys_clk_hz / 1000000u);
+    return failures == 0 ? 0 : 1;
+}
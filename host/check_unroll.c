@@ -0,0 +1,156 @@
+/**
+ * lib/pio_unroll.c: program terurai frekuensi tinggi (mgc_sim unroll)
+ */
+
+#include <stdio.h>
+#include "mgc_checks.h"
+#include "pio_unroll.h"
+#include "sg_run.h"
+#include "signal_timing.h"
+#include "signal_generator.pio.h"
+
+// Kode mesin yang disusun sendiri harus sama dengan keluaran pioasm untuk
+// instruksi yang juga ada di signal_generator_counted
+static bool unroll_encoding_ok(const unroll_program_t *u)
+{
+    const uint16_t *c = signal_generator_counted_program_instructions;
+    uint32_t n = sizeof(signal_generator_counted_program_instructions) / sizeof(uint16_t);
+    uint16_t set_a = c[signal_generator_counted_wrap_target + 1]; // set pins, 25
+    return u->instructions[0] == c[0] && u->instructions[1] == c[signal_generator_counted_offset_start] &&
+           u->instructions[2] == c[signal_generator_counted_offset_start + 1] &&
+           (u->instructions[UNROLL_PROLOG] & 0xe0ffu) == set_a && u->instructions[u->length - 1] == c[n - 1];
+}
+
+// Setiap tepi GP6..GP9 eksak terhadap rencana, tepat 'periods' pulsa dengan
+// lebar penuh, pin LOW dan SM parkir tepat di batas periode
+static bool unroll_run_ok(const unroll_program_t *u, const timing_plan_t *plan, uint32_t periods)
+{
+    static const uint8_t masks[4] = {0x9, 0x0, 0x6, 0x0}; // GP6..GP9 tanpa picu keluar
+    static sg_pin_log_t log;
+    static uint64_t cycle[SG_MAX_LOG];
+    static uint8_t pins[SG_MAX_LOG];
+    uint32_t n = 0;
+    uint64_t now = 0;
+    for (uint32_t p = 0; p < periods; p++)
+        for (int i = 0; i < 4; i++)
+        {
+            if (n == 0 || pins[n - 1] != masks[i])
+            {
+                cycle[n] = now;
+                pins[n++] = masks[i];
+            }
+            now += plan->event_cycles[i];
+        }
+
+    sg_stop_t r;
+    uint64_t t0;
+    uint64_t limit = ((uint64_t)periods + 2) * plan->period_cycles + 1000;
+    if (!sg_simulate_unrolled(u, periods, limit, &r, &log))
+        return false;
+    if (n == 0 || log.n != n || !sg_compare_edges(&log, cycle, pins, n, &t0))
+    {
+        printf("  tepi: %u tercatat, %u diharapkan\n", log.n, n);
+        return false;
+    }
+    uint64_t boundary = t0 + (uint64_t)periods * plan->period_cycles;
+    return r.ch1.pulses == periods && r.ch1.high_cycles == (uint64_t)periods * plan->event_cycles[0] &&
+           r.final_pins == 0 && r.irq && r.stop == boundary;
+}
+
+int cmd_unroll(void)
+{
+    static const uint32_t clocks[] = {125000000u, 250000000u};
+    static const uint32_t freqs[] = {1000, 10000, 20000, 50000, 100000, 250000, 500000};
+    static const uint32_t params[][2] = {{10, 20}, {24, 48}, {100, 200}, {1000, 2000}, {3500, 10000}};
+    static const uint32_t counts[] = {1, 2, 7};
+    uint32_t failures = 0, n_unrolled = 0, n_loop = 0, n_none = 0, n_rescued = 0;
+    unroll_program_t u;
+    timing_plan_t plan;
+
+    // Kode mesin terhadap pioasm
+    timing_request_t probe = {100000, 1000, 2000};
+    bool enc = unroll_compile(&probe, 125000000u, sg_unroll_budget(), &plan, &u) == TIMING_OK && unroll_encoding_ok(&u);
+    printf("Kode mesin (wait, pull, mov, set pins, irq wait) sama dengan pioasm: %s\n", enc ? "OK" : "GAGAL");
+    failures += !enc;
+
+    printf("Ruang program terurai: %u dari %u instruksi (sisanya mesin pola)\n", (unsigned)sg_unroll_budget(),
+           UNROLL_MAX_INSTRUCTIONS);
+    printf("%-5s %8s %12s %-16s %-28s %s\n", "MHz", "Hz", "pulsa/fasa", "program loop", "terurai (A/B/C/D)",
+           "dipakai");
+    for (uint32_t c = 0; c < sizeof(clocks) / sizeof(clocks[0]); c++)
+        for (uint32_t fi = 0; fi < sizeof(freqs) / sizeof(freqs[0]); fi++)
+            for (uint32_t pi = 0; pi < sizeof(params) / sizeof(params[0]); pi++)
+            {
+                timing_request_t req = {freqs[fi], params[pi][0], params[pi][1]};
+                timing_status_t loop = sg_counted_status(&req, clocks[c]);
+                timing_status_t unr = unroll_compile(&req, clocks[c], sg_unroll_budget(), &plan, &u);
+
+                char shape[32], pp[16];
+                if (unr == TIMING_OK)
+                    snprintf(shape, sizeof(shape), "%2u instr (%u/%u/%u/%u)", u.length, u.event_instructions[0],
+                             u.event_instructions[1], u.event_instructions[2], u.event_instructions[3]);
+                else
+                    snprintf(shape, sizeof(shape), "%s", timing_status_str(unr));
+                snprintf(pp, sizeof(pp), "%u/%u", req.pulse_width_ns, req.phase_ns);
+
+                const char *used = "-";
+                bool ok = true;
+                if (unr == TIMING_OK)
+                {
+                    used = "terurai";
+                    n_unrolled++;
+                    n_rescued += loop != TIMING_OK;
+                    for (uint32_t k = 0; k < sizeof(counts) / sizeof(counts[0]); k++)
+                        ok = ok && unroll_run_ok(&u, &plan, counts[k]);
+                }
+                else if (loop == TIMING_OK)
+                {
+                    used = "loop";
+                    n_loop++;
+                }
+                else
+                {
+                    n_none++;
+                }
+                // Ruang UI lama (<= 1 kHz) tidak pernah muat: perilakunya tetap
+                if (req.freq_hz <= 1000 && unr == TIMING_OK)
+                    ok = false;
+                printf("%-5u %8u %12s %-16s %-28s %s %s\n", clocks[c] / 1000000u, req.freq_hz, pp,
+                       timing_status_str(loop), shape, used, ok ? "OK" : "GAGAL");
+                failures += !ok;
+            }
+    printf("Terurai %u (%u hanya mungkin terurai), loop %u, ditolak %u\n", n_unrolled, n_rescued, n_loop, n_none);
+    bool mix = n_unrolled > 0 && n_rescued > 0 && n_loop > 0;
+    if (!mix)
+        printf("GAGAL: sapuan harus memuat program terurai, loop dan kasus yang hanya muat terurai\n");
+    failures += !mix;
+
+    // Ruang lebih kecil (mis. grup kanal memakai program lain): jatuh ke loop
+    timing_request_t wide = {20000, 3500, 10000};
+    timing_status_t full = unroll_compile(&wide, 125000000u, sg_unroll_budget(), &plan, &u);
+    timing_status_t tight = unroll_compile(&wide, 125000000u, 16, &plan, &u);
+    bool budget_ok = full == TIMING_OK && tight == TIMING_ERR_RANGE;
+    printf("20 kHz 3500/10000 ns: %u instruksi muat, ruang 16 -> %s  %s\n", (unsigned)sg_unroll_budget(), timing_status_str(tight),
+           budget_ok ? "OK" : "GAGAL");
+    failures += !budget_ok;
+
+    // Picu eksternal: clkdiv 1 tanpa jitter divider, latensi tetap
+    static const timing_request_t trig_req[] = {{500000, 10, 20}, {100000, 1000, 2000}, {20000, 3500, 10000}};
+    for (uint32_t i = 0; i < sizeof(trig_req) / sizeof(trig_req[0]); i++)
+    {
+        bool ok = unroll_compile(&trig_req[i], sg_sys_clk_hz, sg_unroll_budget(), &plan, &u) == TIMING_OK;
+        uint64_t want = SG_TRIGGER_SYNC_CYCLES + UNROLL_TRIGGER_LATENCY;
+        for (uint64_t trigger = 1000; ok && trigger < 1002; trigger++)
+        {
+            sg_trigger_t r;
+            ok = sg_simulate_unrolled_trigger(&u, trigger, trigger + 2ull * plan.period_cycles, &r) &&
+                 r.ch1_rise - trigger == want && r.ch1_fall - r.ch1_rise == plan.event_cycles[0] &&
+                 r.trig_rise == r.ch1_rise && r.trig_fall == r.ch1_fall;
+        }
+        printf("Picu %u Hz %u/%u ns: latensi %llu siklus clk_sys, picu keluar sejajar CH1  %s\n",
+               trig_req[i].freq_hz, trig_req[i].pulse_width_ns, trig_req[i].phase_ns, (unsigned long long)want,
+               ok ? "OK" : "GAGAL");
+        failures += !ok;
+    }
+    return failures == 0 ? 0 : 1;
+}
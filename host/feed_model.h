@@ -0,0 +1,90 @@
+#ifndef FEED_MODEL_H
+#define FEED_MODEL_H
+
+/**
+ * Model host untuk umpan DMA ring -> TX FIFO PIO.
+ *
+ * Dimodelkan per siklus clk_sys:
+ * - TX FIFO SM (kedalaman 4, atau 8 bila di-join)
+ * - Channel DMA data: baca ring dengan pembungkusan alamat, dipacu DREQ TX
+ *   (DREQ aktif selama FIFO masih punya ruang), latensi tulis bus
+ * - Channel DMA kontrol: memuat ulang transfer count lewat chain lalu
+ *   memicu ulang channel data
+ * - Konsumen SM sederhana untuk program signal_generator: satu kata per
+ *   event, durasi event = kata + overhead siklus PIO
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define PIO_FIFO_MODEL_MAX_DEPTH 8
+
+typedef struct
+{
+    uint32_t data[PIO_FIFO_MODEL_MAX_DEPTH];
+    uint32_t depth;
+    uint32_t level;
+    uint32_t rd;
+} pio_fifo_model_t;
+
+void pio_fifo_model_init(pio_fifo_model_t *f, uint32_t depth);
+bool pio_fifo_model_push(pio_fifo_model_t *f, uint32_t val);
+bool pio_fifo_model_pop(pio_fifo_model_t *f, uint32_t *val);
+
+#define DMA_MODEL_MAX_INFLIGHT 4
+
+typedef struct
+{
+    // Konfigurasi
+    const uint32_t *ring;     // Basis ring (disejajarkan ke ukuran ring)
+    uint32_t ring_size_bits;  // Ukuran ring dalam byte = 1 << ring_size_bits
+    uint32_t reload_count;    // Nilai yang dimuat channel kontrol
+    uint32_t write_latency;   // Siklus dari baca ring sampai kata masuk FIFO
+    uint32_t retrigger_delay; // Siklus chain -> kontrol -> trigger ulang
+
+    // Status channel data
+    uint32_t read_offset; // Offset byte dalam ring (READ_ADDR yang dibungkus)
+    uint32_t remaining;   // TRANS_COUNT
+    bool busy;
+    uint32_t retrigger_timer;
+
+    // Transfer yang sudah dibaca tapi belum mendarat di FIFO
+    uint32_t inflight_val[DMA_MODEL_MAX_INFLIGHT];
+    uint32_t inflight_due[DMA_MODEL_MAX_INFLIGHT];
+    uint32_t inflight;
+
+    // Statistik
+    uint64_t words_transferred;
+    uint32_t retriggers;
+} dma_ring_model_t;
+
+void dma_ring_model_init(dma_ring_model_t *m, const uint32_t *ring, uint32_t ring_size_bits,
+                         uint32_t reload_count);
+void dma_ring_model_start(dma_ring_model_t *m);
+void dma_ring_model_abort(dma_ring_model_t *m);
+void dma_ring_model_step(dma_ring_model_t *m, pio_fifo_model_t *fifo);
+
+typedef struct
+{
+    uint32_t clkdiv;         // Pembagi clock SM (integer)
+    uint32_t event_overhead; // Siklus PIO tambahan per event (pull/mov/set/jmp)
+
+    uint32_t div_phase;
+    uint32_t countdown; // Siklus PIO tersisa pada event berjalan
+    bool stalled;
+    uint32_t event_index;
+
+    // Statistik
+    uint64_t words_consumed;
+    uint32_t periods;
+    uint32_t underruns;     // Jumlah episode FIFO kosong saat SM butuh kata
+    uint64_t stall_cycles;  // Total siklus clk_sys SM menunggu di pull block
+    uint32_t order_errors;  // Kata yang tidak sesuai urutan ring
+    uint32_t min_level;     // Level FIFO terendah yang teramati saat pull
+} sm_feed_consumer_t;
+
+void sm_feed_consumer_init(sm_feed_consumer_t *c, uint32_t clkdiv, uint32_t event_overhead);
+void sm_feed_consumer_step(sm_feed_consumer_t *c, pio_fifo_model_t *fifo,
+                           const uint32_t *expected, uint32_t expected_words);
+
+#endif
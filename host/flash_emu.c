@@ -0,0 +1,66 @@
+#include "flash_emu.h"
+#include <string.h>
+
+static void emu_erase(void *ctx, uint32_t offset)
+{
+    flash_emu_t *e = ctx;
+    if (!e->powered)
+        return;
+    e->erases[offset / PARAM_SECTOR_SIZE]++;
+    for (uint32_t i = 0; i < PARAM_SECTOR_SIZE; i++)
+    {
+        if (e->budget == 0)
+        {
+            // Erase terputus: sisa sektor tetap berisi data lama
+            e->powered = false;
+            return;
+        }
+        if (e->budget > 0)
+            e->budget--;
+        e->mem[offset + i] = 0xff;
+    }
+}
+
+static void emu_program(void *ctx, uint32_t offset, const uint8_t *page)
+{
+    flash_emu_t *e = ctx;
+    if (!e->powered)
+        return;
+    e->programs++;
+    for (uint32_t i = 0; i < PARAM_PAGE_SIZE; i++)
+    {
+        if (e->budget == 0)
+        {
+            e->powered = false;
+            return;
+        }
+        if (e->budget > 0)
+            e->budget--;
+        e->mem[offset + i] &= page[i];
+    }
+}
+
+void flash_emu_init(flash_emu_t *e, uint32_t sectors, uint8_t fill)
+{
+    memset(e, 0, sizeof(*e));
+    memset(e->mem, fill, sizeof(e->mem));
+    e->sectors = sectors;
+    e->budget = -1;
+    e->powered = true;
+    e->flash.base = e->mem;
+    e->flash.sectors = sectors;
+    e->flash.erase_sector = emu_erase;
+    e->flash.program_page = emu_program;
+    e->flash.ctx = e;
+}
+
+void flash_emu_cut_after(flash_emu_t *e, int64_t bytes)
+{
+    e->budget = bytes;
+}
+
+void flash_emu_power_on(flash_emu_t *e)
+{
+    e->budget = -1;
+    e->powered = true;
+}
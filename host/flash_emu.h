@@ -0,0 +1,35 @@
+#ifndef FLASH_EMU_H
+#define FLASH_EMU_H
+
+/**
+ * Emulator NOR flash untuk lib/param_store.c.
+ *
+ * Erase mengisi sektor dengan 0xFF, program hanya dapat mengubah bit 1 -> 0
+ * (AND). Putus daya disuntikkan dengan membatasi jumlah byte yang masih
+ * sempat ditulis/dihapus; setelah itu seluruh operasi diabaikan sampai
+ * flash_emu_power_on().
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "param_store.h"
+
+typedef struct
+{
+    uint8_t mem[PARAM_MAX_SECTORS * PARAM_SECTOR_SIZE];
+    uint32_t sectors;
+    uint32_t erases[PARAM_MAX_SECTORS];
+    uint32_t programs;
+    int64_t budget; // Byte tersisa sebelum daya putus (-1: tanpa batas)
+    bool powered;
+    param_flash_t flash;
+} flash_emu_t;
+
+// Isi awal 'fill' (0xFF = baru, acak untuk flash bekas)
+void flash_emu_init(flash_emu_t *e, uint32_t sectors, uint8_t fill);
+
+// Daya putus setelah 'bytes' byte lagi diprogram/dihapus
+void flash_emu_cut_after(flash_emu_t *e, int64_t bytes);
+void flash_emu_power_on(flash_emu_t *e);
+
+#endif
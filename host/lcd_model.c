@@ -0,0 +1,146 @@
+#include "lcd_model.h"
+#include <string.h>
+
+// Waktu eksekusi HD44780 (fosc 270 kHz)
+#define LCD_EXEC_NS 37000u
+#define LCD_EXEC_CLEAR_NS 1520000u
+
+void lcd_model_init(lcd_model_t *m, uint32_t baud_hz)
+{
+    memset(m, 0, sizeof(*m));
+    m->baud_hz = baud_hz;
+    memset(m->ddram, ' ', sizeof(m->ddram));
+}
+
+void lcd_model_reset_stats(lcd_model_t *m)
+{
+    m->transactions = 0;
+    m->bytes = 0;
+    m->bus_ns = 0;
+    m->sleep_ns = 0;
+}
+
+static void execute(lcd_model_t *m, uint8_t val, bool rs)
+{
+    // Nibble pertama instruksi baru dikunci sebelum instruksi sebelumnya selesai
+    if (m->now_ns < m->busy_until_ns)
+        m->timing_violations++;
+
+    uint32_t exec_ns = LCD_EXEC_NS;
+    if (rs)
+    {
+        int row = m->addr >= 0x40 ? 1 : 0;
+        int col = m->addr - (row ? 0x40 : 0x00);
+        if (col >= 0 && col < LCD_COLS)
+            m->ddram[row][col] = (char)val;
+        m->addr++;
+    }
+    else if (val & 0x80)
+    {
+        m->addr = val & 0x7F;
+    }
+    else if (val == 0x01 || (val & 0xFE) == 0x02)
+    {
+        if (val == 0x01)
+            memset(m->ddram, ' ', sizeof(m->ddram));
+        m->addr = 0;
+        exec_ns = LCD_EXEC_CLEAR_NS;
+    }
+    m->busy_until_ns = m->now_ns + exec_ns;
+}
+
+static void pins(lcd_model_t *m, uint8_t v)
+{
+    // Data dikunci pada tepi turun EN
+    if ((m->last_pins & LCD_PCF_EN) && !(v & LCD_PCF_EN))
+    {
+        uint8_t nibble = m->last_pins & 0xF0;
+        bool rs = m->last_pins & LCD_PCF_RS;
+        if (!m->have_high)
+        {
+            if (m->now_ns < m->busy_until_ns)
+                m->timing_violations++;
+            m->high = nibble;
+            m->have_high = true;
+        }
+        else
+        {
+            m->have_high = false;
+            execute(m, m->high | (nibble >> 4), rs);
+        }
+    }
+    m->last_pins = v;
+}
+
+void lcd_model_write(lcd_model_t *m, const uint8_t *buf, size_t len)
+{
+    // start + (alamat + data) x 9 bit + stop
+    uint64_t bit_ns = 1000000000ull / m->baud_hz;
+    m->transactions++;
+    m->bytes += len;
+    m->now_ns += 10 * bit_ns; // start + alamat/ACK
+    m->bus_ns += 10 * bit_ns;
+    for (size_t i = 0; i < len; i++)
+    {
+        // Keluaran PCF8574 berubah setelah ACK byte data
+        m->now_ns += 9 * bit_ns;
+        m->bus_ns += 9 * bit_ns;
+        pins(m, buf[i]);
+    }
+    m->now_ns += bit_ns; // stop
+    m->bus_ns += bit_ns;
+}
+
+void lcd_model_sleep_us(lcd_model_t *m, uint32_t us)
+{
+    m->now_ns += us * 1000ull;
+    m->sleep_ns += us * 1000ull;
+}
+
+void lcd_model_row(const lcd_model_t *m, int row, char out[LCD_COLS + 1])
+{
+    memcpy(out, m->ddram[row], LCD_COLS);
+    out[LCD_COLS] = 0;
+}
+
+// ===================== DRIVER LAMA =====================
+static void legacy_write_byte(lcd_model_t *m, uint8_t val)
+{
+    lcd_model_write(m, &val, 1);
+}
+
+static void legacy_toggle_enable(lcd_model_t *m, uint8_t val)
+{
+    lcd_model_sleep_us(m, 600);
+    legacy_write_byte(m, val | LCD_PCF_EN);
+    lcd_model_sleep_us(m, 600);
+    legacy_write_byte(m, val & ~LCD_PCF_EN);
+    lcd_model_sleep_us(m, 600);
+}
+
+static void legacy_send_byte(lcd_model_t *m, uint8_t val, int mode)
+{
+    uint8_t high = mode | (val & 0xF0) | LCD_PCF_BACKLIGHT;
+    uint8_t low = mode | ((val << 4) & 0xF0) | LCD_PCF_BACKLIGHT;
+    legacy_write_byte(m, high);
+    legacy_toggle_enable(m, high);
+    legacy_write_byte(m, low);
+    legacy_toggle_enable(m, low);
+}
+
+void lcd_model_legacy_clear(lcd_model_t *m)
+{
+    legacy_send_byte(m, 0x01, 0);
+    lcd_model_sleep_us(m, 2000);
+}
+
+void lcd_model_legacy_set_cursor(lcd_model_t *m, int line, int position)
+{
+    legacy_send_byte(m, (line == 0 ? 0x80 : 0xC0) + position, 0);
+}
+
+void lcd_model_legacy_string(lcd_model_t *m, const char *s)
+{
+    while (*s)
+        legacy_send_byte(m, (uint8_t)*s++, LCD_PCF_RS);
+}
@@ -0,0 +1,52 @@
+#ifndef LCD_MODEL_H
+#define LCD_MODEL_H
+
+/**
+ * Model bus I2C + ekspander PCF8574 + HD44780 (mode 4-bit) untuk mengukur
+ * biaya pembaruan layar: jumlah transaksi, byte, waktu bus dan jeda, serta
+ * memeriksa isi DDRAM dan pelanggaran waktu eksekusi instruksi.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "lcd_frame.h"
+
+typedef struct
+{
+    uint32_t baud_hz;
+
+    // Statistik bus
+    uint32_t transactions;
+    uint32_t bytes; // Byte data (tanpa byte alamat)
+    uint64_t bus_ns;
+    uint64_t sleep_ns;
+    uint64_t now_ns;
+
+    // HD44780
+    char ddram[LCD_ROWS][LCD_COLS];
+    uint8_t addr;
+    uint8_t last_pins;
+    bool have_high;
+    uint8_t high;
+    uint64_t busy_until_ns; // Instruksi sebelumnya selesai dieksekusi
+    uint32_t timing_violations;
+} lcd_model_t;
+
+void lcd_model_init(lcd_model_t *m, uint32_t baud_hz);
+void lcd_model_reset_stats(lcd_model_t *m);
+
+// Satu transaksi tulis ke alamat ekspander (start + alamat + data + stop)
+void lcd_model_write(lcd_model_t *m, const uint8_t *buf, size_t len);
+void lcd_model_sleep_us(lcd_model_t *m, uint32_t us);
+
+// Baris DDRAM sebagai string (16 karakter + NUL)
+void lcd_model_row(const lcd_model_t *m, int row, char out[LCD_COLS + 1]);
+
+// Driver lama (sebelum framebuffer): satu byte per transaksi dan tiga
+// sleep_us(600) per nibble
+void lcd_model_legacy_clear(lcd_model_t *m);
+void lcd_model_legacy_set_cursor(lcd_model_t *m, int line, int position);
+void lcd_model_legacy_string(lcd_model_t *m, const char *s);
+
+#endif
@@ -0,0 +1,36 @@
+#include "legacy_timing.h"
+
+float legacy_clkdiv_for_resolution(float sys_clk_hz, float resolution_ns)
+{
+    float pio_clk_div = (sys_clk_hz * resolution_ns) / 1e9f;
+
+    // Batasi clock divider dalam rentang yang valid (1.0 - 65536.0)
+    if (pio_clk_div < 1.0f)
+        pio_clk_div = 1.0f;
+    if (pio_clk_div > 65536.0f)
+        pio_clk_div = 65536.0f;
+    return pio_clk_div;
+}
+
+void legacy_calculate_delays(float sys_clk_hz, float pio_clk_div, uint32_t event_overhead,
+                             uint32_t *delay_A, uint32_t *delay_B,
+                             uint32_t *delay_C, uint32_t *delay_D,
+                             float freq_hz, float pulse_width_ns, float phase_shift_ns)
+{
+    float pio_clk_hz = sys_clk_hz / pio_clk_div;
+    float period_s = 1.0f / freq_hz;
+    uint32_t total_pio_cycles = (uint32_t)(period_s * pio_clk_hz);
+    uint32_t pulse_width_cycles = (uint32_t)(pulse_width_ns * 1e-9f * pio_clk_hz);
+    uint32_t phase_shift_cycles = (uint32_t)(phase_shift_ns * 1e-9f * pio_clk_hz);
+
+    // Durasi setiap event dalam siklus PIO (sesuai sekuens 1001, 0000, 0110, 0000)
+    uint32_t event_A_duration = pulse_width_cycles; // CH1/CH4 HIGH
+    uint32_t event_B_duration = phase_shift_cycles; // Dead time
+    uint32_t event_C_duration = pulse_width_cycles; // CH2/CH3 HIGH
+    uint32_t event_D_duration = total_pio_cycles - event_A_duration - event_B_duration - event_C_duration;
+
+    *delay_A = event_A_duration > event_overhead ? event_A_duration - event_overhead : 0;
+    *delay_B = event_B_duration > event_overhead ? event_B_duration - event_overhead : 0;
+    *delay_C = event_C_duration > event_overhead ? event_C_duration - event_overhead : 0;
+    *delay_D = event_D_duration > event_overhead ? event_D_duration - event_overhead : 0;
+}
@@ -0,0 +1,17 @@
+#ifndef LEGACY_TIMING_H
+#define LEGACY_TIMING_H
+
+#include <stdint.h>
+
+// Jalur float lama (sebelum kompiler waktu integer di lib/signal_timing.c),
+// dipertahankan di host hanya sebagai pembanding untuk 'sweep legacy' dan
+// 'bench'. Tidak dipakai firmware.
+
+float legacy_clkdiv_for_resolution(float sys_clk_hz, float resolution_ns);
+
+void legacy_calculate_delays(float sys_clk_hz, float pio_clk_div, uint32_t event_overhead,
+                             uint32_t *delay_A, uint32_t *delay_B,
+                             uint32_t *delay_C, uint32_t *delay_D,
+                             float freq_hz, float pulse_width_ns, float phase_shift_ns);
+
+#endif
@@ -0,0 +1,700 @@
+/**
+ * Firmware MGController_RP2040 (main.c + lib/) di host, di atas shim HAL
+ * (host/shim) dengan waktu virtual
+ *
+ * Perintah:
+ *   mgc_app check [-v]
+ *       Sesi UI berskrip terhadap firmware yang sebenarnya: tombol lewat
+ *       tepi GPIO (debounce + auto-repeat), layar dibaca dari model
+ *       HD44780, parameter ditulis ke flash tiruan berbasis berkas lalu
+ *       dimuat ulang pada boot kedua, proses dijalankan sampai selesai/batal
+ *       (lib/pulse_engine.c di core 1; program PIO, DMA dan IRQ PIO di
+ *       simulator PIO) dan protokol kendali lewat CDC,
+ *       termasuk bingkai tangkapan arus/tegangan per pulsa.
+ *       -v: cetak juga log firmware (rekaman jejak yang sudah diformat).
+ *
+ *   mgc_app group
+ *       lib/channel_group.c lewat API-nya: delapan kanal independen di
+ *       PIO0/PIO1 dengan pin, pola dan frekuensi sendiri, start sinkron lewat
+ *       pin SIO. Tepi setiap kanal harus eksak sesuai tabelnya dan skew start
+ *       0 siklus di blok yang sama maupun antar blok (host/check_group.c).
+ *
+ *   mgc_app bench [iterasi]
+ *       Biaya per panggilan fungsi yang sering dipanggil di core 0:
+ *       timing_compile_auto() (pengganti calculate_delays()), updateMenu(),
+ *       handle_menu(), jalur tombol (debouncer + antrean event) dan driver
+ *       LCD (antrean + encoder batch). Diukur di CPU host.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include "shim.h"
+#include "buttons.h"
+#include "lcd_i2c.h"
+#include "lcd_queue.h"
+#include "perf_counters.h"
+#include "pulse_engine.h"
+#include "remote_proto.h"
+#include "scheduler.h"
+#include "signal_timing.h"
+#include "signal_generator.pio.h"
+
+// Harness mencetak ke stdout, bukan ke aliran CDC firmware
+#undef printf
+
+// Simbol main.c (firmware satu berkas tanpa header)
+extern const uint BUTTON_PINS[BUTTON_COUNT];
+extern const uint PIN_CH1_BASE;
+extern uint8_t menu;
+void app_init(void);
+void app_loop(void);
+void updateMenu(void);
+void handle_menu(const button_event_t *ev);
+
+// host/check_group.c
+int cmd_group(void);
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// ===================== HARNESS =====================
+// Jalankan loop utama firmware selama 'ms' waktu virtual
+static void run_ms(uint32_t ms)
+{
+    uint64_t end = time_us_64() + ms * 1000ull;
+    shim_set_horizon(end);
+    while (time_us_64() < end)
+        app_loop();
+}
+
+// Tekan (level LOW) selama 'hold_ms', lepas, lalu beri waktu debounce
+static void press(int button, uint32_t hold_ms)
+{
+    shim_gpio_set(BUTTON_PINS[button], false);
+    run_ms(hold_ms);
+    shim_gpio_set(BUTTON_PINS[button], true);
+    run_ms(50);
+}
+
+static void tap(int button, int times)
+{
+    for (int i = 0; i < times; i++)
+        press(button, 60);
+}
+
+static bool lcd_shows(const char *row0, const char *row1)
+{
+    char want[LCD_ROWS][LCD_COLS + 1];
+    snprintf(want[0], sizeof(want[0]), "%-16s", row0);
+    snprintf(want[1], sizeof(want[1]), "%-16s", row1);
+    bool ok = true;
+    for (int r = 0; r < LCD_ROWS; r++)
+    {
+        char got[LCD_COLS + 1];
+        lcd_model_row(shim_lcd(), r, got);
+        ok = ok && strcmp(got, want[r]) == 0;
+    }
+    return ok;
+}
+
+static void print_lcd(void)
+{
+    char row[LCD_COLS + 1];
+    for (int r = 0; r < LCD_ROWS; r++)
+    {
+        lcd_model_row(shim_lcd(), r, row);
+        printf("    |%s|\n", row);
+    }
+}
+
+// Pesan protokol dari keluaran CDC (teks printf di antaranya dilewati)
+static bool find_message(uint8_t type, uint8_t seq, uint8_t *msg, size_t *msg_len)
+{
+    size_t len;
+    const uint8_t *out = shim_cdc_output(&len);
+    size_t start = 0;
+    bool found = false;
+    for (size_t i = 0; i < len; i++)
+    {
+        if (out[i] != 0)
+            continue;
+        // Pesan lain (event tangkapan) tidak boleh menimpa 'msg'
+        uint8_t buf[REMOTE_MSG_MAX];
+        size_t n;
+        if (i > start && remote_decode(out + start, i - start, buf, &n) && buf[0] == type &&
+            (type == REMOTE_EV_TELEMETRY || buf[1] == seq))
+        {
+            memcpy(msg, buf, n);
+            *msg_len = n;
+            found = true; // Event terakhir yang menang
+        }
+        start = i + 1;
+    }
+    return found;
+}
+
+// Semua event tangkapan di keluaran CDC: jumlah bingkai, false bila ada
+// bingkai rusak, nomor event (periode x 2 + event) tidak berurutan, atau
+// arus event A tidak di atas tengah skala / event C tidak di bawahnya
+typedef struct
+{
+    uint32_t frames, pulses_a, pulses_c;
+    uint32_t last_dropped;
+} capture_seen_t;
+
+static bool collect_captures(capture_seen_t *seen)
+{
+    static uint8_t msg[REMOTE_CAPTURE_MSG_MAX];
+    static capture_slot_t slot;
+    size_t len;
+    const uint8_t *out = shim_cdc_output(&len);
+    size_t start = 0;
+    uint32_t next = 0;
+    bool ok = true;
+    *seen = (capture_seen_t){0};
+    for (size_t i = 0; i < len; i++)
+    {
+        if (out[i] != 0)
+            continue;
+        size_t n;
+        if (i > start && remote_decode_capture(out + start, i - start, msg, &n) && msg[0] == REMOTE_EV_CAPTURE)
+        {
+            ok = ok && capture_decode(msg + 2, n - 2, &slot);
+            uint32_t event_no = slot.pulse * 2 + slot.event;
+            ok = ok && event_no >= next;
+            next = event_no + 1;
+            // Sampel genap arus: rata-rata burst menentukan polaritas
+            uint32_t sum = 0;
+            for (uint32_t k = 0; k < slot.pairs; k++)
+                sum += slot.samples[2 * k];
+            bool above = sum > 2048u * slot.pairs;
+            ok = ok && (slot.event == CAPTURE_EVENT_A ? above : !above);
+            seen->frames++;
+            seen->pulses_a += slot.event == CAPTURE_EVENT_A;
+            seen->pulses_c += slot.event == CAPTURE_EVENT_C;
+            seen->last_dropped = slot.dropped;
+        }
+        start = i + 1;
+    }
+    return ok;
+}
+
+// Kirim satu perintah lewat CDC; false bila tidak ada balasan berhasil
+static bool remote_call(uint8_t cmd, uint8_t seq, const uint8_t *payload, size_t len, uint8_t *msg, size_t *msg_len)
+{
+    uint8_t frame[REMOTE_FRAME_MAX];
+    size_t n = remote_encode(cmd, seq, payload, len, frame);
+    shim_cdc_clear();
+    shim_cdc_input(frame, n);
+    run_ms(5);
+    return find_message(cmd | REMOTE_REPLY, seq, msg, msg_len) && msg[2] == REMOTE_OK;
+}
+
+static int32_t get_i32(const uint8_t *p)
+{
+    return (int32_t)(p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24));
+}
+
+// Berkas VCD uji mandiri dari event REMOTE_EV_LOGIC di keluaran CDC: status
+// potongan terakhir, REMOTE_LOGIC_MORE bila berkas belum lengkap atau offset
+// potongan tidak bersambung
+static remote_logic_status_t collect_logic(char *vcd, size_t cap, size_t *vcd_len)
+{
+    static uint8_t msg[REMOTE_CAPTURE_MSG_MAX];
+    size_t len;
+    const uint8_t *out = shim_cdc_output(&len);
+    size_t start = 0;
+    remote_logic_status_t status = REMOTE_LOGIC_MORE;
+    *vcd_len = 0;
+    for (size_t i = 0; i < len; i++)
+    {
+        if (out[i] != 0)
+            continue;
+        size_t n;
+        if (i > start && remote_decode_capture(out + start, i - start, msg, &n) && msg[0] == REMOTE_EV_LOGIC)
+        {
+            size_t text = n - 2 - REMOTE_LOGIC_HEADER_BYTES;
+            if ((uint32_t)get_i32(msg + 2) != *vcd_len || *vcd_len + text > cap)
+                return REMOTE_LOGIC_MORE;
+            memcpy(vcd + *vcd_len, msg + 2 + REMOTE_LOGIC_HEADER_BYTES, text);
+            *vcd_len += text;
+            status = (remote_logic_status_t)msg[6];
+        }
+        start = i + 1;
+    }
+    return status;
+}
+
+// Tepi naik CH1..CH4 dari output PIO (shim_pio_edges)
+static uint32_t ch_rises[4];
+
+static void count_rises(void *ctx, uint64_t sys_cycle, uint32_t old_pins, uint32_t new_pins)
+{
+    (void)ctx;
+    (void)sys_cycle;
+    uint32_t rise = (new_pins & ~old_pins) >> PIN_CH1_BASE;
+    for (int i = 0; i < 4; i++)
+        ch_rises[i] += (rise >> i) & 1;
+}
+
+typedef struct
+{
+    const char *what;
+    bool ok;
+} app_case_t;
+
+static int report(const char *boot, const app_case_t *cases, int n)
+{
+    int failures = 0;
+    for (int i = 0; i < n; i++)
+    {
+        printf("%-6s %-28s: %s\n", boot, cases[i].what, cases[i].ok ? "OK" : "GAGAL");
+        failures += !cases[i].ok;
+    }
+    return failures;
+}
+
+#define CASE(what, cond)                                   \
+    do                                                     \
+    {                                                      \
+        cases[nc++] = (app_case_t){(what), (cond)};        \
+        if (!cases[nc - 1].ok)                             \
+            print_lcd();                                   \
+    } while (0)
+
+// ===================== CHECK =====================
+// Boot pertama dari flash kosong: menu, edit, commit, proses, protokol
+static int boot_first(void)
+{
+    app_case_t cases[28];
+    int nc = 0;
+
+    app_init();
+    run_ms(100);
+    CASE("boot: menu awal", lcd_shows("FREKUENSI", "100 Hz") &&
+                                shim_cdc_contains("Parameter tidak ditemukan"));
+
+    tap(BUTTON_UP, 1);
+    bool nav = lcd_shows("LEBAR PULSA", "3.5 uS");
+    tap(BUTTON_DOWN, 2);
+    nav = nav && lcd_shows("UJI MANDIRI", "PW/DT/PERIODE");
+    tap(BUTTON_UP, 1);
+    CASE("navigasi UP/DOWN + putar", nav && lcd_shows("FREKUENSI", "100 Hz"));
+
+    // Nilai bawaan (fasa 100 ns < pulsa 3500 ns) ditolak perencana
+    tap(BUTTON_UP, 4);
+    tap(BUTTON_SELECT, 1);
+    CASE("start ditolak", lcd_shows("PARAM TDK VALID", timing_status_str(TIMING_ERR_PHASE_LT_PULSE)));
+    run_ms(2100);
+    CASE("layar pesan habis 2 s", lcd_shows(" MULAI PROSES", ""));
+
+    tap(BUTTON_DOWN, 4);
+    tap(BUTTON_SELECT, 1);
+    tap(BUTTON_UP, 3);
+    bool edit = lcd_shows("SET FREKUENSI", "130 Hz");
+    tap(BUTTON_SELECT, 1);
+    CASE("edit frekuensi", edit && lcd_shows("FREKUENSI", "130 Hz"));
+    CASE("commit flash ditunda", !shim_cdc_contains("Parameter disimpan") && shim_flash_erases() == 0);
+
+    // Tahan UP 2.3 s: 1 tekan + 10 repeat x1 + 8 repeat x10
+    tap(BUTTON_UP, 3);
+    tap(BUTTON_SELECT, 1);
+    press(BUTTON_UP, 2300);
+    bool repeat = lcd_shows("SET BEDA FASA", "9.2 uS");
+    tap(BUTTON_SELECT, 1);
+    CASE("auto-repeat x1/x10", repeat && lcd_shows("BEDA FASA", "9.2 uS"));
+
+    run_ms(3200);
+    CASE("commit setelah 3 s, digabung", shim_cdc_contains("Parameter disimpan (commit 1, digabung 1"));
+
+    // 130 Hz x 3 s = 390 periode, pulsa dari simulator PIO
+    tap(BUTTON_UP, 1);
+    tap(BUTTON_SELECT, 1);
+    bool started = lcd_shows("PROSES DIMULAI", "RES 8.0 nS");
+    run_ms(500);
+    started = started && lcd_shows("BERJALAN SEL=STP", " 0.6s SISA  2.4s");
+    CASE("proses dimulai", started);
+    run_ms(2600);
+    CASE("proses selesai 390 pulsa", lcd_shows("PROSES SELESAI!", "390/390 PLS"));
+    run_ms(2100);
+    // Waktu virtual hanya maju lewat sleep/WFE/flash: loop dan LCD 0 us
+    CASE("ringkasan kinerja", lcd_shows("UR0 LP/IRQ/LCD", "0/0/0 us") &&
+                                  shim_cdc_contains("FIFO TX: 0 underrun dari 2999 sampel"));
+    run_ms(2100);
+
+    tap(BUTTON_SELECT, 1);
+    run_ms(1000);
+    tap(BUTTON_SELECT, 1);
+    char buf[LCD_COLS + 1];
+    lcd_model_row(shim_lcd(), 1, buf);
+    unsigned pulses = 0, expected = 0;
+    bool aborted = lcd_shows("PROSES DIBATAL", buf) && sscanf(buf, "%u/%u", &pulses, &expected) == 2;
+    CASE("batal di tengah proses", aborted && pulses == expected && pulses > 100 && pulses < 390);
+    run_ms(2100);
+
+    // Protokol kendali: SET, GET, START dengan telemetri akhir
+    uint8_t msg[REMOTE_MSG_MAX];
+    size_t msg_len;
+    uint8_t set[5] = {REMOTE_PARAM_FREQ_HZ, 250, 0, 0, 0};
+    uint8_t get = REMOTE_PARAM_FREQ_HZ;
+    bool remote_ok = remote_call(REMOTE_CMD_SET, 1, set, sizeof(set), msg, &msg_len) && get_i32(msg + 4) == 250 &&
+                     remote_call(REMOTE_CMD_GET, 2, &get, 1, msg, &msg_len) && get_i32(msg + 4) == 250;
+    CASE("remote SET/GET", remote_ok);
+    bool remote_run = remote_call(REMOTE_CMD_START, 3, NULL, 0, msg, &msg_len) && msg[3] == TIMING_OK;
+    run_ms(3200);
+    remote_status_t st;
+    remote_run = remote_run && find_message(REMOTE_EV_TELEMETRY, 0, msg, &msg_len) &&
+                 remote_get_status(msg + 2, msg_len - 2, &st) && st.state == 3 && st.pulses == 750 &&
+                 st.expected == 750;
+    CASE("remote START -> telemetri", remote_run && lcd_shows("PROSES SELESAI!", "750/750 PLS"));
+    run_ms(4200);
+
+    // Modul LCD dicabut: batch dibuang (TX_ABRT), layar penuh dikirim ulang
+    shim_lcd_connect(false);
+    tap(BUTTON_DOWN, 1);
+    shim_lcd_connect(true);
+    tap(BUTTON_UP, 1);
+    uint32_t depth, high_water, aborts;
+    lcd_queue_stats(&depth, &high_water, &aborts);
+    CASE("LCD dicabut lalu pulih", aborts > 0 && lcd_shows(" MULAI PROSES", ""));
+
+    tap(BUTTON_UP, 3);
+    tap(BUTTON_SELECT, 1);
+    tap(BUTTON_UP, 1);
+    bool preset = lcd_shows("SIMPAN KE PRESET", "1 KOSONG");
+    tap(BUTTON_SELECT, 1);
+    CASE("simpan preset 1", preset && shim_cdc_contains("Preset 1 disimpan.") && lcd_shows("SIMPAN PRESET", ""));
+
+    // Dump kinerja: histogram dikosongkan saat proses remote dimulai, lalu
+    // simpan preset menambah satu commit flash (program halaman 400 us)
+    uint8_t req[2] = {PERF_FLASH, 0};
+    bool perf = remote_call(REMOTE_CMD_PERF, 4, req, 2, msg, &msg_len) && get_i32(msg + 5) == 125000000 && get_i32(msg + 9) == 1;
+    req[0] = PERF_IRQ_OFF;
+    perf = perf && remote_call(REMOTE_CMD_PERF, 5, req, 2, msg, &msg_len) && get_i32(msg + 13) >= (int32_t)SHIM_FLASH_PROGRAM_US * 125;
+    req[1] = 1 + PERF_BUCKET_PAGES;
+    perf = perf && !remote_call(REMOTE_CMD_PERF, 6, req, 2, msg, &msg_len) && msg[1] == 6 &&
+           msg[2] == REMOTE_ERR_PARAM;
+    CASE("dump kinerja", perf);
+
+    // Statistik penjadwal (dikosongkan bersama histogram): tugas tombol
+    // berjalan untuk setiap tap sejak proses remote, lalu id di luar tabel
+    uint8_t task = 0;
+    bool tasks = remote_call(REMOTE_CMD_TASKS, 7, &task, 1, msg, &msg_len) && msg_len == 4 + SCHED_PAGE_BYTES &&
+                 memcmp(msg + 4, "tombol\0\0", SCHED_NAME_MAX) == 0 && get_i32(msg + 12) > 0;
+    task = 16;
+    tasks = tasks && !remote_call(REMOTE_CMD_TASKS, 8, &task, 1, msg, &msg_len) && msg[2] == REMOTE_ERR_PARAM;
+    CASE("statistik tugas penjadwal", tasks);
+
+    // Picu eksternal: START mempersenjatai, SELECT membatalkan tanpa pulsa;
+    // proses kedua mulai pada tepi GP11 dan durasi dihitung dari picu
+    uint trigger_pin = PIN_CH1_BASE + PE_TRIGGER_IN_OFFSET;
+    uint8_t trig[5] = {REMOTE_PARAM_TRIGGER, 1, 0, 0, 0};
+    bool armed = remote_call(REMOTE_CMD_SET, 7, trig, sizeof(trig), msg, &msg_len) &&
+                 remote_call(REMOTE_CMD_START, 8, NULL, 0, msg, &msg_len) && msg[3] == TIMING_OK;
+    run_ms(1000);
+    armed = armed && lcd_shows("MENUNGGU PICU", "GP11  SEL=BATAL");
+    tap(BUTTON_SELECT, 1);
+    CASE("picu: batal saat menunggu", armed && lcd_shows("PROSES DIBATAL", "0/0 PLS"));
+    run_ms(4200);
+
+    bool triggered = remote_call(REMOTE_CMD_START, 9, NULL, 0, msg, &msg_len) && msg[3] == TIMING_OK;
+    run_ms(700);
+    shim_gpio_set(trigger_pin, true);
+    run_ms(2900);
+    triggered = triggered && lcd_shows("BERJALAN SEL=STP", " 2.8s SISA  0.1s");
+    run_ms(300);
+    triggered = triggered && find_message(REMOTE_EV_TELEMETRY, 0, msg, &msg_len) &&
+                remote_get_status(msg + 2, msg_len - 2, &st) && st.state == 3 && st.pulses == 750 &&
+                st.elapsed_ms == 3000;
+    CASE("picu: mulai pada tepi GP11", triggered && lcd_shows("PROSES SELESAI!", "750/750 PLS"));
+    shim_gpio_set(trigger_pin, false);
+    run_ms(4200);
+    trig[1] = 0;
+    remote_call(REMOTE_CMD_SET, 10, trig, sizeof(trig), msg, &msg_len);
+
+    // Tangkapan per pulsa: dua pasangan (8 us) muat sebelum event C, satu
+    // bingkai per event A dan C; 16 pasangan (64 us) melewati tepi C sehingga
+    // hanya event A yang tertangkap dan event C dihitung ADC sibuk
+    uint8_t cap[5] = {REMOTE_PARAM_CAPTURE, 2, 0, 0, 0};
+    capture_seen_t seen;
+    bool capture = remote_call(REMOTE_CMD_SET, 11, cap, sizeof(cap), msg, &msg_len) &&
+                   remote_call(REMOTE_CMD_START, 12, NULL, 0, msg, &msg_len) && msg[3] == TIMING_OK;
+    run_ms(3200);
+    capture = capture && collect_captures(&seen) && seen.pulses_a == 750 && seen.pulses_c == 750 &&
+              seen.last_dropped == 0 && shim_cdc_contains("Tangkapan: 1500 bingkai terkirim, 0 hilang");
+    CASE("tangkapan: A dan C tiap pulsa", capture);
+    run_ms(4200);
+    cap[1] = 16;
+    capture = remote_call(REMOTE_CMD_SET, 13, cap, sizeof(cap), msg, &msg_len) &&
+              remote_call(REMOTE_CMD_START, 14, NULL, 0, msg, &msg_len) && msg[3] == TIMING_OK;
+    run_ms(3200);
+    capture = capture && collect_captures(&seen) && seen.pulses_a == 750 && seen.pulses_c == 0 &&
+              seen.last_dropped == 749 && shim_cdc_contains("Tangkapan: 750 bingkai terkirim, 750 hilang (ADC sibuk 750");
+    CASE("tangkapan: event C saat ADC sibuk", capture);
+    run_ms(4200);
+    cap[1] = 0;
+    remote_call(REMOTE_CMD_SET, 15, cap, sizeof(cap), msg, &msg_len);
+
+    // Preset bipolar lewat mesin pola: tabel 4 kata dialirkan ring DMA,
+    // transfer count = 750 periode x 4 lalu kata henti
+    uint8_t prog[5] = {REMOTE_PARAM_PROGRAM, 1, 0, 0, 0};
+    shim_cdc_clear();
+    bool pattern = remote_call(REMOTE_CMD_SET, 15, prog, sizeof(prog), msg, &msg_len) &&
+                   remote_call(REMOTE_CMD_START, 16, NULL, 0, msg, &msg_len) && msg[3] == TIMING_OK;
+    run_ms(3200);
+    pattern = pattern && find_message(REMOTE_EV_TELEMETRY, 0, msg, &msg_len) &&
+              remote_get_status(msg + 2, msg_len - 2, &st) && st.state == 3 && st.pulses == 750 &&
+              st.expected == 750 && shim_cdc_contains("Program PIO: pola 4 event + DMA");
+    CASE("mesin pola: preset bipolar", pattern && lcd_shows("PROSES SELESAI!", "750/750 PLS"));
+    run_ms(4200);
+
+    // Dua pasangan independen lewat lib/channel_group.c: satu SM + ring DMA
+    // per pasangan, dilepas bersama di pin sinkron; berhenti menurut waktu
+    // (3000 ms). GP6/GP7 pada 400 Hz aktif, GP8/GP9 pada 250 Hz preset 1.
+    uint8_t fast[5] = {REMOTE_PARAM_FREQ_HZ, 0x90, 0x01, 0, 0};
+    prog[1] = 2;
+    shim_cdc_clear();
+    memset(ch_rises, 0, sizeof(ch_rises));
+    shim_pio_edges(count_rises, NULL);
+    bool pairs = remote_call(REMOTE_CMD_SET, 15, fast, sizeof(fast), msg, &msg_len) &&
+                 remote_call(REMOTE_CMD_SET, 15, prog, sizeof(prog), msg, &msg_len) &&
+                 remote_call(REMOTE_CMD_START, 16, NULL, 0, msg, &msg_len) && msg[3] == TIMING_OK;
+    run_ms(3200);
+    shim_pio_edges(NULL, NULL);
+    pairs = pairs && find_message(REMOTE_EV_TELEMETRY, 0, msg, &msg_len) &&
+            remote_get_status(msg + 2, msg_len - 2, &st) && st.state == 3 && st.pulses == 1200 &&
+            st.expected == 1200 && shim_cdc_contains("Program PIO: 2 pasangan independen, pola 4 event") &&
+            ch_rises[0] == 1200 && ch_rises[1] == 1200 && ch_rises[2] == 750 && ch_rises[3] == 750;
+    CASE("grup kanal: dua pasangan", pairs && lcd_shows("PROSES SELESAI!", "1200/1200 PLS"));
+    run_ms(4200);
+    fast[1] = 250;
+    fast[2] = 0;
+    remote_call(REMOTE_CMD_SET, 15, fast, sizeof(fast), msg, &msg_len);
+    prog[1] = 0;
+    remote_call(REMOTE_CMD_SET, 16, prog, sizeof(prog), msg, &msg_len);
+
+    // Uji mandiri dari menu 11 pada 250 Hz: clkdiv 1 hanya memuat A..C
+    // periode pertama, periode dari penghitung pulsa; VCD menyusul sebagai
+    // REMOTE_EV_LOGIC
+    static char vcd[16384];
+    size_t vcd_len;
+    shim_cdc_clear();
+    tap(BUTTON_UP, 3);
+    tap(BUTTON_SELECT, 1);
+    run_ms(100);
+    bool selftest = collect_logic(vcd, sizeof(vcd), &vcd_len) == REMOTE_LOGIC_PASS &&
+                    strncmp(vcd, "$comment 65536 sampel 8.000 ns $end", 35) == 0;
+    CASE("uji mandiri 250 Hz", selftest && lcd_shows("UJI LULUS 8.0nS", "PW3504 DT5696"));
+    run_ms(2100);
+
+    // Lewat protokol pada 50 kHz: 26 periode dalam jendela
+    uint8_t freq[5] = {REMOTE_PARAM_FREQ_HZ, 0x50, 0xc3, 0, 0};
+    selftest = remote_call(REMOTE_CMD_SET, 16, freq, sizeof(freq), msg, &msg_len) &&
+               remote_call(REMOTE_CMD_SELFTEST, 17, NULL, 0, msg, &msg_len) && msg[3] == TIMING_OK;
+    run_ms(100);
+    selftest = selftest && collect_logic(vcd, sizeof(vcd), &vcd_len) == REMOTE_LOGIC_PASS &&
+               strstr(vcd, "$enddefinitions $end\n#0\n$dumpvars\n1!\n0\"\n0#\n1$\n$end\n") != NULL;
+    CASE("remote uji mandiri 50 kHz", selftest && lcd_shows("UJI LULUS 8.0nS", "PW3504 DT5696"));
+    run_ms(2100);
+    freq[1] = 250;
+    freq[2] = 0;
+    remote_call(REMOTE_CMD_SET, 18, freq, sizeof(freq), msg, &msg_len);
+    run_ms(3200);
+
+    CASE("jeda eksekusi HD44780", shim_lcd()->timing_violations == 0);
+    return report("boot 1", cases, nc);
+}
+
+// Boot kedua dari flash yang sama: parameter dan preset bertahan
+static int boot_second(void)
+{
+    app_case_t cases[12];
+    int nc = 0;
+
+    app_init();
+    run_ms(100);
+    CASE("parameter dimuat", shim_cdc_contains("Memuat parameter dari flash") && lcd_shows("FREKUENSI", "250 Hz"));
+
+    tap(BUTTON_DOWN, 3);
+    tap(BUTTON_SELECT, 1);
+    tap(BUTTON_UP, 1);
+    CASE("ringkasan preset 1", lcd_shows("MUAT PRESET", "1 250Hz 3.5u"));
+    tap(BUTTON_SELECT, 1);
+    CASE("muat preset", shim_cdc_contains("Preset 1 dimuat.") && lcd_shows("MUAT PRESET", ""));
+
+    // Pengosongan bank (jejak bawaan shim: 400 V, tau 200 ms, silang 36 V
+    // pada 482 ms + hold 100 ms); saklar buang GP12 tetap tertutup sesudahnya
+    tap(BUTTON_DOWN, 3);
+    tap(BUTTON_SELECT, 1);
+    run_ms(200);
+    uint8_t msg[REMOTE_FRAME_MAX];
+    size_t msg_len;
+    bool busy = !remote_call(REMOTE_CMD_START, 1, NULL, 0, msg, &msg_len) && msg[2] == REMOTE_ERR_BUSY;
+    CASE("bank: progres dan kunci", busy && gpio_get(12) && lcd_shows("KOSONGKAN   69%", "147.9 V SEL=BTL"));
+    run_ms(400);
+    CASE("bank: aman", gpio_get(12) && lcd_shows("BANK AMAN", " 21.8 V  0.5s") &&
+                           shim_cdc_contains("Pengosongan bank: BANK AMAN"));
+    run_ms(4000);
+    tap(BUTTON_SELECT, 1);
+    run_ms(100);
+    tap(BUTTON_SELECT, 1);
+    CASE("bank: batal", lcd_shows("KOSONGKAN BATAL", "140.6 V  0.2s"));
+    CASE("jeda eksekusi HD44780", shim_lcd()->timing_violations == 0);
+    return report("boot 2", cases, nc);
+}
+
+// Setiap boot di proses anak: variabel statis firmware kembali ke nilai awal
+static int run_boot(int (*boot)(void), const char *flash_path, bool verbose)
+{
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        shim_cdc_echo(verbose);
+        if (!shim_flash_attach(flash_path))
+            _exit(100);
+        int failures = boot();
+        fflush(stdout);
+        _exit(failures > 99 ? 99 : failures);
+    }
+    int status;
+    if (pid < 0 || waitpid(pid, &status, 0) != pid || !WIFEXITED(status))
+        return 1;
+    return WEXITSTATUS(status);
+}
+
+static int cmd_check(int argc, char **argv)
+{
+    bool verbose = argc > 0 && strcmp(argv[0], "-v") == 0;
+    char path[] = "/tmp/mgc_app_flashXXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0)
+    {
+        perror("mkstemp");
+        return 1;
+    }
+    close(fd);
+
+    int failures = run_boot(boot_first, path, verbose);
+    failures += run_boot(boot_second, path, verbose);
+    unlink(path);
+    printf("Hasil: %s\n", failures == 0 ? "OK" : "GAGAL");
+    return failures == 0 ? 0 : 1;
+}
+
+// ===================== BENCH =====================
+static int cmd_bench(int argc, char **argv)
+{
+    uint32_t iterations = argc > 0 ? (uint32_t)strtoul(argv[0], NULL, 0) : 200000;
+    volatile uint32_t sink = 0;
+
+    shim_flash_attach(NULL);
+    app_init();
+
+    double t0 = now_ns();
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        timing_request_t req = {10 + i % 991, 100 + i % 5000, 100 + i % 5000 + i % 5000};
+        timing_plan_t plan;
+        uint32_t div;
+        timing_compile_auto(&req, 125000000u, signal_generator_counted_EVENT_OVERHEAD, &div, &plan);
+        sink += plan.delay[3];
+    }
+    double t1 = now_ns();
+
+    // Bus tetap sibuk (waktu virtual tidak maju): biaya sisi pemanggil saja,
+    // framebuffer + antrean, seperti di firmware yang tidak menunggu bus
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        menu = (uint8_t)(1 + i % 9);
+        updateMenu();
+    }
+    double t2 = now_ns();
+
+    menu = 1;
+    button_event_t up = {BUTTON_UP, BUTTON_EV_PRESS, 1};
+    for (uint32_t i = 0; i < iterations; i++)
+        handle_menu(&up);
+    double t3 = now_ns();
+
+    // Jalur tombol: tepi -> debouncer -> antrean -> loop UI
+    debounce_t d;
+    button_queue_t q;
+    debounce_init(&d, BUTTON_UP, true);
+    button_queue_init(&q);
+    uint64_t t_us = 0;
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        button_event_t ev;
+        debounce_edge(&d, (i & 1) == 0, t_us);
+        t_us += DEBOUNCE_SETTLE_US;
+        while (debounce_poll(&d, t_us, &ev))
+            button_queue_push(&q, &ev);
+        while (button_queue_pop(&q, &ev))
+            sink += ev.type;
+        t_us += 1000;
+    }
+    double t4 = now_ns();
+
+    // Driver LCD: dua baris berubah lalu satu batch DMA dikodekan
+    lcd_queue_t lq;
+    lcd_queue_init(&lq);
+    uint8_t batch[LCD_FRAME_MAX_BYTES];
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        char line[LCD_COLS + 1];
+        snprintf(line, sizeof(line), "%lu Hz", (unsigned long)(i % 1000));
+        lcd_queue_clear(&lq);
+        lcd_queue_print(&lq, 0, 0, "FREKUENSI");
+        lcd_queue_print(&lq, 1, 0, line);
+        uint32_t wait_us;
+        sink += (uint32_t)lcd_queue_next_batch(&lq, LCD_PCF_BACKLIGHT, batch, &wait_us);
+    }
+    double t5 = now_ns();
+
+    printf("Iterasi                  : %u\n", iterations);
+    printf("timing_compile_auto()    : %8.1f ns/panggilan\n", (t1 - t0) / iterations);
+    printf("updateMenu()             : %8.1f ns/panggilan\n", (t2 - t1) / iterations);
+    printf("handle_menu(UP)          : %8.1f ns/panggilan\n", (t3 - t2) / iterations);
+    printf("tombol (tepi -> event)   : %8.1f ns/tepi\n", (t4 - t3) / iterations);
+    printf("LCD (antrean + batch)    : %8.1f ns/layar\n", (t5 - t4) / iterations);
+    printf("Catatan: diukur di CPU host, hanya untuk membandingkan perubahan. Waktu bus\n"
+           "I2C tidak termasuk (dikerjakan DMA + interupsi).\n");
+    (void)sink;
+    return 0;
+}
+
+static void usage(void)
+{
+    fprintf(stderr, "Pemakaian:\n"
+                    "  mgc_app check [-v]\n"
+                    "  mgc_app group\n"
+                    "  mgc_app bench [iterasi]\n");
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        usage();
+        return 2;
+    }
+    if (strcmp(argv[1], "check") == 0)
+        return cmd_check(argc - 2, argv + 2);
+    if (strcmp(argv[1], "group") == 0)
+        return cmd_group();
+    if (strcmp(argv[1], "bench") == 0)
+        return cmd_bench(argc - 2, argv + 2);
+
+    usage();
+    return 2;
+}
@@ -0,0 +1,50 @@
+#ifndef MGC_CHECKS_H
+#define MGC_CHECKS_H
+
+/**
+ * Subperintah pemeriksaan mgc_sim, satu berkas host/check_<nama>.c per
+ * modul yang diperiksa. Kode kembali menjadi kode keluar proses (0 = lulus,
+ * dipakai ctest); deskripsi setiap perintah ada di host/mgc_sim.c.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sg_run.h"
+#include "signal_timing.h"
+
+// Opsi program untuk mgc_sim wave/sweep (host/mgc_sim.c), dipakai juga
+// pemeriksaan yang menjalankan gelombang yang sama
+typedef struct
+{
+    sg_program_t program;
+    bool legacy;
+    uint32_t resolution_ns; // 0: perencana resolusi otomatis seperti firmware
+} wave_opts_t;
+
+// Sama seperti startPulseGeneration(): divider dari perencana resolusi (atau
+// resolusi tetap 'res='), beda fasa UI diukur dari awal pulsa CH1.
+// Mengembalikan clock divider 16.8.
+uint32_t compute_delays(const wave_opts_t *o, long frekuensi, long lebarPulsa, long bedaFasa,
+                        uint32_t delays[4], timing_status_t *status);
+
+// Jam monoton host (ns) untuk microbenchmark
+double now_ns(void);
+
+int cmd_timing(void);
+int cmd_bench(int argc, char **argv);
+int cmd_lcd(void);
+int cmd_buttons(void);
+int cmd_flash(void);
+int cmd_pattern(void);
+int cmd_counter(void);
+int cmd_stop(void);
+int cmd_trigger(void);
+int cmd_unroll(void);
+int cmd_remote(void);
+int cmd_discharge(void);
+int cmd_capture(void);
+int cmd_sched(void);
+int cmd_trace(void);
+int cmd_logic(int argc, char **argv);
+
+#endif
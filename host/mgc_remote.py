@@ -0,0 +1,518 @@
+#!/usr/bin/env python3
+"""Klien protokol kendali biner MGController_RP2040 (lib/remote_proto.h).
+
+Berbicara dengan papan lewat port CDC USB (/dev/ttyACM0) atau dengan
+stand-in host `mgc_sim remote-pty`. Hanya pustaka standar Python.
+
+Log firmware tiba sebagai rekaman jejak biner (lib/trace_log.h) berisi
+alamat string format dan argumen mentah; dengan --elf string format dan
+argumen %s dibaca dari ELF firmware yang sedang berjalan dan setiap rekaman
+dicetak ke stderr sebagai satu baris teks.
+
+Contoh:
+  mgc_remote.py /dev/ttyACM0 status
+  mgc_remote.py /dev/pts/5 set freq=250 pulse=12000 phase=10000
+  mgc_remote.py /dev/ttyACM0 start --wait
+  mgc_remote.py /dev/ttyACM0 ping -n 200
+  mgc_remote.py /dev/ttyACM0 perf
+  mgc_remote.py /dev/ttyACM0 tasks
+  mgc_remote.py /dev/ttyACM0 study freq=100,500,1000 pulse=1000,5000 duration=2 > hasil.csv
+  mgc_remote.py /dev/ttyACM0 capture 16 > arus_tegangan.csv
+  mgc_remote.py /dev/ttyACM0 selftest uji.vcd
+  mgc_remote.py --elf build/MGController_RP2040.elf /dev/ttyACM0 log
+"""
+
+import argparse
+import itertools
+import os
+import re
+import select
+import struct
+import sys
+import termios
+import time
+import zlib
+
+CMD_PING, CMD_GET, CMD_SET, CMD_START, CMD_ABORT, CMD_STATUS, CMD_STREAM, CMD_PERF, CMD_TASKS, CMD_SELFTEST = range(1, 11)
+REPLY = 0x80
+EV_TELEMETRY = 0x40
+EV_CAPTURE = 0x41
+EV_TRACE = 0x42
+EV_LOGIC = 0x43
+
+RESULTS = ["OK", "PERINTAH", "PANJANG", "PARAMETER", "RENTANG", "SIBUK", "TIMING"]
+TIMING = ["OK", "FREKUENSI NOL", "FASA < PULSA", "PULSA TRLL PNDK", "PERIODE PENDEK",
+          "DILUAR RENTANG", "POLA TDK VALID"]
+STATES = ["IDLE", "CONFIGURED", "RUNNING", "DONE", "ABORTED", "ERROR", "PARKED", "ARMED"]
+PARAMS = ["freq", "pulse", "duration", "phase", "precision", "trigger", "capture", "program"]  # remote_param_t
+
+STATUS_FORMAT = "<BBIIIIIQ"  # remote_put_status()
+
+PERF_HISTS = ["loop", "lcd", "irq-off", "flash"]  # perf_hist_id_t
+PERF_SUMMARY_FORMAT = "<IIIQII"  # perf_page() halaman 0
+PERF_BUCKET_PAGES = 4  # 32 bucket log2, 8 per halaman
+
+TASK_FORMAT = "<8sIIQI"  # sched_page(): nama, jalan, maks. us, total us, latensi maks. us
+
+CAPTURE_HEADER_FORMAT = "<IIBBH"  # capture_encode(): pulse, t_us, event, pairs, dropped
+CAPTURE_EVENTS = ["A", "C"]
+
+LOGIC_HEADER_FORMAT = "<IB"  # remote_logic(): offset byte VCD, status
+LOGIC_STATUS = ["LANJUT", "LULUS", "GAGAL"]  # remote_logic_status_t
+
+TRACE_HEADER_FORMAT = "<BBH"  # trace_encode(): lebar kata, core, rekaman hilang
+# Konversi yang didukung trace_render(); pengubah panjang selain ll diabaikan
+TRACE_SPEC = re.compile(r"%([-+ 0#]*)(\d*)(?:\.(\d*))?(hh|h|ll|l|z|j|t)?([diuxXcs%])")
+
+
+def cobs_encode(data):
+    out = bytearray([0])
+    code_at, code = 0, 1
+    for b in data:
+        if b:
+            out.append(b)
+            code += 1
+        if not b or code == 0xFF:
+            out[code_at] = code
+            code_at, code = len(out), 1
+            out.append(0)
+    out[code_at] = code
+    return bytes(out)
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        i += 1
+        if code == 0 or i + code - 1 > len(data):
+            return None
+        out += data[i:i + code - 1]
+        i += code - 1
+        if code != 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+class RemoteError(Exception):
+    pass
+
+
+class ElfStrings:
+    """String C di bagian ELF yang dimuat (SHF_ALLOC), dicari menurut alamat."""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.data = f.read()
+        if self.data[:4] != b"\x7fELF" or self.data[5] != 1:
+            raise SystemExit("%s: bukan ELF little-endian" % path)
+        if self.data[4] == 2:
+            shoff, = struct.unpack_from("<Q", self.data, 0x28)
+            shentsize, shnum = struct.unpack_from("<HH", self.data, 0x3A)
+            header = "<IIQQQQ"
+        else:
+            shoff, = struct.unpack_from("<I", self.data, 0x20)
+            shentsize, shnum = struct.unpack_from("<HH", self.data, 0x2E)
+            header = "<IIIIII"
+        self.sections = []
+        for i in range(shnum):
+            _, sh_type, flags, addr, offset, size = struct.unpack_from(header, self.data, shoff + i * shentsize)
+            # SHF_ALLOC, bukan SHT_NOBITS (.bss)
+            if flags & 2 and sh_type != 8 and size:
+                self.sections.append((addr, size, offset))
+
+    def string(self, addr):
+        for base, size, offset in self.sections:
+            if base <= addr < base + size:
+                start = offset + addr - base
+                end = self.data.find(b"\0", start, offset + size)
+                return self.data[start:end if end >= 0 else offset + size].decode("utf-8", "replace")
+        return None
+
+
+def parse_trace(data):
+    """Payload REMOTE_EV_TRACE -> (core, hilang, [(t_us, alamat format, kata argumen)])."""
+    word, core, dropped = struct.unpack(TRACE_HEADER_FORMAT, data[:4])
+    word_format = "<Q" if word == 8 else "<I"
+    records = []
+    pos = 4
+    while pos + 5 <= len(data):
+        t_us, nargs = struct.unpack("<IB", data[pos:pos + 5])
+        pos += 5
+        words = [struct.unpack(word_format, data[pos + i * word:pos + (i + 1) * word])[0] for i in range(1 + nargs)]
+        pos += (1 + nargs) * word
+        records.append((t_us, words[0], words[1:]))
+    return core, dropped, word, records
+
+
+def format_trace(fmt, args, word, strings):
+    """Seperti trace_render(): konversi non-ll 32 bit, ll dari satu atau dua kata."""
+    args = list(args)
+
+    def take():
+        return args.pop(0) if args else 0
+
+    def convert(m):
+        flags, width, prec, length, conv = m.groups()
+        if conv == "%":
+            return "%"
+        if length == "ll":
+            value = take()
+            if word < 8:
+                value |= take() << 32
+            bits = 64
+        else:
+            value = take() & 0xFFFFFFFF
+            bits = 32
+        spec = "%" + flags + width + ("." + prec if prec is not None else "")
+        if conv in "di":
+            if value >> (bits - 1):
+                value -= 1 << bits
+            return (spec + "d") % value
+        if conv == "u":
+            return (spec + "d") % value
+        if conv in "xX":
+            return (spec + conv) % value
+        if conv == "c":
+            return (spec + "c") % chr(value & 0xFF)
+        text = strings.string(value) if strings else None
+        return (spec + "s") % (text if text is not None else "<0x%x>" % value)
+
+    return TRACE_SPEC.sub(convert, fmt)
+
+
+class Remote:
+    def __init__(self, path, timeout=1.0, elf=None):
+        self.fd = os.open(path, os.O_RDWR | os.O_NOCTTY)
+        attr = termios.tcgetattr(self.fd)
+        # Mode raw: tanpa echo dan tanpa terjemahan CR/LF
+        attr[0] = 0
+        attr[1] = 0
+        attr[3] = 0
+        attr[2] |= termios.CS8 | termios.CREAD | termios.CLOCAL
+        attr[6][termios.VMIN] = 0
+        attr[6][termios.VTIME] = 0
+        termios.tcsetattr(self.fd, termios.TCSANOW, attr)
+        termios.tcflush(self.fd, termios.TCIFLUSH)
+        self.timeout = timeout
+        self.seq = 0
+        self.rx = bytearray()
+        self.events = []
+        self.captures = []
+        self.log = sys.stderr
+        self.strings = ElfStrings(elf) if elf else None
+
+    def close(self):
+        os.close(self.fd)
+
+    def print_trace(self, data):
+        """Rekaman jejak -> satu baris log per rekaman (tanpa --elf: alamat dan argumen mentah)."""
+        core, dropped, word, records = parse_trace(data)
+        if dropped:
+            self.log.write("[core %u: %u rekaman jejak hilang]\n" % (core, dropped))
+        for t_us, fmt_addr, args in records:
+            fmt = self.strings.string(fmt_addr) if self.strings else None
+            if fmt is None:
+                text = "format@0x%x %s" % (fmt_addr, " ".join("0x%x" % a for a in args))
+            else:
+                text = format_trace(fmt, args, word, self.strings)
+            self.log.write("[%11.6f] %u: %s\n" % (t_us / 1e6, core, text))
+        self.log.flush()
+
+    def _messages(self, deadline):
+        """Hasilkan pesan valid sampai tenggat; jejak dan potongan lain dicetak sebagai log."""
+        while True:
+            while 0 in self.rx:
+                chunk, _, rest = self.rx.partition(b"\0")
+                self.rx = bytearray(rest)
+                if not chunk:
+                    continue
+                msg = cobs_decode(bytes(chunk))
+                if msg and len(msg) >= 6 and zlib.crc32(msg[:-4]) == struct.unpack("<I", msg[-4:])[0]:
+                    if msg[0] == EV_TRACE:
+                        self.print_trace(msg[2:-4])
+                    else:
+                        yield msg[:-4]
+                else:
+                    self.log.write(chunk.decode("latin-1"))
+            remaining = deadline - time.monotonic()
+            if remaining <= 0:
+                return
+            ready, _, _ = select.select([self.fd], [], [], remaining)
+            if ready:
+                self.rx += os.read(self.fd, 4096)
+
+    def call(self, cmd, payload=b""):
+        self.seq = (self.seq + 1) & 0xFF
+        body = bytes([cmd, self.seq]) + payload
+        os.write(self.fd, cobs_encode(body + struct.pack("<I", zlib.crc32(body))) + b"\0")
+        for msg in self._messages(time.monotonic() + self.timeout):
+            if msg[0] == EV_TELEMETRY:
+                self.events.append(parse_status(msg[2:]))
+            elif msg[0] == EV_CAPTURE:
+                self.captures.append(parse_capture(msg[2:]))
+            elif msg[0] == cmd | REPLY and msg[1] == self.seq:
+                return msg[2], msg[3:]
+        raise RemoteError("tidak ada balasan untuk perintah %d" % cmd)
+
+    def check(self, cmd, payload=b""):
+        result, data = self.call(cmd, payload)
+        if result != 0:
+            extra = " (%s)" % TIMING[data[0]] if cmd in (CMD_START, CMD_SELFTEST) and data else ""
+            raise RemoteError("ditolak: %s%s" % (RESULTS[result], extra))
+        return data
+
+    def get(self, name):
+        data = self.check(CMD_GET, bytes([PARAMS.index(name)]))
+        return struct.unpack("<i", data[1:5])[0]
+
+    def set(self, name, value):
+        data = self.check(CMD_SET, struct.pack("<Bi", PARAMS.index(name), value))
+        return struct.unpack("<i", data[1:5])[0]
+
+    def status(self):
+        return parse_status(self.check(CMD_STATUS))
+
+    def stream(self, interval_ms):
+        self.check(CMD_STREAM, struct.pack("<H", interval_ms))
+
+    def perf(self, hist):
+        """Histogram kinerja: ringkasan + 32 bucket log2 siklus clk_sys."""
+        data = self.check(CMD_PERF, bytes([hist, 0]))[2:]
+        clk_hz, count, max_cycles, total, samples, underruns = struct.unpack(PERF_SUMMARY_FORMAT, data[:28])
+        buckets = []
+        for page in range(1, PERF_BUCKET_PAGES + 1):
+            buckets += struct.unpack("<8I", self.check(CMD_PERF, bytes([hist, page]))[2:34])
+        return {"clk_hz": clk_hz, "count": count, "max_cycles": max_cycles, "total_cycles": total,
+                "fifo_samples": samples, "fifo_underruns": underruns, "buckets": buckets}
+
+    def tasks(self):
+        """Statistik tugas penjadwal core 0; id dibaca sampai ditolak."""
+        out = []
+        while True:
+            try:
+                data = self.check(CMD_TASKS, bytes([len(out)]))[1:]
+            except RemoteError:
+                if not out:
+                    raise
+                return out
+            name, runs, run_max, total, latency = struct.unpack(TASK_FORMAT, data[:struct.calcsize(TASK_FORMAT)])
+            out.append({"name": name.rstrip(b"\0").decode(), "runs": runs, "run_max_us": run_max,
+                        "run_total_us": total, "latency_max_us": latency})
+
+    def wait_done(self, on_event=None):
+        """Tunggu event telemetri akhir (DONE/ABORTED)."""
+        while True:
+            while self.events:
+                ev = self.events.pop(0)
+                if on_event:
+                    on_event(ev)
+                if ev["state"] not in ("RUNNING", "ARMED"):
+                    return ev
+            for msg in self._messages(time.monotonic() + 0.5):
+                if msg[0] == EV_CAPTURE:
+                    self.captures.append(parse_capture(msg[2:]))
+                elif msg[0] == EV_TELEMETRY:
+                    self.events.append(parse_status(msg[2:]))
+                    break
+
+    def selftest(self, timeout=10.0):
+        """Uji mandiri penganalisis logika: (status akhir, teks VCD)."""
+        self.check(CMD_SELFTEST)
+        vcd = bytearray()
+        deadline = time.monotonic() + timeout
+        while time.monotonic() < deadline:
+            for msg in self._messages(min(deadline, time.monotonic() + 0.5)):
+                if msg[0] != EV_LOGIC:
+                    continue
+                offset, status = struct.unpack(LOGIC_HEADER_FORMAT, msg[2:7])
+                if offset != len(vcd):
+                    raise RemoteError("potongan VCD hilang (offset %u, diharapkan %u)" % (offset, len(vcd)))
+                vcd += msg[7:]
+                if status != 0:
+                    return LOGIC_STATUS[status], bytes(vcd)
+        raise RemoteError("hasil uji mandiri tidak tiba")
+
+
+def parse_status(data):
+    fields = struct.unpack(STATUS_FORMAT, data[:struct.calcsize(STATUS_FORMAT)])
+    state = STATES[fields[0]] if fields[0] < len(STATES) else str(fields[0])
+    return {
+        "state": state,
+        "timing": TIMING[fields[1]] if fields[1] < len(TIMING) else str(fields[1]),
+        "elapsed_ms": fields[2],
+        "duration_ms": fields[3],
+        "pulses": fields[4],
+        "expected": fields[5],
+        "mean_period_ns": fields[6],
+        "on_time_ns": fields[7],
+    }
+
+
+def parse_capture(data):
+    """Bingkai tangkapan (lib/capture_frame.h): sampel I0, V0, I1, V1, ..."""
+    pulse, t_us, event, pairs, dropped = struct.unpack(CAPTURE_HEADER_FORMAT, data[:12])
+    pos = 12
+    samples = list(struct.unpack("<HH", data[pos:pos + 4]))
+    pos += 4
+    for i in range(2, 2 * pairs):
+        z = data[pos]
+        pos += 1
+        if z & 0x80:
+            z = (z & 0x7F) | (data[pos] << 7)
+            pos += 1
+        # Zigzag -> selisih terhadap sampel kanal yang sama sebelumnya
+        samples.append(samples[i - 2] + ((z >> 1) if not z & 1 else -((z + 1) >> 1)))
+    return {"pulse": pulse, "t_us": t_us, "event": CAPTURE_EVENTS[event], "dropped": dropped,
+            "current": samples[0::2], "voltage": samples[1::2]}
+
+
+def print_status(st):
+    print("%-8s %6u/%u ms  pulsa %u/%u  periode %u ns  ON %u ns  (%s)" % (
+        st["state"], st["elapsed_ms"], st["duration_ms"], st["pulses"], st["expected"],
+        st["mean_period_ns"], st["on_time_ns"], st["timing"]))
+
+
+def print_perf(name, h):
+    us = 1e6 / h["clk_hz"]
+    mean = h["total_cycles"] / h["count"] if h["count"] else 0
+    print("%-8s %7u kali  rata-rata %9.1f us  maks %9.1f us" % (
+        name, h["count"], mean * us, h["max_cycles"] * us))
+    for b, n in enumerate(h["buckets"]):
+        if n:
+            print("    %10.2f .. %10.2f us  %u" % ((1 << b) * us, (2 << b) * us, n))
+
+
+def parse_assignments(items):
+    out = []
+    for item in items:
+        name, _, value = item.partition("=")
+        if name not in PARAMS:
+            raise SystemExit("parameter tidak dikenal: %s (pilihan: %s)" % (name, ", ".join(PARAMS)))
+        out.append((name, [int(v) for v in value.split(",")]))
+    return out
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--elf", help="ELF firmware untuk memformat log jejak")
+    ap.add_argument("port")
+    sub = ap.add_subparsers(dest="cmd", required=True)
+    sub.add_parser("status")
+    p = sub.add_parser("get")
+    p.add_argument("names", nargs="*", default=PARAMS)
+    p = sub.add_parser("set")
+    p.add_argument("items", nargs="+", metavar="NAMA=NILAI")
+    p = sub.add_parser("start")
+    p.add_argument("--wait", action="store_true", help="tunggu selesai dan tampilkan telemetri")
+    p.add_argument("--stream", type=int, default=200, metavar="MS")
+    sub.add_parser("abort")
+    sub.add_parser("perf", help="histogram kinerja dan underrun FIFO")
+    sub.add_parser("tasks", help="waktu jalan dan latensi dispatch tiap tugas penjadwal")
+    p = sub.add_parser("ping")
+    p.add_argument("-n", type=int, default=100)
+    p = sub.add_parser("study", help="jalankan setiap kombinasi dan cetak CSV")
+    p.add_argument("items", nargs="+", metavar="NAMA=N1,N2,...")
+    p = sub.add_parser("capture", help="jalankan proses dan cetak sampel arus/tegangan per pulsa sebagai CSV")
+    p.add_argument("pairs", type=int, help="pasangan I/V per event A/C (1-64)")
+    p = sub.add_parser("selftest", help="uji mandiri penganalisis logika internal, simpan VCD")
+    p.add_argument("vcd", nargs="?", help="berkas keluaran VCD")
+    p = sub.add_parser("log", help="tampilkan log jejak firmware sampai Ctrl-C")
+    p.add_argument("--seconds", type=float, default=None, help="berhenti setelah sekian detik")
+    args = ap.parse_args()
+
+    r = Remote(args.port, elf=args.elf)
+    try:
+        if args.cmd == "status":
+            print_status(r.status())
+        elif args.cmd == "get":
+            for name in args.names:
+                print("%s=%d" % (name, r.get(name)))
+        elif args.cmd == "set":
+            for name, values in parse_assignments(args.items):
+                print("%s=%d" % (name, r.set(name, values[0])))
+        elif args.cmd == "start":
+            if args.wait:
+                r.stream(args.stream)
+            print("timing: %s" % TIMING[r.check(CMD_START)[0]])
+            if args.wait:
+                r.wait_done(print_status)
+        elif args.cmd == "abort":
+            r.check(CMD_ABORT)
+        elif args.cmd == "perf":
+            for i, name in enumerate(PERF_HISTS):
+                h = r.perf(i)
+                print_perf(name, h)
+            print("FIFO TX: %u underrun dari %u sampel" % (h["fifo_underruns"], h["fifo_samples"]))
+        elif args.cmd == "tasks":
+            for t in r.tasks():
+                mean = t["run_total_us"] / t["runs"] if t["runs"] else 0
+                print("%-8s %7u kali  rata-rata %7.1f us  maks %6u us  latensi maks %6u us" % (
+                    t["name"], t["runs"], mean, t["run_max_us"], t["latency_max_us"]))
+        elif args.cmd == "ping":
+            rtt = []
+            for i in range(args.n):
+                t0 = time.perf_counter()
+                r.check(CMD_PING, bytes([i & 0xFF]) * 8)
+                rtt.append((time.perf_counter() - t0) * 1e6)
+            rtt.sort()
+            print("RTT %d ping: min %.0f us, median %.0f us, p99 %.0f us, maks %.0f us" % (
+                len(rtt), rtt[0], rtt[len(rtt) // 2], rtt[int(len(rtt) * 0.99)], rtt[-1]))
+        elif args.cmd == "study":
+            grid = parse_assignments(args.items)
+            names = [n for n, _ in grid]
+            print(",".join(names + ["state", "timing", "pulses", "expected", "mean_period_ns", "on_time_ns"]))
+            r.stream(0)
+            for combo in itertools.product(*[v for _, v in grid]):
+                for name, value in zip(names, combo):
+                    r.set(name, value)
+                result, data = r.call(CMD_START)
+                if result == 0:
+                    st = r.wait_done()
+                else:
+                    st = {"state": RESULTS[result], "timing": TIMING[data[0]] if data else "",
+                          "pulses": 0, "expected": 0, "mean_period_ns": 0, "on_time_ns": 0}
+                print(",".join([str(v) for v in combo] + [st["state"], st["timing"]] +
+                               [str(st[k]) for k in ("pulses", "expected", "mean_period_ns", "on_time_ns")]))
+                sys.stdout.flush()
+        elif args.cmd == "capture":
+            r.set("capture", args.pairs)
+            r.stream(0)
+            try:
+                r.check(CMD_START)
+                st = r.wait_done()
+            finally:
+                r.set("capture", 0)
+            print("pulse,event,t_us,index,current,voltage")
+            for f in r.captures:
+                for i, (cur, volt) in enumerate(zip(f["current"], f["voltage"])):
+                    print("%u,%s,%u,%u,%u,%u" % (f["pulse"], f["event"], f["t_us"], i, cur, volt))
+            dropped = r.captures[-1]["dropped"] if r.captures else 0
+            sys.stderr.write("%s: %u bingkai, %u hilang sebelum bingkai terakhir\n" % (
+                st["state"], len(r.captures), dropped))
+        elif args.cmd == "selftest":
+            status, vcd = r.selftest()
+            if args.vcd:
+                with open(args.vcd, "wb") as f:
+                    f.write(vcd)
+            print("uji mandiri: %s (%u byte VCD)" % (status, len(vcd)))
+            if status != "LULUS":
+                raise SystemExit(1)
+        elif args.cmd == "log":
+            end = time.monotonic() + args.seconds if args.seconds is not None else float("inf")
+            try:
+                while time.monotonic() < end:
+                    # Pesan lain (telemetri, tangkapan) tidak ditampilkan di sini
+                    for _ in r._messages(min(end, time.monotonic() + 1.0)):
+                        pass
+            except KeyboardInterrupt:
+                pass
+    except RemoteError as e:
+        raise SystemExit(str(e))
+    finally:
+        r.close()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,484 @@
+/**
+ * Alat host untuk MGController_RP2040 (Linux)
+ *
+ * Perintah:
+ *   mgc_sim feed A B C D [clkdiv] [periode] [reload]
+ *       Jalankan model umpan DMA ring -> TX FIFO -> SM untuk nilai delay
+ *       A..D (plan.delay dari timing_compile) dan laporkan underrun FIFO,
+ *       jumlah re-trigger chain serta integritas urutan kata.
+ *
+ *   mgc_sim wave FREKUENSI LEBAR_PULSA BEDA_FASA [static|dynamic|pattern] [OPSI...]
+ *       Hitung delay dengan timing_compile_auto() seperti startPulseGeneration()
+ *       lalu jalankan program PIO di simulator; cetak setiap tepi GP6-GP9
+ *       beserta timestamp dan hasil pengukuran.
+ *
+ *   mgc_sim sweep [static|dynamic|pattern] [OPSI...] [csv=FILE]
+ *       Sapu ruang parameter UI program loop (10-1000 Hz, lebar pulsa
+ *       100-50000 ns, beda fasa 100-10000 ns) dan laporkan galat terburuk
+ *       periode, lebar pulsa dan dead time terhadap nilai yang diminta.
+ *       Rentang kHz (program terurai) diperiksa oleh "mgc_sim unroll".
+ *
+ *   mgc_sim timing
+ *       Periksa timing_compile() terhadap perhitungan referensi 128-bit untuk
+ *       seluruh ruang parameter UI dan kasus batas (status dan nilai N).
+ *
+ *   mgc_sim bench [iterasi]
+ *       Bandingkan biaya per panggilan jalur float lama (legacy_timing.c)
+ *       dengan timing_compile() di host.
+ *
+ *   mgc_sim lcd
+ *       Model I2C + PCF8574 + HD44780: bandingkan byte, transaksi dan waktu
+ *       bus per pembaruan layar antara driver lama dan framebuffer bayangan
+ *       (lib/lcd_frame.c), serta periksa isi DDRAM dan jeda eksekusi.
+ *       Juga memodelkan antrean asinkron (lib/lcd_queue.c): pembaruan lebih
+ *       cepat dari bus digabung, kedalaman puncak antrean dilaporkan.
+ *
+ *   mgc_sim buttons
+ *       Jalankan jejak pantulan/EMI sintetis melalui debouncer tombol
+ *       (lib/button_debounce.c): jumlah event, latensi, langkah auto-repeat
+ *       dan antrean event.
+ *
+ *   mgc_sim flash
+ *       Emulator NOR flash untuk penyimpanan parameter berbasis log
+ *       (lib/param_store.c): jumlah erase per sektor dibanding skema lama
+ *       (erase tiap simpan) dan pemulihan dari tulis/erase yang terputus.
+ *
+ *   mgc_sim pattern
+ *       Susun pola N-event (lib/pattern.c) untuk topologi unipolar, bergiliran,
+ *       bipolar asimetris dan burst, alirkan tabelnya ke pattern_engine dan
+ *       periksa setiap tepi GP6-GP9 terhadap tabel; juga validasi pembangun.
+ *
+ *   mgc_sim counter
+ *       SM pulse_counter/pulse_span (pulse_counter.pio) mengamati CH1 selama
+ *       jalan yang dihentikan di tengah pulsa: jumlah pulsa harus eksak,
+ *       waktu ON dan periode rata-rata dalam resolusi penghitung.
+ *
+ *   mgc_sim stop
+ *       Proses terhitung (signal_generator_counted, mesin pola dengan kata
+ *       henti) untuk 1..250 periode: jumlah pulsa CH1 eksak, pin akhir LOW,
+ *       titik henti pada jarak tetap dari batas periode; juga konversi
+ *       durasi -> jumlah periode.
+ *
+ *   mgc_sim trigger
+ *       Picu eksternal: signal_generator_counted menunggu pin picu masuk;
+ *       latensi tepi picu -> tepi naik CH1 pertama dan jitternya untuk
+ *       setiap fasa picu pada beberapa clkdiv, serta picu keluar yang harus
+ *       sejajar dengan CH1.
+ *
+ *   mgc_sim unroll
+ *       Program terurai frekuensi tinggi (lib/pio_unroll.c): kode mesin
+ *       terhadap pioasm, pilihan program terurai/loop untuk 1-500 kHz pada
+ *       125/250 MHz, setiap tepi eksak terhadap rencana, berhenti tepat di
+ *       batas periode setelah 1..7 periode, dan latensi picu eksternal.
+ *
+ *   mgc_sim remote
+ *       Protokol kendali biner (lib/remote_proto.c) terhadap perangkat
+ *       tiruan: COBS, setiap perintah, bit rusak, serta teks printf dan
+ *       sampah di sela bingkai yang tiba terpotong-potong.
+ *
+ *   mgc_sim remote-pty
+ *       Stand-in papan: layani protokol di pseudo-terminal agar klien host
+ *       (host/mgc_remote.py) dapat diuji di Linux tanpa perangkat keras.
+ *
+ *   mgc_sim discharge
+ *       Pemantau pengosongan bank (lib/bank_monitor.c) atas jejak ADC tiruan
+ *       (host/adc_trace.c): peluruhan RC bersih, derau, lonjakan EMI,
+ *       resistor buang putus dan bank yang sudah aman pada beberapa laju
+ *       sampel; waktu selesai terhadap titik silang analitik + hold.
+ *
+ *   mgc_sim capture
+ *       Tangkapan arus/tegangan per pulsa: flag IRQ tangkapan
+ *       signal_generator_counted terhadap tepi CH1/CH2, kode delta
+ *       (lib/capture_frame.c) pulang-pergi lewat bingkai REMOTE_EV_CAPTURE,
+ *       dan aliran ISR -> ring -> loop core 0 dengan model beban
+ *       (host/adc_trace.c): bingkai hilang karena ADC sibuk / ring penuh dan
+ *       laju CDC terhadap anggaran kirim per putaran.
+ *
+ *   mgc_sim sched
+ *       Penjadwal kooperatif loop core 0 (lib/scheduler.c) dengan jam
+ *       virtual: urutan tenggat, tugas periodik, post dari interupsi,
+ *       statistik waktu jalan/latensi dan halaman REMOTE_CMD_TASKS, serta
+ *       latensi tombol terburuk terhadap super-loop lama dengan sleep 50 ms.
+ *
+ *   mgc_sim trace
+ *       Log jejak biner (lib/trace_log.c): rekaman TRACE() pulang-pergi
+ *       lewat bingkai REMOTE_EV_TRACE dan diformat di host sama dengan
+ *       snprintf, interupsi yang menyela penulis, ring penuh, serta biaya
+ *       per rekaman terhadap snprintf.
+ *
+ *   mgc_sim logic [vcd=FILE]
+ *       Penganalisis logika uji mandiri (lib/logic_analysis.c): RLE
+ *       pulang-pergi, pengukuran jejak sintetis dengan kesalahan yang
+ *       disuntikkan (lebar salah, status tumpang tindih, C hilang), VCD
+ *       bertahap yang dibaca ulang, dan logic_analyzer.pio di samping
+ *       generator pada simulator PIO untuk 50 Hz-500 kHz di 125/250 MHz.
+ *       vcd=FILE menyimpan tangkapan 20 kHz untuk penampil gelombang.
+ *
+ * OPSI:
+ *   legacy   jalur float lama (resolusi 100 ns) sebagai pembanding
+ *   res=NS   resolusi tetap alih-alih perencana resolusi otomatis
+ *   clk=KHZ  clk_sys yang dimodelkan (250000 untuk mode presisi tinggi)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "feed_model.h"
+#include "legacy_timing.h"
+#include "mgc_checks.h"
+#include "pattern.h"
+#include "pio_sim.h"
+#include "remote_dev.h"
+#include "sg_run.h"
+#include "signal_timing.h"
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "Pemakaian:\n"
+            "  mgc_sim feed A B C D [clkdiv] [periode] [reload]\n"
+            "  mgc_sim wave FREKUENSI LEBAR_PULSA BEDA_FASA [static|dynamic|pattern] [legacy] [res=NS] [clk=KHZ]\n"
+            "  mgc_sim sweep [static|dynamic|pattern] [legacy] [res=NS] [clk=KHZ] [csv=FILE]\n"
+            "  mgc_sim timing\n"
+            "  mgc_sim bench [iterasi]\n"
+            "  mgc_sim lcd\n"
+            "  mgc_sim buttons\n"
+            "  mgc_sim flash\n"
+            "  mgc_sim pattern\n"
+            "  mgc_sim counter\n"
+            "  mgc_sim stop\n"
+            "  mgc_sim trigger\n"
+            "  mgc_sim unroll\n"
+            "  mgc_sim remote\n"
+            "  mgc_sim remote-pty\n"
+            "  mgc_sim discharge\n"
+            "  mgc_sim capture\n"
+            "  mgc_sim sched\n"
+            "  mgc_sim trace\n"
+            "  mgc_sim logic [vcd=FILE]\n");
+}
+
+static int cmd_feed(int argc, char **argv)
+{
+    if (argc < 4)
+    {
+        usage();
+        return 2;
+    }
+
+    static uint32_t ring[4] __attribute__((aligned(16)));
+    for (int i = 0; i < 4; i++)
+        ring[i] = (uint32_t)strtoul(argv[i], NULL, 0);
+    uint32_t clkdiv = argc > 4 ? (uint32_t)strtoul(argv[4], NULL, 0) : 1;
+    uint32_t periods = argc > 5 ? (uint32_t)strtoul(argv[5], NULL, 0) : 1000;
+    uint32_t reload = argc > 6 ? (uint32_t)strtoul(argv[6], NULL, 0) : 0x10000;
+
+    pio_fifo_model_t fifo;
+    dma_ring_model_t dma;
+    sm_feed_consumer_t smc;
+    pio_fifo_model_init(&fifo, 4);
+    dma_ring_model_init(&dma, ring, 4, reload);
+    sm_feed_consumer_init(&smc, clkdiv, sg_event_overhead(SG_PROGRAM_DYNAMIC));
+
+    // Sama seperti firmware: DMA dimulai sebelum SM diaktifkan
+    dma_ring_model_start(&dma);
+    for (int i = 0; i < 16; i++)
+        dma_ring_model_step(&dma, &fifo);
+
+    uint64_t cycles = 0;
+    while (smc.periods < periods)
+    {
+        dma_ring_model_step(&dma, &fifo);
+        sm_feed_consumer_step(&smc, &fifo, ring, 4);
+        cycles++;
+    }
+    dma_ring_model_abort(&dma);
+
+    printf("Delays       : A=%u B=%u C=%u D=%u (clkdiv %u)\n",
+           ring[0], ring[1], ring[2], ring[3], clkdiv);
+    printf("Periode      : %u (%llu siklus clk_sys)\n", smc.periods, (unsigned long long)cycles);
+    printf("Kata DMA     : %llu, re-trigger chain: %u\n",
+           (unsigned long long)dma.words_transferred, dma.retriggers);
+    printf("FIFO min     : %u kata saat pull\n", smc.min_level);
+    printf("Underrun     : %u (%llu siklus stall)\n", smc.underruns,
+           (unsigned long long)smc.stall_cycles);
+    printf("Urutan salah : %u\n", smc.order_errors);
+
+    return (smc.underruns == 0 && smc.order_errors == 0) ? 0 : 1;
+}
+
+double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void parse_opt(wave_opts_t *o, const char *arg)
+{
+    if (strncmp(arg, "res=", 4) == 0)
+        o->resolution_ns = (uint32_t)strtoul(arg + 4, NULL, 0);
+    else if (strncmp(arg, "clk=", 4) == 0)
+        sg_sys_clk_hz = (uint32_t)strtoul(arg + 4, NULL, 0) * 1000u;
+    else if (strcmp(arg, "dynamic") == 0)
+        o->program = SG_PROGRAM_DYNAMIC;
+    else if (strcmp(arg, "static") == 0)
+        o->program = SG_PROGRAM_STATIC;
+    else if (strcmp(arg, "pattern") == 0)
+        o->program = SG_PROGRAM_PATTERN;
+    else if (strcmp(arg, "legacy") == 0)
+        o->legacy = true;
+}
+
+static double cycles_to_ns(uint64_t cycles)
+{
+    return cycles * 1e9 / sg_sys_clk_hz;
+}
+
+uint32_t compute_delays(const wave_opts_t *o, long frekuensi, long lebarPulsa, long bedaFasa,
+                               uint32_t delays[4], timing_status_t *status)
+{
+    uint32_t overhead = sg_event_overhead(o->program);
+
+    if (o->legacy)
+    {
+        float sys_clk_hz = sg_sys_clk_hz;
+        float pio_clk_div = legacy_clkdiv_for_resolution(sys_clk_hz, 100.0f); // Resolusi lama
+        legacy_calculate_delays(sys_clk_hz, pio_clk_div, overhead,
+                                &delays[0], &delays[1], &delays[2], &delays[3],
+                                (float)frekuensi, (float)lebarPulsa, (float)bedaFasa - (float)lebarPulsa);
+        *status = bedaFasa < lebarPulsa ? TIMING_ERR_PHASE_LT_PULSE : TIMING_OK;
+        if (o->program == SG_PROGRAM_PATTERN)
+        {
+            static const uint8_t masks[4] = {0x9, 0x0, 0x6, 0x0};
+            for (int i = 0; i < 4; i++)
+                delays[i] = PATTERN_WORD(masks[i], delays[i]);
+        }
+        return pio_sim_clkdiv_fixed(pio_clk_div);
+    }
+
+    uint32_t clkdiv_fixed;
+    timing_request_t req = {(uint32_t)frekuensi, (uint32_t)lebarPulsa, (uint32_t)bedaFasa};
+    timing_plan_t plan;
+    if (o->resolution_ns)
+    {
+        clkdiv_fixed = timing_clkdiv_for_resolution(sg_sys_clk_hz, o->resolution_ns);
+        *status = timing_compile(&req, sg_sys_clk_hz, clkdiv_fixed, overhead, &plan);
+    }
+    else
+    {
+        *status = timing_compile_auto(&req, sg_sys_clk_hz, overhead, &clkdiv_fixed, &plan);
+    }
+    memcpy(delays, plan.delay, sizeof(plan.delay));
+
+    // Mesin pola: preset bipolar disusun pada divider yang sama, seperti
+    // compile_pattern() di lib/pulse_engine.c; 'delays' berisi kata tabel
+    if (o->program == SG_PROGRAM_PATTERN && *status == TIMING_OK)
+    {
+        static pattern_t preset;
+        static pattern_table_t table;
+        *status = pattern_bipolar(&preset, &req);
+        if (*status == TIMING_OK)
+            *status = pattern_compile(&preset, sg_sys_clk_hz, clkdiv_fixed, overhead, &table);
+        if (*status == TIMING_OK && table.length != 4)
+            *status = TIMING_ERR_PATTERN;
+        if (*status == TIMING_OK)
+            memcpy(delays, table.words, 4 * sizeof(uint32_t));
+    }
+    return clkdiv_fixed;
+}
+
+static int cmd_wave(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        usage();
+        return 2;
+    }
+    long frekuensi = strtol(argv[0], NULL, 0);
+    long lebarPulsa = strtol(argv[1], NULL, 0);
+    long bedaFasa = strtol(argv[2], NULL, 0);
+    wave_opts_t opts = {SG_PROGRAM_STATIC, false, 0};
+    for (int i = 3; i < argc; i++)
+        parse_opt(&opts, argv[i]);
+    sg_program_t program = opts.program;
+
+    uint32_t delays[4];
+    timing_status_t status;
+    uint32_t clkdiv_fixed = compute_delays(&opts, frekuensi, lebarPulsa, bedaFasa, delays, &status);
+    printf("Delays: A=%u B=%u C=%u D=%u, clkdiv %u+%u/256, status %s\n",
+           delays[0], delays[1], delays[2], delays[3], clkdiv_fixed >> 8, clkdiv_fixed & 0xff,
+           timing_status_str(status));
+
+    sg_edges_t edges = {.trace = stdout};
+    uint64_t limit = (uint64_t)sg_sys_clk_hz * 3 / (frekuensi > 0 ? frekuensi : 1) + 1000000;
+    bool ok = sg_simulate(program, delays, clkdiv_fixed, 2, limit, &edges);
+
+    sg_measure_t m;
+    if (!ok || !sg_measure(&edges, &m))
+    {
+        printf("Gelombang tidak lengkap dalam %llu siklus\n", (unsigned long long)limit);
+        return 1;
+    }
+    printf("Periode     : %.1f .. %.1f ns (diminta %.1f)\n",
+           cycles_to_ns(m.period_min), cycles_to_ns(m.period_max), 1e9 / frekuensi);
+    printf("Lebar pulsa : %.1f .. %.1f ns (diminta %ld)\n",
+           cycles_to_ns(m.pulse_min), cycles_to_ns(m.pulse_max), lebarPulsa);
+    printf("Dead time   : %.1f .. %.1f ns (diminta %ld)\n",
+           cycles_to_ns(m.dead_min), cycles_to_ns(m.dead_max), bedaFasa - lebarPulsa);
+    return 0;
+}
+
+typedef struct
+{
+    double err;
+    long f, pw, ph;
+} worst_t;
+
+static void track_worst(worst_t *w, double measured_min, double measured_max, double requested,
+                        long f, long pw, long ph)
+{
+    double e1 = measured_min - requested;
+    double e2 = measured_max - requested;
+    double e = (e1 < 0 ? -e1 : e1) > (e2 < 0 ? -e2 : e2) ? e1 : e2;
+    if ((e < 0 ? -e : e) > (w->err < 0 ? -w->err : w->err))
+        *w = (worst_t){e, f, pw, ph};
+}
+
+static int cmd_sweep(int argc, char **argv)
+{
+    wave_opts_t opts = {SG_PROGRAM_STATIC, false, 0};
+    FILE *csv = NULL;
+    for (int i = 0; i < argc; i++)
+    {
+        if (strncmp(argv[i], "csv=", 4) == 0)
+            csv = fopen(argv[i] + 4, "w");
+        else
+            parse_opt(&opts, argv[i]);
+    }
+    sg_program_t program = opts.program;
+    if (csv)
+        fprintf(csv, "frekuensi,lebar_pulsa,beda_fasa,periode_min,periode_max,pulsa_min,pulsa_max,dead_min,dead_max\n");
+
+    worst_t w_period = {0}, w_pulse = {0}, w_dead = {0};
+    uint32_t points = 0, infeasible = 0, failed = 0;
+
+    // Rentang program loop di handle_menu() (langkah 10 Hz / 100 ns)
+    for (long f = 10; f <= 1000; f += 10)
+    {
+        for (long pw = 100; pw <= 50000; pw += 100)
+        {
+            for (long ph = 100; ph <= 10000; ph += 100)
+            {
+                points++;
+
+                // Dead time negatif tidak dapat dibentuk oleh sekuens
+                // 1001/0000/0110/0000; firmware menolak titik ini
+                uint32_t delays[4];
+                timing_status_t status;
+                uint32_t clkdiv_fixed = compute_delays(&opts, f, pw, ph, delays, &status);
+                if (status != TIMING_OK)
+                {
+                    infeasible++;
+                    continue;
+                }
+                sg_edges_t edges = {0};
+                uint64_t limit = (uint64_t)sg_sys_clk_hz * 4 / f;
+                sg_measure_t m;
+                if (!sg_simulate(program, delays, clkdiv_fixed, 2, limit, &edges) ||
+                    !sg_measure(&edges, &m))
+                {
+                    failed++;
+                    continue;
+                }
+
+                track_worst(&w_period, cycles_to_ns(m.period_min), cycles_to_ns(m.period_max),
+                            1e9 / f, f, pw, ph);
+                track_worst(&w_pulse, cycles_to_ns(m.pulse_min), cycles_to_ns(m.pulse_max),
+                            pw, f, pw, ph);
+                track_worst(&w_dead, cycles_to_ns(m.dead_min), cycles_to_ns(m.dead_max),
+                            ph - pw, f, pw, ph);
+                if (csv)
+                    fprintf(csv, "%ld,%ld,%ld,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f\n", f, pw, ph,
+                            cycles_to_ns(m.period_min), cycles_to_ns(m.period_max),
+                            cycles_to_ns(m.pulse_min), cycles_to_ns(m.pulse_max),
+                            cycles_to_ns(m.dead_min), cycles_to_ns(m.dead_max));
+            }
+        }
+    }
+    if (csv)
+        fclose(csv);
+
+    char mode[40];
+    if (opts.legacy)
+        snprintf(mode, sizeof(mode), "jalur float lama");
+    else if (opts.resolution_ns)
+        snprintf(mode, sizeof(mode), "resolusi tetap %u ns", opts.resolution_ns);
+    else
+        snprintf(mode, sizeof(mode), "perencana resolusi");
+    printf("Program      : %s, clk_sys %u Hz, %s\n",
+           program == SG_PROGRAM_STATIC    ? "signal_generator_static"
+           : program == SG_PROGRAM_PATTERN ? "pattern_engine (tabel pola)"
+                                           : "signal_generator (FIFO)",
+           sg_sys_clk_hz, mode);
+    printf("Titik        : %u total, %u disimulasikan, %u tidak valid (status != OK), %u gagal\n",
+           points, points - infeasible - failed, infeasible, failed);
+    printf("Galat terburuk (ns, terukur - diminta):\n");
+    printf("  Periode     : %+10.1f  @ %ld Hz, %ld ns, %ld ns\n", w_period.err, w_period.f, w_period.pw, w_period.ph);
+    printf("  Lebar pulsa : %+10.1f  @ %ld Hz, %ld ns, %ld ns\n", w_pulse.err, w_pulse.f, w_pulse.pw, w_pulse.ph);
+    printf("  Dead time   : %+10.1f  @ %ld Hz, %ld ns, %ld ns\n", w_dead.err, w_dead.f, w_dead.pw, w_dead.ph);
+    return failed == 0 ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        usage();
+        return 2;
+    }
+    if (strcmp(argv[1], "feed") == 0)
+        return cmd_feed(argc - 2, argv + 2);
+    if (strcmp(argv[1], "wave") == 0)
+        return cmd_wave(argc - 2, argv + 2);
+    if (strcmp(argv[1], "sweep") == 0)
+        return cmd_sweep(argc - 2, argv + 2);
+    if (strcmp(argv[1], "timing") == 0)
+        return cmd_timing();
+    if (strcmp(argv[1], "bench") == 0)
+        return cmd_bench(argc - 2, argv + 2);
+    if (strcmp(argv[1], "lcd") == 0)
+        return cmd_lcd();
+    if (strcmp(argv[1], "buttons") == 0)
+        return cmd_buttons();
+    if (strcmp(argv[1], "flash") == 0)
+        return cmd_flash();
+    if (strcmp(argv[1], "pattern") == 0)
+        return cmd_pattern();
+    if (strcmp(argv[1], "stop") == 0)
+        return cmd_stop();
+    if (strcmp(argv[1], "trigger") == 0)
+        return cmd_trigger();
+    if (strcmp(argv[1], "unroll") == 0)
+        return cmd_unroll();
+    if (strcmp(argv[1], "counter") == 0)
+        return cmd_counter();
+    if (strcmp(argv[1], "remote") == 0)
+        return cmd_remote();
+    if (strcmp(argv[1], "discharge") == 0)
+        return cmd_discharge();
+    if (strcmp(argv[1], "capture") == 0)
+        return cmd_capture();
+    if (strcmp(argv[1], "sched") == 0)
+        return cmd_sched();
+    if (strcmp(argv[1], "trace") == 0)
+        return cmd_trace();
+    if (strcmp(argv[1], "logic") == 0)
+        return cmd_logic(argc - 2, argv + 2);
+    if (strcmp(argv[1], "remote-pty") == 0)
+        return remote_dev_serve_pty();
+
+    usage();
+    return 2;
+}
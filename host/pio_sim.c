@@ -0,0 +1,644 @@
+#include "pio_sim.h"
+#include <string.h>
+
+enum
+{
+    EXEC_DONE,
+    EXEC_JUMPED,
+    EXEC_STALL,
+};
+
+static uint32_t rotr32(uint32_t v, uint32_t n)
+{
+    n &= 31;
+    return n ? (v >> n) | (v << (32 - n)) : v;
+}
+
+static uint32_t bitrev32(uint32_t v)
+{
+    uint32_t r = 0;
+    for (int i = 0; i < 32; i++)
+    {
+        r = (r << 1) | (v & 1);
+        v >>= 1;
+    }
+    return r;
+}
+
+// Bit FDEBUG SM yang stall di FIFO (TXSTALL / RXSTALL)
+static uint32_t txstall_bit(const pio_sim_sm_t *sm)
+{
+    return 1u << (24 + sm->index % 4);
+}
+
+static uint32_t rxstall_bit(const pio_sim_sm_t *sm)
+{
+    return 1u << (sm->index % 4);
+}
+
+static uint32_t range_mask(uint32_t base, uint32_t count)
+{
+    uint32_t m = 0;
+    for (uint32_t i = 0; i < count; i++)
+        m |= 1u << ((base + i) & 31);
+    return m;
+}
+
+// ===================== INISIALISASI =====================
+void pio_sim_init(pio_sim_t *sim, uint32_t num_sm)
+{
+    memset(sim, 0, sizeof(*sim));
+    sim->num_sm = num_sm > PIO_SIM_MAX_SM ? PIO_SIM_MAX_SM : num_sm;
+    for (uint32_t i = 0; i < PIO_SIM_MAX_SM; i++)
+    {
+        pio_sim_sm_t *sm = &sim->sm[i];
+        sm->sim = sim;
+        sm->index = i;
+        sm->wrap = PIO_SIM_INSTR_MEM - 1;
+        sm->out_shift_right = true;
+        sm->in_shift_right = true;
+        sm->pull_threshold = 32;
+        sm->push_threshold = 32;
+        sm->clkdiv_fixed = 256;
+        pio_fifo_model_init(&sm->tx, 4);
+        pio_fifo_model_init(&sm->rx, 4);
+    }
+}
+
+void pio_sim_load(pio_sim_sm_t *sm, const pio_sim_program_t *prog, uint32_t offset)
+{
+    // Relokasi alamat JMP seperti pio_add_program()
+    for (uint32_t i = 0; i < prog->length; i++)
+    {
+        uint16_t instr = prog->instructions[i];
+        if ((instr >> 13) == 0)
+            instr = (instr & ~0x1fu) | ((instr + offset) & 0x1fu);
+        sm->mem[(offset + i) % PIO_SIM_INSTR_MEM] = instr;
+    }
+    sm->wrap_target = (offset + prog->wrap_target) % PIO_SIM_INSTR_MEM;
+    sm->wrap = (offset + prog->wrap) % PIO_SIM_INSTR_MEM;
+    sm->sideset_bits = prog->sideset_bits;
+    sm->sideset_opt = prog->sideset_opt;
+}
+
+void pio_sim_sm_reset(pio_sim_sm_t *sm, uint32_t initial_pc)
+{
+    pio_sim_t *sim = sm->sim;
+    sm->pc = initial_pc % PIO_SIM_INSTR_MEM;
+    sm->x = sm->y = sm->isr = sm->osr = 0;
+    sm->isr_count = 0;
+    sm->osr_count = 32; // OSR kosong
+    sm->delay = 0;
+    sm->stalled = false;
+    sm->t256 = sim->now << 8;
+    pio_fifo_model_init(&sm->tx, sm->tx.depth);
+    pio_fifo_model_init(&sm->rx, sm->rx.depth);
+
+    uint32_t side_count = sm->sideset_bits - (sm->sideset_opt ? 1 : 0);
+    sim->gpio_out_mask |= range_mask(sm->set_base, sm->set_count) |
+                          range_mask(sm->out_base, sm->out_count) |
+                          range_mask(sm->sideset_base, side_count);
+}
+
+bool pio_sim_put(pio_sim_sm_t *sm, uint32_t val)
+{
+    return pio_fifo_model_push(&sm->tx, val);
+}
+
+bool pio_sim_get(pio_sim_sm_t *sm, uint32_t *val)
+{
+    return pio_fifo_model_pop(&sm->rx, val);
+}
+
+uint32_t pio_sim_pins(const pio_sim_t *sim)
+{
+    return (sim->gpio_out & sim->gpio_out_mask) | (sim->gpio_in & ~sim->gpio_out_mask);
+}
+
+uint32_t pio_sim_clkdiv_fixed(float div)
+{
+    if (div < 1.0f)
+        div = 1.0f;
+    if (div > 65536.0f)
+        div = 65536.0f;
+    uint32_t div_int = (uint32_t)div;
+    uint32_t div_frac = (uint32_t)((div - (float)div_int) * 256.0f);
+    return (div_int << 8) | (div_frac & 0xff);
+}
+
+// ===================== EKSEKUSI =====================
+static void write_pins(pio_sim_sm_t *sm, uint32_t base, uint32_t count, uint32_t value)
+{
+    pio_sim_t *sim = sm->sim;
+    uint32_t old = sim->gpio_out;
+    uint32_t out = old;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint32_t bit = 1u << ((base + i) & 31);
+        out = (value >> i) & 1 ? (out | bit) : (out & ~bit);
+    }
+    if (out != old)
+    {
+        sim->gpio_out = out;
+        if (sim->on_edge)
+            sim->on_edge(sim->edge_ctx, sim->now, old, out);
+    }
+}
+
+static uint32_t irq_index(const pio_sim_sm_t *sm, uint32_t idx)
+{
+    if (idx & 0x10)
+        return (idx & 0x4) | ((idx + sm->index) & 0x3);
+    return idx & 0x7;
+}
+
+static void raise_irq(pio_sim_sm_t *sm, uint32_t idx)
+{
+    pio_sim_t *sim = sm->sim;
+    uint32_t flag = irq_index(sm, idx);
+    sim->irq_flags[sm->index / 4] |= 1u << flag;
+    if (sim->on_irq)
+        sim->on_irq(sim->irq_ctx, sim->now, sm->index, flag);
+}
+
+static uint32_t read_src(pio_sim_sm_t *sm, uint32_t src)
+{
+    switch (src)
+    {
+    case 0:
+        return rotr32(pio_sim_pins(sm->sim), sm->in_base);
+    case 1:
+        return sm->x;
+    case 2:
+        return sm->y;
+    case 6:
+        return sm->isr;
+    case 7:
+        return sm->osr;
+    default:
+        return 0; // null, status
+    }
+}
+
+static int exec_instr(pio_sim_sm_t *sm, uint16_t instr)
+{
+    pio_sim_t *sim = sm->sim;
+    uint32_t op = instr >> 13;
+    uint32_t arg1 = (instr >> 5) & 0x7;
+    uint32_t arg2 = instr & 0x1f;
+    uint32_t *irq = &sim->irq_flags[sm->index / 4];
+    sm->stall_fdebug = 0;
+
+    switch (op)
+    {
+    case 0: // JMP
+    {
+        bool take;
+        switch (arg1)
+        {
+        case 0:
+            take = true;
+            break;
+        case 1:
+            take = sm->x == 0;
+            break;
+        case 2:
+            take = sm->x != 0;
+            sm->x--;
+            break;
+        case 3:
+            take = sm->y == 0;
+            break;
+        case 4:
+            take = sm->y != 0;
+            sm->y--;
+            break;
+        case 5:
+            take = sm->x != sm->y;
+            break;
+        case 6:
+            take = (pio_sim_pins(sim) >> sm->jmp_pin) & 1;
+            break;
+        default:
+            take = sm->osr_count < sm->pull_threshold;
+            break;
+        }
+        if (take)
+        {
+            sm->pc = arg2;
+            return EXEC_JUMPED;
+        }
+        return EXEC_DONE;
+    }
+    case 1: // WAIT
+    {
+        uint32_t pol = (instr >> 7) & 1;
+        uint32_t src = (instr >> 5) & 3;
+        uint32_t val;
+        if (src == 0)
+            val = (pio_sim_pins(sim) >> arg2) & 1;
+        else if (src == 1)
+            val = (pio_sim_pins(sim) >> ((sm->in_base + arg2) & 31)) & 1;
+        else
+            val = (*irq >> irq_index(sm, arg2)) & 1;
+        if (val != pol)
+            return EXEC_STALL;
+        if (src == 2 && pol)
+            *irq &= ~(1u << irq_index(sm, arg2));
+        return EXEC_DONE;
+    }
+    case 2: // IN
+    {
+        uint32_t n = arg2 ? arg2 : 32;
+        if (sm->autopush && sm->isr_count + n >= sm->push_threshold && sm->rx.level >= sm->rx.depth)
+        {
+            sm->stall_fdebug = rxstall_bit(sm);
+            return EXEC_STALL;
+        }
+        uint32_t val = read_src(sm, arg1);
+        uint32_t mask = n == 32 ? 0xffffffffu : ((1u << n) - 1);
+        val &= mask;
+        if (sm->in_shift_right)
+            sm->isr = n == 32 ? val : (sm->isr >> n) | (val << (32 - n));
+        else
+            sm->isr = n == 32 ? val : (sm->isr << n) | val;
+        sm->isr_count = sm->isr_count + n > 32 ? 32 : sm->isr_count + n;
+        if (sm->autopush && sm->isr_count >= sm->push_threshold)
+        {
+            pio_fifo_model_push(&sm->rx, sm->isr);
+            sm->isr = 0;
+            sm->isr_count = 0;
+        }
+        return EXEC_DONE;
+    }
+    case 3: // OUT
+    {
+        uint32_t n = arg2 ? arg2 : 32;
+        if (sm->autopull && sm->osr_count >= sm->pull_threshold)
+        {
+            if (!pio_fifo_model_pop(&sm->tx, &sm->osr))
+            {
+                sm->stall_fdebug = txstall_bit(sm);
+                return EXEC_STALL;
+            }
+            sm->osr_count = 0;
+        }
+        uint32_t val;
+        if (sm->out_shift_right)
+        {
+            val = n == 32 ? sm->osr : sm->osr & ((1u << n) - 1);
+            sm->osr = n == 32 ? 0 : sm->osr >> n;
+        }
+        else
+        {
+            val = sm->osr >> (32 - n);
+            sm->osr = n == 32 ? 0 : sm->osr << n;
+        }
+        sm->osr_count = sm->osr_count + n > 32 ? 32 : sm->osr_count + n;
+        switch (arg1)
+        {
+        case 0:
+            write_pins(sm, sm->out_base, sm->out_count, val);
+            break;
+        case 1:
+            sm->x = val;
+            break;
+        case 2:
+            sm->y = val;
+            break;
+        case 5:
+            sm->pc = val & 0x1f;
+            return EXEC_JUMPED;
+        case 6:
+            sm->isr = val;
+            sm->isr_count = n;
+            break;
+        default:
+            break; // null, pindirs, exec
+        }
+        return EXEC_DONE;
+    }
+    case 4: // PUSH / PULL
+    {
+        bool is_pull = (instr >> 7) & 1;
+        bool if_cond = (instr >> 6) & 1;
+        bool block = (instr >> 5) & 1;
+        if (!is_pull)
+        {
+            if (if_cond && sm->isr_count < sm->push_threshold)
+                return EXEC_DONE;
+            if (sm->rx.level >= sm->rx.depth)
+            {
+                if (block)
+                {
+                    sm->stall_fdebug = rxstall_bit(sm);
+                    return EXEC_STALL;
+                }
+            }
+            else
+            {
+                pio_fifo_model_push(&sm->rx, sm->isr);
+            }
+            sm->isr = 0;
+            sm->isr_count = 0;
+            return EXEC_DONE;
+        }
+        if (if_cond && sm->osr_count < sm->pull_threshold)
+            return EXEC_DONE;
+        if (!pio_fifo_model_pop(&sm->tx, &sm->osr))
+        {
+            if (block)
+            {
+                sm->stall_fdebug = txstall_bit(sm);
+                return EXEC_STALL;
+            }
+            sm->osr = sm->x; // pull noblock dengan FIFO kosong menyalin X
+        }
+        sm->osr_count = 0;
+        return EXEC_DONE;
+    }
+    case 5: // MOV
+    {
+        uint32_t mov_op = (instr >> 3) & 3;
+        uint32_t val = read_src(sm, instr & 7);
+        if (mov_op == 1)
+            val = ~val;
+        else if (mov_op == 2)
+            val = bitrev32(val);
+        switch (arg1)
+        {
+        case 0:
+            write_pins(sm, sm->out_base, sm->out_count, val);
+            break;
+        case 1:
+            sm->x = val;
+            break;
+        case 2:
+            sm->y = val;
+            break;
+        case 5:
+            sm->pc = val & 0x1f;
+            return EXEC_JUMPED;
+        case 6:
+            sm->isr = val;
+            sm->isr_count = 0;
+            break;
+        case 7:
+            sm->osr = val;
+            sm->osr_count = 0;
+            break;
+        default:
+            break; // exec
+        }
+        return EXEC_DONE;
+    }
+    case 6: // IRQ
+    {
+        bool clr = (instr >> 6) & 1;
+        bool wait = (instr >> 5) & 1;
+        uint32_t bit = 1u << irq_index(sm, arg2);
+        if (clr)
+        {
+            *irq &= ~bit;
+            return EXEC_DONE;
+        }
+        if (wait)
+        {
+            // Instruksi pertama menyetel flag, lalu stall sampai dibersihkan
+            if (!sm->stalled)
+            {
+                raise_irq(sm, arg2);
+                return EXEC_STALL;
+            }
+            return (*irq & bit) ? EXEC_STALL : EXEC_DONE;
+        }
+        raise_irq(sm, arg2);
+        return EXEC_DONE;
+    }
+    default: // SET
+        switch (arg1)
+        {
+        case 0:
+            write_pins(sm, sm->set_base, sm->set_count, arg2);
+            break;
+        case 1:
+            sm->x = arg2;
+            break;
+        case 2:
+            sm->y = arg2;
+            break;
+        default:
+            break; // pindirs
+        }
+        return EXEC_DONE;
+    }
+}
+
+static uint32_t next_pc(const pio_sim_sm_t *sm, uint32_t pc)
+{
+    return pc == sm->wrap ? sm->wrap_target : (pc + 1) % PIO_SIM_INSTR_MEM;
+}
+
+// Tick pertama (1/256 siklus) SM lain yang dapat mengubah pin: SM penulis
+// pin (set/out/side-set) yang tidak stall, dan SM berumpan. Bila ada
+// penulis pin yang stall, SM lain yang tidak stall bisa melepasnya lebih
+// dulu (flag IRQ), jadi semuanya ikut membatasi.
+static uint64_t pin_horizon(const pio_sim_t *sim, const pio_sim_sm_t *self, uint64_t until)
+{
+    uint64_t writers = (until + 1) << 8, active = writers;
+    bool stalled_writer = false;
+    for (uint32_t i = 0; i < sim->num_sm; i++)
+    {
+        const pio_sim_sm_t *sm = &sim->sm[i];
+        if (sm == self || !sm->enabled)
+            continue;
+        bool runs = !sm->stalled || sm->feed;
+        if (runs && sm->t256 < active)
+            active = sm->t256;
+        if (!sm->set_count && !sm->out_count && !sm->sideset_bits && !sm->feed)
+            continue;
+        if (!runs)
+            stalled_writer = true;
+        else if (sm->t256 < writers)
+            writers = sm->t256;
+    }
+    return stalled_writer ? active : writers;
+}
+
+// Loop dua instruksi tanpa delay yang hanya menunggu pin jmp:
+//   p: jmp x--/y-- q   q: jmp pin p   selama pin HIGH (register turun bebas)
+//   p: jmp pin r       q: jmp x--/y-- p   selama pin LOW (register > 0)
+// dengan q = instruksi sesudah p. Putaran dilompati selama semua tick-nya
+// jatuh sebelum SM lain dapat mengubah pin; hasilnya sama dengan per tick.
+static bool pin_loop(pio_sim_sm_t *sm, uint64_t until)
+{
+    if (sm->feed || sm->sideset_bits)
+        return false;
+    uint32_t p = sm->pc, q = next_pc(sm, p);
+    uint16_t a = sm->mem[p], b = sm->mem[q];
+    if (q == p || (a >> 8) != 0 || (b >> 8) != 0)
+        return false; // Bukan JMP, atau ada delay/side-set
+    uint32_t cond_a = (a >> 5) & 7, cond_b = (b >> 5) & 7;
+    bool pin = (pio_sim_pins(sm->sim) >> sm->jmp_pin) & 1;
+
+    uint32_t *reg;
+    uint64_t max_k;
+    if ((cond_a == 2 || cond_a == 4) && cond_b == 6 && (a & 0x1f) == q && (b & 0x1f) == p && pin)
+    {
+        reg = cond_a == 2 ? &sm->x : &sm->y;
+        max_k = UINT64_MAX;
+    }
+    else if (cond_a == 6 && (cond_b == 2 || cond_b == 4) && (b & 0x1f) == p && !pin)
+    {
+        reg = cond_b == 2 ? &sm->x : &sm->y;
+        max_k = *reg;
+    }
+    else
+    {
+        return false;
+    }
+
+    uint64_t limit = pin_horizon(sm->sim, sm, until);
+    if (limit <= sm->t256)
+        return false;
+    uint64_t cd = sm->clkdiv_fixed;
+    uint64_t k = (limit - 1 - sm->t256 + cd) / (2 * cd);
+    if (k > max_k)
+        k = max_k;
+    if (k == 0)
+        return false;
+    *reg -= (uint32_t)k;
+    sm->t256 += 2 * k * cd;
+    sm->instructions += 2 * k;
+    sm->stalled = false;
+    return true;
+}
+
+static void sm_tick(pio_sim_sm_t *sm, uint64_t until)
+{
+    // Siklus delay tidak punya efek samping (side-set sudah diterapkan di
+    // awal instruksi): seluruhnya dilompati dalam satu langkah
+    if (sm->delay > 0)
+    {
+        sm->t256 += (uint64_t)sm->delay * sm->clkdiv_fixed;
+        sm->delay = 0;
+        return;
+    }
+
+    if (sm->feed)
+        sm->feed(sm->feed_ctx, sm, sm->sim->now);
+
+    if (pin_loop(sm, until))
+        return;
+
+    uint16_t instr = sm->mem[sm->pc];
+    uint32_t field = (instr >> 8) & 0x1f;
+    uint32_t delay_bits = 5 - sm->sideset_bits;
+    uint32_t delay = field & ((1u << delay_bits) - 1);
+
+    // Side-set diterapkan di awal instruksi, juga saat instruksi stall
+    if (sm->sideset_bits > 0)
+    {
+        uint32_t side_count = sm->sideset_bits - (sm->sideset_opt ? 1 : 0);
+        bool side_en = !sm->sideset_opt || (field & 0x10);
+        if (side_en)
+            write_pins(sm, sm->sideset_base, side_count,
+                       (field >> delay_bits) & ((1u << side_count) - 1));
+    }
+
+    // Percepatan analitis untuk "jmp x-- self" / "jmp y-- self" tanpa delay:
+    // loop berjalan reg kali lalu jatuh ke instruksi berikutnya.
+    uint32_t jmp_cond = (instr >> 5) & 7;
+    if ((instr >> 13) == 0 && (instr & 0x1f) == sm->pc && delay == 0 &&
+        (jmp_cond == 2 || jmp_cond == 4))
+    {
+        uint32_t *reg = jmp_cond == 2 ? &sm->x : &sm->y;
+        if (*reg > 1)
+        {
+            uint64_t skip = *reg - 1;
+            *reg = 1;
+            sm->instructions += skip;
+            sm->t256 += skip * sm->clkdiv_fixed;
+            return;
+        }
+    }
+
+    int result = exec_instr(sm, instr);
+    sm->t256 += sm->clkdiv_fixed;
+    if (result == EXEC_STALL)
+    {
+        if (!sm->stalled)
+            sm->sim->epoch++;
+        sm->stalled = true;
+        sm->stall_epoch = sm->sim->epoch;
+        sm->stall_ticks++;
+        sm->sim->fdebug[sm->index / 4] |= sm->stall_fdebug;
+        return;
+    }
+    sm->stalled = false;
+    sm->sim->epoch++;
+    sm->instructions++;
+    sm->delay = delay;
+    if (result == EXEC_DONE)
+        sm->pc = next_pc(sm, sm->pc);
+}
+
+// SM stall: statusnya hanya berubah oleh SM lain yang tidak
+// stall (atau CPU di luar pio_sim_run_until()). Bila tidak ada yang berubah
+// sejak stall terakhirnya (epoch), tick sebelum giliran SM lain itu
+// mengulang stall yang sama. false bila tidak ada yang dilompati.
+static bool skip_stall(pio_sim_t *sim, pio_sim_sm_t *sm, uint64_t until)
+{
+    if (!sim->skip_stalls || !sm->stalled || sm->delay > 0 || sm->stall_epoch != sim->epoch)
+        return false;
+    uint64_t limit = (until + 1) << 8;
+    for (uint32_t i = 0; i < sim->num_sm; i++)
+    {
+        const pio_sim_sm_t *other = &sim->sm[i];
+        if (other != sm && other->enabled && (!other->stalled || other->feed) && other->t256 < limit)
+            limit = other->t256;
+    }
+    if (limit <= sm->t256)
+        return false;
+    uint64_t k = (limit - sm->t256 + sm->clkdiv_fixed - 1) / sm->clkdiv_fixed;
+    sm->t256 += k * sm->clkdiv_fixed;
+    sm->stall_ticks += k;
+    sim->fdebug[sm->index / 4] |= sm->stall_fdebug;
+    return true;
+}
+
+void pio_sim_run_until(pio_sim_t *sim, uint64_t until)
+{
+    // CPU bisa mengubah FIFO, pin atau flag sejak pemanggilan sebelumnya
+    sim->epoch++;
+    for (;;)
+    {
+        pio_sim_sm_t *next = NULL;
+        for (uint32_t i = 0; i < sim->num_sm; i++)
+        {
+            pio_sim_sm_t *sm = &sim->sm[i];
+            if (sm->enabled && (next == NULL || sm->t256 < next->t256))
+                next = sm;
+        }
+        if (sim->stop)
+            return;
+        if (next == NULL || (next->t256 >> 8) > until)
+        {
+            sim->now = until;
+            return;
+        }
+        sim->now = next->t256 >> 8;
+        if (!skip_stall(sim, next, until))
+            sm_tick(next, until);
+    }
+}
+
+void pio_sim_exec(pio_sim_sm_t *sm, uint16_t instr)
+{
+    uint32_t pc = sm->pc;
+    int result = exec_instr(sm, instr);
+    if (result == EXEC_STALL)
+        sm->sim->fdebug[sm->index / 4] |= sm->stall_fdebug;
+    if (result != EXEC_JUMPED)
+        sm->pc = pc;
+}
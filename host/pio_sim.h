@@ -0,0 +1,137 @@
+#ifndef PIO_SIM_H
+#define PIO_SIM_H
+
+/**
+ * Simulator PIO RP2040 yang akurat per siklus (host/Linux).
+ *
+ * Menjalankan kode mesin keluaran pioasm (array *_program_instructions)
+ * untuk satu atau beberapa state machine yang berbagi GPIO. Waktu dihitung
+ * dalam siklus clk_sys; clock divider 16.8 dimodelkan seperti akumulator
+ * perangkat keras sehingga jitter divider fraksional ikut terlihat.
+ *
+ * Loop "jmp x-- <diri sendiri>" / "jmp y-- <diri sendiri>" dan siklus delay
+ * [n] dipercepat secara analitis (hasilnya identik dengan eksekusi per
+ * siklus). Begitu pula loop dua instruksi yang hanya menunggu pin
+ * ("jmp x-- q" + "jmp pin p", atau "jmp pin r" + "jmp x-- p", seperti
+ * program penghitung pulsa): loop dilompati sampai SM lain yang dapat
+ * mengubah pin mendapat giliran. Dengan skip_stalls, SM yang stall juga
+ * melompati tick sampai SM lain yang tidak stall berjalan, setelah
+ * satu tick stall sesudah perubahan terakhir oleh SM lain atau CPU.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "feed_model.h"
+
+#define PIO_SIM_INSTR_MEM 32
+#define PIO_SIM_MAX_SM 8 // 2 blok PIO x 4 SM
+
+typedef struct pio_sim pio_sim_t;
+typedef struct pio_sim_sm pio_sim_sm_t;
+
+// Dipanggil setiap kali nilai output GPIO berubah
+typedef void (*pio_sim_edge_fn)(void *ctx, uint64_t sys_cycle, uint32_t old_pins, uint32_t new_pins);
+// Dipanggil setiap kali instruksi "irq" (nowait/wait) menyetel flag 'flag'
+// (0..7, sesudah indeks relatif diterapkan) di blok SM 'sm'
+typedef void (*pio_sim_irq_fn)(void *ctx, uint64_t sys_cycle, uint32_t sm, uint32_t flag);
+// Dipanggil sebelum setiap instruksi dieksekusi; dapat mengisi TX FIFO
+typedef void (*pio_sim_feed_fn)(void *ctx, pio_sim_sm_t *sm, uint64_t sys_cycle);
+
+typedef struct
+{
+    const uint16_t *instructions;
+    uint32_t length;
+    uint32_t wrap_target; // Relatif terhadap awal program
+    uint32_t wrap;
+    uint32_t sideset_bits; // Termasuk bit enable bila opsional
+    bool sideset_opt;
+} pio_sim_program_t;
+
+struct pio_sim_sm
+{
+    pio_sim_t *sim;
+    uint32_t index; // 0..7 (blok = index / 4)
+    bool enabled;
+
+    // Konfigurasi
+    uint16_t mem[PIO_SIM_INSTR_MEM];
+    uint32_t wrap_target, wrap;
+    uint32_t sideset_bits;
+    bool sideset_opt;
+    uint32_t set_base, set_count;
+    uint32_t out_base, out_count;
+    uint32_t in_base;
+    uint32_t sideset_base;
+    uint32_t jmp_pin;
+    bool out_shift_right, in_shift_right;
+    bool autopull, autopush;
+    uint32_t pull_threshold, push_threshold;
+    uint32_t clkdiv_fixed; // Format 16.8 (256 = clkdiv 1)
+
+    // Status
+    uint32_t pc;
+    uint32_t x, y, isr, osr;
+    uint32_t isr_count, osr_count;
+    uint32_t delay;
+    bool stalled;
+    uint64_t t256; // Waktu tick berikutnya dalam 1/256 siklus clk_sys
+    pio_fifo_model_t tx, rx;
+
+    // Statistik
+    uint64_t instructions;
+    uint64_t stall_ticks;
+    uint32_t stall_fdebug; // Bit FDEBUG yang disetel stall terakhir
+    uint64_t stall_epoch;  // pio_sim_t.epoch saat stall terakhir
+
+    pio_sim_feed_fn feed;
+    void *feed_ctx;
+};
+
+struct pio_sim
+{
+    pio_sim_sm_t sm[PIO_SIM_MAX_SM];
+    uint32_t num_sm;
+    uint32_t gpio_out;     // Nilai output yang digerakkan SM
+    uint32_t gpio_in;      // Input eksternal (dibaca oleh wait/in/jmp pin)
+    uint32_t gpio_out_mask; // Pin yang dikendalikan PIO (selain itu dibaca dari gpio_in)
+    uint32_t irq_flags[2]; // IRQ flag per blok PIO
+    uint32_t fdebug[2];    // FDEBUG per blok: TXSTALL (bit 24 + sm), RXSTALL (bit sm)
+    uint64_t now;          // Siklus clk_sys saat ini
+    bool stop;             // Disetel callback untuk menghentikan pio_sim_run_until()
+    // SM yang stall tidak dijalankan per tick (stall_ticks tetap dihitung).
+    // Umpannya hanya boleh mengubah status SM bila ada yang berubah sejak
+    // tick sebelumnya, atau harus menaikkan epoch; umpan yang harus
+    // dipanggil setiap tick (sg_run) butuh false.
+    bool skip_stalls;
+    // Bertambah setiap kali SM menjalankan instruksi atau mulai stall (dan
+    // di awal pio_sim_run_until()): SM stall hanya dilompati bila tidak ada
+    // yang berubah sejak stall-nya
+    uint64_t epoch;
+
+    pio_sim_edge_fn on_edge;
+    void *edge_ctx;
+    pio_sim_irq_fn on_irq;
+    void *irq_ctx;
+};
+
+void pio_sim_init(pio_sim_t *sim, uint32_t num_sm);
+void pio_sim_load(pio_sim_sm_t *sm, const pio_sim_program_t *prog, uint32_t offset);
+void pio_sim_sm_reset(pio_sim_sm_t *sm, uint32_t initial_pc);
+bool pio_sim_put(pio_sim_sm_t *sm, uint32_t val);
+bool pio_sim_get(pio_sim_sm_t *sm, uint32_t *val);
+
+// Jalankan satu instruksi segera seperti register SMx_INSTR (pio_sm_exec()):
+// PC hanya berubah bila instruksinya lompatan
+void pio_sim_exec(pio_sim_sm_t *sm, uint16_t instr);
+
+// Jalankan semua SM yang aktif sampai waktu clk_sys mencapai 'until' atau
+// sampai sim->stop disetel
+void pio_sim_run_until(pio_sim_t *sim, uint64_t until);
+
+// Nilai pin yang terlihat oleh SM (output PIO digabung dengan input eksternal)
+uint32_t pio_sim_pins(const pio_sim_t *sim);
+
+// Fixed-point 16.8 seperti sm_config_set_clkdiv(float)
+uint32_t pio_sim_clkdiv_fixed(float div);
+
+#endif
@@ -0,0 +1,251 @@
+#define _GNU_SOURCE
+#include "remote_dev.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "signal_generator.pio.h"
+#include "signal_timing.h"
+
+// Nilai pe_state_t (lib/pulse_engine.h)
+enum
+{
+    DEV_IDLE = 0,
+    DEV_CONFIGURED,
+    DEV_RUNNING,
+    DEV_DONE,
+    DEV_ABORTED,
+    DEV_ERROR,
+};
+
+static remote_result_t dev_get(void *ctx, remote_param_t id, int32_t *value)
+{
+    remote_dev_t *d = ctx;
+    *value = d->param[id];
+    return REMOTE_OK;
+}
+
+static remote_result_t dev_set(void *ctx, remote_param_t id, int32_t value)
+{
+    remote_dev_t *d = ctx;
+    if (d->running)
+        return REMOTE_ERR_BUSY;
+    d->param[id] = value;
+    return REMOTE_OK;
+}
+
+static remote_result_t dev_start(void *ctx, uint8_t *timing_status)
+{
+    remote_dev_t *d = ctx;
+    if (d->running)
+        return REMOTE_ERR_BUSY;
+
+    // Validasi sama seperti engine_configure(): program statis terhitung
+    timing_request_t req = {(uint32_t)d->param[REMOTE_PARAM_FREQ_HZ], (uint32_t)d->param[REMOTE_PARAM_PULSE_NS],
+                            (uint32_t)d->param[REMOTE_PARAM_PHASE_NS]};
+    uint32_t sys_clk_hz = d->param[REMOTE_PARAM_PRECISION] ? 250000000u : 125000000u;
+    uint32_t div;
+    timing_plan_t plan;
+    timing_status_t status = timing_compile_auto(&req, sys_clk_hz, signal_generator_counted_EVENT_OVERHEAD,
+                                                 &div, &plan);
+    if (status == TIMING_OK && plan.delay[3] <= signal_generator_counted_D_EXTRA)
+        status = TIMING_ERR_PERIOD_TOO_SHORT;
+    *timing_status = (uint8_t)status;
+    d->last = (remote_status_t){0};
+    d->last.timing_status = (uint8_t)status;
+    if (status != TIMING_OK)
+    {
+        d->state = DEV_ERROR;
+        return REMOTE_ERR_TIMING;
+    }
+
+    d->running = true;
+    d->state = DEV_RUNNING;
+    d->start_ms = d->now_ms;
+    d->last.duration_ms = (uint32_t)d->param[REMOTE_PARAM_DURATION_S] * 1000u;
+    d->last.mean_period_ns = plan.period_ns;
+    d->periods = timing_periods_for_duration(d->last.duration_ms, sys_clk_hz, div, plan.period_cycles);
+    d->starts++;
+    return REMOTE_OK;
+}
+
+// Hasil sintetis: satu pulsa CH1 per periode yang dimulai; jalan yang
+// selesai sendiri berisi tepat d->periods periode
+static void finish(remote_dev_t *d, uint8_t state)
+{
+    uint64_t run_ms = d->now_ms - d->start_ms;
+    uint64_t period_ns = d->last.mean_period_ns;
+    d->running = false;
+    d->state = state;
+    d->stop_ms = d->now_ms;
+    d->last.pulses = state == DEV_DONE ? d->periods
+                                       : (uint32_t)((run_ms * 1000000u + period_ns - 1) / period_ns);
+    d->last.expected = d->last.pulses;
+    d->last.on_time_ns = (uint64_t)d->last.pulses * (uint32_t)d->param[REMOTE_PARAM_PULSE_NS];
+}
+
+static remote_result_t dev_abort(void *ctx)
+{
+    remote_dev_t *d = ctx;
+    if (!d->running)
+        return REMOTE_ERR_BUSY;
+    finish(d, DEV_ABORTED);
+    d->aborts++;
+    return REMOTE_OK;
+}
+
+static void dev_status(void *ctx, remote_status_t *out)
+{
+    remote_dev_t *d = ctx;
+    *out = d->last;
+    out->state = d->state;
+    if (d->running)
+    {
+        out->elapsed_ms = (uint32_t)(d->now_ms - d->start_ms);
+        out->pulses = out->expected = 0;
+        out->on_time_ns = 0;
+        out->mean_period_ns = 0;
+    }
+    else if (d->state == DEV_DONE || d->state == DEV_ABORTED)
+    {
+        out->elapsed_ms = (uint32_t)(d->stop_ms - d->start_ms);
+    }
+}
+
+void remote_dev_init(remote_dev_t *d)
+{
+    memset(d, 0, sizeof(*d));
+    // Nilai awal variabel UI di main.c
+    d->param[REMOTE_PARAM_FREQ_HZ] = 100;
+    d->param[REMOTE_PARAM_PULSE_NS] = 3500;
+    d->param[REMOTE_PARAM_DURATION_S] = 3;
+    d->param[REMOTE_PARAM_PHASE_NS] = 100;
+    d->param[REMOTE_PARAM_PRECISION] = 0;
+    d->param[REMOTE_PARAM_TRIGGER] = 0; // Tiruan tidak memodelkan picu: selalu mulai segera
+    d->param[REMOTE_PARAM_CAPTURE] = 0; // Tiruan tidak mengirim bingkai tangkapan
+    d->state = DEV_IDLE;
+    d->ops = (remote_ops_t){
+        .get_param = dev_get,
+        .set_param = dev_set,
+        .start = dev_start,
+        .abort = dev_abort,
+        .status = dev_status,
+        .ctx = d,
+    };
+}
+
+bool remote_dev_advance(remote_dev_t *d, uint64_t now_ms)
+{
+    d->now_ms = now_ms;
+    if (!d->running || now_ms - d->start_ms < d->last.duration_ms)
+        return false;
+    d->now_ms = d->start_ms + d->last.duration_ms;
+    finish(d, DEV_DONE);
+    d->now_ms = now_ms;
+    return true;
+}
+
+// ===================== PSEUDO-TERMINAL =====================
+static uint64_t monotonic_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u;
+}
+
+static void write_all(int fd, const void *buf, size_t len)
+{
+    const uint8_t *p = buf;
+    while (len > 0)
+    {
+        ssize_t n = write(fd, p, len);
+        if (n < 0)
+        {
+            if (errno == EINTR || errno == EAGAIN)
+                continue;
+            return;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+}
+
+// Teks log di sela bingkai seperti printf firmware
+static void log_text(int fd, const char *s)
+{
+    write_all(fd, s, strlen(s));
+}
+
+int remote_dev_serve_pty(void)
+{
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0)
+    {
+        perror("posix_openpt");
+        return 1;
+    }
+    const char *path = ptsname(master);
+
+    // Slave tetap dibuka di sini (mode raw) agar master tidak mendapat EIO
+    // saat klien menutup port, dan byte 0x0a/0x0d tidak diterjemahkan
+    int slave = open(path, O_RDWR | O_NOCTTY);
+    struct termios tio;
+    if (slave < 0 || tcgetattr(slave, &tio) != 0)
+    {
+        perror(path);
+        return 1;
+    }
+    cfmakeraw(&tio);
+    tcsetattr(slave, TCSANOW, &tio);
+
+    printf("Stand-in protokol kendali di %s (Ctrl+C untuk berhenti)\n", path);
+    fflush(stdout);
+
+    remote_dev_t dev;
+    remote_t remote;
+    remote_dev_init(&dev);
+    remote_init(&remote, &dev.ops);
+
+    uint8_t out[REMOTE_FRAME_MAX];
+    uint64_t last_stream = 0;
+    for (;;)
+    {
+        struct pollfd pfd = {master, POLLIN, 0};
+        poll(&pfd, 1, 1);
+
+        uint64_t now = monotonic_ms();
+        if (remote_dev_advance(&dev, now))
+        {
+            // Telemetri akhir selalu dikirim, seperti handle_run()
+            remote_status_t st;
+            dev.ops.status(dev.ops.ctx, &st);
+            log_text(master, "Generasi pulsa selesai.\n");
+            write_all(master, out, remote_telemetry(&remote, &st, out));
+        }
+        else if (dev.running && remote.stream_ms && now - last_stream >= remote.stream_ms)
+        {
+            remote_status_t st;
+            dev.ops.status(dev.ops.ctx, &st);
+            write_all(master, out, remote_telemetry(&remote, &st, out));
+            last_stream = now;
+        }
+
+        if (!(pfd.revents & POLLIN))
+            continue;
+        uint8_t buf[256];
+        ssize_t n = read(master, buf, sizeof(buf));
+        for (ssize_t i = 0; i < n; i++)
+        {
+            uint32_t starts = dev.starts;
+            size_t len = remote_feed(&remote, buf[i], out);
+            if (dev.starts != starts)
+                log_text(master, "Konfigurasi PIO: stand-in host\n");
+            write_all(master, out, len);
+        }
+    }
+}
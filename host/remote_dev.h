@@ -0,0 +1,38 @@
+#ifndef REMOTE_DEV_H
+#define REMOTE_DEV_H
+
+/**
+ * Perangkat tiruan di balik lib/remote_proto.c: parameter UI dengan rentang
+ * yang sama seperti menu, jalan berdurasi yang berakhir sendiri dan
+ * telemetri dosis sintetis (pulsa = frekuensi x durasi). Waktu dimajukan
+ * pemanggil sehingga uji mgc_sim remote deterministik; remote_dev_serve_pty()
+ * memakai jam monotonik agar klien host dapat diuji tanpa papan.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "remote_proto.h"
+
+typedef struct
+{
+    int32_t param[REMOTE_PARAM_COUNT];
+    bool running;
+    uint8_t state; // Nilai pe_state_t
+    uint64_t now_ms;
+    uint64_t start_ms, stop_ms;
+    uint32_t periods; // Jumlah periode jalan terakhir (timing_periods_for_duration)
+    remote_status_t last; // Hasil jalan terakhir
+    uint32_t starts, aborts;
+    remote_ops_t ops;
+} remote_dev_t;
+
+void remote_dev_init(remote_dev_t *d);
+
+// Majukan waktu; true bila jalan baru saja berakhir (kirim telemetri akhir)
+bool remote_dev_advance(remote_dev_t *d, uint64_t now_ms);
+
+// Buka pseudo-terminal, cetak path slave dan layani protokol sampai
+// dihentikan (Ctrl+C). Mengembalikan kode keluar proses.
+int remote_dev_serve_pty(void);
+
+#endif
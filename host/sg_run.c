@@ -0,0 +1,707 @@
+#include "sg_run.h"
+#include <string.h>
+#include "pattern.h"
+#include "pio_sim.h"
+#include "signal_generator.pio.h"
+#include "signal_generator_ref.pio.h"
+#include "pattern_engine.pio.h"
+#include "pulse_counter.pio.h"
+#include "logic_analyzer.pio.h"
+
+uint32_t sg_sys_clk_hz = SG_SYS_CLK_HZ;
+
+static sg_logic_t *logic;
+
+typedef struct
+{
+    sg_edges_t *edges;
+    uint32_t periods;
+    pio_sim_t *sim;
+} edge_ctx_t;
+
+uint32_t sg_event_overhead(sg_program_t program)
+{
+    switch (program)
+    {
+    case SG_PROGRAM_STATIC:
+        return signal_generator_static_EVENT_OVERHEAD;
+    case SG_PROGRAM_PATTERN:
+        return pattern_engine_EVENT_OVERHEAD;
+    default:
+        return signal_generator_EVENT_OVERHEAD;
+    }
+}
+
+// Umpan DMA yang tidak pernah terlambat: FIFO selalu diisi penuh
+static void ideal_feed(void *ctx, pio_sim_sm_t *sm, uint64_t sys_cycle)
+{
+    sg_feed_t *f = ctx;
+    (void)sys_cycle;
+    while (pio_sim_put(sm, f->table[f->next]))
+        f->next = (f->next + 1) % f->words;
+}
+
+static void record(uint64_t *arr, uint32_t *n, uint64_t t)
+{
+    if (*n < SG_MAX_EDGES)
+        arr[*n] = t;
+    (*n)++;
+}
+
+static void on_edge(void *ctx, uint64_t sys_cycle, uint32_t old_pins, uint32_t new_pins)
+{
+    edge_ctx_t *e = ctx;
+    sg_edges_t *edges = e->edges;
+    uint32_t changed = old_pins ^ new_pins;
+
+    if (edges->trace)
+        fprintf(edges->trace, "%12llu siklus  %12.1f ns  GP6-9=%u%u%u%u\n",
+                (unsigned long long)sys_cycle, sys_cycle * 1e9 / sg_sys_clk_hz,
+                (new_pins >> 6) & 1, (new_pins >> 7) & 1, (new_pins >> 8) & 1, (new_pins >> 9) & 1);
+
+    if (changed & (1u << SG_PIN_CH1))
+    {
+        if (new_pins & (1u << SG_PIN_CH1))
+            record(edges->ch1_rise, &edges->n_ch1_rise, sys_cycle);
+        else
+            record(edges->ch1_fall, &edges->n_ch1_fall, sys_cycle);
+    }
+    if (changed & (1u << SG_PIN_CH2))
+    {
+        if (new_pins & (1u << SG_PIN_CH2))
+            record(edges->ch2_rise, &edges->n_ch2_rise, sys_cycle);
+        else
+            record(edges->ch2_fall, &edges->n_ch2_fall, sys_cycle);
+    }
+
+    // Cukup sampai CH1 naik lagi setelah 'periods' periode penuh
+    if (edges->n_ch1_rise > e->periods)
+        e->sim->stop = true;
+}
+
+// Konfigurasi SM seperti get_program_config() di lib/pulse_engine.c
+static void load_program(pio_sim_sm_t *sm, sg_program_t program, uint32_t clkdiv_fixed)
+{
+    pio_sim_program_t prog;
+    if (program == SG_PROGRAM_STATIC)
+    {
+        prog = (pio_sim_program_t){signal_generator_static_program_instructions,
+                                   sizeof(signal_generator_static_program_instructions) / sizeof(uint16_t),
+                                   signal_generator_static_wrap_target, signal_generator_static_wrap, 0, false};
+    }
+    else if (program == SG_PROGRAM_PATTERN)
+    {
+        prog = (pio_sim_program_t){pattern_engine_program_instructions,
+                                   sizeof(pattern_engine_program_instructions) / sizeof(uint16_t),
+                                   pattern_engine_wrap_target, pattern_engine_wrap, 0, false};
+    }
+    else
+    {
+        prog = (pio_sim_program_t){signal_generator_program_instructions,
+                                   sizeof(signal_generator_program_instructions) / sizeof(uint16_t),
+                                   signal_generator_wrap_target, signal_generator_wrap, 0, false};
+    }
+
+    pio_sim_load(sm, &prog, 0);
+    sm->set_base = SG_PIN_CH1;
+    sm->set_count = 4;
+    if (program == SG_PROGRAM_PATTERN)
+    {
+        // out pins 4 bit, autopull 32 bit geser kanan, TX FIFO digabung
+        sm->out_base = SG_PIN_CH1;
+        sm->out_count = pattern_engine_MASK_BITS;
+        sm->out_shift_right = true;
+        sm->autopull = true;
+        sm->pull_threshold = 32;
+        pio_fifo_model_init(&sm->tx, 8);
+    }
+    sm->clkdiv_fixed = clkdiv_fixed;
+
+    // Mesin pulsa tunggal masuk di 'start', melewati prolog sinkron
+    pio_sim_sm_reset(sm, program == SG_PROGRAM_PATTERN ? pattern_engine_offset_start : 0);
+}
+
+bool sg_simulate(sg_program_t program, const uint32_t delays[4], uint32_t clkdiv_fixed,
+                 uint32_t periods, uint64_t max_cycles, sg_edges_t *edges)
+{
+    static pio_sim_t sim;
+    sg_feed_t feed = {delays, 4, 0};
+    edge_ctx_t ctx = {edges, periods, &sim};
+
+    if (periods + 1 > SG_MAX_EDGES)
+        periods = SG_MAX_EDGES - 1;
+
+    pio_sim_init(&sim, 1);
+    pio_sim_sm_t *sm = &sim.sm[0];
+    load_program(sm, program, clkdiv_fixed);
+
+    // Sama seperti startPulseGeneration(): FIFO diisi sebelum SM diaktifkan
+    if (program == SG_PROGRAM_STATIC)
+    {
+        pio_sim_put(sm, delays[0]);
+        pio_sim_put(sm, delays[1]);
+        pio_sim_put(sm, delays[3]);
+    }
+    else
+    {
+        sm->feed = ideal_feed;
+        sm->feed_ctx = &feed;
+    }
+
+    memset(edges->ch1_rise, 0, sizeof(edges->ch1_rise));
+    edges->n_ch1_rise = edges->n_ch1_fall = edges->n_ch2_rise = edges->n_ch2_fall = 0;
+    sim.on_edge = on_edge;
+    sim.edge_ctx = &ctx;
+    sm->enabled = true;
+    pio_sim_run_until(&sim, max_cycles);
+
+    return edges->n_ch1_rise > periods;
+}
+
+static void log_edge(void *ctx, uint64_t sys_cycle, uint32_t old_pins, uint32_t new_pins)
+{
+    sg_pin_log_t *log = ctx;
+    (void)old_pins;
+    if (log->n < SG_MAX_LOG)
+    {
+        log->cycle[log->n] = sys_cycle;
+        log->pins[log->n] = (new_pins >> SG_PIN_CH1) & 0xf;
+    }
+    log->n++;
+}
+
+bool sg_simulate_table(const uint32_t *words, uint32_t length, uint32_t clkdiv_fixed,
+                       uint64_t cycles, sg_pin_log_t *log)
+{
+    static pio_sim_t sim;
+    sg_feed_t feed = {words, length, 0};
+
+    pio_sim_init(&sim, 1);
+    pio_sim_sm_t *sm = &sim.sm[0];
+    load_program(sm, SG_PROGRAM_PATTERN, clkdiv_fixed);
+    sm->feed = ideal_feed;
+    sm->feed_ctx = &feed;
+
+    log->n = 0;
+    sim.on_edge = log_edge;
+    sim.edge_ctx = log;
+    sm->enabled = true;
+    pio_sim_run_until(&sim, cycles);
+
+    return log->n <= SG_MAX_LOG;
+}
+
+typedef struct
+{
+    sg_truth_t *truth;
+    uint64_t rise;
+} truth_ctx_t;
+
+static void truth_edge(void *ctx, uint64_t sys_cycle, uint32_t old_pins, uint32_t new_pins)
+{
+    truth_ctx_t *t = ctx;
+    uint32_t bit = 1u << SG_PIN_CH1;
+    if (!((old_pins ^ new_pins) & bit))
+        return;
+    if (new_pins & bit)
+    {
+        if (t->truth->pulses++ == 0)
+            t->truth->first_rise = sys_cycle;
+        t->truth->last_rise = sys_cycle;
+        t->rise = sys_cycle;
+    }
+    else
+    {
+        t->truth->high_cycles += sys_cycle - t->rise;
+    }
+}
+
+static void load_counter(pio_sim_sm_t *sm, const uint16_t *instr, uint32_t length, uint32_t wrap_target,
+                         uint32_t wrap, uint32_t entry, uint32_t counter_div)
+{
+    // Sama seperti pulse_counter_arm(): in_base = jmp_pin = CH1, X = Y = ~0
+    pio_sim_program_t prog = {instr, length, wrap_target, wrap, 0, false};
+    pio_sim_load(sm, &prog, 0);
+    sm->in_base = SG_PIN_CH1;
+    sm->jmp_pin = SG_PIN_CH1;
+    sm->clkdiv_fixed = counter_div << 8;
+    pio_sim_sm_reset(sm, entry);
+    sm->x = sm->y = UINT32_MAX;
+    sm->enabled = true;
+}
+
+void sg_simulate_counted(sg_program_t program, const uint32_t delays[4], uint32_t clkdiv_fixed,
+                         uint64_t run_cycles, uint32_t counter_div, pulse_raw_t *raw, sg_truth_t *truth)
+{
+    static pio_sim_t sim;
+    sg_feed_t feed = {delays, 4, 0};
+    truth_ctx_t ctx = {truth, 0};
+
+    // SM 0 = generator (PIO0), SM 4/5 = penghitung (PIO1)
+    pio_sim_init(&sim, 6);
+    load_counter(&sim.sm[4], pulse_counter_program_instructions,
+                 sizeof(pulse_counter_program_instructions) / sizeof(uint16_t),
+                 pulse_counter_wrap_target, pulse_counter_wrap, pulse_counter_offset_start, counter_div);
+    load_counter(&sim.sm[5], pulse_span_program_instructions,
+                 sizeof(pulse_span_program_instructions) / sizeof(uint16_t),
+                 pulse_span_wrap_target, pulse_span_wrap, 0, counter_div);
+
+    pio_sim_sm_t *sm = &sim.sm[0];
+    load_program(sm, program, clkdiv_fixed);
+    if (program == SG_PROGRAM_STATIC)
+    {
+        pio_sim_put(sm, delays[0]);
+        pio_sim_put(sm, delays[1]);
+        pio_sim_put(sm, delays[3]);
+    }
+    else
+    {
+        sm->feed = ideal_feed;
+        sm->feed_ctx = &feed;
+    }
+
+    memset(truth, 0, sizeof(*truth));
+    sim.on_edge = truth_edge;
+    sim.edge_ctx = &ctx;
+    pio_sim_run_until(&sim, 10); // Penghitung diaktifkan sebelum generator
+    sm->enabled = true;
+    sm->t256 = sim.now << 8;
+    pio_sim_run_until(&sim, 10 + run_cycles);
+
+    // engine_halt(): SM mati lalu "set pins, 0"
+    sm->enabled = false;
+    uint32_t old = sim.gpio_out;
+    sim.gpio_out &= ~(0xfu << SG_PIN_CH1);
+    if (old != sim.gpio_out)
+        truth_edge(&ctx, sim.now, old, sim.gpio_out);
+    pio_sim_run_until(&sim, sim.now + 16u * counter_div);
+
+    raw->pulses = UINT32_MAX - sim.sm[4].y;
+    raw->high_dec = UINT32_MAX - sim.sm[4].x;
+    raw->span_dec = UINT32_MAX - sim.sm[5].y;
+}
+
+// Umpan terhitung: DMA dengan transfer count, lalu (pola) satu kata henti
+typedef struct
+{
+    const uint32_t *words;
+    uint32_t length, next;
+    uint64_t remaining; // Kata yang belum dikirim channel data
+    bool tail;          // Kata henti belum dikirim
+    uint32_t tail_word;
+    uint32_t done_pc;   // PC tempat SM berhenti
+    bool stopped;
+    sg_stop_t *out;
+    sg_pin_log_t *log; // Opsional
+    truth_ctx_t truth;
+    uint64_t ch1_rise, ch2_rise; // Tepi naik terakhir, untuk jarak IRQ tangkapan
+} period_ctx_t;
+
+static void period_feed(void *ctx, pio_sim_sm_t *sm, uint64_t sys_cycle)
+{
+    period_ctx_t *p = ctx;
+    for (;;)
+    {
+        if (p->remaining > 0)
+        {
+            if (!pio_sim_put(sm, p->words[p->next]))
+                break;
+            p->next = (p->next + 1) % p->length;
+            p->remaining--;
+        }
+        else if (p->tail)
+        {
+            if (!pio_sim_put(sm, p->tail_word))
+                break;
+            p->tail = false;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    // Program statis: tunggu sampai flag IRQ terlihat (satu siklus PIO
+    // setelah "irq wait")
+    if (p->stopped)
+    {
+        p->out->irq = (sm->sim->irq_flags[sm->index / 4] >> sm->index) & 1u;
+        sm->sim->stop = p->out->irq;
+        return;
+    }
+
+    // Instruksi berikutnya adalah titik henti: "irq wait" (statis) atau
+    // "out pins" dengan OSR dan FIFO kosong setelah kata henti (pola)
+    if (sm->pc != p->done_pc || sm->stalled || p->remaining > 0 || p->tail)
+        return;
+    if (sm->autopull && (sm->osr_count < sm->pull_threshold || sm->tx.level > 0))
+        return;
+    p->out->stop = sys_cycle;
+    p->stopped = true;
+    sm->sim->stop = sm->autopull;
+}
+
+static void period_edge(void *ctx, uint64_t sys_cycle, uint32_t old_pins, uint32_t new_pins)
+{
+    period_ctx_t *p = ctx;
+    truth_edge(&p->truth, sys_cycle, old_pins, new_pins);
+    if (p->log && ((old_pins ^ new_pins) & (0xfu << SG_PIN_CH1)))
+        log_edge(p->log, sys_cycle, old_pins, new_pins);
+    if ((old_pins ^ new_pins) & (0xfu << SG_PIN_CH1))
+        p->out->last_edge = sys_cycle;
+    uint32_t rose = ~old_pins & new_pins;
+    if ((rose >> SG_PIN_CH1) & 1u)
+        p->ch1_rise = sys_cycle;
+    if ((rose >> SG_PIN_CH2) & 1u)
+        p->ch2_rise = sys_cycle;
+}
+
+static void period_irq(void *ctx, uint64_t sys_cycle, uint32_t sm, uint32_t flag)
+{
+    period_ctx_t *p = ctx;
+    uint64_t rise;
+    if (flag == ((signal_generator_counted_CAPTURE_IRQ_A + sm) & 3u))
+    {
+        p->out->capture_a++;
+        rise = p->ch1_rise;
+    }
+    else if (flag == ((signal_generator_counted_CAPTURE_IRQ_C + sm) & 3u))
+    {
+        p->out->capture_c++;
+        rise = p->ch2_rise;
+    }
+    else
+    {
+        return; // "irq wait 0 rel" di akhir proses
+    }
+    uint64_t lag = sys_cycle - rise;
+    if (p->out->capture_a + p->out->capture_c == 1 || lag < p->out->capture_lag_min)
+        p->out->capture_lag_min = lag;
+    if (lag > p->out->capture_lag_max)
+        p->out->capture_lag_max = lag;
+}
+
+// DMA ideal: RX FIFO dikuras setiap instruksi sampai buffer penuh, lalu SM
+// dimatikan (di firmware SM tertahan di "in" tanpa menimpa sampel)
+static void logic_feed(void *ctx, pio_sim_sm_t *sm, uint64_t sys_cycle)
+{
+    sg_logic_t *l = ctx;
+    uint32_t word;
+    while (l->filled < l->capacity && pio_sim_get(sm, &word))
+        l->words[l->filled++] = word;
+    if (l->filled == l->capacity)
+        sm->enabled = false;
+}
+
+void sg_attach_logic(sg_logic_t *l)
+{
+    logic = l;
+}
+
+// Penganalisis terpasang: SM 4 dimuat seperti logic_analyzer_arm() dan
+// berjalan SG_LOGIC_LEAD_CYCLES siklus sebelum generator diaktifkan
+static void start_logic(pio_sim_t *sim)
+{
+    if (!logic)
+        return;
+    sim->num_sm = 5;
+    pio_sim_sm_t *sm = &sim->sm[4];
+    pio_sim_program_t prog = {logic_analyzer_program_instructions,
+                              sizeof(logic_analyzer_program_instructions) / sizeof(uint16_t),
+                              logic_analyzer_wrap_target, logic_analyzer_wrap, 0, false};
+    pio_sim_load(sm, &prog, 0);
+    sm->in_base = SG_PIN_CH1;
+    sm->in_shift_right = true;
+    sm->autopush = true;
+    sm->push_threshold = 32;
+    sm->clkdiv_fixed = 1u << 8;
+    pio_fifo_model_init(&sm->rx, 8); // PIO_FIFO_JOIN_RX
+    pio_sim_sm_reset(sm, logic->trigger ? logic_analyzer_offset_trigger : logic_analyzer_offset_sample);
+    sm->feed = logic_feed;
+    sm->feed_ctx = logic;
+    logic->filled = 0;
+    sm->enabled = true;
+    pio_sim_run_until(sim, SG_LOGIC_LEAD_CYCLES);
+    sim->sm[0].t256 = sim->now << 8;
+}
+
+// Program statis terhitung seperti get_program_config(): set pins mencakup
+// picu keluar; tanpa picu SM masuk di 'start'
+static void load_counted(pio_sim_sm_t *sm, uint32_t clkdiv_fixed, bool external_trigger)
+{
+    pio_sim_program_t prog = {signal_generator_counted_program_instructions,
+                              sizeof(signal_generator_counted_program_instructions) / sizeof(uint16_t),
+                              signal_generator_counted_wrap_target, signal_generator_counted_wrap, 0, false};
+    pio_sim_load(sm, &prog, 0);
+    sm->set_base = SG_PIN_CH1;
+    sm->set_count = SG_PIN_TRIG_OUT - SG_PIN_CH1 + 1;
+    sm->in_base = SG_PIN_TRIG_IN;
+    sm->clkdiv_fixed = clkdiv_fixed;
+    pio_sim_sm_reset(sm, external_trigger ? 0 : signal_generator_counted_offset_start);
+}
+
+bool sg_simulate_periods(sg_program_t program, const uint32_t *words, uint32_t length,
+                         uint32_t clkdiv_fixed, uint32_t periods, uint64_t max_cycles, sg_stop_t *out)
+{
+    static pio_sim_t sim;
+    static uint32_t counted_word;
+    period_ctx_t ctx = {0};
+
+    memset(out, 0, sizeof(*out));
+    ctx.out = out;
+    ctx.truth.truth = &out->ch1;
+    ctx.remaining = periods;
+
+    pio_sim_init(&sim, 1);
+    pio_sim_sm_t *sm = &sim.sm[0];
+    if (program == SG_PROGRAM_STATIC)
+    {
+        load_counted(sm, clkdiv_fixed, false);
+
+        // Sama seperti engine_run(): Y dan ISR lewat CPU, lalu DMA
+        pio_sim_put(sm, words[0] - signal_generator_counted_PULSE_EXTRA);
+        pio_sim_put(sm, words[1]);
+        counted_word = ~(words[3] - signal_generator_counted_D_EXTRA);
+        ctx.words = &counted_word;
+        ctx.length = 1;
+        ctx.done_pc = signal_generator_counted_wrap + 1;
+    }
+    else
+    {
+        load_program(sm, SG_PROGRAM_PATTERN, clkdiv_fixed);
+        ctx.words = words;
+        ctx.length = length;
+        ctx.remaining = (uint64_t)length * periods;
+        ctx.tail = true;
+        ctx.tail_word = PATTERN_WORD(0, 0);
+        ctx.done_pc = pattern_engine_offset_start;
+    }
+    sm->feed = period_feed;
+    sm->feed_ctx = &ctx;
+
+    sim.on_edge = period_edge;
+    sim.edge_ctx = &ctx;
+    sim.on_irq = period_irq;
+    sim.irq_ctx = &ctx;
+    start_logic(&sim);
+    sm->enabled = true;
+    pio_sim_run_until(&sim, sim.now + max_cycles);
+
+    out->final_pins = (sim.gpio_out >> SG_PIN_CH1) & 0xf;
+    return sim.stop;
+}
+
+typedef struct
+{
+    sg_trigger_t *out;
+    bool ch1_fall, trig_fall;
+} trigger_ctx_t;
+
+static void trigger_edge(void *ctx, uint64_t sys_cycle, uint32_t old_pins, uint32_t new_pins)
+{
+    trigger_ctx_t *t = ctx;
+    uint32_t rose = ~old_pins & new_pins, fell = old_pins & ~new_pins;
+    if ((rose >> SG_PIN_CH1) & 1u && !t->out->ch1_rise)
+        t->out->ch1_rise = sys_cycle;
+    if ((fell >> SG_PIN_CH1) & 1u && !t->ch1_fall)
+    {
+        t->out->ch1_fall = sys_cycle;
+        t->ch1_fall = true;
+    }
+    if ((rose >> SG_PIN_TRIG_OUT) & 1u && !t->out->trig_rise)
+        t->out->trig_rise = sys_cycle;
+    if ((fell >> SG_PIN_TRIG_OUT) & 1u && !t->trig_fall)
+    {
+        t->out->trig_fall = sys_cycle;
+        t->trig_fall = true;
+    }
+}
+
+// SM generator (sim->sm[0]) sudah dimuat di "wait 1 pin 0": aktifkan, naikkan
+// pin picu masuk lalu tunggu pulsa CH1 pertama selesai
+static bool run_trigger(pio_sim_t *sim, sg_trigger_t *out, uint64_t trigger_cycle, uint64_t max_cycles)
+{
+    trigger_ctx_t ctx = {out};
+    memset(out, 0, sizeof(*out));
+    sim->on_edge = trigger_edge;
+    sim->edge_ctx = &ctx;
+    sim->sm[0].enabled = true;
+
+    // Siklus pertama yang melihat pin HIGH adalah trigger + sinkronisasi
+    uint64_t visible = trigger_cycle + SG_TRIGGER_SYNC_CYCLES;
+    pio_sim_run_until(sim, visible - 1);
+    if (out->ch1_rise)
+        return false; // SM tidak menunggu picu
+    sim->gpio_in |= 1u << SG_PIN_TRIG_IN;
+    while (sim->now < max_cycles && !(ctx.ch1_fall && ctx.trig_fall))
+        pio_sim_run_until(sim, sim->now + 64);
+    return ctx.ch1_fall && ctx.trig_fall;
+}
+
+bool sg_simulate_trigger(const uint32_t delays[4], uint32_t clkdiv_fixed, uint64_t trigger_cycle,
+                         uint64_t max_cycles, sg_trigger_t *out)
+{
+    static pio_sim_t sim;
+    static uint32_t counted_word;
+
+    pio_sim_init(&sim, 1);
+    pio_sim_sm_t *sm = &sim.sm[0];
+    load_counted(sm, clkdiv_fixed, true);
+    pio_sim_put(sm, delays[0] - signal_generator_counted_PULSE_EXTRA);
+    pio_sim_put(sm, delays[1]);
+    counted_word = ~(delays[3] - signal_generator_counted_D_EXTRA);
+    sg_feed_t feed = {&counted_word, 1, 0};
+    sm->feed = ideal_feed;
+    sm->feed_ctx = &feed;
+    return run_trigger(&sim, out, trigger_cycle, max_cycles);
+}
+
+// Program terurai seperti get_program_config(): dimuat di ujung atas memori
+// instruksi (tempat pio_add_program() menaruhnya) sehingga relokasi JMP ikut
+// diuji; set pins mencakup picu keluar. Mengembalikan offset program.
+static uint32_t load_unrolled(pio_sim_sm_t *sm, const unroll_program_t *prog, bool external_trigger)
+{
+    pio_sim_program_t p = {prog->instructions, prog->length, prog->wrap_target, prog->wrap, 0, false};
+    uint32_t offset = PIO_SIM_INSTR_MEM - prog->length;
+    pio_sim_load(sm, &p, offset);
+    sm->set_base = SG_PIN_CH1;
+    sm->set_count = UNROLL_SET_PINS;
+    sm->in_base = SG_PIN_TRIG_IN;
+    sm->clkdiv_fixed = TIMING_CLKDIV_ONE;
+    pio_sim_sm_reset(sm, offset + (external_trigger ? 0 : UNROLL_OFFSET_START));
+    return offset;
+}
+
+bool sg_simulate_unrolled(const unroll_program_t *prog, uint32_t periods, uint64_t max_cycles, sg_stop_t *out,
+                          sg_pin_log_t *log)
+{
+    static pio_sim_t sim;
+    period_ctx_t ctx = {0};
+
+    memset(out, 0, sizeof(*out));
+    ctx.out = out;
+    ctx.truth.truth = &out->ch1;
+    ctx.log = log;
+    if (log)
+        log->n = 0;
+
+    pio_sim_init(&sim, 1);
+    pio_sim_sm_t *sm = &sim.sm[0];
+    uint32_t offset = load_unrolled(sm, prog, false);
+
+    // Sama seperti engine_run(): satu kata hitungan periode, tanpa umpan
+    pio_sim_put(sm, periods - 1);
+    ctx.done_pc = offset + prog->wrap;
+    sm->feed = period_feed;
+    sm->feed_ctx = &ctx;
+
+    sim.on_edge = period_edge;
+    sim.edge_ctx = &ctx;
+    start_logic(&sim);
+    sm->enabled = true;
+    pio_sim_run_until(&sim, sim.now + max_cycles);
+
+    out->final_pins = (sim.gpio_out >> SG_PIN_CH1) & 0xf;
+    return sim.stop;
+}
+
+bool sg_simulate_unrolled_trigger(const unroll_program_t *prog, uint64_t trigger_cycle, uint64_t max_cycles,
+                                  sg_trigger_t *out)
+{
+    static pio_sim_t sim;
+
+    pio_sim_init(&sim, 1);
+    load_unrolled(&sim.sm[0], prog, true);
+    pio_sim_put(&sim.sm[0], UINT32_MAX); // Hitungan periode tidak habis selama uji
+    return run_trigger(&sim, out, trigger_cycle, max_cycles);
+}
+
+static void minmax(uint64_t v, uint64_t *mn, uint64_t *mx)
+{
+    if (v < *mn)
+        *mn = v;
+    if (v > *mx)
+        *mx = v;
+}
+
+bool sg_measure(const sg_edges_t *e, sg_measure_t *m)
+{
+    memset(m, 0, sizeof(*m));
+    m->period_min = m->pulse_min = m->dead_min = UINT64_MAX;
+
+    uint32_t n = e->n_ch1_rise < SG_MAX_EDGES ? e->n_ch1_rise : SG_MAX_EDGES;
+    for (uint32_t i = 0; i + 1 < n; i++)
+    {
+        // Periode ke-i: CH1 naik [i] ... CH1 naik [i+1]
+        if (i >= e->n_ch1_fall || i >= e->n_ch2_rise || i >= e->n_ch2_fall)
+            return false;
+        minmax(e->ch1_rise[i + 1] - e->ch1_rise[i], &m->period_min, &m->period_max);
+        minmax(e->ch1_fall[i] - e->ch1_rise[i], &m->pulse_min, &m->pulse_max);
+        minmax(e->ch2_fall[i] - e->ch2_rise[i], &m->pulse_min, &m->pulse_max);
+        minmax(e->ch2_rise[i] - e->ch1_fall[i], &m->dead_min, &m->dead_max);
+        m->periods++;
+    }
+    return m->periods > 0;
+}
+
+// Urutan perubahan pin yang diharapkan dari kata tabel, dalam siklus clk_sys
+// sejak event pertama, mulai dari semua pin LOW saat SM diaktifkan
+uint32_t sg_expected_edges(const pattern_table_t *t, uint32_t clkdiv_fixed, uint32_t periods,
+                           uint64_t *cycle, uint8_t *pins)
+{
+    uint64_t div = clkdiv_fixed >> 8;
+    uint32_t n = 0;
+    uint8_t prev = 0;
+    uint64_t now = 0;
+    for (uint32_t p = 0; p < periods; p++)
+        for (uint32_t i = 0; i < t->length; i++)
+        {
+            uint8_t mask = pattern_word_mask(t->words[i]);
+            if (mask != prev && n < SG_MAX_LOG)
+            {
+                cycle[n] = now;
+                pins[n++] = mask;
+            }
+            prev = mask;
+            now += ((uint64_t)pattern_word_count(t->words[i]) + sg_event_overhead(SG_PROGRAM_PATTERN)) * div;
+        }
+    return n;
+}
+
+// Bandingkan log simulasi dengan urutan yang diharapkan tanpa toleransi satu
+// siklus pun. Tepi pertama menentukan latensi start (t0, siklus event
+// pertama dalam log); sisanya harus eksak.
+bool sg_compare_edges(const sg_pin_log_t *log, const uint64_t *cycle, const uint8_t *pins,
+                      uint32_t n, uint64_t *t0)
+{
+    if (log->n < n || n == 0)
+        return false;
+    *t0 = log->cycle[0] - cycle[0];
+    for (uint32_t i = 0; i < n; i++)
+        if (log->cycle[i] - *t0 != cycle[i] || log->pins[i] != pins[i])
+        {
+            printf("  tepi %u: %llu siklus pin %x, diharapkan %llu pin %x\n", i,
+                   (unsigned long long)(log->cycle[i] - *t0), log->pins[i],
+                   (unsigned long long)cycle[i], pins[i]);
+            return false;
+        }
+    return true;
+}
+
+uint32_t sg_unroll_budget(void)
+{
+    return UNROLL_MAX_INSTRUCTIONS - sizeof(pattern_engine_program_instructions) / sizeof(uint16_t);
+}
+
+timing_status_t sg_counted_status(const timing_request_t *req, uint32_t sys_clk_hz)
+{
+    uint32_t div;
+    timing_plan_t plan;
+    timing_status_t status =
+        timing_compile_auto(req, sys_clk_hz, signal_generator_counted_EVENT_OVERHEAD, &div, &plan);
+    if (status == TIMING_OK && plan.delay[0] < signal_generator_counted_PULSE_EXTRA)
+        status = TIMING_ERR_EVENT_TOO_SHORT;
+    if (status == TIMING_OK && plan.delay[3] <= signal_generator_counted_D_EXTRA)
+        status = TIMING_ERR_PERIOD_TOO_SHORT;
+    return status;
+}
@@ -0,0 +1,189 @@
+#ifndef SG_RUN_H
+#define SG_RUN_H
+
+/**
+ * Menjalankan program signal_generator / pattern_engine di simulator PIO dan
+ * mengukur tepi CH1 (GP6) dan CH2 (GP7) seperti yang akan terlihat pada
+ * osiloskop.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "pattern.h"
+#include "pio_sim.h"
+#include "pio_unroll.h"
+#include "pulse_stats.h"
+
+#define SG_SYS_CLK_HZ 125000000u
+#define SG_PIN_CH1 6
+#define SG_PIN_CH2 7
+#define SG_PIN_TRIG_OUT 10 // pin_base + PE_TRIGGER_OUT_OFFSET
+#define SG_PIN_TRIG_IN 11  // pin_base + PE_TRIGGER_IN_OFFSET
+// Sinkronisasi input GPIO RP2040: dua flip-flop clk_sys sebelum pin
+// terlihat oleh PIO (tidak dimodelkan pio_sim, ditambahkan di sini)
+#define SG_TRIGGER_SYNC_CYCLES 2
+#define SG_MAX_EDGES 8
+#define SG_MAX_LOG 4096
+
+typedef enum
+{
+    SG_PROGRAM_DYNAMIC, // signal_generator + umpan FIFO (DMA ideal)
+    SG_PROGRAM_STATIC,  // signal_generator_static
+    SG_PROGRAM_PATTERN, // pattern_engine + tabel pola (DMA ideal)
+} sg_program_t;
+
+typedef struct
+{
+    uint64_t ch1_rise[SG_MAX_EDGES], ch1_fall[SG_MAX_EDGES];
+    uint64_t ch2_rise[SG_MAX_EDGES], ch2_fall[SG_MAX_EDGES];
+    uint32_t n_ch1_rise, n_ch1_fall, n_ch2_rise, n_ch2_fall;
+    FILE *trace; // Bila tidak NULL, setiap tepi pin dicetak dengan timestamp
+} sg_edges_t;
+
+// Umpan tabel ideal (DMA tidak pernah terlambat), berputar tanpa batas
+typedef struct
+{
+    const uint32_t *table;
+    uint32_t words;
+    uint32_t next;
+} sg_feed_t;
+
+// Setiap perubahan GP6..GP9 (nibble, bit 0 = GP6) dengan timestamp clk_sys
+typedef struct
+{
+    uint64_t cycle[SG_MAX_LOG];
+    uint8_t pins[SG_MAX_LOG];
+    uint32_t n;
+} sg_pin_log_t;
+
+// Hasil pengukuran dalam siklus clk_sys (min/maks atas semua periode)
+typedef struct
+{
+    uint32_t periods;
+    uint64_t period_min, period_max;
+    uint64_t pulse_min, pulse_max; // Lebar pulsa CH1 dan CH2
+    uint64_t dead_min, dead_max;   // CH1 turun -> CH2 naik
+} sg_measure_t;
+
+// clk_sys yang dimodelkan (default SG_SYS_CLK_HZ; 250 MHz untuk mode presisi tinggi)
+extern uint32_t sg_sys_clk_hz;
+
+uint32_t sg_event_overhead(sg_program_t program);
+
+// Jalankan 'periods' periode penuh; false bila tepi yang diharapkan tidak
+// muncul sebelum max_cycles. Untuk SG_PROGRAM_PATTERN 'delays' adalah empat
+// kata tabel pola preset bipolar (lib/pattern.h).
+bool sg_simulate(sg_program_t program, const uint32_t delays[4], uint32_t clkdiv_fixed,
+                 uint32_t periods, uint64_t max_cycles, sg_edges_t *edges);
+
+// Alirkan tabel pola sembarang ke pattern_engine selama 'cycles' siklus
+// clk_sys dan catat setiap perubahan pin; false bila log penuh
+bool sg_simulate_table(const uint32_t *words, uint32_t length, uint32_t clkdiv_fixed,
+                       uint64_t cycles, sg_pin_log_t *log);
+
+// Kebenaran dasar dari log pin CH1, dalam siklus clk_sys
+typedef struct
+{
+    uint32_t pulses;
+    uint64_t high_cycles;
+    uint64_t first_rise, last_rise;
+} sg_truth_t;
+
+// Jalankan generator selama 'run_cycles' lalu hentikan seperti engine_halt()
+// (SM mati, pin dipaksa LOW, mungkin di tengah pulsa), dengan SM
+// pulse_counter dan pulse_span di blok PIO kedua mengamati CH1
+void sg_simulate_counted(sg_program_t program, const uint32_t delays[4], uint32_t clkdiv_fixed,
+                         uint64_t run_cycles, uint32_t counter_div, pulse_raw_t *raw, sg_truth_t *truth);
+
+// Proses terhitung (engine_run()): berhenti sendiri setelah tepat 'periods'
+// periode. Semua waktu dalam siklus clk_sys sejak SM diaktifkan.
+typedef struct
+{
+    sg_truth_t ch1;
+    uint64_t stop;       // Program statis: instruksi "irq wait" dieksekusi;
+                         // pola: SM mulai stall di "out pins" setelah kata henti
+    uint64_t last_edge;  // Perubahan GP6..GP9 terakhir
+    uint32_t final_pins; // GP6..GP9 setelah berhenti (bit 0 = GP6)
+    bool irq;            // Flag IRQ SM disetel (program statis)
+    // Program statis: flag IRQ tangkapan A/C yang disetel dan jaraknya dari
+    // tepi naik CH1/CH2 terakhir (lib/pulse_capture.h)
+    uint32_t capture_a, capture_c;
+    uint64_t capture_lag_min, capture_lag_max;
+} sg_stop_t;
+
+// SG_PROGRAM_STATIC: signal_generator_counted dengan 'words' = plan.delay A..D
+// (satu kata ~V per periode seperti start_counted_dma()). SG_PROGRAM_PATTERN:
+// tabel pola 'words' diulang 'periods' kali lalu kata henti, seperti umpan
+// ring + channel kontrol. false bila SM tidak berhenti sebelum max_cycles.
+bool sg_simulate_periods(sg_program_t program, const uint32_t *words, uint32_t length,
+                         uint32_t clkdiv_fixed, uint32_t periods, uint64_t max_cycles, sg_stop_t *out);
+
+// Picu eksternal: tepi pertama setelah tepi naik pin picu masuk, dalam
+// siklus clk_sys sejak SM diaktifkan
+typedef struct
+{
+    uint64_t ch1_rise, ch1_fall;
+    uint64_t trig_rise, trig_fall; // Picu keluar (GP10)
+} sg_trigger_t;
+
+// signal_generator_counted diaktifkan di "wait 1 pin 0" (in_base = picu
+// masuk) dengan 'delays' = plan.delay A..D seperti engine_run(). Tepi picu
+// tiba di pin pada siklus 'trigger_cycle' dan terlihat SM
+// SG_TRIGGER_SYNC_CYCLES siklus kemudian. false bila periode pertama tidak
+// selesai sebelum max_cycles.
+bool sg_simulate_trigger(const uint32_t delays[4], uint32_t clkdiv_fixed, uint64_t trigger_cycle,
+                         uint64_t max_cycles, sg_trigger_t *out);
+
+// Program terurai (lib/pio_unroll.h) pada clkdiv 1 seperti engine_run():
+// satu kata 'periods' - 1 untuk Y, tanpa umpan; 'out->stop' = siklus "irq
+// wait". 'log' (boleh NULL) mencatat setiap perubahan GP6..GP9. false bila
+// SM tidak parkir sebelum max_cycles.
+bool sg_simulate_unrolled(const unroll_program_t *prog, uint32_t periods, uint64_t max_cycles, sg_stop_t *out,
+                          sg_pin_log_t *log);
+
+// Seperti sg_simulate_trigger() untuk program terurai
+bool sg_simulate_unrolled_trigger(const unroll_program_t *prog, uint64_t trigger_cycle, uint64_t max_cycles,
+                                  sg_trigger_t *out);
+
+// Penganalisis logika (logic_analyzer.pio) seperti logic_analyzer_arm():
+// SM 4 (blok PIO kedua) pada clkdiv 1, in_base = CH1, autopush 32 bit ke RX
+// FIFO gabungan yang dikuras DMA ideal ke 'words' sampai 'capacity' kata penuh
+typedef struct
+{
+    uint32_t *words;
+    uint32_t capacity; // Kata
+    bool trigger;      // Masuk di 'trigger' (tepi naik CH1 pertama)
+    uint32_t filled;   // Kata yang sudah dipindahkan
+} sg_logic_t;
+
+// Penganalisis aktif SG_LOGIC_LEAD_CYCLES siklus sebelum generator (arm
+// sebelum pio_sm_set_enabled()), sehingga waktu absolut sg_stop_t dan log
+// pin bergeser sebanyak itu; selisih waktu tidak berubah
+#define SG_LOGIC_LEAD_CYCLES 16
+
+// Pasang penganalisis untuk sg_simulate_periods() / sg_simulate_unrolled()
+// berikutnya; NULL melepasnya
+void sg_attach_logic(sg_logic_t *logic);
+
+bool sg_measure(const sg_edges_t *edges, sg_measure_t *m);
+
+// Ruang program terurai di firmware: blok PIO dikurangi mesin pola
+uint32_t sg_unroll_budget(void);
+
+// Status program loop (signal_generator_counted) seperti engine_configure()
+timing_status_t sg_counted_status(const timing_request_t *req, uint32_t sys_clk_hz);
+
+// Urutan perubahan GP6..GP9 yang diharapkan dari kata tabel pola, dalam
+// siklus clk_sys sejak event pertama, mulai dari semua pin LOW saat SM
+// diaktifkan; paling banyak SG_MAX_LOG perubahan
+uint32_t sg_expected_edges(const pattern_table_t *t, uint32_t clkdiv_fixed, uint32_t periods, uint64_t *cycle,
+                           uint8_t *pins);
+
+// Bandingkan log simulasi dengan urutan yang diharapkan tanpa toleransi satu
+// siklus pun. Tepi pertama menentukan latensi start (t0, siklus event
+// pertama dalam log); sisanya harus eksak. Tepi pertama yang berbeda dicetak.
+bool sg_compare_edges(const sg_pin_log_t *log, const uint64_t *cycle, const uint8_t *pins, uint32_t n,
+                      uint64_t *t0);
+
+#endif
@@ -0,0 +1,86 @@
+/**
+ * bank_adc untuk mgc_app: API lib/bank_adc.h tanpa ADC dan DMA.
+ *
+ * Sampel berasal dari jejak host/adc_trace.c yang dimulai pada
+ * bank_adc_start(). Indeks penulis dihitung dari waktu virtual, dan sampel
+ * baru dibuat saat dibaca, jadi loop yang tertahan (flash, LCD) kehilangan
+ * sampel dengan aturan ring yang sama seperti channel DMA di lib/bank_adc.c.
+ */
+
+#include "bank_adc.h"
+#include "shim.h"
+
+#define RING_GUARD (BANK_ADC_RING_SAMPLES / 8)
+
+static adc_trace_cfg_t trace = {
+    .full_scale_mv = 660000,
+    .v0_mv = 400000,
+    .tau_us = 200000,
+    .noise_lsb = 3,
+};
+static uint16_t ring[BANK_ADC_RING_SAMPLES];
+static uint64_t start_us;
+static uint32_t rate;
+static uint32_t read_index;
+static uint32_t overruns;
+static bool running;
+
+void shim_bank_trace(const adc_trace_cfg_t *cfg)
+{
+    trace = *cfg;
+}
+
+void bank_adc_init(uint adc_gpio)
+{
+    running = false;
+}
+
+uint32_t bank_adc_start(uint32_t rate_hz)
+{
+    // Divider ADC seperti firmware: 48 MHz / siklus, minimal 96 siklus
+    if (rate_hz == 0 || rate_hz > BANK_ADC_MAX_RATE_HZ)
+        rate_hz = BANK_ADC_MAX_RATE_HZ;
+    uint32_t cycles = (48000000u + rate_hz / 2) / rate_hz;
+    if (cycles < 96)
+        cycles = 96;
+    rate = 48000000u / cycles;
+    start_us = time_us_64();
+    read_index = 0;
+    overruns = 0;
+    running = true;
+    return rate;
+}
+
+void bank_adc_stop(void)
+{
+    running = false;
+}
+
+uint32_t bank_adc_next(const uint16_t **samples)
+{
+    if (!running)
+        return 0;
+    uint32_t written = (uint32_t)((time_us_64() - start_us) * rate / 1000000u);
+    uint32_t pending = written - read_index;
+    if (pending > BANK_ADC_RING_SAMPLES - RING_GUARD)
+    {
+        uint32_t skip = pending - BANK_ADC_RING_SAMPLES / 2;
+        overruns += skip;
+        read_index += skip;
+        pending -= skip;
+    }
+    uint32_t start = read_index & (BANK_ADC_RING_SAMPLES - 1);
+    uint32_t n = BANK_ADC_RING_SAMPLES - start;
+    if (n > pending)
+        n = pending;
+    for (uint32_t i = 0; i < n; i++)
+        ring[start + i] = adc_trace_sample(&trace, read_index + i, rate);
+    *samples = &ring[start];
+    read_index += n;
+    return n;
+}
+
+uint32_t bank_adc_overruns(void)
+{
+    return overruns;
+}
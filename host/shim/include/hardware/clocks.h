@@ -0,0 +1,16 @@
+#ifndef SHIM_HARDWARE_CLOCKS_H
+#define SHIM_HARDWARE_CLOCKS_H
+
+#include "pico/stdlib.h"
+
+enum clock_index
+{
+    clk_ref = 4,
+    clk_sys = 5,
+    clk_peri = 6,
+};
+
+// clk_sys dan clk_peri mengikuti set_sys_clock_khz() (awal 125 MHz)
+uint32_t clock_get_hz(enum clock_index clk_index);
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef SHIM_HARDWARE_DMA_H
+#define SHIM_HARDWARE_DMA_H
+
+#include "pico/stdlib.h"
+
+// Channel DMA (host/shim/pio_dma.c): transfer ke IC_DATA_CMD I2C menjadi
+// satu transaksi di model LCD dengan STOP_DET menyusul setelah waktu bus
+// (host/shim/shim.c). Channel yang dipacu DREQ PIO memindahkan satu elemen
+// setiap kali DREQ aktif (TX FIFO punya ruang / RX FIFO berisi) tepat
+// sebelum SM menjalankan instruksi, tanpa latensi bus; DREQ_FORCE berjalan
+// sampai selesai saat dipicu. Ring, chain dan alias register yang ditulis
+// channel lain (mis. AL3_READ_ADDR_TRIG) ikut dimodelkan.
+enum dma_channel_transfer_size
+{
+    DMA_SIZE_8 = 0,
+    DMA_SIZE_16 = 1,
+    DMA_SIZE_32 = 2,
+};
+
+#define NUM_DMA_CHANNELS 12
+#define DREQ_FORCE 0x3f
+
+// Register per channel dengan urutan alias seperti RP2040. Lebarnya
+// uintptr_t, bukan 32 bit: alamat di host 64 bit, sehingga channel yang
+// menulis alamat ke register channel lain menulis satu pointer utuh.
+typedef struct
+{
+    volatile uintptr_t read_addr;
+    volatile uintptr_t write_addr;
+    volatile uintptr_t transfer_count; // Sisa transfer, selalu terkini
+    volatile uintptr_t ctrl_trig;
+    volatile uintptr_t al1_ctrl;
+    volatile uintptr_t al1_read_addr;
+    volatile uintptr_t al1_write_addr;
+    volatile uintptr_t al1_transfer_count_trig;
+    volatile uintptr_t al2_ctrl;
+    volatile uintptr_t al2_transfer_count;
+    volatile uintptr_t al2_read_addr;
+    volatile uintptr_t al2_write_addr_trig;
+    volatile uintptr_t al3_ctrl;
+    volatile uintptr_t al3_write_addr;
+    volatile uintptr_t al3_transfer_count;
+    volatile uintptr_t al3_read_addr_trig;
+} dma_channel_hw_t;
+
+typedef struct
+{
+    dma_channel_hw_t ch[NUM_DMA_CHANNELS];
+} dma_hw_t;
+
+extern dma_hw_t shim_dma_hw;
+#define dma_hw (&shim_dma_hw)
+
+static inline dma_channel_hw_t *dma_channel_hw_addr(uint channel)
+{
+    return &dma_hw->ch[channel];
+}
+
+typedef struct
+{
+    enum dma_channel_transfer_size size;
+    bool read_increment, write_increment;
+    uint dreq;
+    uint chain_to; // Sama dengan channel sendiri: tanpa chain
+    bool ring_write;
+    uint ring_bits; // 0: tanpa ring
+} dma_channel_config;
+
+int dma_claim_unused_channel(bool required);
+dma_channel_config dma_channel_get_default_config(uint channel);
+void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size);
+void channel_config_set_read_increment(dma_channel_config *c, bool incr);
+void channel_config_set_write_increment(dma_channel_config *c, bool incr);
+void channel_config_set_dreq(dma_channel_config *c, uint dreq);
+void channel_config_set_chain_to(dma_channel_config *c, uint chain_to);
+void channel_config_set_ring(dma_channel_config *c, bool write, uint size_bits);
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint transfer_count, bool trigger);
+void dma_channel_transfer_from_buffer_now(uint channel, const volatile void *read_addr, uint32_t transfer_count);
+void dma_channel_abort(uint channel);
+void dma_channel_unclaim(uint channel);
+bool dma_channel_is_busy(uint channel);
+
+#endif
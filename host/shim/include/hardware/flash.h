@@ -0,0 +1,14 @@
+#ifndef SHIM_HARDWARE_FLASH_H
+#define SHIM_HARDWARE_FLASH_H
+
+#include "pico/stdlib.h"
+
+#define FLASH_SECTOR_SIZE 4096u
+#define FLASH_PAGE_SIZE 256u
+
+// Semantik NOR (erase -> 0xFF, program hanya 1 -> 0) dengan waktu operasi
+// tipikal W25Q16; isi ditulis ke berkas bila shim_flash_attach() dipakai
+void flash_range_erase(uint32_t flash_offs, size_t count);
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count);
+
+#endif
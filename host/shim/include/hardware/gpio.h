@@ -0,0 +1,7 @@
+#ifndef SHIM_HARDWARE_GPIO_H
+#define SHIM_HARDWARE_GPIO_H
+
+// Fungsi GPIO dideklarasikan di pico/stdlib.h (shim)
+#include "pico/stdlib.h"
+
+#endif
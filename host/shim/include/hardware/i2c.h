@@ -0,0 +1,47 @@
+#ifndef SHIM_HARDWARE_I2C_H
+#define SHIM_HARDWARE_I2C_H
+
+#include "pico/stdlib.h"
+#include "hardware/irq.h"
+
+// Register DW_apb_i2c yang dipakai lib/lcd_i2c.c. Membaca clr_* tidak
+// membersihkan apa pun di host: shim membersihkan status interupsi setelah
+// handler kembali.
+typedef struct
+{
+    volatile uint32_t tar;
+    volatile uint32_t data_cmd;
+    volatile uint32_t intr_stat;
+    volatile uint32_t intr_mask;
+    volatile uint32_t raw_intr_stat;
+    volatile uint32_t clr_intr;
+    volatile uint32_t clr_tx_abrt;
+    volatile uint32_t clr_stop_det;
+    volatile uint32_t enable;
+} i2c_hw_t;
+
+typedef struct i2c_inst
+{
+    i2c_hw_t *hw;
+    uint index;
+    uint baudrate;
+} i2c_inst_t;
+
+extern i2c_inst_t i2c0_inst;
+#define i2c0 (&i2c0_inst)
+
+#define I2C_IC_DATA_CMD_STOP_BITS 0x200u
+#define I2C_IC_INTR_MASK_M_STOP_DET_BITS 0x200u
+#define I2C_IC_INTR_MASK_M_TX_ABRT_BITS 0x40u
+#define I2C_IC_INTR_STAT_R_STOP_DET_BITS 0x200u
+#define I2C_IC_INTR_STAT_R_TX_ABRT_BITS 0x40u
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate);
+uint i2c_set_baudrate(i2c_inst_t *i2c, uint baudrate);
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+
+static inline i2c_hw_t *i2c_get_hw(i2c_inst_t *i2c) { return i2c->hw; }
+static inline uint i2c_get_index(i2c_inst_t *i2c) { return i2c->index; }
+static inline uint i2c_get_dreq(i2c_inst_t *i2c, bool is_tx) { return 32u + 2u * i2c->index + (is_tx ? 0u : 1u); }
+
+#endif
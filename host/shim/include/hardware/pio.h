@@ -0,0 +1,237 @@
+#ifndef SHIM_HARDWARE_PIO_H
+#define SHIM_HARDWARE_PIO_H
+
+#include "pico/stdlib.h"
+
+// Kedua blok PIO dijalankan simulator host/pio_sim.c (host/shim/pio_dma.c)
+// pada waktu virtual: setiap panggilan di sini lebih dulu menjalankan SM
+// sampai saat ini. Register yang dibaca/ditulis langsung oleh firmware
+// (FDEBUG, alamat TXF/RXF untuk DMA) ada di pio_hw_t; FDEBUG diperbarui
+// setiap kali waktu maju dan tulis-1-hapus diterapkan saat sinkron berikutnya.
+typedef struct
+{
+    volatile uint32_t ctrl;
+    volatile uint32_t fstat;
+    volatile uint32_t fdebug;
+    volatile uint32_t flevel;
+    volatile uint32_t txf[4];
+    volatile uint32_t rxf[4];
+    volatile uint32_t irq;
+} pio_hw_t;
+
+typedef pio_hw_t *PIO;
+
+extern pio_hw_t shim_pio0_hw, shim_pio1_hw;
+#define pio0 (&shim_pio0_hw)
+#define pio1 (&shim_pio1_hw)
+
+#define NUM_PIO_STATE_MACHINES 4
+#define PIO_INSTRUCTION_COUNT 32
+#define PIO_FDEBUG_TXSTALL_LSB 24
+#define PIO_FDEBUG_RXSTALL_LSB 0
+
+typedef struct pio_program
+{
+    const uint16_t *instructions;
+    uint8_t length;
+    int8_t origin; // -1: di mana saja
+    uint8_t pio_version;
+} pio_program_t;
+
+// ===================== KONFIGURASI SM =====================
+// Bukan register SMx_* seperti SDK: field terpisah yang disalin ke SM
+// simulator oleh pio_sm_init()
+typedef struct
+{
+    uint32_t clkdiv_fixed; // 16.8
+    uint32_t wrap_target, wrap;
+    uint32_t set_base, set_count;
+    uint32_t out_base, out_count;
+    uint32_t in_base;
+    uint32_t sideset_base, sideset_bits;
+    bool sideset_opt;
+    uint32_t jmp_pin;
+    bool out_shift_right, autopull;
+    uint32_t pull_threshold;
+    bool in_shift_right, autopush;
+    uint32_t push_threshold;
+    uint32_t fifo_join;
+} pio_sm_config;
+
+enum pio_fifo_join
+{
+    PIO_FIFO_JOIN_NONE = 0,
+    PIO_FIFO_JOIN_TX = 1,
+    PIO_FIFO_JOIN_RX = 2,
+};
+
+static inline pio_sm_config pio_get_default_sm_config(void)
+{
+    return (pio_sm_config){
+        .clkdiv_fixed = 256,
+        .wrap_target = 0,
+        .wrap = PIO_INSTRUCTION_COUNT - 1,
+        .out_shift_right = true,
+        .pull_threshold = 32,
+        .in_shift_right = true,
+        .push_threshold = 32,
+    };
+}
+
+static inline void sm_config_set_wrap(pio_sm_config *c, uint wrap_target, uint wrap)
+{
+    c->wrap_target = wrap_target;
+    c->wrap = wrap;
+}
+
+static inline void sm_config_set_set_pins(pio_sm_config *c, uint set_base, uint set_count)
+{
+    c->set_base = set_base;
+    c->set_count = set_count;
+}
+
+static inline void sm_config_set_out_pins(pio_sm_config *c, uint out_base, uint out_count)
+{
+    c->out_base = out_base;
+    c->out_count = out_count;
+}
+
+static inline void sm_config_set_in_pins(pio_sm_config *c, uint in_base)
+{
+    c->in_base = in_base;
+}
+
+static inline void sm_config_set_sideset_pins(pio_sm_config *c, uint sideset_base)
+{
+    c->sideset_base = sideset_base;
+}
+
+static inline void sm_config_set_sideset(pio_sm_config *c, uint bit_count, bool optional, bool pindirs)
+{
+    c->sideset_bits = bit_count;
+    c->sideset_opt = optional;
+}
+
+static inline void sm_config_set_jmp_pin(pio_sm_config *c, uint pin)
+{
+    c->jmp_pin = pin;
+}
+
+static inline void sm_config_set_clkdiv_int_frac8(pio_sm_config *c, uint32_t div_int, uint8_t div_frac8)
+{
+    c->clkdiv_fixed = (div_int << 8) | div_frac8;
+}
+
+static inline void sm_config_set_out_shift(pio_sm_config *c, bool shift_right, bool autopull, uint pull_threshold)
+{
+    c->out_shift_right = shift_right;
+    c->autopull = autopull;
+    c->pull_threshold = pull_threshold;
+}
+
+static inline void sm_config_set_in_shift(pio_sm_config *c, bool shift_right, bool autopush, uint push_threshold)
+{
+    c->in_shift_right = shift_right;
+    c->autopush = autopush;
+    c->push_threshold = push_threshold;
+}
+
+static inline void sm_config_set_fifo_join(pio_sm_config *c, enum pio_fifo_join join)
+{
+    c->fifo_join = join;
+}
+
+// ===================== MEMORI INSTRUKSI DAN SM =====================
+bool pio_can_add_program(PIO pio, const pio_program_t *program);
+uint pio_add_program(PIO pio, const pio_program_t *program);
+void pio_remove_program(PIO pio, const pio_program_t *program, uint loaded_offset);
+
+int pio_claim_unused_sm(PIO pio, bool required);
+void pio_sm_unclaim(PIO pio, uint sm);
+bool pio_sm_is_claimed(PIO pio, uint sm);
+
+void pio_gpio_init(PIO pio, uint pin);
+int pio_sm_set_consecutive_pindirs(PIO pio, uint sm, uint pin_base, uint pin_count, bool is_out);
+void pio_sm_init(PIO pio, uint sm, uint initial_pc, const pio_sm_config *config);
+void pio_sm_set_enabled(PIO pio, uint sm, bool enabled);
+void pio_set_sm_mask_enabled(PIO pio, uint32_t mask, bool enabled);
+void pio_enable_sm_mask_in_sync(PIO pio, uint32_t mask);
+
+void pio_sm_exec(PIO pio, uint sm, uint instr);
+uint8_t pio_sm_get_pc(PIO pio, uint sm);
+void pio_sm_put(PIO pio, uint sm, uint32_t data);
+uint32_t pio_sm_get(PIO pio, uint sm); // 0 bila RX FIFO kosong
+uint pio_sm_get_tx_fifo_level(PIO pio, uint sm);
+bool pio_sm_is_tx_fifo_empty(PIO pio, uint sm);
+bool pio_sm_is_tx_fifo_full(PIO pio, uint sm);
+void pio_sm_clear_fifos(PIO pio, uint sm);
+
+static inline uint pio_get_index(PIO pio) { return pio == pio1; }
+static inline uint pio_get_dreq(PIO pio, uint sm, bool is_tx)
+{
+    return pio_get_index(pio) * 8u + (is_tx ? 0u : 4u) + sm;
+}
+
+// ===================== IRQ =====================
+typedef enum pio_interrupt_source
+{
+    pis_interrupt0 = 8,
+    pis_interrupt1 = 9,
+    pis_interrupt2 = 10,
+    pis_interrupt3 = 11,
+} pio_interrupt_source_t;
+
+// Jalur IRQ_0/IRQ_1 blok PIO aktif (level) selama flag 0..3 yang dirutekan
+// tersetel; lihat hardware/irq.h untuk nomor interupsinya
+void pio_set_irq0_source_enabled(PIO pio, pio_interrupt_source_t source, bool enabled);
+void pio_set_irq1_source_enabled(PIO pio, pio_interrupt_source_t source, bool enabled);
+bool pio_interrupt_get(PIO pio, uint pio_interrupt_num);
+void pio_interrupt_clear(PIO pio, uint pio_interrupt_num);
+
+// ===================== ENKODER INSTRUKSI =====================
+enum pio_src_dest
+{
+    pio_pins = 0,
+    pio_x = 1,
+    pio_y = 2,
+    pio_null = 3,
+    pio_pindirs = 4,
+    pio_exec_mov = 4,
+    pio_status = 5,
+    pio_pc = 5,
+    pio_isr = 6,
+    pio_osr = 7,
+    pio_exec_out = 7,
+};
+
+static inline uint pio_encode_set(enum pio_src_dest dest, uint value)
+{
+    return 0xe000u | ((dest & 7u) << 5) | (value & 0x1fu);
+}
+
+static inline uint pio_encode_mov(enum pio_src_dest dest, enum pio_src_dest src)
+{
+    return 0xa000u | ((dest & 7u) << 5) | (src & 7u);
+}
+
+static inline uint pio_encode_mov_not(enum pio_src_dest dest, enum pio_src_dest src)
+{
+    return 0xa000u | ((dest & 7u) << 5) | (1u << 3) | (src & 7u);
+}
+
+static inline uint pio_encode_in(enum pio_src_dest src, uint count)
+{
+    return 0x4000u | ((src & 7u) << 5) | (count & 0x1fu);
+}
+
+static inline uint pio_encode_push(bool if_full, bool block)
+{
+    return 0x8000u | (if_full ? 0x40u : 0) | (block ? 0x20u : 0);
+}
+
+static inline uint pio_encode_pull(bool if_empty, bool block)
+{
+    return 0x8080u | (if_empty ? 0x40u : 0) | (block ? 0x20u : 0);
+}
+
+#endif
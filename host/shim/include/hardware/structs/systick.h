@@ -0,0 +1,22 @@
+#ifndef SHIM_HARDWARE_STRUCTS_SYSTICK_H
+#define SHIM_HARDWARE_STRUCTS_SYSTICK_H
+
+#include "pico/stdlib.h"
+
+#define M0PLUS_SYST_CSR_ENABLE_BITS 0x00000001u
+#define M0PLUS_SYST_CSR_CLKSOURCE_BITS 0x00000004u
+
+// SysTick core 0: CVR menghitung turun satu per siklus clk_sys dari waktu
+// virtual (resolusi 1 us), dihitung ulang setiap kali waktu maju
+typedef struct
+{
+    volatile uint32_t csr;
+    volatile uint32_t rvr;
+    volatile uint32_t cvr;
+    volatile uint32_t calib;
+} systick_hw_t;
+
+extern systick_hw_t shim_systick_hw;
+#define systick_hw (&shim_systick_hw)
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef SHIM_HARDWARE_SYNC_H
+#define SHIM_HARDWARE_SYNC_H
+
+#include "pico/stdlib.h"
+
+// Interupsi tertunda (alarm, GPIO, I2C) baru dijalankan saat dipulihkan
+uint32_t save_and_disable_interrupts(void);
+void restore_interrupts(uint32_t status);
+
+void __sev(void);
+void __wfe(void);
+static inline void __dmb(void) {}
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef SHIM_HARDWARE_TIMER_H
+#define SHIM_HARDWARE_TIMER_H
+
+#include "pico/stdlib.h"
+
+// Hanya register yang dibaca firmware; ikut maju bersama waktu virtual
+typedef struct
+{
+    volatile uint32_t timerawh;
+    volatile uint32_t timerawl;
+} timer_hw_t;
+
+extern timer_hw_t shim_timer_hw;
+#define timer_hw (&shim_timer_hw)
+
+#endif
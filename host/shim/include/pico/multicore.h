@@ -0,0 +1,30 @@
+#ifndef SHIM_PICO_MULTICORE_H
+#define SHIM_PICO_MULTICORE_H
+
+#include "pico/stdlib.h"
+
+// Core 1 berjalan sebagai coroutine di atas waktu virtual yang sama
+// (host/shim/shim.c): ia mendapat giliran setiap kali core 0 menunggu
+// (sleep, WFE, FIFO) dan berjalan sampai ia sendiri menunggu. FIFO antar
+// core 8 kata per arah seperti SIO; push membangunkan WFE kedua core.
+void multicore_launch_core1(void (*entry)(void));
+
+// Di core 1 poll kosong berulang pada waktu yang sama menghabiskan 1 us,
+// agar loop sibuk yang hanya mem-poll FIFO tetap memajukan waktu
+bool multicore_fifo_rvalid(void);
+bool multicore_fifo_wready(void);
+void multicore_fifo_push_blocking(uint32_t data);
+uint32_t multicore_fifo_pop_blocking(void);
+
+// SDK: versi inline untuk kode yang berjalan dari RAM
+static inline void multicore_fifo_push_blocking_inline(uint32_t data)
+{
+    multicore_fifo_push_blocking(data);
+}
+
+static inline uint32_t multicore_fifo_pop_blocking_inline(void)
+{
+    return multicore_fifo_pop_blocking();
+}
+
+#endif
@@ -0,0 +1,119 @@
+#ifndef SHIM_PICO_STDLIB_H
+#define SHIM_PICO_STDLIB_H
+
+/**
+ * Shim HAL Pico SDK untuk build host (mgc_app)
+ *
+ * Hanya subset API yang dipakai main.c dan lib/ dengan nama dan tipe yang
+ * sama seperti SDK, diimplementasikan di host/shim/shim.c di atas waktu
+ * virtual: waktu hanya maju lewat sleep/busy wait/WFE, dan alarm, GPIO,
+ * I2C, DMA serta CDC menjadi event yang dijalankan sebagai "interupsi"
+ * saat waktu melewatinya. PIO berjalan di simulator host/pio_sim.c dan
+ * core 1 sebagai coroutine (pico/multicore.h). Kendali dari harness lewat
+ * host/shim/shim.h.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+typedef unsigned int uint;
+
+// ===================== WAKTU =====================
+typedef uint64_t absolute_time_t;
+
+uint64_t time_us_64(void);
+static inline uint32_t time_us_32(void) { return (uint32_t)time_us_64(); }
+static inline absolute_time_t get_absolute_time(void) { return time_us_64(); }
+static inline absolute_time_t from_us_since_boot(uint64_t us) { return us; }
+static inline uint64_t to_us_since_boot(absolute_time_t t) { return t; }
+static inline uint32_t to_ms_since_boot(absolute_time_t t) { return (uint32_t)(t / 1000u); }
+static inline absolute_time_t make_timeout_time_us(uint64_t us) { return time_us_64() + us; }
+static inline absolute_time_t make_timeout_time_ms(uint32_t ms) { return time_us_64() + ms * 1000ull; }
+
+void sleep_us(uint64_t us);
+void sleep_ms(uint32_t ms);
+void busy_wait_us(uint64_t us);
+
+// Putaran tunggu sibuk memajukan waktu 1 us agar event yang ditunggu tiba
+// (di core 1: memberi giliran ke core 0 selama 1 us)
+void tight_loop_contents(void);
+
+// Tidur sampai interupsi, __sev() atau 't'; true bila batas waktu tercapai
+bool best_effort_wfe_or_timeout(absolute_time_t t);
+
+// ===================== ALARM =====================
+typedef int32_t alarm_id_t;
+// Kembalian: 0 selesai, >0 ulangi relatif ke jadwal sebelumnya, <0 relatif ke sekarang
+typedef int64_t (*alarm_callback_t)(alarm_id_t id, void *user_data);
+
+alarm_id_t add_alarm_at(absolute_time_t t, alarm_callback_t callback, void *user_data, bool fire_if_past);
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void *user_data, bool fire_if_past);
+alarm_id_t add_alarm_in_ms(uint32_t ms, alarm_callback_t callback, void *user_data, bool fire_if_past);
+bool cancel_alarm(alarm_id_t id);
+
+// ===================== GPIO =====================
+#define GPIO_IN 0
+#define GPIO_OUT 1
+
+enum gpio_function
+{
+    GPIO_FUNC_I2C = 3,
+    GPIO_FUNC_PIO0 = 6,
+    GPIO_FUNC_PIO1 = 7,
+    GPIO_FUNC_SIO = 5,
+    GPIO_FUNC_NULL = 0x1f,
+};
+
+enum gpio_irq_level
+{
+    GPIO_IRQ_LEVEL_LOW = 1,
+    GPIO_IRQ_LEVEL_HIGH = 2,
+    GPIO_IRQ_EDGE_FALL = 4,
+    GPIO_IRQ_EDGE_RISE = 8,
+};
+
+typedef void (*gpio_irq_callback_t)(uint gpio, uint32_t event_mask);
+
+void gpio_init(uint gpio);
+void gpio_set_dir(uint gpio, bool out);
+void gpio_set_function(uint gpio, enum gpio_function fn);
+void gpio_pull_up(uint gpio);
+void gpio_pull_down(uint gpio);
+void gpio_put(uint gpio, bool value);
+bool gpio_get(uint gpio);
+void gpio_set_irq_enabled(uint gpio, uint32_t events, bool enabled);
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t events, bool enabled, gpio_irq_callback_t callback);
+
+// ===================== STDIO (CDC) =====================
+#define PICO_OK 0
+#define PICO_ERROR_TIMEOUT -1
+#define PICO_ERROR_GENERIC -2
+
+bool stdio_init_all(void);
+int getchar_timeout_us(uint32_t timeout_us);
+int stdio_put_string(const char *s, int len, bool newline, bool cr_translation);
+void stdio_set_chars_available_callback(void (*fn)(void *), void *param);
+
+// printf firmware masuk ke aliran CDC yang sama dengan bingkai protokol
+int shim_printf(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+#define printf shim_printf
+
+// ===================== CLOCK DAN LAIN-LAIN =====================
+bool set_sys_clock_khz(uint32_t freq_khz, bool required);
+void setup_default_uart(void);
+
+#define PICO_FLASH_SIZE_BYTES (2u * 1024u * 1024u)
+// Jendela XIP = isi flash tiruan (host/shim/shim.c)
+extern uint8_t shim_flash_mem[PICO_FLASH_SIZE_BYTES];
+#define XIP_BASE ((uintptr_t)shim_flash_mem)
+
+// Core yang sedang berjalan (core 1: coroutine multicore_launch_core1())
+uint get_core_num(void);
+
+#define __not_in_flash_func(func_name) func_name
+#define __time_critical_func(func_name) func_name
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+
+#endif
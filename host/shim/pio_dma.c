@@ -0,0 +1,752 @@
+/**
+ * PIO dan DMA untuk mgc_app: API hardware/pio.h dan hardware/dma.h di atas
+ * simulator host/pio_sim.c, sehingga lib/pulse_engine.c, pulse_counter.c,
+ * logic_analyzer.c dan pio_programs.c berjalan tanpa diubah.
+ *
+ * Kedua blok PIO adalah satu pio_sim_t dengan 8 SM (SM n blok b = indeks
+ * b x 4 + n) yang dijalankan sampai waktu virtual setiap kali waktu maju
+ * (shim_pio_run_to(), dari host/shim/shim.c) dan sebelum setiap panggilan
+ * API di sini. Waktu -> siklus clk_sys mengikuti set_sys_clock_khz().
+ * SM yang stall melompati tick-nya (pio_sim_t.skip_stalls),
+ * jadi proses detik-an dengan clkdiv 1 tetap murah.
+ *
+ * Flag IRQ 0..3 yang dirutekan ke IRQ_0/IRQ_1 blok adalah jalur level:
+ * simulasi berhenti pada siklus flag naik bila jalurnya aktif di NVIC salah
+ * satu core, sehingga handler (mis. engine_irq_handler() di core 1)
+ * berjalan pada mikrodetik yang benar, dan jalur ditandai tertunda lagi
+ * selama flag belum dihapus.
+ *
+ * Channel DMA yang dipacu DREQ PIO dipompa sebagai umpan SM (dipanggil
+ * pio_sim tepat sebelum SM menjalankan instruksi): satu elemen per DREQ
+ * aktif tanpa latensi bus. Chain, ring dan tulisan ke register channel lain
+ * (alias *_TRIG) dijalankan di pompa yang sama.
+ */
+
+#include "shim_hw.h"
+#include "shim.h"
+#include <stdlib.h>
+#include <string.h>
+#include "hardware/irq.h"
+#include "hardware/pio.h"
+#include "pio_sim.h"
+
+pio_hw_t shim_pio0_hw, shim_pio1_hw;
+dma_hw_t shim_dma_hw;
+
+// ===================== SIMULATOR DAN WAKTU =====================
+typedef struct
+{
+    uint16_t mem[PIO_INSTRUCTION_COUNT];
+    uint32_t used;    // Slot instruksi terisi
+    uint32_t claimed; // SM yang diklaim
+    uint32_t inte[2]; // Sumber IRQ_0 / IRQ_1 (bit = pio_interrupt_source_t)
+} shim_pio_t;
+
+static pio_sim_t sim;
+static shim_pio_t blocks[2];
+static uint32_t pio_owned; // Pin dengan fungsi GPIO_FUNC_PIO0/1
+
+// Siklus clk_sys = cyc_base pada us_base, lalu clk_hz
+static uint64_t us_base, cyc_base;
+static uint32_t clk_hz = 125000000u;
+
+static void sim_irq(void *ctx, uint64_t sys_cycle, uint32_t sm, uint32_t flag);
+
+__attribute__((constructor)) static void pio_reset(void)
+{
+    pio_sim_init(&sim, PIO_SIM_MAX_SM);
+    sim.skip_stalls = true;
+    sim.on_irq = sim_irq;
+}
+
+static PIO pio_of(uint block)
+{
+    return block ? pio1 : pio0;
+}
+
+static pio_sim_sm_t *sim_sm(PIO pio, uint sm)
+{
+    return &sim.sm[pio_get_index(pio) * NUM_PIO_STATE_MACHINES + sm];
+}
+
+static uint64_t cycle_at(uint64_t us)
+{
+    return cyc_base + (us - us_base) * clk_hz / 1000000u;
+}
+
+static uint64_t us_at_ceil(uint64_t cycle)
+{
+    return us_base + ((cycle - cyc_base) * 1000000u + clk_hz - 1) / clk_hz;
+}
+
+// FDEBUG lengket milik simulator diterbitkan dengan penanda bit 31 (tidak
+// dipakai perangkat keras). Firmware menghapus dengan menulis 1 yang
+// menimpa register tanpa penanda; bit itu dihapus dari simulator di sini.
+#define FDEBUG_MARK (1u << 31)
+
+static void fdebug_collect(void)
+{
+    for (uint b = 0; b < 2; b++)
+    {
+        uint32_t v = pio_of(b)->fdebug;
+        if (!(v & FDEBUG_MARK))
+            sim.fdebug[b] &= ~v;
+    }
+}
+
+static void fdebug_publish(void)
+{
+    for (uint b = 0; b < 2; b++)
+        pio_of(b)->fdebug = sim.fdebug[b] | FDEBUG_MARK;
+}
+
+// Jalankan sampai siklus 'target'; false bila berhenti lebih awal di flag IRQ
+static bool run_cycles(uint64_t target)
+{
+    fdebug_collect();
+    if (target < sim.now)
+        target = sim.now;
+    sim.stop = false;
+    pio_sim_run_until(&sim, target);
+    bool done = !sim.stop;
+    sim.stop = false;
+    fdebug_publish();
+    shim_pio_irq_update();
+    return done;
+}
+
+uint64_t shim_pio_run_to(uint64_t us)
+{
+    if (run_cycles(cycle_at(us)))
+        return us;
+    uint64_t reached = us_at_ceil(sim.now);
+    return reached < us ? reached : us;
+}
+
+// Sinkron ke waktu saat ini sebelum status PIO/DMA dibaca atau diubah
+static void sync(void)
+{
+    uint64_t target = cycle_at(time_us_64());
+    while (!run_cycles(target))
+        ;
+}
+
+void shim_pio_set_clock(uint32_t hz)
+{
+    sync();
+    us_base = time_us_64();
+    cyc_base = sim.now;
+    clk_hz = hz;
+}
+
+// ===================== PIN =====================
+void shim_pio_pin_owner(uint gpio, bool pio)
+{
+    sync();
+    if (pio)
+        pio_owned |= 1u << gpio;
+    else
+        pio_owned &= ~(1u << gpio);
+    sim.gpio_out_mask = pio_owned;
+}
+
+void shim_pio_input(uint gpio, bool level)
+{
+    sync();
+    if (level)
+        sim.gpio_in |= 1u << gpio;
+    else
+        sim.gpio_in &= ~(1u << gpio);
+}
+
+bool shim_pio_output(uint gpio)
+{
+    sync();
+    return (pio_sim_pins(&sim) >> gpio) & 1;
+}
+
+void shim_pio_edges(shim_edge_fn fn, void *ctx)
+{
+    sync();
+    sim.on_edge = fn;
+    sim.edge_ctx = ctx;
+}
+
+void pio_gpio_init(PIO pio, uint pin)
+{
+    gpio_set_function(pin, pio == pio1 ? GPIO_FUNC_PIO1 : GPIO_FUNC_PIO0);
+}
+
+int pio_sm_set_consecutive_pindirs(PIO pio, uint sm, uint pin_base, uint pin_count, bool is_out)
+{
+    // Arah pin tidak dimodelkan: pin berfungsi PIO selalu digerakkan PIO
+    return PICO_OK;
+}
+
+// ===================== IRQ =====================
+static uint irq_num(uint block, uint line)
+{
+    return PIO0_IRQ_0 + block * 2 + line;
+}
+
+static bool line_asserted(uint block, uint line)
+{
+    return (((sim.irq_flags[block] & 0xfu) << pis_interrupt0) & blocks[block].inte[line]) != 0;
+}
+
+void shim_pio_irq_update(void)
+{
+    for (uint b = 0; b < 2; b++)
+    {
+        for (uint line = 0; line < 2; line++)
+        {
+            if (line_asserted(b, line))
+                shim_irq_pend(irq_num(b, line));
+        }
+    }
+}
+
+static void sim_irq(void *ctx, uint64_t sys_cycle, uint32_t sm, uint32_t flag)
+{
+    uint b = sm / NUM_PIO_STATE_MACHINES;
+    for (uint line = 0; line < 2 && flag < 4; line++)
+    {
+        if ((blocks[b].inte[line] >> (pis_interrupt0 + flag)) & 1u && shim_irq_routed(irq_num(b, line)))
+            sim.stop = true;
+    }
+}
+
+static void set_irq_source(PIO pio, uint line, pio_interrupt_source_t source, bool enabled)
+{
+    sync();
+    uint32_t *inte = &blocks[pio_get_index(pio)].inte[line];
+    if (enabled)
+        *inte |= 1u << source;
+    else
+        *inte &= ~(1u << source);
+    shim_pio_irq_update();
+    shim_irq_changed();
+}
+
+void pio_set_irq0_source_enabled(PIO pio, pio_interrupt_source_t source, bool enabled)
+{
+    set_irq_source(pio, 0, source, enabled);
+}
+
+void pio_set_irq1_source_enabled(PIO pio, pio_interrupt_source_t source, bool enabled)
+{
+    set_irq_source(pio, 1, source, enabled);
+}
+
+bool pio_interrupt_get(PIO pio, uint pio_interrupt_num)
+{
+    sync();
+    return (sim.irq_flags[pio_get_index(pio)] >> pio_interrupt_num) & 1u;
+}
+
+void pio_interrupt_clear(PIO pio, uint pio_interrupt_num)
+{
+    sync();
+    sim.irq_flags[pio_get_index(pio)] &= ~(1u << pio_interrupt_num);
+}
+
+// ===================== MEMORI INSTRUKSI =====================
+static uint32_t program_mask(const pio_program_t *program)
+{
+    return program->length >= 32 ? 0xffffffffu : (1u << program->length) - 1;
+}
+
+// Seperti SDK: origin tetap, atau slot bebas tertinggi
+static int find_offset(PIO pio, const pio_program_t *program)
+{
+    uint32_t used = blocks[pio_get_index(pio)].used;
+    uint32_t mask = program_mask(program);
+    if (program->length > PIO_INSTRUCTION_COUNT)
+        return -1;
+    if (program->origin >= 0)
+    {
+        if (program->origin + program->length > PIO_INSTRUCTION_COUNT || (used & (mask << program->origin)))
+            return -1;
+        return program->origin;
+    }
+    for (int i = PIO_INSTRUCTION_COUNT - program->length; i >= 0; i--)
+    {
+        if (!(used & (mask << i)))
+            return i;
+    }
+    return -1;
+}
+
+bool pio_can_add_program(PIO pio, const pio_program_t *program)
+{
+    return find_offset(pio, program) >= 0;
+}
+
+uint pio_add_program(PIO pio, const pio_program_t *program)
+{
+    int offset = find_offset(pio, program);
+    if (offset < 0)
+        abort(); // SDK: panic "No program space"
+    sync();
+    uint b = pio_get_index(pio);
+    shim_pio_t *blk = &blocks[b];
+    for (uint i = 0; i < program->length; i++)
+    {
+        // Relokasi alamat JMP seperti pio_add_program()
+        uint16_t instr = program->instructions[i];
+        if ((instr >> 13) == 0)
+            instr = (uint16_t)((instr & ~0x1fu) | ((instr + offset) & 0x1fu));
+        blk->mem[offset + i] = instr;
+    }
+    blk->used |= program_mask(program) << offset;
+    for (uint k = 0; k < NUM_PIO_STATE_MACHINES; k++)
+        memcpy(sim.sm[b * NUM_PIO_STATE_MACHINES + k].mem, blk->mem, sizeof(blk->mem));
+    return (uint)offset;
+}
+
+void pio_remove_program(PIO pio, const pio_program_t *program, uint loaded_offset)
+{
+    blocks[pio_get_index(pio)].used &= ~(program_mask(program) << loaded_offset);
+}
+
+int pio_claim_unused_sm(PIO pio, bool required)
+{
+    shim_pio_t *blk = &blocks[pio_get_index(pio)];
+    for (uint sm = 0; sm < NUM_PIO_STATE_MACHINES; sm++)
+    {
+        if (!(blk->claimed & (1u << sm)))
+        {
+            blk->claimed |= 1u << sm;
+            return (int)sm;
+        }
+    }
+    if (required)
+        abort();
+    return -1;
+}
+
+void pio_sm_unclaim(PIO pio, uint sm)
+{
+    blocks[pio_get_index(pio)].claimed &= ~(1u << sm);
+}
+
+bool pio_sm_is_claimed(PIO pio, uint sm)
+{
+    return (blocks[pio_get_index(pio)].claimed >> sm) & 1u;
+}
+
+// ===================== STATE MACHINE =====================
+static void dma_pump(void);
+
+void pio_sm_init(PIO pio, uint sm, uint initial_pc, const pio_sm_config *config)
+{
+    sync();
+    pio_sim_sm_t *s = sim_sm(pio, sm);
+    s->enabled = false;
+    s->clkdiv_fixed = config->clkdiv_fixed;
+    s->wrap_target = config->wrap_target;
+    s->wrap = config->wrap;
+    s->set_base = config->set_base;
+    s->set_count = config->set_count;
+    s->out_base = config->out_base;
+    s->out_count = config->out_count;
+    s->in_base = config->in_base;
+    s->sideset_base = config->sideset_base;
+    s->sideset_bits = config->sideset_bits;
+    s->sideset_opt = config->sideset_opt;
+    s->jmp_pin = config->jmp_pin;
+    s->out_shift_right = config->out_shift_right;
+    s->autopull = config->autopull;
+    s->pull_threshold = config->pull_threshold;
+    s->in_shift_right = config->in_shift_right;
+    s->autopush = config->autopush;
+    s->push_threshold = config->push_threshold;
+    s->tx.depth = config->fifo_join == PIO_FIFO_JOIN_TX ? 8 : config->fifo_join == PIO_FIFO_JOIN_RX ? 0 : 4;
+    s->rx.depth = config->fifo_join == PIO_FIFO_JOIN_RX ? 8 : config->fifo_join == PIO_FIFO_JOIN_TX ? 0 : 4;
+    pio_sim_sm_reset(s, initial_pc);
+    // pio_sim_sm_reset() menambah pin set/out; yang digerakkan PIO hanya
+    // pin dengan fungsi GPIO PIO
+    sim.gpio_out_mask = pio_owned;
+    // SDK juga menghapus flag debug FIFO SM ini
+    sim.fdebug[pio_get_index(pio)] &= ~((1u << (PIO_FDEBUG_TXSTALL_LSB + sm)) | (1u << (PIO_FDEBUG_RXSTALL_LSB + sm)));
+    fdebug_publish();
+}
+
+// Siklus clk_sys antara dua tulisan CTRL berurutan dari CPU (str ke APB +
+// instruksi di antaranya): SM yang diaktifkan sudah berjalan sebanyak ini
+// saat pemanggil melanjutkan, mis. antara blok PIO0 dan PIO1 di
+// channel_group_start()
+#define CTRL_WRITE_CYCLES 3
+
+void pio_set_sm_mask_enabled(PIO pio, uint32_t mask, bool enabled)
+{
+    sync();
+    bool started = false;
+    for (uint sm = 0; sm < NUM_PIO_STATE_MACHINES; sm++)
+    {
+        if (!(mask & (1u << sm)))
+            continue;
+        pio_sim_sm_t *s = sim_sm(pio, sm);
+        // Tick pertama pada siklus sesudah tulisan CTRL
+        if (enabled && !s->enabled)
+        {
+            s->t256 = (sim.now + 1) << 8;
+            started = true;
+        }
+        s->enabled = enabled;
+    }
+    if (started)
+        while (!run_cycles(sim.now + CTRL_WRITE_CYCLES))
+            ;
+}
+
+void pio_sm_set_enabled(PIO pio, uint sm, bool enabled)
+{
+    pio_set_sm_mask_enabled(pio, 1u << sm, enabled);
+}
+
+void pio_enable_sm_mask_in_sync(PIO pio, uint32_t mask)
+{
+    // Divider dimulai ulang bersamaan: tick pertama semua SM sama
+    sync();
+    for (uint sm = 0; sm < NUM_PIO_STATE_MACHINES; sm++)
+    {
+        if (mask & (1u << sm))
+            sim_sm(pio, sm)->enabled = false;
+    }
+    pio_set_sm_mask_enabled(pio, mask, true);
+}
+
+void pio_sm_exec(PIO pio, uint sm, uint instr)
+{
+    sync();
+    pio_sim_exec(sim_sm(pio, sm), (uint16_t)instr);
+    dma_pump();
+}
+
+uint8_t pio_sm_get_pc(PIO pio, uint sm)
+{
+    sync();
+    return (uint8_t)sim_sm(pio, sm)->pc;
+}
+
+void pio_sm_put(PIO pio, uint sm, uint32_t data)
+{
+    sync();
+    pio_sim_put(sim_sm(pio, sm), data);
+}
+
+uint32_t pio_sm_get(PIO pio, uint sm)
+{
+    sync();
+    uint32_t data = 0;
+    pio_sim_get(sim_sm(pio, sm), &data);
+    return data;
+}
+
+uint pio_sm_get_tx_fifo_level(PIO pio, uint sm)
+{
+    sync();
+    return sim_sm(pio, sm)->tx.level;
+}
+
+bool pio_sm_is_tx_fifo_empty(PIO pio, uint sm)
+{
+    return pio_sm_get_tx_fifo_level(pio, sm) == 0;
+}
+
+bool pio_sm_is_tx_fifo_full(PIO pio, uint sm)
+{
+    pio_sim_sm_t *s = sim_sm(pio, sm);
+    return pio_sm_get_tx_fifo_level(pio, sm) >= s->tx.depth;
+}
+
+void pio_sm_clear_fifos(PIO pio, uint sm)
+{
+    sync();
+    pio_sim_sm_t *s = sim_sm(pio, sm);
+    pio_fifo_model_init(&s->tx, s->tx.depth);
+    pio_fifo_model_init(&s->rx, s->rx.depth);
+    dma_pump();
+}
+
+// ===================== DMA =====================
+typedef struct
+{
+    bool claimed;
+    bool busy;
+    dma_channel_config config;
+    uint32_t reload;      // TRANS_COUNT yang dimuat saat dipicu
+    pio_sim_sm_t *paced;  // SM pemilik DREQ (NULL: tanpa pacu)
+    bool paced_tx;
+} shim_dma_t;
+
+static shim_dma_t dma[NUM_DMA_CHANNELS];
+static bool pumping;
+
+int dma_claim_unused_channel(bool required)
+{
+    for (uint ch = 0; ch < NUM_DMA_CHANNELS; ch++)
+    {
+        if (!dma[ch].claimed)
+        {
+            dma[ch].claimed = true;
+            return (int)ch;
+        }
+    }
+    if (required)
+        abort();
+    return -1;
+}
+
+dma_channel_config dma_channel_get_default_config(uint channel)
+{
+    return (dma_channel_config){
+        .size = DMA_SIZE_32,
+        .read_increment = true,
+        .write_increment = false,
+        .dreq = DREQ_FORCE,
+        .chain_to = channel,
+    };
+}
+
+void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size)
+{
+    c->size = size;
+}
+
+void channel_config_set_read_increment(dma_channel_config *c, bool incr)
+{
+    c->read_increment = incr;
+}
+
+void channel_config_set_write_increment(dma_channel_config *c, bool incr)
+{
+    c->write_increment = incr;
+}
+
+void channel_config_set_dreq(dma_channel_config *c, uint dreq)
+{
+    c->dreq = dreq;
+}
+
+void channel_config_set_chain_to(dma_channel_config *c, uint chain_to)
+{
+    c->chain_to = chain_to;
+}
+
+void channel_config_set_ring(dma_channel_config *c, bool write, uint size_bits)
+{
+    c->ring_write = write;
+    c->ring_bits = size_bits;
+}
+
+static void dma_start(uint ch)
+{
+    shim_dma_t *d = &dma[ch];
+    dma_channel_hw_t *hw = &dma_hw->ch[ch];
+    hw->transfer_count = d->reload;
+    if (shim_i2c_dma((volatile void *)hw->write_addr, (const volatile void *)hw->read_addr, d->reload,
+                     d->config.size))
+        return;
+    // DREQ 0..15: PIO0/PIO1, TX lalu RX per SM
+    uint dreq = d->config.dreq;
+    d->paced = dreq < 16 ? &sim.sm[(dreq / 8) * NUM_PIO_STATE_MACHINES + dreq % 4] : NULL;
+    d->paced_tx = dreq % 8 < 4;
+    d->busy = true;
+}
+
+static bool dreq_active(const shim_dma_t *d)
+{
+    if (d->paced == NULL)
+        return true;
+    return d->paced_tx ? d->paced->tx.level < d->paced->tx.depth : d->paced->rx.level > 0;
+}
+
+// SM yang FIFO TX/RX-nya beralamat 'addr'; NULL bila bukan FIFO PIO
+static pio_sim_sm_t *fifo_sm(uintptr_t addr, bool tx)
+{
+    for (uint b = 0; b < 2; b++)
+    {
+        for (uint k = 0; k < NUM_PIO_STATE_MACHINES; k++)
+        {
+            volatile uint32_t *reg = tx ? &pio_of(b)->txf[k] : &pio_of(b)->rxf[k];
+            if (addr == (uintptr_t)reg)
+                return &sim.sm[b * NUM_PIO_STATE_MACHINES + k];
+        }
+    }
+    return NULL;
+}
+
+// Tulisan ke register channel lain. Alias: baca/tulis/hitungan/ctrl per
+// urutan RP2040; alias terakhir tiap baris (*_TRIG) memicu channel itu.
+static void dma_reg_write(uintptr_t addr, uintptr_t val)
+{
+    static const uint8_t kind[16] = {0, 1, 2, 3, 3, 0, 1, 2, 3, 2, 0, 1, 3, 1, 2, 0};
+    uintptr_t offset = addr - (uintptr_t)&dma_hw->ch[0];
+    uint ch = (uint)(offset / sizeof(dma_channel_hw_t));
+    uint reg = (uint)(offset % sizeof(dma_channel_hw_t) / sizeof(uintptr_t));
+    dma_channel_hw_t *hw = &dma_hw->ch[ch];
+    switch (kind[reg])
+    {
+    case 0:
+        hw->read_addr = val;
+        break;
+    case 1:
+        hw->write_addr = val;
+        break;
+    case 2:
+        dma[ch].reload = (uint32_t)val;
+        break;
+    default:
+        break; // CTRL: konfigurasi ada di dma_channel_config
+    }
+    if (reg % 4 == 3)
+        dma_start(ch);
+}
+
+static bool is_dma_reg(uintptr_t addr)
+{
+    uintptr_t base = (uintptr_t)&dma_hw->ch[0];
+    return addr >= base && addr < base + sizeof(dma_hw->ch);
+}
+
+static uintptr_t next_addr(uintptr_t addr, uint32_t size, uint ring_bits)
+{
+    if (ring_bits == 0)
+        return addr + size;
+    uintptr_t mask = ((uintptr_t)1 << ring_bits) - 1;
+    return (addr & ~mask) | ((addr + size) & mask);
+}
+
+static void dma_transfer(uint ch)
+{
+    shim_dma_t *d = &dma[ch];
+    dma_channel_hw_t *hw = &dma_hw->ch[ch];
+    uint32_t size = 1u << d->config.size;
+    uintptr_t src = hw->read_addr, dst = hw->write_addr;
+
+    // Register channel ditulis satu pointer utuh (lihat hardware/dma.h)
+    uintptr_t val = 0;
+    pio_sim_sm_t *rx = fifo_sm(src, false);
+    if (is_dma_reg(dst))
+    {
+        memcpy(&val, (const void *)src, sizeof(val));
+    }
+    else if (rx)
+    {
+        uint32_t word = 0;
+        pio_sim_get(rx, &word);
+        val = word;
+    }
+    else
+    {
+        memcpy(&val, (const void *)src, size);
+    }
+
+    if (d->config.read_increment)
+        hw->read_addr = next_addr(src, size, d->config.ring_write ? 0 : d->config.ring_bits);
+    if (d->config.write_increment)
+        hw->write_addr = next_addr(dst, size, d->config.ring_write ? d->config.ring_bits : 0);
+    hw->transfer_count--;
+
+    pio_sim_sm_t *tx = fifo_sm(dst, true);
+    if (is_dma_reg(dst))
+        dma_reg_write(dst, val);
+    else if (tx)
+        pio_sim_put(tx, (uint32_t)val);
+    else
+        memcpy((void *)dst, &val, size);
+}
+
+static void dma_feed(void *ctx, pio_sim_sm_t *sm, uint64_t sys_cycle)
+{
+    dma_pump();
+}
+
+// Jalankan semua channel sibuk selama DREQ-nya aktif, termasuk channel
+// yang dipicu chain/tulisan register di tengah jalan
+static void dma_pump(void)
+{
+    if (pumping)
+        return;
+    pumping = true;
+    bool progress;
+    do
+    {
+        progress = false;
+        for (uint ch = 0; ch < NUM_DMA_CHANNELS; ch++)
+        {
+            shim_dma_t *d = &dma[ch];
+            while (d->busy && (dma_hw->ch[ch].transfer_count == 0 || dreq_active(d)))
+            {
+                progress = true;
+                if (dma_hw->ch[ch].transfer_count > 0)
+                {
+                    dma_transfer(ch);
+                    if (dma_hw->ch[ch].transfer_count > 0)
+                        continue;
+                }
+                d->busy = false;
+                if (d->config.chain_to != ch)
+                    dma_start(d->config.chain_to);
+            }
+        }
+        // FIFO yang diisi/dikuras dapat melepas SM yang stall
+        if (progress)
+            sim.epoch++;
+    } while (progress);
+    pumping = false;
+
+    // Channel yang dipacu SM dipompa lagi sebelum setiap instruksi SM itu
+    for (uint i = 0; i < PIO_SIM_MAX_SM; i++)
+        sim.sm[i].feed = NULL;
+    for (uint ch = 0; ch < NUM_DMA_CHANNELS; ch++)
+    {
+        if (dma[ch].busy && dma[ch].paced)
+            dma[ch].paced->feed = dma_feed;
+    }
+}
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint transfer_count, bool trigger)
+{
+    sync();
+    dma_channel_hw_t *hw = &dma_hw->ch[channel];
+    dma[channel].config = *config;
+    dma[channel].reload = transfer_count;
+    hw->write_addr = (uintptr_t)write_addr;
+    hw->read_addr = (uintptr_t)read_addr;
+    if (trigger)
+    {
+        dma_start(channel);
+        dma_pump();
+    }
+}
+
+void dma_channel_transfer_from_buffer_now(uint channel, const volatile void *read_addr, uint32_t transfer_count)
+{
+    sync();
+    dma_hw->ch[channel].read_addr = (uintptr_t)read_addr;
+    dma[channel].reload = transfer_count;
+    dma_start(channel);
+    dma_pump();
+}
+
+void dma_channel_unclaim(uint channel)
+{
+    dma[channel].claimed = false;
+}
+
+void dma_channel_abort(uint channel)
+{
+    sync();
+    dma[channel].busy = false;
+    dma_pump();
+}
+
+bool dma_channel_is_busy(uint channel)
+{
+    sync();
+    return dma[channel].busy;
+}
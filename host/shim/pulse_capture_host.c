@@ -0,0 +1,147 @@
+/**
+ * pulse_capture untuk mgc_app: API lib/pulse_capture.h dengan jalur IRQ PIO
+ * yang sama seperti lib/pulse_capture.c, tetapi tanpa ADC dan DMA.
+ *
+ * Flag CAPTURE_IRQ_A/C yang disetel signal_generator_counted di simulator
+ * PIO dirutekan ke IRQ_1 blok dan dilayani core 1. Handler memulai burst
+ * dengan aturan hilang yang sama (tepi selama burst sebelumnya masih
+ * berjalan = ADC sibuk, ring penuh = penuh); sampelnya berasal dari model
+ * beban host/adc_trace.c dengan lebar pulsa dari rencana yang diterbitkan
+ * lib/pulse_engine.c. Pengganti IRQ selesai DMA: burst diterbitkan setelah
+ * pairs x 4 us waktu virtual, saat burst berikutnya mulai, saat ring dibaca
+ * atau saat disarm.
+ */
+
+#include "pulse_capture.h"
+#include "pulse_engine.h"
+#include "adc_trace.h"
+#include "hardware/irq.h"
+#include "signal_generator.pio.h"
+
+static PIO pio;
+static uint sm;
+static uint32_t pairs;
+static capture_ring_t ring;
+static capture_slot_t *active; // Burst yang sedang "dikonversi"
+static uint64_t active_end_us;
+static uint32_t periods_seen;
+static uint32_t arm_us;
+
+static adc_pulse_cfg_t model = {
+    .tau_ns = 20000,
+    .lag_ns = 2500, // Latensi IRQ core 1 + satu konversi
+    .sample_ns = CAPTURE_SAMPLE_US * 1000,
+    .peak_lsb = 1500,
+    .v_idle_lsb = 3600,
+    .v_sag_lsb = 400,
+    .noise_lsb = 3,
+};
+
+static uint capture_flag(uint index)
+{
+    return (index + sm) & 3u;
+}
+
+// Burst yang konversinya sudah selesai menurut waktu virtual diterbitkan
+static void finish_burst(void)
+{
+    if (active == NULL || time_us_64() < active_end_us)
+        return;
+    active = NULL;
+    capture_ring_commit(&ring);
+}
+
+static void begin_burst(capture_event_t event)
+{
+    uint32_t pulse = event == CAPTURE_EVENT_A ? periods_seen++ : periods_seen - 1;
+    finish_burst();
+    if (active != NULL)
+    {
+        ring.dropped_busy++;
+        return;
+    }
+    capture_slot_t *s = capture_ring_claim(&ring);
+    if (s == NULL)
+        return;
+    uint32_t dropped = capture_ring_dropped(&ring);
+    s->pulse = pulse;
+    s->t_us = time_us_32() - arm_us;
+    s->event = (uint8_t)event;
+    s->pairs = (uint8_t)pairs;
+    s->dropped = dropped > 0xffff ? 0xffff : (uint16_t)dropped;
+    adc_pulse_burst(&model, pulse, event, pairs * CAPTURE_CHANNELS, s->samples);
+    active = s;
+    active_end_us = time_us_64() + (uint64_t)pairs * CAPTURE_CHANNELS * CAPTURE_SAMPLE_US;
+}
+
+static void capture_pio_irq(void)
+{
+    uint flag_a = capture_flag(signal_generator_counted_CAPTURE_IRQ_A);
+    uint flag_c = capture_flag(signal_generator_counted_CAPTURE_IRQ_C);
+    if (pio_interrupt_get(pio, flag_a))
+    {
+        pio_interrupt_clear(pio, flag_a);
+        begin_burst(CAPTURE_EVENT_A);
+    }
+    if (pio_interrupt_get(pio, flag_c))
+    {
+        pio_interrupt_clear(pio, flag_c);
+        begin_burst(CAPTURE_EVENT_C);
+    }
+}
+
+static void set_pio_sources(bool enabled)
+{
+    pio_set_irq1_source_enabled(pio, (pio_interrupt_source_t)(pis_interrupt0 +
+                                capture_flag(signal_generator_counted_CAPTURE_IRQ_A)), enabled);
+    pio_set_irq1_source_enabled(pio, (pio_interrupt_source_t)(pis_interrupt0 +
+                                capture_flag(signal_generator_counted_CAPTURE_IRQ_C)), enabled);
+}
+
+void pulse_capture_init(PIO pio_instance, uint sm_index)
+{
+    pio = pio_instance;
+    sm = sm_index;
+    capture_ring_init(&ring);
+    uint irq = pio_get_index(pio) ? PIO1_IRQ_1 : PIO0_IRQ_1;
+    irq_set_exclusive_handler(irq, capture_pio_irq);
+    irq_set_enabled(irq, true);
+}
+
+void pulse_capture_arm(uint32_t pairs_per_event)
+{
+    pairs = pairs_per_event > CAPTURE_MAX_PAIRS ? CAPTURE_MAX_PAIRS : pairs_per_event;
+    if (pairs == 0)
+        return;
+    ring.captured = ring.dropped_busy = ring.dropped_full = 0;
+    periods_seen = 0;
+    active = NULL;
+
+    pulse_engine_status_t status;
+    pulse_engine_status(&status);
+    model.pulse_ns = status.plan.pulse_width_ns;
+
+    pio_interrupt_clear(pio, capture_flag(signal_generator_counted_CAPTURE_IRQ_A));
+    pio_interrupt_clear(pio, capture_flag(signal_generator_counted_CAPTURE_IRQ_C));
+    arm_us = time_us_32();
+    set_pio_sources(true);
+}
+
+void pulse_capture_disarm(void)
+{
+    if (pairs == 0)
+        return;
+    set_pio_sources(false);
+    while (active != NULL)
+    {
+        tight_loop_contents();
+        finish_burst();
+    }
+    pairs = 0;
+}
+
+capture_ring_t *pulse_capture_ring(void)
+{
+    finish_burst();
+    return &ring;
+}
@@ -0,0 +1,920 @@
+#define _GNU_SOURCE
+#include "shim.h"
+#include "shim_hw.h"
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ucontext.h>
+#include "pico/stdlib.h"
+#include "pico/multicore.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/flash.h"
+#include "hardware/i2c.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+#include "hardware/vreg.h"
+#include "hardware/structs/systick.h"
+#include "remote_proto.h"
+
+// ===================== WAKTU VIRTUAL DAN CORE =====================
+// Status per core: PRIMASK, handler yang sedang berjalan (tidak bersarang),
+// register event WFE dan jumlah handler yang sudah dijalankan (membangunkan
+// WFE). Core 0 memajukan waktu; core 1 coroutine yang berjalan setiap kali
+// core 0 menunggu, sampai ia sendiri menunggu.
+typedef struct
+{
+    bool irq_enabled;
+    bool in_irq;
+    bool event_flag;
+    uint32_t irq_taken;
+} shim_core_t;
+
+static shim_core_t cores[2] = {{.irq_enabled = true}, {.irq_enabled = true}};
+static uint cur_core;
+
+static uint64_t now_us;
+static uint64_t horizon_us = UINT64_MAX;
+
+timer_hw_t shim_timer_hw;
+systick_hw_t shim_systick_hw;
+static uint32_t sys_clk_hz = 125000000u;
+
+static void set_now(uint64_t t)
+{
+    if (t > now_us)
+        now_us = t;
+    shim_timer_hw.timerawl = (uint32_t)now_us;
+    shim_timer_hw.timerawh = (uint32_t)(now_us >> 32);
+    // Reload selalu 2^24 - 1 seperti yang dipasang perf_init()
+    if (shim_systick_hw.csr & M0PLUS_SYST_CSR_ENABLE_BITS)
+        shim_systick_hw.cvr = 0x00ffffffu - (uint32_t)(now_us * (sys_clk_hz / 1000000u) & 0x00ffffffu);
+}
+
+uint64_t time_us_64(void)
+{
+    return now_us;
+}
+
+uint get_core_num(void)
+{
+    return cur_core;
+}
+
+void shim_set_horizon(uint64_t us)
+{
+    horizon_us = us;
+}
+
+// ===================== ALARM =====================
+// Pool alarm default SDK: callback berjalan sebagai interupsi di core 0
+#define SHIM_ALARMS 16
+
+typedef struct
+{
+    alarm_id_t id; // 0: slot kosong
+    uint64_t at;
+    alarm_callback_t callback;
+    void *user_data;
+} shim_alarm_t;
+
+static shim_alarm_t alarms[SHIM_ALARMS];
+static alarm_id_t next_alarm_id = 1;
+
+static shim_alarm_t *earliest_alarm(void)
+{
+    shim_alarm_t *best = NULL;
+    for (int i = 0; i < SHIM_ALARMS; i++)
+    {
+        if (alarms[i].id && (!best || alarms[i].at < best->at))
+            best = &alarms[i];
+    }
+    return best;
+}
+
+static bool insert_alarm(alarm_id_t id, uint64_t at, alarm_callback_t callback, void *user_data)
+{
+    for (int i = 0; i < SHIM_ALARMS; i++)
+    {
+        if (!alarms[i].id)
+        {
+            alarms[i] = (shim_alarm_t){id, at, callback, user_data};
+            return true;
+        }
+    }
+    return false;
+}
+
+static void fire_alarm(shim_alarm_t *a)
+{
+    shim_alarm_t copy = *a;
+    a->id = 0;
+    int64_t next = copy.callback(copy.id, copy.user_data);
+    if (next > 0)
+        insert_alarm(copy.id, copy.at + (uint64_t)next, copy.callback, copy.user_data);
+    else if (next < 0)
+        insert_alarm(copy.id, now_us + (uint64_t)-next, copy.callback, copy.user_data);
+}
+
+alarm_id_t add_alarm_at(absolute_time_t t, alarm_callback_t callback, void *user_data, bool fire_if_past)
+{
+    alarm_id_t id = next_alarm_id++;
+    if (next_alarm_id <= 0)
+        next_alarm_id = 1;
+    if (t <= now_us)
+    {
+        if (!fire_if_past)
+            return 0;
+        // Seperti SDK: callback dijalankan langsung oleh pemanggil
+        int64_t next = callback(id, user_data);
+        if (next == 0)
+            return 0;
+        t = next > 0 ? t + (uint64_t)next : now_us + (uint64_t)-next;
+    }
+    return insert_alarm(id, t, callback, user_data) ? id : -1;
+}
+
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void *user_data, bool fire_if_past)
+{
+    return add_alarm_at(now_us + us, callback, user_data, fire_if_past);
+}
+
+alarm_id_t add_alarm_in_ms(uint32_t ms, alarm_callback_t callback, void *user_data, bool fire_if_past)
+{
+    return add_alarm_at(now_us + ms * 1000ull, callback, user_data, fire_if_past);
+}
+
+bool cancel_alarm(alarm_id_t id)
+{
+    for (int i = 0; i < SHIM_ALARMS; i++)
+    {
+        if (alarms[i].id == id)
+        {
+            alarms[i].id = 0;
+            return true;
+        }
+    }
+    return false;
+}
+
+// ===================== INTERUPSI =====================
+#define SHIM_IRQS 32
+#define SHIM_GPIO_COUNT 30
+
+// NVIC per core; status tertunda dibagi (yang pertama melayani menghapusnya)
+static irq_handler_t irq_handlers[2][SHIM_IRQS];
+static bool irq_line_enabled[2][SHIM_IRQS];
+static uint32_t irq_pending;
+
+static bool gpio_level[SHIM_GPIO_COUNT];
+static bool gpio_driven[SHIM_GPIO_COUNT];
+static enum gpio_function gpio_fn[SHIM_GPIO_COUNT];
+static uint32_t gpio_irq_events[SHIM_GPIO_COUNT];
+static uint32_t gpio_pending[SHIM_GPIO_COUNT];
+static gpio_irq_callback_t gpio_callback;
+
+static i2c_hw_t i2c0_hw;
+i2c_inst_t i2c0_inst = {&i2c0_hw, 0, 0};
+
+static bool irq_deliverable(uint core)
+{
+    for (uint num = 0; num < SHIM_IRQS; num++)
+    {
+        if ((irq_pending & (1u << num)) && irq_line_enabled[core][num] && irq_handlers[core][num])
+            return true;
+    }
+    return false;
+}
+
+// Satu interupsi periferal tertunda untuk 'core' (GPIO hanya di core 0,
+// lalu jalur NVIC); false bila tidak ada
+static bool take_peripheral_irq(uint core)
+{
+    for (uint32_t gpio = 0; gpio < SHIM_GPIO_COUNT && core == 0; gpio++)
+    {
+        uint32_t events = gpio_pending[gpio] & gpio_irq_events[gpio];
+        gpio_pending[gpio] = 0;
+        if (events && gpio_callback)
+        {
+            gpio_callback(gpio, events);
+            return true;
+        }
+    }
+    for (uint32_t num = 0; num < SHIM_IRQS; num++)
+    {
+        if (!(irq_pending & (1u << num)) || !irq_line_enabled[core][num] || !irq_handlers[core][num])
+            continue;
+        irq_pending &= ~(1u << num);
+        irq_handlers[core][num]();
+        // Handler membaca clr_*; di host statusnya dibersihkan di sini
+        if (num == I2C0_IRQ)
+            i2c0_hw.raw_intr_stat = i2c0_hw.intr_stat = 0;
+        // Jalur level PIO yang flag-nya belum dihapus tertunda lagi
+        shim_pio_irq_update();
+        return true;
+    }
+    return false;
+}
+
+// Jalankan semua interupsi 'core' yang jatuh tempo bila interupsinya aktif;
+// hanya dipanggil dari konteks core itu sendiri
+static void service(uint core)
+{
+    shim_core_t *c = &cores[core];
+    if (!c->irq_enabled || c->in_irq)
+        return;
+    c->in_irq = true;
+    for (;;)
+    {
+        if (take_peripheral_irq(core))
+        {
+            c->irq_taken++;
+            continue;
+        }
+        shim_alarm_t *a = core == 0 ? earliest_alarm() : NULL;
+        if (!a || a->at > now_us)
+            break;
+        fire_alarm(a);
+        c->irq_taken++;
+    }
+    c->in_irq = false;
+}
+
+// ===================== CORE 1 =====================
+#define SHIM_CORE1_STACK (256u * 1024u)
+
+static ucontext_t core0_ctx, core1_ctx;
+static void (*core1_entry)(void);
+static bool core1_launched;
+// Core 1 yang menunggu: berjalan lagi pada core1_wake, saat interupsinya
+// tertunda atau (core1_on_event) saat event WFE-nya tersetel
+static uint64_t core1_wake = UINT64_MAX;
+static bool core1_on_event;
+
+static bool core1_ready(void)
+{
+    const shim_core_t *c = &cores[1];
+    return core1_wake <= now_us || (core1_on_event && c->event_flag) ||
+           (c->irq_enabled && !c->in_irq && irq_deliverable(1));
+}
+
+// Beri giliran ke core 1 selama ia siap berjalan (dari core 0 saja)
+static void core1_poll(void)
+{
+    while (core1_launched && cur_core == 0 && core1_ready())
+    {
+        cur_core = 1;
+        swapcontext(&core0_ctx, &core1_ctx);
+        cur_core = 0;
+    }
+}
+
+// Core 1 menunggu sampai 'wake' (paling cepat 1 us lagi bila tidak menunggu
+// event) dan kembali ke core 0; interupsinya dilayani saat ia berjalan lagi
+static void core1_block(uint64_t wake, bool on_event)
+{
+    if (!on_event && wake <= now_us)
+        wake = now_us + 1;
+    core1_wake = wake;
+    core1_on_event = on_event;
+    cur_core = 0;
+    swapcontext(&core1_ctx, &core0_ctx);
+    cur_core = 1;
+    core1_wake = UINT64_MAX;
+    core1_on_event = false;
+    service(1);
+}
+
+static void core1_main(void)
+{
+    cur_core = 1;
+    core1_entry();
+    // Entry yang kembali: core 1 tidur selamanya
+    for (;;)
+        core1_block(UINT64_MAX, false);
+}
+
+void multicore_launch_core1(void (*entry)(void))
+{
+    static void *stack;
+    if (!stack && !(stack = malloc(SHIM_CORE1_STACK)))
+        abort();
+    getcontext(&core1_ctx);
+    core1_ctx.uc_stack.ss_sp = stack;
+    core1_ctx.uc_stack.ss_size = SHIM_CORE1_STACK;
+    core1_ctx.uc_link = NULL;
+    makecontext(&core1_ctx, core1_main, 0);
+    core1_entry = entry;
+    core1_launched = true;
+    cur_core = 1;
+    swapcontext(&core0_ctx, &core1_ctx);
+    cur_core = 0;
+    core1_poll();
+}
+
+// ===================== MAJU WAKTU =====================
+// Majukan waktu core 0 ke 't': alarm, PIO (shim_pio_run_to()) dan core 1
+// berjalan tepat pada waktunya, interupsi dengan PRIMASK core 0 mati
+// tertunda sampai restore_interrupts(). Dengan 'wake' kembali lebih awal
+// bila __sev() atau interupsi apa pun membangunkan core 0.
+static void advance(uint64_t t, bool wake)
+{
+    shim_core_t *c = &cores[0];
+    uint32_t taken = c->irq_taken;
+    for (;;)
+    {
+        service(0);
+        core1_poll();
+        if (wake && (c->event_flag || c->irq_taken != taken))
+            return;
+        if (now_us >= t)
+            return;
+        uint64_t next = t;
+        shim_alarm_t *a = earliest_alarm();
+        if (a && c->irq_enabled && !c->in_irq && a->at < next)
+            next = a->at;
+        if (core1_launched && core1_wake < next)
+            next = core1_wake;
+        if (next <= now_us)
+            next = now_us + 1;
+        set_now(shim_pio_run_to(next));
+    }
+}
+
+// Tunggu sibuk sampai 't' di core mana pun
+static void wait_until(uint64_t t)
+{
+    if (cur_core == 0)
+    {
+        advance(t, false);
+        return;
+    }
+    while (now_us < t)
+        core1_block(t, false);
+}
+
+uint32_t save_and_disable_interrupts(void)
+{
+    uint32_t status = cores[cur_core].irq_enabled;
+    cores[cur_core].irq_enabled = false;
+    return status;
+}
+
+void restore_interrupts(uint32_t status)
+{
+    cores[cur_core].irq_enabled = status != 0;
+    service(cur_core);
+}
+
+void shim_irq_pend(uint num)
+{
+    irq_pending |= 1u << num;
+}
+
+bool shim_irq_routed(uint num)
+{
+    return irq_line_enabled[0][num] || irq_line_enabled[1][num];
+}
+
+void shim_irq_changed(void)
+{
+    service(cur_core);
+    core1_poll();
+}
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler)
+{
+    irq_handlers[cur_core][num] = handler;
+}
+
+void irq_set_enabled(uint num, bool enabled)
+{
+    irq_line_enabled[cur_core][num] = enabled;
+    if (enabled)
+        shim_irq_changed();
+}
+
+void irq_clear(uint num)
+{
+    irq_pending &= ~(1u << num);
+}
+
+void __sev(void)
+{
+    cores[0].event_flag = cores[1].event_flag = true;
+    core1_poll();
+}
+
+void __wfe(void)
+{
+    shim_core_t *c = &cores[cur_core];
+    if (c->event_flag)
+    {
+        c->event_flag = false;
+        return;
+    }
+    if (cur_core == 1)
+    {
+        core1_block(UINT64_MAX, true);
+    }
+    else
+    {
+        shim_alarm_t *a = earliest_alarm();
+        advance(a && a->at > now_us ? a->at : now_us + 1, true);
+    }
+    c->event_flag = false;
+}
+
+bool best_effort_wfe_or_timeout(absolute_time_t t)
+{
+    shim_core_t *c = &cores[cur_core];
+    if (c->event_flag)
+    {
+        c->event_flag = false;
+        return now_us >= t;
+    }
+
+    // Interupsi apa pun membangunkan core; di core 0 cakrawala harness juga
+    if (cur_core == 1)
+    {
+        if (t > now_us)
+            core1_block(t, true);
+    }
+    else
+    {
+        advance(t < horizon_us ? t : horizon_us, true);
+    }
+    c->event_flag = false;
+    return now_us >= t;
+}
+
+void sleep_us(uint64_t us)
+{
+    wait_until(now_us + us);
+}
+
+void sleep_ms(uint32_t ms)
+{
+    wait_until(now_us + ms * 1000ull);
+}
+
+void busy_wait_us(uint64_t us)
+{
+    wait_until(now_us + us);
+}
+
+void tight_loop_contents(void)
+{
+    wait_until(now_us + 1);
+}
+
+// ===================== FIFO ANTAR CORE =====================
+#define SHIM_FIFO_DEPTH 8
+
+typedef struct
+{
+    uint32_t buf[SHIM_FIFO_DEPTH];
+    uint32_t head, tail;
+} shim_fifo_t;
+
+static shim_fifo_t fifo_to[2];        // fifo_to[k]: dibaca core k
+static uint64_t fifo_poll_us[2] = {UINT64_MAX, UINT64_MAX};
+
+static bool fifo_empty(const shim_fifo_t *f)
+{
+    return f->head == f->tail;
+}
+
+bool multicore_fifo_rvalid(void)
+{
+    shim_fifo_t *f = &fifo_to[cur_core];
+    if (fifo_empty(f))
+    {
+        // Poll kosong kedua pada us yang sama: loop sibuk, beri waktu 1 us
+        if (fifo_poll_us[cur_core] == now_us)
+            wait_until(now_us + 1);
+        fifo_poll_us[cur_core] = now_us;
+    }
+    return !fifo_empty(f);
+}
+
+bool multicore_fifo_wready(void)
+{
+    const shim_fifo_t *f = &fifo_to[cur_core ^ 1];
+    return f->head - f->tail < SHIM_FIFO_DEPTH;
+}
+
+void multicore_fifo_push_blocking(uint32_t data)
+{
+    shim_fifo_t *f = &fifo_to[cur_core ^ 1];
+    while (f->head - f->tail >= SHIM_FIFO_DEPTH)
+        tight_loop_contents();
+    f->buf[f->head++ % SHIM_FIFO_DEPTH] = data;
+    __sev();
+}
+
+uint32_t multicore_fifo_pop_blocking(void)
+{
+    shim_fifo_t *f = &fifo_to[cur_core];
+    while (fifo_empty(f))
+        __wfe();
+    return f->buf[f->tail++ % SHIM_FIFO_DEPTH];
+}
+
+// ===================== GPIO =====================
+static bool pio_function(enum gpio_function fn)
+{
+    return fn == GPIO_FUNC_PIO0 || fn == GPIO_FUNC_PIO1;
+}
+
+void gpio_init(uint gpio)
+{
+    gpio_irq_events[gpio] = 0;
+    gpio_set_function(gpio, GPIO_FUNC_SIO);
+}
+
+void gpio_set_dir(uint gpio, bool out)
+{
+}
+
+void gpio_set_function(uint gpio, enum gpio_function fn)
+{
+    gpio_fn[gpio] = fn;
+    shim_pio_pin_owner(gpio, pio_function(fn));
+}
+
+static void set_level(uint gpio, bool level)
+{
+    gpio_level[gpio] = level;
+    shim_pio_input(gpio, level);
+}
+
+void gpio_pull_up(uint gpio)
+{
+    if (!gpio_driven[gpio])
+        set_level(gpio, true);
+}
+
+void gpio_pull_down(uint gpio)
+{
+    if (!gpio_driven[gpio])
+        set_level(gpio, false);
+}
+
+void gpio_put(uint gpio, bool value)
+{
+    set_level(gpio, value);
+}
+
+bool gpio_get(uint gpio)
+{
+    return pio_function(gpio_fn[gpio]) ? shim_pio_output(gpio) : gpio_level[gpio];
+}
+
+void gpio_set_irq_enabled(uint gpio, uint32_t events, bool enabled)
+{
+    if (enabled)
+        gpio_irq_events[gpio] |= events;
+    else
+        gpio_irq_events[gpio] &= ~events;
+}
+
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t events, bool enabled, gpio_irq_callback_t callback)
+{
+    gpio_callback = callback;
+    gpio_set_irq_enabled(gpio, events, enabled);
+}
+
+void shim_gpio_set(uint32_t gpio, bool level)
+{
+    gpio_driven[gpio] = true;
+    if (gpio_level[gpio] == level)
+        return;
+    set_level(gpio, level);
+    gpio_pending[gpio] |= level ? GPIO_IRQ_EDGE_RISE : GPIO_IRQ_EDGE_FALL;
+    service(0);
+    core1_poll();
+}
+
+// ===================== I2C + LCD =====================
+static lcd_model_t lcd;
+static bool lcd_connected = true;
+
+lcd_model_t *shim_lcd(void)
+{
+    return &lcd;
+}
+
+void shim_lcd_connect(bool connected)
+{
+    lcd_connected = connected;
+}
+
+// Satu transaksi tulis di model bus; 'done_us' = STOP selesai. false bila
+// alamat tidak dijawab (NACK setelah byte alamat).
+static bool bus_write(uint8_t addr, const uint8_t *buf, size_t len, uint64_t *done_us)
+{
+    if (lcd.now_ns < now_us * 1000u)
+        lcd.now_ns = now_us * 1000u;
+    if (!lcd_connected || addr != SHIM_LCD_ADDR)
+    {
+        *done_us = (lcd.now_ns + 11 * (1000000000ull / lcd.baud_hz) + 999) / 1000;
+        return false;
+    }
+    lcd_model_write(&lcd, buf, len);
+    *done_us = (lcd.now_ns + 999) / 1000;
+    return true;
+}
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate)
+{
+    lcd_model_init(&lcd, baudrate);
+    return i2c_set_baudrate(i2c, baudrate);
+}
+
+uint i2c_set_baudrate(i2c_inst_t *i2c, uint baudrate)
+{
+    i2c->baudrate = baudrate;
+    lcd.baud_hz = baudrate;
+    return baudrate;
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop)
+{
+    uint64_t done_us;
+    bool ack = bus_write(addr, src, len, &done_us);
+    wait_until(done_us);
+    return ack ? (int)len : PICO_ERROR_GENERIC;
+}
+
+// Akhir transaksi DMA: STOP_DET atau TX_ABRT masuk jalur interupsi I2C0
+static int64_t i2c_bus_event(alarm_id_t id, void *user_data)
+{
+    i2c0_hw.raw_intr_stat |= (uint32_t)(uintptr_t)user_data;
+    i2c0_hw.intr_stat = i2c0_hw.raw_intr_stat & i2c0_hw.intr_mask;
+    if (i2c0_hw.intr_stat)
+        irq_pending |= 1u << I2C0_IRQ;
+    return 0;
+}
+
+bool shim_i2c_dma(volatile void *write_addr, const volatile void *read_addr, uint32_t count,
+                  enum dma_channel_transfer_size size)
+{
+    if (write_addr != &i2c0_hw.data_cmd)
+        return false;
+    if (count == 0)
+        return true;
+
+    // Kata IC_DATA_CMD -> byte data; STOP pada kata terakhir menutup transaksi
+    uint8_t bytes[256];
+    size_t n = count < sizeof(bytes) ? count : sizeof(bytes);
+    for (size_t i = 0; i < n; i++)
+    {
+        if (size == DMA_SIZE_16)
+            bytes[i] = (uint8_t)((const volatile uint16_t *)read_addr)[i];
+        else if (size == DMA_SIZE_32)
+            bytes[i] = (uint8_t)((const volatile uint32_t *)read_addr)[i];
+        else
+            bytes[i] = ((const volatile uint8_t *)read_addr)[i];
+    }
+    uint64_t done_us;
+    bool ack = bus_write((uint8_t)i2c0_hw.tar, bytes, n, &done_us);
+    uint32_t bits = ack ? I2C_IC_INTR_STAT_R_STOP_DET_BITS
+                        : I2C_IC_INTR_STAT_R_TX_ABRT_BITS | I2C_IC_INTR_STAT_R_STOP_DET_BITS;
+    insert_alarm(next_alarm_id++, done_us, i2c_bus_event, (void *)(uintptr_t)bits);
+    return true;
+}
+
+// ===================== FLASH =====================
+uint8_t shim_flash_mem[PICO_FLASH_SIZE_BYTES];
+static FILE *flash_file;
+static uint32_t flash_erases;
+
+__attribute__((constructor)) static void flash_blank(void)
+{
+    memset(shim_flash_mem, 0xff, sizeof(shim_flash_mem));
+}
+
+static void flash_write_back(uint32_t offset, size_t count)
+{
+    if (!flash_file)
+        return;
+    fseek(flash_file, (long)offset, SEEK_SET);
+    fwrite(shim_flash_mem + offset, 1, count, flash_file);
+    fflush(flash_file);
+}
+
+bool shim_flash_attach(const char *path)
+{
+    if (flash_file)
+        fclose(flash_file);
+    flash_file = NULL;
+    flash_blank();
+    if (!path)
+        return true;
+
+    flash_file = fopen(path, "r+b");
+    if (flash_file)
+    {
+        size_t n = fread(shim_flash_mem, 1, sizeof(shim_flash_mem), flash_file);
+        if (n == sizeof(shim_flash_mem))
+            return true;
+    }
+    else
+    {
+        flash_file = fopen(path, "w+b");
+        if (!flash_file)
+            return false;
+    }
+    // Berkas baru atau terpotong: tulis citra penuh agar sisa terbaca 0xFF
+    flash_write_back(0, sizeof(shim_flash_mem));
+    return true;
+}
+
+uint32_t shim_flash_erases(void)
+{
+    return flash_erases;
+}
+
+void flash_range_erase(uint32_t flash_offs, size_t count)
+{
+    if (flash_offs % FLASH_SECTOR_SIZE || count % FLASH_SECTOR_SIZE || flash_offs + count > sizeof(shim_flash_mem))
+        abort();
+    memset(shim_flash_mem + flash_offs, 0xff, count);
+    flash_write_back(flash_offs, count);
+    flash_erases += count / FLASH_SECTOR_SIZE;
+    busy_wait_us((uint64_t)SHIM_FLASH_ERASE_US * (count / FLASH_SECTOR_SIZE));
+}
+
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count)
+{
+    if (flash_offs % FLASH_PAGE_SIZE || count % FLASH_PAGE_SIZE || flash_offs + count > sizeof(shim_flash_mem))
+        abort();
+    for (size_t i = 0; i < count; i++)
+        shim_flash_mem[flash_offs + i] &= data[i];
+    flash_write_back(flash_offs, count);
+    busy_wait_us((uint64_t)SHIM_FLASH_PROGRAM_US * (count / FLASH_PAGE_SIZE));
+}
+
+// ===================== CLOCK DAN VREG =====================
+bool set_sys_clock_khz(uint32_t freq_khz, bool required)
+{
+    shim_pio_set_clock(freq_khz * 1000u);
+    sys_clk_hz = freq_khz * 1000u;
+    return true;
+}
+
+uint32_t clock_get_hz(enum clock_index clk_index)
+{
+    return clk_index == clk_ref ? 12000000u : sys_clk_hz;
+}
+
+void vreg_set_voltage(enum vreg_voltage voltage)
+{
+}
+
+// ===================== STDIO (CDC) =====================
+static uint8_t *cdc_out;
+static size_t cdc_out_len, cdc_out_cap;
+// Teks yang akan dibaca di terminal: printf dan rekaman jejak terformat
+static char *cdc_text;
+static size_t cdc_text_len, cdc_text_cap;
+static bool cdc_echo;
+static uint8_t cdc_in[1024];
+static size_t cdc_in_head, cdc_in_tail;
+static void (*chars_available)(void *);
+static void *chars_available_param;
+
+static void buf_append(void *pbuf, size_t *len, size_t *cap, const void *data, size_t n)
+{
+    uint8_t **buf = pbuf;
+    if (*len + n > *cap)
+    {
+        *cap = (*len + n) * 2;
+        *buf = realloc(*buf, *cap);
+        if (!*buf)
+            abort();
+    }
+    memcpy(*buf + *len, data, n);
+    *len += n;
+}
+
+static void cdc_append(const void *buf, size_t len)
+{
+    buf_append(&cdc_out, &cdc_out_len, &cdc_out_cap, buf, len);
+}
+
+static void text_append(const char *text, size_t len)
+{
+    buf_append(&cdc_text, &cdc_text_len, &cdc_text_cap, text, len);
+    if (cdc_echo)
+        fwrite(text, 1, len, stdout);
+}
+
+// Event jejak di bingkai yang ditulis firmware -> satu baris per rekaman,
+// seperti yang ditampilkan host/mgc_remote.py dari ELF
+static void render_trace(const uint8_t *buf, size_t len)
+{
+    static uint8_t msg[REMOTE_CAPTURE_MSG_MAX];
+    size_t start = 0;
+    for (size_t i = 0; i < len; i++)
+    {
+        if (buf[i] != 0)
+            continue;
+        size_t n;
+        trace_reader_t rd;
+        if (i > start && remote_decode_capture(buf + start, i - start, msg, &n) && msg[0] == REMOTE_EV_TRACE &&
+            trace_reader_init(&rd, msg + 2, n - 2))
+        {
+            char line[256];
+            trace_record_t rec;
+            if (rd.dropped)
+                text_append(line, (size_t)snprintf(line, sizeof(line), "[%u rekaman jejak hilang]\n", rd.dropped));
+            while (trace_reader_next(&rd, &rec))
+            {
+                size_t k = trace_render((const char *)rec.fmt, rec.arg, rec.nargs, line, sizeof(line) - 1);
+                line[k++] = '\n';
+                text_append(line, k);
+            }
+        }
+        start = i + 1;
+    }
+}
+
+bool stdio_init_all(void)
+{
+    return true;
+}
+
+void setup_default_uart(void)
+{
+}
+
+int shim_printf(const char *fmt, ...)
+{
+    char buf[512];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    if (n < 0)
+        return n;
+    size_t len = (size_t)n < sizeof(buf) ? (size_t)n : sizeof(buf) - 1;
+    cdc_append(buf, len);
+    text_append(buf, len);
+    return n;
+}
+
+int stdio_put_string(const char *s, int len, bool newline, bool cr_translation)
+{
+    cdc_append(s, (size_t)len);
+    if (newline)
+        cdc_append("\n", 1);
+    render_trace((const uint8_t *)s, (size_t)len);
+    return len;
+}
+
+int getchar_timeout_us(uint32_t timeout_us)
+{
+    if (cdc_in_tail == cdc_in_head)
+        return PICO_ERROR_TIMEOUT;
+    return cdc_in[cdc_in_tail++ % sizeof(cdc_in)];
+}
+
+void stdio_set_chars_available_callback(void (*fn)(void *), void *param)
+{
+    chars_available = fn;
+    chars_available_param = param;
+}
+
+void shim_cdc_input(const uint8_t *buf, size_t len)
+{
+    for (size_t i = 0; i < len && cdc_in_head - cdc_in_tail < sizeof(cdc_in); i++)
+        cdc_in[cdc_in_head++ % sizeof(cdc_in)] = buf[i];
+    // Interupsi USB
+    if (chars_available)
+        chars_available(chars_available_param);
+}
+
+const uint8_t *shim_cdc_output(size_t *len)
+{
+    *len = cdc_out_len;
+    return cdc_out;
+}
+
+void shim_cdc_clear(void)
+{
+    cdc_out_len = 0;
+    cdc_text_len = 0;
+}
+
+bool shim_cdc_contains(const char *text)
+{
+    return cdc_text_len && memmem(cdc_text, cdc_text_len, text, strlen(text)) != NULL;
+}
+
+void shim_cdc_echo(bool echo)
+{
+    cdc_echo = echo;
+}
@@ -0,0 +1,60 @@
+#ifndef SHIM_H
+#define SHIM_H
+
+/**
+ * Kendali harness untuk shim HAL host (host/shim/include)
+ *
+ * Firmware (main.c + lib/) berjalan di atas waktu virtual. Harness memanggil
+ * app_loop() berulang sampai waktu virtual mencapai cakrawala yang dipasang
+ * dengan shim_set_horizon(): WFE di loop utama tidak pernah tidur melewati
+ * cakrawala itu. Di antara putaran harness mengubah level tombol, mengirim
+ * byte CDC dan membaca layar dari model LCD (host/lcd_model.c).
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "lcd_model.h"
+#include "adc_trace.h"
+
+// Waktu operasi flash yang dimodelkan (W25Q16JV, tipikal)
+#define SHIM_FLASH_ERASE_US 45000u
+#define SHIM_FLASH_PROGRAM_US 400u
+
+// Alamat ekspander PCF8574 yang menjawab ACK di bus I2C tiruan
+#define SHIM_LCD_ADDR 0x27
+
+// Batas waktu WFE di loop utama (waktu absolut, us)
+void shim_set_horizon(uint64_t us);
+
+// Level pin yang digerakkan dari luar (tombol); tepi memicu interupsi GPIO
+void shim_gpio_set(uint32_t gpio, bool level);
+
+// Model LCD di belakang bus I2C; 'connected' false: setiap transaksi NACK
+lcd_model_t *shim_lcd(void);
+void shim_lcd_connect(bool connected);
+
+// Byte masuk CDC (memanggil callback chars_available) dan keluaran CDC yang
+// terkumpul (printf + bingkai biner). contains dan echo melihat teksnya:
+// printf dan rekaman event jejak (lib/trace_log.h) yang sudah diformat.
+void shim_cdc_input(const uint8_t *buf, size_t len);
+const uint8_t *shim_cdc_output(size_t *len);
+void shim_cdc_clear(void);
+bool shim_cdc_contains(const char *text);
+void shim_cdc_echo(bool echo); // Salin teks juga ke stdout
+
+// Flash tiruan: isi dimuat dari 'path' (0xFF bila belum ada) dan setiap
+// erase/program ditulis balik. NULL: hanya di memori.
+bool shim_flash_attach(const char *path);
+uint32_t shim_flash_erases(void);
+
+// Setiap perubahan output PIO (kedua blok, satu ruang pin) dengan siklus
+// clk_sys; NULL melepas pengamat
+typedef void (*shim_edge_fn)(void *ctx, uint64_t sys_cycle, uint32_t old_pins, uint32_t new_pins);
+void shim_pio_edges(shim_edge_fn fn, void *ctx);
+
+// Tegangan bank yang dibaca lib/bank_adc.h (host/shim/bank_adc_host.c);
+// jejak dimulai ulang setiap bank_adc_start()
+void shim_bank_trace(const adc_trace_cfg_t *cfg);
+
+#endif
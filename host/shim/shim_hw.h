@@ -0,0 +1,41 @@
+#ifndef SHIM_HW_H
+#define SHIM_HW_H
+
+/**
+ * Antarmuka internal antara host/shim/shim.c (waktu virtual, core,
+ * interupsi, GPIO, I2C) dan host/shim/pio_dma.c (PIO + DMA). Bukan untuk
+ * firmware maupun harness.
+ */
+
+#include "pico/stdlib.h"
+#include "hardware/dma.h"
+
+// ===================== DARI shim.c =====================
+// Tandai jalur interupsi 'num' tertunda (jalur level PIO yang aktif)
+void shim_irq_pend(uint num);
+// Jalur 'num' diaktifkan di NVIC salah satu core
+bool shim_irq_routed(uint num);
+// Layani interupsi core pemanggil setelah status interupsi berubah
+void shim_irq_changed(void);
+// Transfer DMA ke IC_DATA_CMD I2C (model bus LCD); false bila 'write_addr'
+// bukan register itu
+bool shim_i2c_dma(volatile void *write_addr, const volatile void *read_addr, uint32_t count,
+                  enum dma_channel_transfer_size size);
+
+// ===================== DARI pio_dma.c =====================
+// Jalankan PIO (dan DMA yang dipacunya) sampai waktu 'us'. Berhenti lebih
+// awal pada siklus flag IRQ yang dirutekan ke NVIC naik; kembalian = waktu
+// yang dicapai (dibulatkan ke atas ke us berikutnya, <= 'us').
+uint64_t shim_pio_run_to(uint64_t us);
+// Ganti clk_sys: siklus PIO sesudah saat ini dihitung dengan 'hz'
+void shim_pio_set_clock(uint32_t hz);
+// Pin 'gpio' digerakkan PIO (GPIO_FUNC_PIO0/1) atau tidak
+void shim_pio_pin_owner(uint gpio, bool pio);
+// Level pin yang tidak digerakkan PIO (SIO atau dari luar), dibaca SM
+void shim_pio_input(uint gpio, bool level);
+// Level pin yang digerakkan PIO
+bool shim_pio_output(uint gpio);
+// Jalur IRQ PIO yang masih aktif ditandai tertunda lagi (setelah handler)
+void shim_pio_irq_update(void);
+
+#endif
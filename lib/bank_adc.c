@@ -0,0 +1,99 @@
+#include "bank_adc.h"
+#include "hardware/adc.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+
+#define RING_BYTES (BANK_ADC_RING_SAMPLES * sizeof(uint16_t))
+
+// Transfer count awal: 2^32 - 1 sampel (2.4 jam pada 500 kS/s), jauh di
+// atas batas waktu pengosongan, jadi channel tidak pernah perlu dipicu ulang
+#define TRANSFERS 0xffffffffu
+
+// Satu konversi ADC RP2040 = 96 siklus clk_adc
+#define ADC_CONVERSION_CYCLES 96u
+
+// Pembaca yang lebih dekat dari ini ke penulis dianggap tertinggal: segmen
+// yang dikembalikan harus tetap utuh selama diproses (< 1 ms pada 500 kS/s)
+#define RING_GUARD (BANK_ADC_RING_SAMPLES / 8)
+
+static uint16_t ring[BANK_ADC_RING_SAMPLES] __attribute__((aligned(RING_BYTES)));
+static int dma_chan = -1;
+static uint32_t read_index; // Indeks absolut sampel berikutnya yang dibaca
+static uint32_t overruns;
+static uint input;
+
+void bank_adc_init(uint adc_gpio)
+{
+    adc_init();
+    adc_gpio_init(adc_gpio);
+    input = adc_gpio - 26;
+    dma_chan = dma_claim_unused_channel(true);
+}
+
+uint32_t bank_adc_start(uint32_t rate_hz)
+{
+    if (rate_hz == 0 || rate_hz > BANK_ADC_MAX_RATE_HZ)
+        rate_hz = BANK_ADC_MAX_RATE_HZ;
+    uint32_t adc_hz = clock_get_hz(clk_adc);
+    uint32_t cycles = (adc_hz + rate_hz / 2) / rate_hz;
+    if (cycles < ADC_CONVERSION_CYCLES)
+        cycles = ADC_CONVERSION_CYCLES;
+
+    // ADC dipakai bergantian dengan tangkapan pulsa (lib/pulse_capture.c):
+    // kanal, round-robin dan FIFO disetel ulang setiap mulai
+    adc_run(false);
+    adc_set_round_robin(0);
+    adc_select_input(input);
+    // FIFO dengan DREQ tiap sampel, tanpa bit galat, 12 bit penuh
+    adc_fifo_setup(true, true, 1, false, false);
+    adc_fifo_drain();
+    // Periode sampel = 1 + DIV siklus; ditulis langsung tanpa float
+    adc_hw->div = (cycles - 1) << ADC_DIV_INT_LSB;
+
+    // Alamat tulis membungkus di batas ring (disejajarkan ke ukurannya)
+    dma_channel_config c = dma_channel_get_default_config(dma_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, false);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_ring(&c, true, BANK_ADC_RING_BITS + 1);
+    channel_config_set_dreq(&c, DREQ_ADC);
+    dma_channel_configure(dma_chan, &c, ring, &adc_hw->fifo, TRANSFERS, true);
+
+    read_index = 0;
+    overruns = 0;
+    adc_run(true);
+    return adc_hz / cycles;
+}
+
+void bank_adc_stop(void)
+{
+    adc_run(false);
+    dma_channel_abort(dma_chan);
+    adc_fifo_drain();
+}
+
+uint32_t bank_adc_next(const uint16_t **samples)
+{
+    uint32_t written = TRANSFERS - dma_channel_hw_addr(dma_chan)->transfer_count;
+    uint32_t pending = written - read_index;
+    if (pending > BANK_ADC_RING_SAMPLES - RING_GUARD)
+    {
+        // Lompat ke setengah ring di belakang penulis
+        uint32_t skip = pending - BANK_ADC_RING_SAMPLES / 2;
+        overruns += skip;
+        read_index += skip;
+        pending -= skip;
+    }
+    uint32_t start = read_index & (BANK_ADC_RING_SAMPLES - 1);
+    uint32_t n = BANK_ADC_RING_SAMPLES - start;
+    if (n > pending)
+        n = pending;
+    *samples = &ring[start];
+    read_index += n;
+    return n;
+}
+
+uint32_t bank_adc_overruns(void)
+{
+    return overruns;
+}
@@ -0,0 +1,39 @@
+#ifndef BANK_ADC_H
+#define BANK_ADC_H
+
+/**
+ * Sampling tegangan bank kapasitor
+ *
+ * ADC berjalan bebas (round-robin mati, satu kanal) pada laju yang dipilih
+ * dan FIFO-nya dikuras satu channel DMA ke ring 16 bit di RAM tanpa campur
+ * tangan CPU. Channel ditulis dengan mode ring alamat tulis dan transfer
+ * count sangat besar, sehingga sisa transfer count memberi indeks absolut
+ * sampel yang sudah ditulis: pembaca (loop core 0) tahu persis berapa
+ * sampel baru dan kapan ia tertinggal satu putaran ring. Filter dan
+ * detektor ambang ada di lib/bank_monitor.c.
+ */
+
+#include "pico/stdlib.h"
+
+// 4096 sampel = 8 ms cadangan pada 500 kS/s sebelum penulis menyusul loop UI
+#define BANK_ADC_RING_BITS 12
+#define BANK_ADC_RING_SAMPLES (1u << BANK_ADC_RING_BITS)
+#define BANK_ADC_MAX_RATE_HZ 500000u
+
+// Klaim channel DMA dan siapkan pin ADC (GP26..GP29). Dipanggil sekali.
+void bank_adc_init(uint adc_gpio);
+
+// Mulai sampling bebas; laju dibulatkan ke divider ADC terdekat (48 MHz /
+// (1 + div), dibatasi BANK_ADC_MAX_RATE_HZ). Mengembalikan laju sebenarnya.
+uint32_t bank_adc_start(uint32_t rate_hz);
+void bank_adc_stop(void);
+
+// Segmen kontigu berikutnya dari sampel yang belum dibaca; 0 bila tidak ada.
+// Dipanggil berulang sampai 0 untuk menguras ring. Bila penulis sudah
+// menyusul pembaca, sampel tertua dilewati (dihitung bank_adc_overruns()).
+uint32_t bank_adc_next(const uint16_t **samples);
+
+// Sampel yang dilewati karena pembaca tertinggal satu putaran ring
+uint32_t bank_adc_overruns(void);
+
+#endif
@@ -0,0 +1,108 @@
+#include "bank_monitor.h"
+#include <string.h>
+
+static uint32_t code_to_mv(const bank_monitor_t *m, int32_t y_q16)
+{
+    return (uint32_t)((uint64_t)y_q16 * m->cfg.full_scale_mv / ((uint64_t)BANK_ADC_MAX << 16));
+}
+
+void bank_monitor_init(bank_monitor_t *m, const bank_monitor_cfg_t *cfg)
+{
+    memset(m, 0, sizeof(*m));
+    m->cfg = *cfg;
+
+    // alpha = 2^-k: k terdekat ke log2(sampel per tau), tanpa perkalian di
+    // loop sampel. k <= 15 menjaga selisih Q16 tetap di atas 1 LSB.
+    uint64_t per_tau = (uint64_t)cfg->tau_us * cfg->sample_rate_hz / 1000000u;
+    while (m->shift < 15 && (1ull << m->shift) + (1ull << m->shift) / 2 < per_tau)
+        m->shift++;
+
+    m->safe_q16 = (int32_t)(((uint64_t)cfg->safe_mv * BANK_ADC_MAX << 16) / cfg->full_scale_mv);
+    uint64_t hold = (uint64_t)cfg->hold_us * cfg->sample_rate_hz / 1000000u;
+    m->hold_samples = hold > 0 ? (uint32_t)hold : 1;
+    m->timeout_samples = (uint64_t)cfg->timeout_ms * cfg->sample_rate_hz / 1000u;
+}
+
+void bank_monitor_start(bank_monitor_t *m)
+{
+    m->state = BANK_DISCHARGING;
+    m->seeded = false;
+    m->y = 0;
+    m->below = 0;
+    m->samples = 0;
+    m->done_sample = 0;
+    m->start_mv = 0;
+}
+
+bank_state_t bank_monitor_feed(bank_monitor_t *m, const uint16_t *samples, uint32_t n)
+{
+    if (m->state != BANK_DISCHARGING)
+        return m->state;
+
+    uint32_t i = 0;
+    if (!m->seeded && n > 0)
+    {
+        // Filter dimulai dari 0 akan langsung terbaca aman
+        m->y = (int32_t)(samples[0] & BANK_ADC_MAX) << 16;
+        m->start_mv = code_to_mv(m, m->y);
+        m->seeded = true;
+    }
+
+    // Batas waktu dipotong ke dalam segmen lebih dulu: loop hanya filter,
+    // bandingan dan hitungan hold. Salinan lokal agar tetap di register.
+    uint32_t end = n;
+    bool timeout = false;
+    if (m->timeout_samples > 0 && m->timeout_samples - m->samples <= n)
+    {
+        end = (uint32_t)(m->timeout_samples - m->samples);
+        timeout = true;
+    }
+    int32_t y = m->y, safe = m->safe_q16;
+    uint32_t below = m->below, hold = m->hold_samples;
+    uint8_t k = m->shift;
+    for (; i < end; i++)
+    {
+        int32_t x = (int32_t)(samples[i] & BANK_ADC_MAX) << 16;
+        y += (x - y) >> k;
+        below = y < safe ? below + 1 : 0;
+        if (below >= hold)
+        {
+            m->state = BANK_SAFE;
+            i++;
+            break;
+        }
+    }
+    if (m->state == BANK_DISCHARGING && timeout)
+        m->state = BANK_TIMEOUT;
+
+    m->y = y;
+    m->below = below;
+    m->samples += i;
+    if (m->state != BANK_DISCHARGING)
+        m->done_sample = m->samples;
+    return m->state;
+}
+
+uint32_t bank_monitor_mv(const bank_monitor_t *m)
+{
+    return code_to_mv(m, m->y);
+}
+
+uint32_t bank_monitor_progress(const bank_monitor_t *m)
+{
+    if (m->state == BANK_SAFE)
+        return 100;
+    uint32_t mv = bank_monitor_mv(m);
+    if (m->start_mv <= m->cfg.safe_mv || mv >= m->start_mv)
+        return 0;
+    if (mv <= m->cfg.safe_mv)
+        return 99; // Di bawah ambang, menunggu hold
+    uint32_t pct = (uint32_t)((uint64_t)(m->start_mv - mv) * 100u / (m->start_mv - m->cfg.safe_mv));
+    return pct > 99 ? 99 : pct;
+}
+
+uint64_t bank_monitor_elapsed_us(const bank_monitor_t *m)
+{
+    uint64_t samples = m->state == BANK_DISCHARGING ? m->samples : m->done_sample;
+    return samples * 1000000u / m->cfg.sample_rate_hz;
+}
@@ -0,0 +1,69 @@
+#ifndef BANK_MONITOR_H
+#define BANK_MONITOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Pemantau pengosongan bank kapasitor: filter IIR orde satu dan detektor
+// ambang atas sampel ADC 12 bit yang dialirkan DMA ke ring (lib/bank_adc.c).
+// Bank dinyatakan aman setelah tegangan terfilter tetap di bawah ambang
+// selama hold_us; lonjakan EMI singkat diredam filter dan mereset hitungan
+// hold bila terfilter kembali di atas ambang. Tidak bergantung pada Pico SDK
+// sehingga filter dan logika berhentinya diuji di host dengan jejak ADC
+// tiruan (mgc_sim discharge).
+
+#define BANK_ADC_MAX 4095u
+
+typedef struct
+{
+    uint32_t full_scale_mv;  // Tegangan bank pada kode BANK_ADC_MAX (pembagi + Vref)
+    uint32_t safe_mv;        // Di bawah ini bank aman disentuh
+    uint32_t sample_rate_hz; // Laju ADC (maks. 500 kS/s)
+    uint32_t tau_us;         // Konstanta waktu filter, dibulatkan ke 2^k sampel
+    uint32_t hold_us;        // Lama di bawah ambang sebelum dinyatakan aman
+    uint32_t timeout_ms;     // Tanpa hasil sampai batas ini: saklar/resistor buang gagal (0: tanpa batas)
+} bank_monitor_cfg_t;
+
+typedef enum
+{
+    BANK_IDLE = 0,
+    BANK_DISCHARGING,
+    BANK_SAFE,
+    BANK_TIMEOUT,
+} bank_state_t;
+
+typedef struct
+{
+    bank_monitor_cfg_t cfg;
+    bank_state_t state;
+    uint8_t shift;          // alpha = 2^-shift
+    bool seeded;            // Filter diisi sampel pertama, bukan 0
+    int32_t y;              // Kode ADC terfilter, Q16
+    int32_t safe_q16;       // Ambang dalam kode ADC, Q16
+    uint32_t hold_samples;
+    uint64_t timeout_samples;
+    uint32_t below;         // Sampel berturut-turut di bawah ambang
+    uint64_t samples;       // Sampel sejak bank_monitor_start()
+    uint64_t done_sample;   // Sampel yang mengakhiri pengosongan (SAFE/TIMEOUT)
+    uint32_t start_mv;      // Tegangan terfilter awal (acuan progres)
+} bank_monitor_t;
+
+void bank_monitor_init(bank_monitor_t *m, const bank_monitor_cfg_t *cfg);
+
+// Mulai pengosongan baru; sampel pertama berikutnya mengisi filter
+void bank_monitor_start(bank_monitor_t *m);
+
+// Proses satu segmen ring. Berhenti di sampel yang mengubah status, sisa
+// segmen diabaikan. Mengembalikan status sesudahnya.
+bank_state_t bank_monitor_feed(bank_monitor_t *m, const uint16_t *samples, uint32_t n);
+
+// Tegangan terfilter dalam mV
+uint32_t bank_monitor_mv(const bank_monitor_t *m);
+
+// Progres 0..100 %: penurunan tegangan dari awal menuju ambang aman
+uint32_t bank_monitor_progress(const bank_monitor_t *m);
+
+// Waktu sejak start (atau sampai selesai) dalam us menurut jumlah sampel
+uint64_t bank_monitor_elapsed_us(const bank_monitor_t *m);
+
+#endif
@@ -0,0 +1,104 @@
+#include "button_debounce.h"
+
+void debounce_init(debounce_t *d, uint8_t button, bool repeat)
+{
+    d->button = button;
+    d->repeat = repeat;
+    d->raw = d->stable = false;
+    d->last_edge_us = 0;
+    d->next_repeat_us = 0;
+    d->repeats = 0;
+}
+
+void debounce_edge(debounce_t *d, bool pressed, uint64_t now_us)
+{
+    // Setiap tepi memulai ulang jendela settle, termasuk pantulan yang
+    // kembali ke level stabil
+    d->raw = pressed;
+    d->last_edge_us = now_us;
+}
+
+static uint16_t repeat_step(uint32_t repeats)
+{
+    if (repeats >= BUTTON_REPEAT_X100_AFTER)
+        return 100;
+    if (repeats >= BUTTON_REPEAT_X10_AFTER)
+        return 10;
+    return 1;
+}
+
+bool debounce_poll(debounce_t *d, uint64_t now_us, button_event_t *ev)
+{
+    ev->button = d->button;
+    ev->step = 1;
+
+    if (d->raw != d->stable)
+    {
+        if (now_us - d->last_edge_us < DEBOUNCE_SETTLE_US)
+            return false;
+        d->stable = d->raw;
+        if (d->stable)
+        {
+            d->next_repeat_us = now_us + BUTTON_HOLD_US;
+            d->repeats = 0;
+            ev->type = BUTTON_EV_PRESS;
+        }
+        else
+        {
+            ev->type = BUTTON_EV_RELEASE;
+        }
+        return true;
+    }
+
+    if (d->stable && d->repeat && now_us >= d->next_repeat_us)
+    {
+        ev->type = BUTTON_EV_REPEAT;
+        ev->step = repeat_step(d->repeats);
+        d->repeats++;
+        // Jangan mengejar repeat yang terlewat (mis. interupsi mati saat
+        // flash ditulis): satu event lalu lanjut dari sekarang
+        d->next_repeat_us += BUTTON_REPEAT_US;
+        if (d->next_repeat_us <= now_us)
+            d->next_repeat_us = now_us + BUTTON_REPEAT_US;
+        return true;
+    }
+    return false;
+}
+
+uint64_t debounce_deadline(const debounce_t *d)
+{
+    if (d->raw != d->stable)
+        return d->last_edge_us + DEBOUNCE_SETTLE_US;
+    if (d->stable && d->repeat)
+        return d->next_repeat_us;
+    return 0;
+}
+
+void button_queue_init(button_queue_t *q)
+{
+    q->head = q->tail = 0;
+    q->dropped = 0;
+}
+
+bool button_queue_push(button_queue_t *q, const button_event_t *ev)
+{
+    uint32_t head = q->head;
+    if (head - __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE) >= BUTTON_QUEUE_SIZE)
+    {
+        q->dropped++;
+        return false;
+    }
+    q->ev[head % BUTTON_QUEUE_SIZE] = *ev;
+    __atomic_store_n(&q->head, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+bool button_queue_pop(button_queue_t *q, button_event_t *ev)
+{
+    uint32_t tail = q->tail;
+    if (__atomic_load_n(&q->head, __ATOMIC_ACQUIRE) == tail)
+        return false;
+    *ev = q->ev[tail % BUTTON_QUEUE_SIZE];
+    __atomic_store_n(&q->tail, tail + 1, __ATOMIC_RELEASE);
+    return true;
+}
@@ -0,0 +1,74 @@
+#ifndef BUTTON_DEBOUNCE_H
+#define BUTTON_DEBOUNCE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Debounce tombol berbasis tepi + waktu dan antrean event lock-free satu
+// produsen/satu konsumen (interupsi -> loop UI). Tidak bergantung pada Pico
+// SDK sehingga jejak pantulan sintetis dapat diuji di host (mgc_sim buttons).
+
+// Level harus stabil selama ini sebelum diterima. Tidak langsung menerima
+// tepi pertama: lonjakan EMI saat bank kapasitor dilepas tidak boleh
+// terbaca sebagai tekanan tombol.
+#define DEBOUNCE_SETTLE_US 5000u
+
+// Auto-repeat: mulai setelah ditahan BUTTON_HOLD_US, lalu tiap
+// BUTTON_REPEAT_US dengan langkah x1, x10 lalu x100
+#define BUTTON_HOLD_US 500000u
+#define BUTTON_REPEAT_US 100000u
+#define BUTTON_REPEAT_X10_AFTER 10  // Jumlah repeat sebelum langkah x10
+#define BUTTON_REPEAT_X100_AFTER 20 // Jumlah repeat sebelum langkah x100
+
+typedef enum
+{
+    BUTTON_EV_PRESS = 1,
+    BUTTON_EV_REPEAT, // Masih ditahan; 'step' = pengali langkah
+    BUTTON_EV_RELEASE,
+} button_ev_type_t;
+
+typedef struct
+{
+    uint8_t button;
+    uint8_t type; // button_ev_type_t
+    uint16_t step;
+} button_event_t;
+
+typedef struct
+{
+    uint8_t button;
+    bool repeat; // false: hanya PRESS/RELEASE (mis. SELECT)
+    bool raw;    // Level mentah terakhir (true = ditekan)
+    bool stable; // Level yang sudah diterima
+    uint64_t last_edge_us;
+    uint64_t next_repeat_us;
+    uint32_t repeats;
+} debounce_t;
+
+void debounce_init(debounce_t *d, uint8_t button, bool repeat);
+
+// Tepi mentah (dari interupsi GPIO atau sampel ulang) dengan level sesudahnya
+void debounce_edge(debounce_t *d, bool pressed, uint64_t now_us);
+
+// Majukan waktu; keluarkan paling banyak satu event per panggilan
+bool debounce_poll(debounce_t *d, uint64_t now_us, button_event_t *ev);
+
+// Waktu absolut debounce_poll() berikutnya diperlukan; 0 bila tidak ada
+uint64_t debounce_deadline(const debounce_t *d);
+
+// ===================== ANTREAN EVENT =====================
+#define BUTTON_QUEUE_SIZE 16 // Pangkat dua
+
+typedef struct
+{
+    button_event_t ev[BUTTON_QUEUE_SIZE];
+    uint32_t head; // Ditulis produsen
+    uint32_t tail; // Ditulis konsumen
+    uint32_t dropped;
+} button_queue_t;
+
+void button_queue_init(button_queue_t *q);
+bool button_queue_push(button_queue_t *q, const button_event_t *ev); // false bila penuh
+bool button_queue_pop(button_queue_t *q, button_event_t *ev);
+
+#endif
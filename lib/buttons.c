@@ -0,0 +1,123 @@
+#include "buttons.h"
+#include "hardware/gpio.h"
+#include "hardware/sync.h"
+
+static uint button_pins[BUTTON_COUNT];
+static debounce_t debouncers[BUTTON_COUNT];
+static alarm_id_t alarms[BUTTON_COUNT]; // 0: tidak ada alarm aktif
+static button_queue_t queue;
+static void (*notify)(uint64_t now_us);
+
+static void emit_events(int i, uint64_t now)
+{
+    button_event_t ev;
+    bool any = false;
+    while (debounce_poll(&debouncers[i], now, &ev))
+    {
+        button_queue_push(&queue, &ev);
+        any = true;
+    }
+    if (any && notify)
+        notify(now);
+    // Bangunkan loop UI yang menunggu di __wfe()
+    __sev();
+}
+
+static int64_t debounce_alarm(alarm_id_t id, void *user_data)
+{
+    int i = (int)(intptr_t)user_data;
+    uint64_t now = time_us_64();
+
+    // Sampel ulang: dua tepi yang lebih rapat dari latensi interupsi dapat
+    // meninggalkan level mentah yang salah
+    bool pressed = !gpio_get(button_pins[i]);
+    if (pressed != debouncers[i].raw)
+        debounce_edge(&debouncers[i], pressed, now);
+
+    emit_events(i, now);
+
+    uint64_t next = debounce_deadline(&debouncers[i]);
+    if (!next)
+    {
+        alarms[i] = 0;
+        return 0;
+    }
+    // Negatif: dijadwalkan ulang relatif terhadap sekarang
+    return -(int64_t)(next > now ? next - now : 1);
+}
+
+static void schedule(int i)
+{
+    if (alarms[i] > 0)
+        cancel_alarm(alarms[i]);
+    alarms[i] = 0;
+
+    uint64_t next = debounce_deadline(&debouncers[i]);
+    if (!next)
+        return;
+    alarm_id_t id = add_alarm_at(from_us_since_boot(next), debounce_alarm, (void *)(intptr_t)i, true);
+    // Gagal (slot alarm habis): tepi berikutnya mencoba lagi
+    alarms[i] = id > 0 ? id : 0;
+}
+
+static void button_gpio_irq(uint gpio, uint32_t events)
+{
+    uint64_t now = time_us_64();
+    for (int i = 0; i < BUTTON_COUNT; i++)
+    {
+        if (button_pins[i] != gpio)
+            continue;
+        debounce_edge(&debouncers[i], !gpio_get(gpio), now);
+        schedule(i);
+    }
+}
+
+void buttons_init(const uint pins[BUTTON_COUNT], uint32_t repeat_mask)
+{
+    button_queue_init(&queue);
+
+    for (int i = 0; i < BUTTON_COUNT; i++)
+    {
+        button_pins[i] = pins[i];
+        alarms[i] = 0;
+        debounce_init(&debouncers[i], (uint8_t)i, (repeat_mask >> i) & 1u);
+
+        gpio_init(pins[i]);
+        gpio_set_dir(pins[i], GPIO_IN);
+        gpio_pull_up(pins[i]);
+    }
+    // Pull-up butuh waktu sebelum level dibaca sebagai "dilepas"
+    sleep_us(10);
+
+    uint32_t edges = GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE;
+    gpio_set_irq_enabled_with_callback(pins[0], edges, true, button_gpio_irq);
+    for (int i = 1; i < BUTTON_COUNT; i++)
+        gpio_set_irq_enabled(pins[i], edges, true);
+
+    // Tombol yang sudah ditekan saat boot tidak menghasilkan tepi
+    for (int i = 0; i < BUTTON_COUNT; i++)
+    {
+        if (!gpio_get(pins[i]))
+        {
+            uint32_t irq_state = save_and_disable_interrupts();
+            debounce_edge(&debouncers[i], true, time_us_64());
+            schedule(i);
+            restore_interrupts(irq_state);
+        }
+    }
+}
+
+void buttons_set_notify(void (*fn)(uint64_t now_us))
+{
+    notify = fn;
+}
+
+bool buttons_next(button_event_t *ev)
+{
+    return button_queue_pop(&queue, ev);
+}
+
+uint32_t buttons_dropped(void)
+{
+    return queue.dropped;
+}
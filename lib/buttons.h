@@ -0,0 +1,40 @@
+#ifndef BUTTONS_H
+#define BUTTONS_H
+
+/**
+ * Input tombol berbasis interupsi
+ *
+ * Setiap tepi GPIO (kedua arah) memulai ulang jendela settle di debouncer
+ * (button_debounce.c); alarm di akhir jendela menerima level baru dan
+ * menjadwalkan auto-repeat. Event masuk antrean lock-free yang dikuras loop
+ * UI dengan buttons_next(), sehingga tidak ada polling maupun sleep debounce.
+ */
+
+#include "pico/stdlib.h"
+#include "button_debounce.h"
+
+#define BUTTON_COUNT 3
+
+// Indeks tombol pada button_event_t.button
+enum
+{
+    BUTTON_SELECT = 0,
+    BUTTON_UP,
+    BUTTON_DOWN,
+};
+
+// Pin aktif-rendah dengan pull-up internal. repeat_mask: bit per tombol
+// yang mendapat auto-repeat.
+void buttons_init(const uint pins[BUTTON_COUNT], uint32_t repeat_mask);
+
+// Dipanggil dari interupsi (alarm debounce) setelah event masuk antrean,
+// sebelum __sev(); mis. sched_post() tugas tombol. NULL: tidak ada.
+void buttons_set_notify(void (*fn)(uint64_t now_us));
+
+// Ambil event berikutnya; false bila antrean kosong
+bool buttons_next(button_event_t *ev);
+
+// Event yang dibuang karena antrean penuh
+uint32_t buttons_dropped(void);
+
+#endif
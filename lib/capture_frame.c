@@ -0,0 +1,145 @@
+#include "capture_frame.h"
+
+#define SAMPLE_MASK 0x0fffu
+
+// ===================== RING =====================
+void capture_ring_init(capture_ring_t *r)
+{
+    r->head = r->tail = 0;
+    r->captured = r->dropped_busy = r->dropped_full = 0;
+}
+
+capture_slot_t *capture_ring_claim(capture_ring_t *r)
+{
+    uint32_t head = r->head;
+    if (head - __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE) >= CAPTURE_SLOTS)
+    {
+        r->dropped_full++;
+        return NULL;
+    }
+    return &r->slot[head % CAPTURE_SLOTS];
+}
+
+void capture_ring_commit(capture_ring_t *r)
+{
+    r->captured++;
+    __atomic_store_n(&r->head, r->head + 1, __ATOMIC_RELEASE);
+}
+
+const capture_slot_t *capture_ring_peek(capture_ring_t *r)
+{
+    uint32_t tail = r->tail;
+    if (__atomic_load_n(&r->head, __ATOMIC_ACQUIRE) == tail)
+        return NULL;
+    return &r->slot[tail % CAPTURE_SLOTS];
+}
+
+void capture_ring_release(capture_ring_t *r)
+{
+    __atomic_store_n(&r->tail, r->tail + 1, __ATOMIC_RELEASE);
+}
+
+uint32_t capture_ring_dropped(const capture_ring_t *r)
+{
+    return r->dropped_busy + r->dropped_full;
+}
+
+// ===================== KODE DELTA =====================
+static void put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    put_u16(p, (uint16_t)v);
+    put_u16(p + 2, (uint16_t)(v >> 16));
+}
+
+static uint16_t get_u16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t *p)
+{
+    return get_u16(p) | ((uint32_t)get_u16(p + 2) << 16);
+}
+
+size_t capture_encode(const capture_slot_t *s, uint8_t *out)
+{
+    put_u32(out, s->pulse);
+    put_u32(out + 4, s->t_us);
+    out[8] = s->event;
+    out[9] = s->pairs;
+    put_u16(out + 10, s->dropped);
+    size_t n = CAPTURE_HEADER_BYTES;
+
+    uint32_t count = (uint32_t)s->pairs * CAPTURE_CHANNELS;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint16_t x = s->samples[i] & SAMPLE_MASK;
+        if (i < CAPTURE_CHANNELS)
+        {
+            put_u16(out + n, x);
+            n += 2;
+            continue;
+        }
+        // Zigzag: selisih kecil bertanda -> bilangan kecil tak bertanda
+        int32_t d = (int32_t)x - (int32_t)(s->samples[i - CAPTURE_CHANNELS] & SAMPLE_MASK);
+        uint32_t z = d >= 0 ? (uint32_t)d << 1 : ((uint32_t)-d << 1) - 1;
+        if (z < 0x80)
+        {
+            out[n++] = (uint8_t)z;
+        }
+        else
+        {
+            out[n++] = (uint8_t)(0x80 | (z & 0x7f));
+            out[n++] = (uint8_t)(z >> 7);
+        }
+    }
+    return n;
+}
+
+bool capture_decode(const uint8_t *in, size_t len, capture_slot_t *s)
+{
+    if (len < CAPTURE_HEADER_BYTES)
+        return false;
+    s->pulse = get_u32(in);
+    s->t_us = get_u32(in + 4);
+    s->event = in[8];
+    s->pairs = in[9];
+    s->dropped = get_u16(in + 10);
+    if (s->event > CAPTURE_EVENT_C || s->pairs == 0 || s->pairs > CAPTURE_MAX_PAIRS)
+        return false;
+
+    size_t n = CAPTURE_HEADER_BYTES;
+    uint32_t count = (uint32_t)s->pairs * CAPTURE_CHANNELS;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (i < CAPTURE_CHANNELS)
+        {
+            if (n + 2 > len)
+                return false;
+            s->samples[i] = get_u16(in + n) & SAMPLE_MASK;
+            n += 2;
+            continue;
+        }
+        if (n >= len)
+            return false;
+        uint32_t z = in[n++];
+        if (z & 0x80)
+        {
+            if (n >= len)
+                return false;
+            z = (z & 0x7f) | ((uint32_t)in[n++] << 7);
+        }
+        int32_t d = (z & 1) ? -(int32_t)((z + 1) >> 1) : (int32_t)(z >> 1);
+        int32_t x = (int32_t)s->samples[i - CAPTURE_CHANNELS] + d;
+        if (x < 0 || x > (int32_t)SAMPLE_MASK)
+            return false;
+        s->samples[i] = (uint16_t)x;
+    }
+    return n == len;
+}
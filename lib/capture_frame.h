@@ -0,0 +1,78 @@
+#ifndef CAPTURE_FRAME_H
+#define CAPTURE_FRAME_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Bingkai tangkapan arus/tegangan per pulsa: ring slot satu produsen (ISR
+// core 1, lib/pulse_capture.c) satu konsumen (loop core 0), serta kode delta
+// untuk mengirimnya lewat CDC (lib/remote_proto.h, REMOTE_EV_CAPTURE).
+// Tidak bergantung pada Pico SDK sehingga ring dan kodenya diuji di host
+// (mgc_sim capture).
+//
+// Sampel berselang-seling I0, V0, I1, V1, ... (ADC round-robin dua kanal).
+// Kode: kepala CAPTURE_HEADER_BYTES byte, dua sampel pertama mentah (u16
+// LE), lalu setiap sampel sebagai selisih terhadap sampel sebelumnya di
+// kanal yang sama: zigzag + varint 7 bit (|d| < 64 LSB = 1 byte, sisanya 2
+// byte). Derau ADC beberapa LSB membuat bingkai kira-kira separuh ukuran
+// mentah 16 bit.
+
+#define CAPTURE_CHANNELS 2
+#define CAPTURE_MAX_PAIRS 64
+#define CAPTURE_MAX_SAMPLES (CAPTURE_CHANNELS * CAPTURE_MAX_PAIRS)
+#define CAPTURE_SLOTS 8 // Pangkat dua
+#define CAPTURE_HEADER_BYTES 12
+// Terburuk: setiap selisih 2 byte
+#define CAPTURE_PAYLOAD_MAX (CAPTURE_HEADER_BYTES + 2 * CAPTURE_MAX_SAMPLES)
+
+typedef enum
+{
+    CAPTURE_EVENT_A = 0, // Tepi naik CH1 (CH1/CH4)
+    CAPTURE_EVENT_C,     // Tepi naik CH2 (CH2/CH3)
+} capture_event_t;
+
+typedef struct
+{
+    uint32_t pulse;   // Nomor periode sejak proses mulai (A dan C berbagi nomor)
+    uint32_t t_us;    // Saat IRQ sejak tangkapan dipersenjatai
+    uint8_t event;    // capture_event_t
+    uint8_t pairs;    // Pasangan I/V di samples[]
+    uint16_t dropped; // Bingkai hilang sebelum bingkai ini (jenuh di 65535)
+    uint16_t samples[CAPTURE_MAX_SAMPLES];
+} capture_slot_t;
+
+typedef struct
+{
+    capture_slot_t slot[CAPTURE_SLOTS];
+    uint32_t head; // Ditulis produsen
+    uint32_t tail; // Ditulis konsumen
+
+    // Statistik produsen; boleh dinolkan produsen kapan saja (awal proses)
+    uint32_t captured;
+    uint32_t dropped_busy; // IRQ tiba saat burst sebelumnya masih berjalan
+    uint32_t dropped_full; // Tidak ada slot kosong: pengiriman tertinggal
+} capture_ring_t;
+
+// Sebelum produsen dan konsumen mulai memakai ring
+void capture_ring_init(capture_ring_t *r);
+
+// Produsen: slot kosong berikutnya, NULL (dan dropped_full bertambah) bila
+// penuh. Slot baru terlihat konsumen setelah capture_ring_commit().
+capture_slot_t *capture_ring_claim(capture_ring_t *r);
+void capture_ring_commit(capture_ring_t *r);
+
+// Konsumen: bingkai tertua yang sudah lengkap, NULL bila kosong
+const capture_slot_t *capture_ring_peek(capture_ring_t *r);
+void capture_ring_release(capture_ring_t *r);
+
+// Total bingkai hilang (busy + full)
+uint32_t capture_ring_dropped(const capture_ring_t *r);
+
+// Slot -> payload (maks. CAPTURE_PAYLOAD_MAX byte); mengembalikan panjangnya
+size_t capture_encode(const capture_slot_t *s, uint8_t *out);
+
+// Payload -> slot; false bila terpotong, rusak atau pairs di luar batas
+bool capture_decode(const uint8_t *in, size_t len, capture_slot_t *s);
+
+#endif
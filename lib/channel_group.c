@@ -0,0 +1,253 @@
+#include "channel_group.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "pattern_engine.pio.h"
+#include "pio_programs.h"
+
+// Kanal berjalan sampai dihentikan; transfer count maksimum cukup untuk
+// berhari-hari pada pola UI (lihat channel_group_run_limit_us)
+#define CHANNEL_DMA_TRANSFER_COUNT 0xffffffffu
+
+// Ruang kerja penyusun; terlalu besar untuk stack core 1
+static pattern_table_t scratch;
+
+static uint32_t log2_u32(uint32_t v)
+{
+    uint32_t n = 0;
+    while (v >>= 1)
+        n++;
+    return n;
+}
+
+// Susun pola kanal pada divider 'clkdiv_fixed'. Bila 'table' NULL hanya
+// diperiksa, tabel kanal tidak disentuh.
+static timing_status_t compile_channel(const pattern_t *pattern, uint32_t sys_clk_hz, uint32_t clkdiv_fixed,
+                                       uint32_t *table, channel_t *ch)
+{
+    timing_status_t status = pattern_compile(pattern, sys_clk_hz, clkdiv_fixed,
+                                             pattern_engine_EVENT_OVERHEAD, &scratch);
+    if (status != TIMING_OK)
+        return status;
+    if (!pattern_table_pad_pow2(&scratch, pattern_engine_EVENT_OVERHEAD, CHANNEL_TABLE_WORDS))
+        return TIMING_ERR_PATTERN;
+
+    if (table != NULL)
+    {
+        for (uint32_t i = 0; i < scratch.length; i++)
+            table[i] = scratch.words[i];
+        ch->length = scratch.length;
+        ch->period_cycles = scratch.period_cycles;
+    }
+    return TIMING_OK;
+}
+
+static bool claim_sm(channel_t *ch)
+{
+    PIO blocks[2] = {pio0, pio1};
+    for (int b = 0; b < 2; b++)
+    {
+        uint offset;
+        if (!pio_programs_acquire(blocks[b], &pattern_engine_program, &offset))
+            continue;
+        int sm = pio_claim_unused_sm(blocks[b], false);
+        if (sm < 0)
+        {
+            pio_programs_release(blocks[b], &pattern_engine_program);
+            continue;
+        }
+        ch->pio = blocks[b];
+        ch->sm = (uint)sm;
+        ch->offset = offset;
+        return true;
+    }
+    return false;
+}
+
+// SM yang belum diklaim di kedua blok (mesin pulsa, penghitung dan
+// penganalisis logika sudah mengambil bagiannya)
+static uint free_sms(void)
+{
+    PIO blocks[2] = {pio0, pio1};
+    uint n = 0;
+    for (int b = 0; b < 2; b++)
+        for (uint sm = 0; sm < 4; sm++)
+            n += !pio_sm_is_claimed(blocks[b], sm);
+    return n;
+}
+
+timing_status_t channel_group_init(channel_group_t *g, uint sync_pin, uint channels)
+{
+    g->count = 0;
+    g->capacity = 0;
+    if (channels == 0 || channels > CHANNEL_GROUP_MAX || channels > free_sms())
+        return TIMING_ERR_RANGE;
+    g->capacity = channels;
+    g->sync_pin = sync_pin;
+    g->clkdiv_fixed = TIMING_CLKDIV_ONE;
+    g->sm_mask[0] = g->sm_mask[1] = 0;
+    g->running = false;
+
+    // Pin sinkron dikendalikan SIO; PIO membacanya lewat sinkronisator input
+    gpio_init(sync_pin);
+    gpio_set_dir(sync_pin, GPIO_OUT);
+    gpio_put(sync_pin, 0);
+    return TIMING_OK;
+}
+
+timing_status_t channel_group_add(channel_group_t *g, uint pin_base, uint pin_count,
+                                  const pattern_t *pattern)
+{
+    if (g->running || g->count >= g->capacity || pin_count == 0 ||
+        pin_count > pattern_engine_MASK_BITS)
+        return TIMING_ERR_RANGE;
+    for (uint32_t i = 0; i < pattern->count; i++)
+        if (pattern->steps[i].mask >> pin_count)
+            return TIMING_ERR_PATTERN;
+
+    uint32_t sys_clk_hz = clock_get_hz(clk_sys);
+    uint32_t div;
+    timing_status_t status = pattern_compile_auto(pattern, sys_clk_hz, pattern_engine_EVENT_OVERHEAD,
+                                                  &div, &scratch);
+    if (status != TIMING_OK)
+        return status;
+
+    // Divider bersama: semua kanal harus tetap valid di divider terbesar
+    if (div < g->clkdiv_fixed)
+        div = g->clkdiv_fixed;
+    for (uint i = 0; i < g->count && div != g->clkdiv_fixed; i++)
+    {
+        status = compile_channel(g->ch[i].pattern, sys_clk_hz, div, NULL, NULL);
+        if (status != TIMING_OK)
+            return status;
+    }
+
+    channel_t *ch = &g->ch[g->count];
+    status = compile_channel(pattern, sys_clk_hz, div, NULL, NULL);
+    if (status != TIMING_OK)
+        return status;
+    if (!claim_sm(ch))
+        return TIMING_ERR_RANGE;
+    ch->dma_chan = dma_claim_unused_channel(false);
+    if (ch->dma_chan < 0)
+    {
+        pio_sm_unclaim(ch->pio, ch->sm);
+        pio_programs_release(ch->pio, &pattern_engine_program);
+        return TIMING_ERR_RANGE;
+    }
+
+    // Semua pemeriksaan lolos: tulis tabel (kanal lama disusun ulang bila
+    // divider naik) dan ambil alih pin
+    if (div != g->clkdiv_fixed)
+    {
+        for (uint i = 0; i < g->count; i++)
+            compile_channel(g->ch[i].pattern, sys_clk_hz, div, g->tables[i], &g->ch[i]);
+        g->clkdiv_fixed = div;
+    }
+    ch->pin_base = pin_base;
+    ch->pin_count = pin_count;
+    ch->pattern = pattern;
+    compile_channel(pattern, sys_clk_hz, div, g->tables[g->count], ch);
+
+    for (uint i = 0; i < pin_count; i++)
+        pio_gpio_init(ch->pio, pin_base + i);
+    pio_sm_set_consecutive_pindirs(ch->pio, ch->sm, pin_base, pin_count, true);
+
+    g->sm_mask[pio_get_index(ch->pio)] |= 1u << ch->sm;
+    g->count++;
+    return TIMING_OK;
+}
+
+static void configure_channel(const channel_group_t *g, const channel_t *ch, const uint32_t *table)
+{
+    pio_sm_config c = pattern_engine_program_get_default_config(ch->offset);
+    sm_config_set_out_pins(&c, ch->pin_base, ch->pin_count);
+    sm_config_set_set_pins(&c, ch->pin_base, ch->pin_count);
+    sm_config_set_in_pins(&c, g->sync_pin); // "wait 1 pin 0"
+    sm_config_set_out_shift(&c, true, true, 32);
+    sm_config_set_fifo_join(&c, PIO_FIFO_JOIN_TX);
+    sm_config_set_clkdiv_int_frac8(&c, g->clkdiv_fixed >> 8, 0);
+
+    // Mulai di offset 0 (prolog sinkron), bukan di label 'start'
+    pio_sm_init(ch->pio, ch->sm, ch->offset, &c);
+
+    // Satu channel DMA per kanal: ring sebesar tabel, transfer count maksimum
+    dma_channel_config cfg = dma_channel_get_default_config(ch->dma_chan);
+    channel_config_set_transfer_data_size(&cfg, DMA_SIZE_32);
+    channel_config_set_read_increment(&cfg, true);
+    channel_config_set_write_increment(&cfg, false);
+    channel_config_set_ring(&cfg, false, log2_u32(ch->length * sizeof(uint32_t)));
+    channel_config_set_dreq(&cfg, pio_get_dreq(ch->pio, ch->sm, true));
+    dma_channel_configure(ch->dma_chan, &cfg, &ch->pio->txf[ch->sm], table,
+                          CHANNEL_DMA_TRANSFER_COUNT, true);
+}
+
+void channel_group_start(channel_group_t *g)
+{
+    if (g->running || g->count == 0)
+        return;
+
+    gpio_put(g->sync_pin, 0);
+    for (uint i = 0; i < g->count; i++)
+        configure_channel(g, &g->ch[i], g->tables[i]);
+
+    // Tunggu semua TX FIFO penuh agar tidak ada kanal yang kehabisan kata
+    // pada event pertama
+    for (uint i = 0; i < g->count; i++)
+        while (!pio_sm_is_tx_fifo_full(g->ch[i].pio, g->ch[i].sm))
+            tight_loop_contents();
+
+    // SM diaktifkan per blok (divider di-restart bersamaan) dan berhenti di
+    // "wait 1 pin 0"; satu tulisan SIO melepas semuanya pada siklus yang sama
+    pio_enable_sm_mask_in_sync(pio0, g->sm_mask[0]);
+    pio_enable_sm_mask_in_sync(pio1, g->sm_mask[1]);
+    gpio_put(g->sync_pin, 1);
+    g->running = true;
+}
+
+void channel_group_stop(channel_group_t *g)
+{
+    pio_set_sm_mask_enabled(pio0, g->sm_mask[0], false);
+    pio_set_sm_mask_enabled(pio1, g->sm_mask[1], false);
+    for (uint i = 0; i < g->count; i++)
+    {
+        channel_t *ch = &g->ch[i];
+        dma_channel_abort(ch->dma_chan);
+        // SM yang dimatikan di tengah pulsa membiarkan pin HIGH
+        pio_sm_exec(ch->pio, ch->sm, pio_encode_set(pio_pins, 0));
+        pio_sm_clear_fifos(ch->pio, ch->sm);
+    }
+    gpio_put(g->sync_pin, 0);
+    g->running = false;
+}
+
+void channel_group_release(channel_group_t *g)
+{
+    if (g->running)
+        channel_group_stop(g);
+    for (uint i = 0; i < g->count; i++)
+    {
+        channel_t *ch = &g->ch[i];
+        dma_channel_unclaim(ch->dma_chan);
+        pio_sm_unclaim(ch->pio, ch->sm);
+        pio_programs_release(ch->pio, &pattern_engine_program);
+    }
+    g->count = 0;
+    g->clkdiv_fixed = TIMING_CLKDIV_ONE;
+    g->sm_mask[0] = g->sm_mask[1] = 0;
+}
+
+uint64_t channel_group_run_limit_us(const channel_group_t *g, uint32_t sys_clk_hz)
+{
+    uint64_t limit = UINT64_MAX;
+    for (uint i = 0; i < g->count; i++)
+    {
+        // periode penuh yang muat dalam transfer count x durasi periode,
+        // dipecah agar tidak melimpah 64 bit
+        uint64_t periods = CHANNEL_DMA_TRANSFER_COUNT / g->ch[i].length;
+        uint64_t period_ns = timing_cycles_to_ns(g->ch[i].period_cycles, sys_clk_hz, g->clkdiv_fixed);
+        uint64_t us = period_ns / 1000 * periods + period_ns % 1000 * periods / 1000;
+        if (us < limit)
+            limit = us;
+    }
+    return limit;
+}
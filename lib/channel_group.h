@@ -0,0 +1,88 @@
+#ifndef CHANNEL_GROUP_H
+#define CHANNEL_GROUP_H
+
+/**
+ * Grup kanal multi-SM
+ *
+ * Beberapa kanal (satu SM per kanal, PIO0 lalu PIO1), masing-masing dengan
+ * pin, pola dan frekuensi sendiri, misalnya pasangan elektroda independen.
+ * Semua SM menjalankan satu salinan pattern_engine per blok (pio_programs)
+ * dan diumpan satu channel DMA mode ring per kanal tanpa CPU.
+ *
+ * Anggaran SM: 8 hanya tanpa mesin pulsa. Setelah pulse_engine_launch()
+ * blok mesin pulsa memakai 1 SM dan blok kedua 3 (pulse_counter,
+ * pulse_span, logic_analyzer), jadi tersisa CHANNEL_GROUP_FREE_WITH_ENGINE
+ * SM. channel_group_init() menolak grup yang lebih besar dari SM yang
+ * belum diklaim.
+ *
+ * Start sinkron: SM diaktifkan per blok dengan pio_enable_sm_mask_in_sync()
+ * (clock divider di-restart bersamaan) lalu menunggu di "wait 1 pin" pada
+ * pin sinkron. Satu tulisan SIO ke pin itu melepas semua SM di kedua blok
+ * pada siklus clk_sys yang sama. Semua kanal memakai divider integer yang
+ * sama; skew antar kanal 0 siklus untuk clkdiv 1 (seluruh ruang UI). Untuk
+ * clkdiv D > 1, kanal di blok yang sama tetap 0 siklus, antar blok maks.
+ * D - 1 siklus (fase divider tiap blok mengikuti waktu tulis CTRL-nya).
+ *
+ * Dipanggil dari core pemilik PIO. Pin kanal tidak boleh tumpang tindih
+ * dengan mesin pulsa yang sedang berjalan.
+ */
+
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "pattern.h"
+
+#define CHANNEL_GROUP_MAX 8
+#define CHANNEL_GROUP_FREE_WITH_ENGINE 4
+// Tabel per kanal diputar DMA mode ring: panjang pangkat dua, maks. 16 kata
+#define CHANNEL_TABLE_RING_BITS 6
+#define CHANNEL_TABLE_WORDS (1u << (CHANNEL_TABLE_RING_BITS - 2))
+
+typedef struct
+{
+    PIO pio;
+    uint sm;
+    uint offset;
+    int dma_chan;
+    uint pin_base, pin_count;
+    const pattern_t *pattern; // Disusun ulang bila divider bersama naik
+    uint32_t length;          // Kata dalam tabel (pangkat dua)
+    uint32_t period_cycles;
+} channel_t;
+
+typedef struct
+{
+    // Tabel ring per kanal, sejajar ukuran ring agar DMA dapat membungkus
+    // alamat baca; instance grup harus statis/global (bukan malloc)
+    uint32_t tables[CHANNEL_GROUP_MAX][CHANNEL_TABLE_WORDS]
+        __attribute__((aligned(1u << CHANNEL_TABLE_RING_BITS)));
+    channel_t ch[CHANNEL_GROUP_MAX];
+    uint count;
+    uint capacity;         // Kanal yang diminta saat init (<= SM bebas)
+    uint sync_pin;
+    uint32_t clkdiv_fixed; // Divider integer bersama seluruh kanal
+    uint32_t sm_mask[2];   // SM yang dipakai per blok PIO
+    bool running;
+} channel_group_t;
+
+// Siapkan grup untuk 'channels' kanal; TIMING_ERR_RANGE bila 0, lebih dari
+// CHANNEL_GROUP_MAX atau lebih dari SM yang belum diklaim di kedua blok
+timing_status_t channel_group_init(channel_group_t *g, uint sync_pin, uint channels);
+
+// Tambah kanal: pola disusun (mask harus muat di pin_count pin), dipadatkan
+// ke panjang pangkat dua, lalu SM + DMA diklaim. Kanal yang sudah ada disusun
+// ulang bila divider bersama harus naik, jadi 'pattern' harus tetap valid
+// selama grup dipakai. Melebihi kapasitas init atau kehabisan SM/DMA/memori
+// instruksi -> TIMING_ERR_RANGE.
+timing_status_t channel_group_add(channel_group_t *g, uint pin_base, uint pin_count,
+                                  const pattern_t *pattern);
+
+void channel_group_start(channel_group_t *g);
+void channel_group_stop(channel_group_t *g); // Semua pin kanal dipaksa LOW
+
+// Lepas SM, DMA dan program; grup dapat diisi ulang setelahnya
+void channel_group_release(channel_group_t *g);
+
+// Batas waktu jalan terpendek sebelum transfer count DMA (2^32 - 1 kata) habis
+uint64_t channel_group_run_limit_us(const channel_group_t *g, uint32_t sys_clk_hz);
+
+#endif
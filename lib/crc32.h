@@ -0,0 +1,14 @@
+#ifndef CRC32_H
+#define CRC32_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// CRC-32 (IEEE 802.3, polinom terbalik 0xEDB88320), sama dengan zlib.
+// Tabel 16 entri per nibble: kecil di flash dan cukup cepat untuk rekaman
+// parameter 256 byte. Tidak bergantung pada Pico SDK.
+
+// 'crc' awal 0; hasil panggilan sebelumnya dapat diteruskan untuk data bertahap
+uint32_t crc32_update(uint32_t crc, const void *data, size_t len);
+
+#endif
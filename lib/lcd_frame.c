@@ -0,0 +1,115 @@
+#include "lcd_frame.h"
+#include <string.h>
+
+#define LCD_SETDDRAMADDR 0x80
+
+void lcd_frame_init(lcd_frame_t *f)
+{
+    memset(f->target, ' ', sizeof(f->target));
+    lcd_frame_invalidate(f);
+}
+
+void lcd_frame_invalidate(lcd_frame_t *f)
+{
+    f->shown_valid = false;
+    f->last_rs_valid = false;
+}
+
+void lcd_frame_mark_cleared(lcd_frame_t *f)
+{
+    memset(f->shown, ' ', sizeof(f->shown));
+    f->shown_valid = true;
+}
+
+void lcd_frame_clear(lcd_frame_t *f)
+{
+    memset(f->target, ' ', sizeof(f->target));
+}
+
+void lcd_frame_print(lcd_frame_t *f, int row, int col, const char *s)
+{
+    if (row < 0 || row >= LCD_ROWS || col < 0)
+        return;
+    while (*s && col < LCD_COLS)
+        f->target[row][col++] = *s++;
+}
+
+uint32_t lcd_frame_dirty_count(const lcd_frame_t *f)
+{
+    if (!f->shown_valid)
+        return LCD_ROWS * LCD_COLS;
+    uint32_t n = 0;
+    for (int row = 0; row < LCD_ROWS; row++)
+        for (int col = 0; col < LCD_COLS; col++)
+            n += f->target[row][col] != f->shown[row][col];
+    return n;
+}
+
+size_t lcd_frame_encode_byte(lcd_frame_t *f, uint8_t *out, uint8_t val, bool rs, uint8_t backlight)
+{
+    uint8_t mode = (rs ? LCD_PCF_RS : 0) | backlight;
+    uint8_t high = mode | (val & 0xF0);
+    uint8_t low = mode | ((val << 4) & 0xF0);
+    size_t n = 0;
+
+    if (!f->last_rs_valid || f->last_rs != rs)
+        out[n++] = high;
+    out[n++] = high | LCD_PCF_EN;
+    out[n++] = high;
+    out[n++] = low | LCD_PCF_EN;
+    out[n++] = low;
+
+    f->last_rs = rs;
+    f->last_rs_valid = true;
+    return n;
+}
+
+size_t lcd_frame_encode_dirty(lcd_frame_t *f, uint8_t backlight, uint8_t *out)
+{
+    size_t n = 0;
+
+    for (int row = 0; row < LCD_ROWS; row++)
+    {
+        int col = 0;
+        while (col < LCD_COLS)
+        {
+            if (f->shown_valid && f->target[row][col] == f->shown[row][col])
+            {
+                col++;
+                continue;
+            }
+
+            // Awal deretan: satu perintah alamat (4-6 byte) lalu karakter.
+            // Satu sel tak berubah (4 byte) lebih murah ditulis ulang daripada
+            // alamat baru, dua sel atau lebih tidak.
+            int end = col + 1;
+            while (end < LCD_COLS)
+            {
+                if (!f->shown_valid || f->target[row][end] != f->shown[row][end])
+                    end++;
+                else if (end + 1 < LCD_COLS && f->target[row][end + 1] != f->shown[row][end + 1])
+                    end += 2;
+                else
+                    break;
+            }
+
+            uint8_t addr = (row == 0 ? 0x00 : 0x40) + col;
+            n += lcd_frame_encode_byte(f, out + n, LCD_SETDDRAMADDR | addr, false, backlight);
+            for (; col < end; col++)
+            {
+                // Dibaca sekali: target dapat berubah di tengah encode bila
+                // dipanggil dari interupsi
+                char c = f->target[row][col];
+                n += lcd_frame_encode_byte(f, out + n, (uint8_t)c, true, backlight);
+                f->shown[row][col] = c;
+            }
+        }
+    }
+
+    if (!f->shown_valid)
+    {
+        // Semua sel baru saja ditulis
+        f->shown_valid = true;
+    }
+    return n;
+}
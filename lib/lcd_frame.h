@@ -0,0 +1,60 @@
+#ifndef LCD_FRAME_H
+#define LCD_FRAME_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Framebuffer bayangan LCD 2x16 dan encoder byte ekspander PCF8574 untuk
+// HD44780 mode 4-bit. Tidak bergantung pada Pico SDK sehingga dapat dipakai
+// juga oleh model LCD di host (host/).
+
+#define LCD_ROWS 2
+#define LCD_COLS 16
+
+// Bit ekspander PCF8574 (P0..P3 = RS, RW, EN, backlight; P4..P7 = D4..D7)
+#define LCD_PCF_RS 0x01
+#define LCD_PCF_EN 0x04
+#define LCD_PCF_BACKLIGHT 0x08
+
+// Ukuran buffer terburuk untuk satu flush (seluruh layar berubah)
+#define LCD_FRAME_MAX_BYTES (LCD_ROWS * (2 + 4 + LCD_COLS * 4))
+
+typedef struct
+{
+    char target[LCD_ROWS][LCD_COLS]; // Isi yang diinginkan
+    char shown[LCD_ROWS][LCD_COLS];  // Isi yang sudah ada di DDRAM
+    bool shown_valid;                // false: isi DDRAM tidak diketahui
+    bool last_rs_valid;
+    bool last_rs; // RS pada byte terakhir yang dikirim
+} lcd_frame_t;
+
+void lcd_frame_init(lcd_frame_t *f);
+
+// Isi DDRAM tidak lagi diketahui (mis. setelah perintah mentah): flush
+// berikutnya menulis ulang semua sel
+void lcd_frame_invalidate(lcd_frame_t *f);
+
+// DDRAM baru saja dikosongkan oleh perintah Clear Display
+void lcd_frame_mark_cleared(lcd_frame_t *f);
+
+// Operasi pada target (tanpa lalu lintas bus). Teks dipotong di kolom 16.
+void lcd_frame_clear(lcd_frame_t *f);
+void lcd_frame_print(lcd_frame_t *f, int row, int col, const char *s);
+
+// Jumlah sel yang belum terkirim
+uint32_t lcd_frame_dirty_count(const lcd_frame_t *f);
+
+// Kodekan satu byte HD44780 menjadi 4 byte ekspander (nibble atas lalu
+// bawah, masing-masing EN=1 kemudian EN=0; data dikunci pada tepi turun EN).
+// Bila RS berubah dibanding byte sebelumnya, satu byte persiapan dengan EN=0
+// didahulukan agar RS stabil sebelum EN naik (tAS). Mengembalikan jumlah byte.
+size_t lcd_frame_encode_byte(lcd_frame_t *f, uint8_t *out, uint8_t val, bool rs, uint8_t backlight);
+
+// Kodekan hanya sel yang berubah sejak flush terakhir ke 'out' (minimal
+// LCD_FRAME_MAX_BYTES) lalu tandai sebagai sudah tampil. Sel tak berubah di
+// antara dua sel berubah ikut ditulis bila lebih murah daripada perintah
+// Set DDRAM Address baru. Mengembalikan jumlah byte (0 = tidak ada perubahan).
+size_t lcd_frame_encode_dirty(lcd_frame_t *f, uint8_t backlight, uint8_t *out);
+
+#endif
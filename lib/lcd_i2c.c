@@ -1,5 +1,11 @@
 #include "lcd_i2c.h"
 #include <string.h>
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "lcd_frame.h"
+#include "lcd_queue.h"
+#include "perf_counters.h"
 
 // Definisi Command
 const int LCD_CLEARDISPLAY = 0x01;
@@ -43,7 +49,6 @@ const int LCD_5x8DOTS = 0x00;
 const int LCD_BACKLIGHT = 0x08;
 const int LCD_NOBACKLIGHT = 0x00;
 
-#define ENABLE 0x04     // Enable bit
 #define REG_CHARACTER 1 // Mode - Sending data
 #define REG_COMMAND 0   // Mode - Sending command
 
@@ -51,85 +56,267 @@ static i2c_inst_t *i2c_instance_ptr;
 static uint8_t i2c_addr;
 static uint8_t backlight_val = LCD_BACKLIGHT;
 
-void i2c_write_byte(uint8_t val)
+// Antrean tampilan: semua tulisan masuk ke framebuffer bayangan di dalamnya
+// dan hanya sel yang berubah dikirim. Pengiriman dikerjakan DMA (DREQ TX I2C)
+// dan interupsi STOP_DET, sehingga pemanggil tidak pernah menunggu bus.
+static lcd_queue_t queue;
+static int cursor_line, cursor_pos;
+
+// ===================== BACKEND ASINKRON =====================
+// Tanpa jeda tetap: setiap byte ekspander sudah memakan 9 bit waktu bus
+// (22.5 us pada 400 kHz), sehingga pulsa EN (min. 450 ns) dan jeda antar
+// instruksi HD44780 (37 us = dua byte ekspander) terpenuhi oleh bus itu
+// sendiri hingga ~480 kHz. Hanya Clear Display/Return Home yang butuh
+// 1.52 ms, ditunggu dengan alarm setelah STOP.
+//
+// Satu batch dalam perjalanan: byte ekspander sebagai kata IC_DATA_CMD
+// (STOP pada kata terakhir) yang dibaca DMA langsung ke FIFO TX.
+static uint16_t dma_buf[LCD_FRAME_MAX_BYTES];
+static int dma_chan = -1;
+static volatile bool busy;       // Batch di bus atau menunggu waktu eksekusi
+static uint32_t pending_wait_us; // Jeda setelah STOP batch ini (Clear/Home)
+static volatile uint32_t tx_aborts;
+
+// Dipanggil dengan interupsi mati (loop UI) atau dari interupsi
+static void lcd_kick(void)
+{
+    if (busy || dma_chan < 0)
+        return;
+
+    uint8_t batch[LCD_FRAME_MAX_BYTES];
+    size_t n = lcd_queue_next_batch(&queue, backlight_val, batch, &pending_wait_us);
+    if (!n)
+        return;
+
+    for (size_t i = 0; i < n; i++)
+        dma_buf[i] = batch[i];
+    dma_buf[n - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+
+    busy = true;
+    dma_channel_transfer_from_buffer_now(dma_chan, dma_buf, n);
+}
+
+static int64_t lcd_wait_done(alarm_id_t id, void *user_data)
 {
-    i2c_write_blocking(i2c_instance_ptr, i2c_addr, &val, 1, false);
+    busy = false;
+    lcd_kick();
+    return 0;
 }
 
-void lcd_toggle_enable(uint8_t val)
+static void lcd_i2c_irq(void)
 {
-    // Toggle enable pin on LCD display
-    // We cannot do this too quickly
-    sleep_us(600);
-    i2c_write_byte(val | ENABLE);
-    sleep_us(600);
-    i2c_write_byte(val & ~ENABLE);
-    sleep_us(600);
+    i2c_hw_t *hw = i2c_get_hw(i2c_instance_ptr);
+    uint32_t stat = hw->intr_stat;
+
+    if (stat & I2C_IC_INTR_STAT_R_TX_ABRT_BITS)
+    {
+        // Tanpa ACK (modul dicabut, gangguan bus): buang batch, kirim ulang
+        // seluruh layar pada flush berikutnya. Tidak langsung dicoba lagi
+        // agar modul yang hilang tidak memicu badai interupsi.
+        dma_channel_abort(dma_chan);
+        (void)hw->clr_tx_abrt;
+        (void)hw->clr_stop_det;
+        tx_aborts++;
+        lcd_frame_invalidate(&queue.frame);
+        busy = false;
+        return;
+    }
+    if (!(stat & I2C_IC_INTR_STAT_R_STOP_DET_BITS))
+        return;
+    (void)hw->clr_stop_det;
+
+    if (!busy)
+        return;
+    if (pending_wait_us && add_alarm_in_us(pending_wait_us, lcd_wait_done, NULL, true) > 0)
+        return;
+    busy = false;
+    lcd_kick();
 }
 
-// The display is sent data in two halves, each half being 4 bits.
-void lcd_send_byte(uint8_t val, int mode)
+static void lcd_async_init(void)
 {
-    uint8_t high_nibble = mode | (val & 0xF0) | backlight_val;
-    uint8_t low_nibble = mode | ((val << 4) & 0xF0) | backlight_val;
+    i2c_hw_t *hw = i2c_get_hw(i2c_instance_ptr);
+
+    // LCD satu-satunya perangkat di bus: alamat target ditulis sekali
+    hw->enable = 0;
+    hw->tar = i2c_addr;
+    hw->enable = 1;
+
+    dma_chan = dma_claim_unused_channel(true);
+    dma_channel_config c = dma_channel_get_default_config(dma_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, i2c_get_dreq(i2c_instance_ptr, true));
+    dma_channel_configure(dma_chan, &c, &hw->data_cmd, dma_buf, 0, false);
 
-    i2c_write_byte(high_nibble);
-    lcd_toggle_enable(high_nibble);
-    i2c_write_byte(low_nibble);
-    lcd_toggle_enable(low_nibble);
+    uint irq = I2C0_IRQ + i2c_get_index(i2c_instance_ptr);
+    (void)hw->clr_intr;
+    hw->intr_mask = I2C_IC_INTR_MASK_M_STOP_DET_BITS | I2C_IC_INTR_MASK_M_TX_ABRT_BITS;
+    irq_set_exclusive_handler(irq, lcd_i2c_irq);
+    irq_set_enabled(irq, true);
 }
 
+// Tulis blocking, hanya saat antrean kosong (inisialisasi dan backlight).
+// Interupsi I2C dimatikan agar tidak memakan STOP_DET yang ditunggu SDK.
+static void i2c_write_bytes(const uint8_t *buf, size_t len)
+{
+    uint irq = I2C0_IRQ + i2c_get_index(i2c_instance_ptr);
+    bool async = dma_chan >= 0;
+    if (async)
+        irq_set_enabled(irq, false);
+    i2c_write_blocking(i2c_instance_ptr, i2c_addr, buf, len, false);
+    if (async)
+    {
+        (void)i2c_get_hw(i2c_instance_ptr)->clr_stop_det;
+        irq_set_enabled(irq, true);
+    }
+}
+
+// Satu nibble tunggal (mode 8-bit saat inisialisasi)
+static void lcd_send_init_nibble(uint8_t nibble)
+{
+    uint8_t val = (nibble << 4) | backlight_val;
+    uint8_t buf[3] = {val, val | LCD_PCF_EN, val};
+    i2c_write_bytes(buf, sizeof(buf));
+}
+
+// Blocking, hanya untuk urutan inisialisasi sebelum backend asinkron aktif
+static void lcd_send_byte(uint8_t val, int mode)
+{
+    uint8_t buf[5];
+    size_t n = lcd_frame_encode_byte(&queue.frame, buf, val, mode == REG_CHARACTER, backlight_val);
+    i2c_write_bytes(buf, n);
+}
+
+// ===================== API =====================
+
 void lcd_send_cmd(uint8_t cmd)
 {
-    lcd_send_byte(cmd, REG_COMMAND);
+    for (;;)
+    {
+        uint32_t irq_state = save_and_disable_interrupts();
+        perf_stamp_t off = perf_begin();
+        bool queued = lcd_queue_cmd(&queue, cmd);
+        if (queued)
+            lcd_kick();
+        perf_end(PERF_IRQ_OFF, off);
+        restore_interrupts(irq_state);
+        if (queued)
+            return;
+        // Ring perintah mentah penuh (jarang): tunggu interupsi mengurasnya
+        tight_loop_contents();
+    }
 }
 
 void lcd_send_char(uint8_t val)
 {
-    lcd_send_byte(val, REG_CHARACTER);
+    char s[2] = {(char)val, 0};
+    lcd_string(s);
 }
 
 void lcd_clear(void)
 {
-    lcd_send_cmd(LCD_CLEARDISPLAY);
-    sleep_ms(2);
+    lcd_fb_clear();
+    cursor_line = cursor_pos = 0;
 }
 
 void lcd_set_cursor(int line, int position)
 {
-    int val = (line == 0) ? 0x80 + position : 0xC0 + position;
-    lcd_send_cmd(val);
+    cursor_line = line;
+    cursor_pos = position;
 }
 
 void lcd_string(const char *s)
 {
-    while (*s)
-    {
-        lcd_send_char(*s++);
-    }
+    // API lama: tulis di posisi kursor lalu langsung kirim
+    lcd_fb_print(cursor_line, cursor_pos, s);
+    cursor_pos += strlen(s);
+    lcd_fb_flush();
+}
+
+void lcd_fb_clear(void)
+{
+    uint32_t irq_state = save_and_disable_interrupts();
+    lcd_queue_clear(&queue);
+    restore_interrupts(irq_state);
+}
+
+void lcd_fb_print(int line, int position, const char *s)
+{
+    uint32_t irq_state = save_and_disable_interrupts();
+    lcd_queue_print(&queue, line, position, s);
+    restore_interrupts(irq_state);
+}
+
+void lcd_fb_flush(void)
+{
+    // Tidak menunggu: bila batch sebelumnya masih di bus, sel yang berubah
+    // ikut batch berikutnya yang dimulai dari interupsi STOP_DET
+    perf_stamp_t start = perf_begin();
+    uint32_t irq_state = save_and_disable_interrupts();
+    perf_stamp_t off = perf_begin();
+    lcd_kick();
+    perf_end(PERF_IRQ_OFF, off);
+    restore_interrupts(irq_state);
+    perf_end(PERF_LCD, start);
+}
+
+bool lcd_idle(void)
+{
+    uint32_t irq_state = save_and_disable_interrupts();
+    bool idle = !busy && lcd_queue_depth(&queue) == 0;
+    restore_interrupts(irq_state);
+    return idle;
+}
+
+void lcd_wait_idle(void)
+{
+    while (!lcd_idle())
+        tight_loop_contents();
+}
+
+void lcd_queue_stats(uint32_t *depth, uint32_t *high_water, uint32_t *aborts)
+{
+    uint32_t irq_state = save_and_disable_interrupts();
+    *depth = lcd_queue_depth(&queue);
+    *high_water = queue.high_water;
+    *aborts = tx_aborts;
+    restore_interrupts(irq_state);
 }
 
 void lcd_backlight(bool on)
 {
     backlight_val = on ? LCD_BACKLIGHT : LCD_NOBACKLIGHT;
-    i2c_write_byte(backlight_val); // Langsung tulis untuk update state
+    lcd_wait_idle();
+    i2c_write_bytes(&backlight_val, 1); // Langsung tulis untuk update state
 }
 
 void lcd_init(i2c_inst_t *i2c, uint8_t addr)
 {
     i2c_instance_ptr = i2c;
     i2c_addr = addr;
+    lcd_queue_init(&queue);
 
-    // Inisialisasi 4-bit mode
-    lcd_send_byte(0x03, REG_COMMAND);
-    lcd_send_byte(0x03, REG_COMMAND);
-    lcd_send_byte(0x03, REG_COMMAND);
-    lcd_send_byte(0x02, REG_COMMAND);
+    // Inisialisasi 4-bit mode (urutan datasheet HD44780). Controller masih
+    // dalam mode 8-bit dan busy flag tidak dapat dibaca lewat ekspander.
+    lcd_send_init_nibble(0x03);
+    sleep_ms(5);
+    lcd_send_init_nibble(0x03);
+    sleep_us(150);
+    lcd_send_init_nibble(0x03);
+    sleep_us(150);
+    lcd_send_init_nibble(0x02);
+    sleep_us(150);
 
     // Konfigurasi display
-    lcd_send_cmd(LCD_FUNCTIONSET | LCD_2LINE | LCD_5x8DOTS | LCD_4BITMODE);
-    lcd_send_cmd(LCD_DISPLAYCONTROL | LCD_DISPLAYON);
-    lcd_clear();
-    lcd_send_cmd(LCD_ENTRYMODESET | LCD_ENTRYLEFT);
+    lcd_send_byte(LCD_FUNCTIONSET | LCD_2LINE | LCD_5x8DOTS | LCD_4BITMODE, REG_COMMAND);
+    lcd_send_byte(LCD_DISPLAYCONTROL | LCD_DISPLAYON, REG_COMMAND);
+    lcd_send_byte(LCD_CLEARDISPLAY, REG_COMMAND);
+    sleep_ms(2);
+    lcd_frame_mark_cleared(&queue.frame);
+    lcd_send_byte(LCD_ENTRYMODESET | LCD_ENTRYLEFT, REG_COMMAND);
     sleep_ms(5);
-}
\ No newline at end of file
+
+    lcd_async_init();
+}
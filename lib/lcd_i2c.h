@@ -13,4 +13,16 @@ void lcd_clear(void);
 void lcd_set_cursor(int line, int position);
 void lcd_backlight(bool on);
 
+// Framebuffer bayangan 2x16: print/clear hanya mengubah buffer, flush
+// mengirim sel yang berubah dalam satu transaksi I2C
+void lcd_fb_clear(void);
+void lcd_fb_print(int line, int position, const char *s);
+void lcd_fb_flush(void);
+
+// Backend asinkron: flush/print/cmd hanya mengantre dan langsung kembali,
+// antrean dikuras DMA + interupsi I2C di latar belakang
+bool lcd_idle(void);      // Antrean kosong dan bus bebas
+void lcd_wait_idle(void); // Sebelum mengubah baudrate/clock sistem
+void lcd_queue_stats(uint32_t *depth, uint32_t *high_water, uint32_t *aborts);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,72 @@
+#include "lcd_queue.h"
+
+#define LCD_CLEARDISPLAY 0x01
+#define LCD_RETURNHOME 0x02
+
+static void track_depth(lcd_queue_t *q)
+{
+    uint32_t depth = lcd_queue_depth(q);
+    if (depth > q->high_water)
+        q->high_water = depth;
+}
+
+void lcd_queue_init(lcd_queue_t *q)
+{
+    lcd_frame_init(&q->frame);
+    q->raw_head = q->raw_tail = 0;
+    q->high_water = 0;
+    q->raw_dropped = 0;
+}
+
+void lcd_queue_print(lcd_queue_t *q, int row, int col, const char *s)
+{
+    lcd_frame_print(&q->frame, row, col, s);
+    track_depth(q);
+}
+
+void lcd_queue_clear(lcd_queue_t *q)
+{
+    // Cukup mengosongkan target: diff hanya menulis spasi pada sel yang
+    // terisi, tanpa Clear Display 1.52 ms
+    lcd_frame_clear(&q->frame);
+    track_depth(q);
+}
+
+bool lcd_queue_cmd(lcd_queue_t *q, uint8_t cmd)
+{
+    if (q->raw_head - q->raw_tail >= LCD_QUEUE_RAW_SLOTS)
+    {
+        q->raw_dropped++;
+        return false;
+    }
+    q->raw[q->raw_head % LCD_QUEUE_RAW_SLOTS] = cmd;
+    q->raw_head++;
+    track_depth(q);
+    return true;
+}
+
+uint32_t lcd_queue_depth(const lcd_queue_t *q)
+{
+    return (q->raw_head - q->raw_tail) + lcd_frame_dirty_count(&q->frame);
+}
+
+size_t lcd_queue_next_batch(lcd_queue_t *q, uint8_t backlight, uint8_t *out, uint32_t *wait_us)
+{
+    *wait_us = 0;
+
+    if (q->raw_head != q->raw_tail)
+    {
+        uint8_t cmd = q->raw[q->raw_tail % LCD_QUEUE_RAW_SLOTS];
+        q->raw_tail++;
+        size_t n = lcd_frame_encode_byte(&q->frame, out, cmd, false, backlight);
+        if (cmd == LCD_CLEARDISPLAY || (cmd & 0xFE) == LCD_RETURNHOME)
+            *wait_us = LCD_CLEAR_WAIT_US;
+        if (cmd == LCD_CLEARDISPLAY)
+            lcd_frame_mark_cleared(&q->frame);
+        else if ((cmd & 0xFE) != LCD_RETURNHOME && !(cmd & 0x80))
+            lcd_frame_invalidate(&q->frame); // Efek pada DDRAM tidak dilacak
+        return n;
+    }
+
+    return lcd_frame_encode_dirty(&q->frame, backlight, out);
+}
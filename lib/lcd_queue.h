@@ -0,0 +1,46 @@
+#ifndef LCD_QUEUE_H
+#define LCD_QUEUE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "lcd_frame.h"
+
+// Antrean perintah LCD berukuran tetap untuk backend asinkron. Penulisan sel
+// disimpan sebagai peta sel (framebuffer), sehingga tulisan berulang ke sel
+// yang sama dan perpindahan kursor otomatis digabung; perintah mentah
+// (display control, entry mode, dst.) masuk ring terpisah dan didahulukan.
+// Tidak bergantung pada Pico SDK sehingga dapat dipakai juga oleh host/.
+
+#define LCD_QUEUE_RAW_SLOTS 8 // Pangkat dua
+
+// Waktu eksekusi HD44780 yang lebih lama dari dua byte ekspander di bus
+#define LCD_CLEAR_WAIT_US 1600
+
+typedef struct
+{
+    lcd_frame_t frame;
+    uint8_t raw[LCD_QUEUE_RAW_SLOTS];
+    volatile uint32_t raw_head; // Ditulis produsen
+    volatile uint32_t raw_tail; // Ditulis konsumen
+    uint32_t high_water;        // Kedalaman antrean maksimum (sel + perintah)
+    uint32_t raw_dropped;
+} lcd_queue_t;
+
+void lcd_queue_init(lcd_queue_t *q);
+
+// Produsen (loop UI)
+void lcd_queue_print(lcd_queue_t *q, int row, int col, const char *s);
+void lcd_queue_clear(lcd_queue_t *q);
+bool lcd_queue_cmd(lcd_queue_t *q, uint8_t cmd); // false bila ring penuh
+
+// Sel tertunda + perintah mentah tertunda
+uint32_t lcd_queue_depth(const lcd_queue_t *q);
+
+// Konsumen (interupsi): kodekan batch berikutnya ke 'out' (minimal
+// LCD_FRAME_MAX_BYTES). Perintah mentah dikirim satu per batch; 'wait_us'
+// diisi jeda yang dibutuhkan setelah batch selesai di bus (0 bila tidak ada).
+// Mengembalikan 0 bila antrean kosong.
+size_t lcd_queue_next_batch(lcd_queue_t *q, uint8_t backlight, uint8_t *out, uint32_t *wait_us);
+
+#endif
@@ -0,0 +1,266 @@
+#include "logic_analysis.h"
+#include <stdio.h>
+#include <string.h>
+#include "signal_timing.h"
+
+// ===================== TANGKAPAN =====================
+void logic_rle_encode(const logic_capture_t *cap, logic_rle_t *rle)
+{
+    // Satu kata berisi delapan sampel yang sama = 0x11111111 x status
+    const uint32_t same = 0x11111111u;
+    rle->count = 0;
+    rle->truncated = false;
+    uint32_t pins = 0;
+    uint32_t i = 0;
+    while (i < cap->samples)
+    {
+        uint32_t shift = (i % LOGIC_SAMPLES_PER_WORD) * LOGIC_CHANNELS;
+        uint32_t word = cap->words[i / LOGIC_SAMPLES_PER_WORD];
+        if (rle->count > 0 && shift == 0 && i + LOGIC_SAMPLES_PER_WORD <= cap->samples && word == pins * same)
+        {
+            i += LOGIC_SAMPLES_PER_WORD;
+            continue;
+        }
+        uint32_t p = (word >> shift) & 0xf;
+        if (rle->count == 0 || p != pins)
+        {
+            if (rle->count == LOGIC_RUNS_MAX)
+            {
+                rle->truncated = true;
+                break;
+            }
+            rle->run[rle->count].start = i;
+            rle->run[rle->count].pins = (uint8_t)p;
+            rle->count++;
+            pins = p;
+        }
+        i++;
+    }
+    rle->samples = i;
+}
+
+// ===================== ANALISIS =====================
+typedef struct
+{
+    uint32_t count;
+    uint32_t min, max; // Sampel
+} span_acc_t;
+
+static void span_add(span_acc_t *s, uint32_t samples)
+{
+    if (s->count == 0 || samples < s->min)
+        s->min = samples;
+    if (s->count == 0 || samples > s->max)
+        s->max = samples;
+    s->count++;
+}
+
+static uint32_t run_end(const logic_rle_t *rle, uint32_t k)
+{
+    return k + 1 < rle->count ? rle->run[k + 1].start : rle->samples;
+}
+
+// Tepi awal run tertangkap bila ada run sebelumnya; run 0 hanya dengan
+// picu (tepi naik CH1 LOGIC_TRIGGER_LAG_SAMPLES sebelum sampel 0)
+static bool start_seen(const logic_capture_t *cap, uint32_t k)
+{
+    return k > 0 || cap->triggered;
+}
+
+static uint32_t run_len(const logic_rle_t *rle, const logic_capture_t *cap, uint32_t k)
+{
+    uint32_t lag = k == 0 && cap->triggered ? LOGIC_TRIGGER_LAG_SAMPLES : 0;
+    return run_end(rle, k) - rle->run[k].start + lag;
+}
+
+// Tepi akhir tertangkap: ada run sesudahnya (juga run terakhir bila ring
+// run penuh, karena pemotongan terjadi tepat pada tepi berikutnya)
+static bool end_seen(const logic_rle_t *rle, uint32_t k)
+{
+    return k + 1 < rle->count || rle->truncated;
+}
+
+static uint32_t diff_u32(uint32_t a, uint32_t b)
+{
+    return a > b ? a - b : b - a;
+}
+
+bool logic_analyze(const logic_rle_t *rle, const logic_capture_t *cap, const pulse_report_t *counter,
+                   const logic_expect_t *e, logic_result_t *r)
+{
+    span_acc_t acc[LOGIC_MEASURES] = {0};
+    memset(r, 0, sizeof(*r));
+    r->sample_ps = timing_resolution_ps(cap->sys_clk_hz, TIMING_CLKDIV_ONE);
+
+    bool a_seen = false, a_pending = false;
+    uint32_t a_end = 0;
+    for (uint32_t k = 0; k < rle->count; k++)
+    {
+        const logic_run_t *run = &rle->run[k];
+        bool complete = start_seen(cap, k) && end_seen(rle, k);
+        uint32_t len = run_len(rle, cap, k);
+
+        if (run->pins == LOGIC_STATE_A)
+        {
+            if (complete)
+                span_add(&acc[LOGIC_PULSE_A], len);
+            if (a_pending && r->bad_order++ == 0 && r->bad_states == 0)
+                r->first_bad = run->start;
+            a_end = run_end(rle, k);
+            a_pending = a_seen = true;
+        }
+        else if (run->pins == LOGIC_STATE_C)
+        {
+            if (complete)
+                span_add(&acc[LOGIC_PULSE_C], len);
+            if (a_pending)
+                span_add(&acc[LOGIC_DEAD_TIME], run->start - a_end);
+            else if (a_seen && r->bad_order++ == 0 && r->bad_states == 0)
+                r->first_bad = run->start;
+            a_pending = false;
+        }
+        else if (run->pins != 0)
+        {
+            if (r->bad_states++ == 0 && r->bad_order == 0)
+                r->first_bad = run->start;
+        }
+    }
+
+    r->pass = r->bad_states == 0 && r->bad_order == 0;
+    for (int m = 0; m < LOGIC_MEASURES; m++)
+    {
+        logic_span_t *s = &r->span[m];
+        uint32_t tolerance = e->tolerance_ns;
+        if (m == LOGIC_PERIOD)
+        {
+            // Rentang tepi naik pertama -> terakhir dari pulse_span: seluruh
+            // proses pada resolusi penghitung, bukan jendela tangkapan
+            s->count = counter->pulses >= 2 ? counter->pulses - 1 : 0;
+            s->min_ns = s->max_ns = counter->mean_period_ns;
+            tolerance = e->period_tolerance_ns;
+        }
+        else
+        {
+            s->count = acc[m].count;
+            s->min_ns = (uint32_t)timing_cycles_to_ns(acc[m].min, cap->sys_clk_hz, TIMING_CLKDIV_ONE);
+            s->max_ns = (uint32_t)timing_cycles_to_ns(acc[m].max, cap->sys_clk_hz, TIMING_CLKDIV_ONE);
+        }
+        s->ok = s->count > 0 && diff_u32(s->min_ns, e->expect_ns[m]) <= tolerance &&
+                diff_u32(s->max_ns, e->expect_ns[m]) <= tolerance;
+        r->pass = r->pass && s->ok;
+    }
+    return r->pass;
+}
+
+const char *logic_measure_name(logic_measure_t m)
+{
+    static const char *const names[LOGIC_MEASURES] = {"LEBAR A", "LEBAR C", "DEAD", "PERIODE"};
+    return (unsigned)m < LOGIC_MEASURES ? names[m] : "?";
+}
+
+// ===================== VCD =====================
+enum
+{
+    VCD_HEADER = 0,
+    VCD_RUNS,
+    VCD_END,
+    VCD_DONE,
+};
+
+// Kode identitas VCD per kanal: '!', '"', '#', '$'
+#define VCD_ID(ch) ((char)('!' + (ch)))
+
+void logic_vcd_init(logic_vcd_t *v, const logic_rle_t *rle, const logic_capture_t *cap)
+{
+    memset(v, 0, sizeof(*v));
+    v->rle = rle;
+    v->sys_clk_hz = cap->sys_clk_hz;
+}
+
+static uint64_t sample_ns(const logic_vcd_t *v, uint32_t sample)
+{
+    return timing_cycles_to_ns(sample, v->sys_clk_hz, TIMING_CLKDIV_ONE);
+}
+
+// Baris kepala ke-i; 0 bila kepala selesai
+static int header_line(const logic_vcd_t *v, uint32_t i, char *out, size_t cap)
+{
+    uint32_t ps = timing_resolution_ps(v->sys_clk_hz, TIMING_CLKDIV_ONE);
+    switch (i)
+    {
+    case 0:
+        return snprintf(out, cap, "$comment %lu sampel %lu.%03lu ns $end\n",
+                        (unsigned long)v->rle->samples, (unsigned long)(ps / 1000), (unsigned long)(ps % 1000));
+    case 1:
+        return snprintf(out, cap, "$timescale 1 ns $end\n");
+    case 2:
+        return snprintf(out, cap, "$scope module mgc $end\n");
+    case 3:
+    case 4:
+    case 5:
+    case 6:
+        return snprintf(out, cap, "$var wire 1 %c CH%u $end\n", VCD_ID(i - 3), (unsigned)(i - 2));
+    case 7:
+        return snprintf(out, cap, "$upscope $end\n");
+    case 8:
+        return snprintf(out, cap, "$enddefinitions $end\n");
+    default:
+        return 0;
+    }
+}
+
+// Run ke-k: waktu lalu kanal yang berubah (run pertama: semua kanal)
+static int run_lines(logic_vcd_t *v, uint32_t k, char *out, size_t cap)
+{
+    const logic_run_t *run = &v->rle->run[k];
+    int n = snprintf(out, cap, "#%llu\n%s", (unsigned long long)sample_ns(v, run->start),
+                     k == 0 ? "$dumpvars\n" : "");
+    uint8_t changed = k == 0 ? 0xf : (uint8_t)(run->pins ^ v->pins);
+    for (int ch = 0; ch < LOGIC_CHANNELS; ch++)
+        if (changed & (1u << ch))
+            n += snprintf(out + n, cap - n, "%u%c\n", (run->pins >> ch) & 1u, VCD_ID(ch));
+    if (k == 0)
+        n += snprintf(out + n, cap - n, "$end\n");
+    return n;
+}
+
+size_t logic_vcd_next(logic_vcd_t *v, char *out, size_t cap)
+{
+    char line[LOGIC_VCD_LINE_MAX];
+    size_t n = 0;
+    while (v->stage != VCD_DONE)
+    {
+        int len = 0;
+        if (v->stage == VCD_HEADER)
+            len = header_line(v, v->line, line, sizeof(line));
+        else if (v->stage == VCD_RUNS)
+            len = v->line < v->rle->count ? run_lines(v, v->line, line, sizeof(line)) : 0;
+        else
+            len = snprintf(line, sizeof(line), "#%llu\n", (unsigned long long)sample_ns(v, v->rle->samples));
+        if (len <= 0)
+        {
+            // Bagian ini selesai: lanjut ke bagian berikutnya
+            v->stage++;
+            v->line = 0;
+            continue;
+        }
+        if (n + (size_t)len > cap)
+            break;
+        memcpy(out + n, line, (size_t)len);
+        n += (size_t)len;
+        if (v->stage == VCD_RUNS)
+            v->pins = v->rle->run[v->line].pins;
+        if (v->stage == VCD_END)
+        {
+            v->stage = VCD_DONE;
+            break;
+        }
+        v->line++;
+    }
+    return n;
+}
+
+bool logic_vcd_done(const logic_vcd_t *v)
+{
+    return v->stage == VCD_DONE;
+}
@@ -0,0 +1,125 @@
+#ifndef LOGIC_ANALYSIS_H
+#define LOGIC_ANALYSIS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "pulse_stats.h"
+
+// Analisis tangkapan penganalisis logika (lib/logic_analyzer.h): sampel
+// GP6..GP9 dikodekan run-length, lalu lebar pulsa dan dead time diukur dari
+// run, periode diambil dari penghitung pulsa CH1 (lib/pulse_stats.h), dan
+// semuanya dibandingkan dengan parameter UI; hasil tangkapan
+// diekspor sebagai VCD untuk penampil gelombang (GTKWave, PulseView). Tidak
+// bergantung pada Pico SDK sehingga diuji di host terhadap tangkapan
+// simulator PIO (mgc_sim logic).
+//
+// Sampel: 4 bit per sampel (bit 0 = GP6 = CH1), delapan per kata dengan
+// sampel pertama di bit 0..3, sama seperti "in pins, 4" dengan ISR geser
+// kanan dan autopush 32 bit. Satu sampel per siklus clk_sys.
+
+#define LOGIC_CHANNELS 4
+#define LOGIC_SAMPLES_PER_WORD (32 / LOGIC_CHANNELS)
+#define LOGIC_RUNS_MAX 1024
+
+// Dengan picu, sampel 0 diambil satu siklus sesudah tepi naik CH1 ("wait 1
+// pin" lalu "in"); sinkronisasi input menunda semua tepi sama besar
+#define LOGIC_TRIGGER_LAG_SAMPLES 1
+
+// Status pin program statis (sekuens 1001, 0000, 0110, 0000)
+#define LOGIC_STATE_A 0x9 // CH1 + CH4
+#define LOGIC_STATE_C 0x6 // CH2 + CH3
+
+// Satu tangkapan, diisi penganalisis setelah DMA selesai atau dihentikan
+typedef struct
+{
+    const uint32_t *words;
+    uint32_t samples;
+    uint32_t sys_clk_hz;
+    bool triggered; // Run 0 dimulai pada tepi naik CH1 (LOGIC_TRIGGER_LAG_SAMPLES)
+} logic_capture_t;
+
+typedef struct
+{
+    uint32_t start; // Indeks sampel pertama
+    uint8_t pins;
+} logic_run_t;
+
+typedef struct
+{
+    logic_run_t run[LOGIC_RUNS_MAX];
+    uint32_t count;
+    uint32_t samples; // Sampel yang tercakup run (< tangkapan bila terpotong)
+    bool truncated;   // Run penuh: run terakhir berakhir pada tepi di 'samples'
+} logic_rle_t;
+
+typedef enum
+{
+    LOGIC_PULSE_A = 0, // Lebar status A (CH1/CH4 HIGH)
+    LOGIC_PULSE_C,     // Lebar status C (CH2/CH3 HIGH)
+    LOGIC_DEAD_TIME,   // Akhir A -> awal C
+    LOGIC_PERIOD,      // Rata-rata tepi naik CH1 dari penghitung pulsa
+    LOGIC_MEASURES,
+} logic_measure_t;
+
+typedef struct
+{
+    uint32_t expect_ns[LOGIC_MEASURES]; // Dari parameter UI
+    uint32_t tolerance_ns;              // Lebar A/C dan dead time
+    uint32_t period_tolerance_ns;       // Periode (lihat pulse_stats_period_error_ns)
+} logic_expect_t;
+
+typedef struct
+{
+    uint32_t count; // Interval lengkap (kedua tepinya tertangkap)
+    uint32_t min_ns, max_ns;
+    bool ok;
+} logic_span_t;
+
+typedef struct
+{
+    logic_span_t span[LOGIC_MEASURES];
+    uint32_t sample_ps;
+    uint32_t bad_states;    // Run dengan status selain 0, A, C (tumpang tindih, glitch)
+    uint32_t bad_order;     // A tanpa C sebelum A berikutnya, atau C tanpa A
+    uint32_t first_bad;     // Indeks sampel masalah pertama
+    bool pass;
+} logic_result_t;
+
+// Sampel -> run; berhenti (truncated) bila LOGIC_RUNS_MAX run penuh
+void logic_rle_encode(const logic_capture_t *cap, logic_rle_t *rle);
+
+// Ukur setiap interval lengkap; LOGIC_PERIOD dari 'counter' (pulses - 1
+// interval dengan nilai mean_period_ns). Lulus bila setiap besaran punya
+// minimal satu interval, min dan maks-nya dalam toleransi, dan tidak ada
+// status atau urutan yang salah.
+bool logic_analyze(const logic_rle_t *rle, const logic_capture_t *cap, const pulse_report_t *counter,
+                   const logic_expect_t *e, logic_result_t *r);
+
+// Nama singkat untuk LCD dan log (maks. 7 karakter)
+const char *logic_measure_name(logic_measure_t m);
+
+// Penyandi VCD bertahap: teks dihasilkan per baris utuh sehingga dapat
+// dikirim dalam potongan kecil tanpa buffer seukuran berkas
+typedef struct
+{
+    const logic_rle_t *rle;
+    uint32_t sys_clk_hz;
+    uint32_t line; // Baris kepala berikutnya, lalu run berikutnya
+    uint8_t stage;
+    uint8_t pins;
+} logic_vcd_t;
+
+// Satu run terpanjang: "#<ns>" + empat perubahan
+#define LOGIC_VCD_LINE_MAX 64
+
+void logic_vcd_init(logic_vcd_t *v, const logic_rle_t *rle, const logic_capture_t *cap);
+
+// Teks berikutnya ke 'out' (maks. 'cap' byte, minimal LOGIC_VCD_LINE_MAX);
+// 0 bila berkas selesai
+size_t logic_vcd_next(logic_vcd_t *v, char *out, size_t cap);
+
+// Baris terakhir sudah dihasilkan
+bool logic_vcd_done(const logic_vcd_t *v);
+
+#endif
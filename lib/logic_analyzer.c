@@ -0,0 +1,93 @@
+#include "logic_analyzer.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "logic_analyzer.pio.h"
+#include "pio_programs.h"
+
+static PIO pio;
+static uint pin_base;
+static uint sm;
+static uint offset;
+static int dma_chan = -1;
+static bool ready;
+
+static uint32_t buffer[LOGIC_BUFFER_WORDS];
+// Ditulis core 1 saat disarm, dibaca core 0 setelah status mesin pulsa
+// terbit (seqlock mailbox memberi barrier)
+static logic_capture_t last;
+static bool armed, captured;
+
+bool logic_analyzer_init(PIO pio_instance, uint pin)
+{
+    pio = pio_instance;
+    pin_base = pin;
+    if (!pio_programs_acquire(pio, &logic_analyzer_program, &offset))
+        return false;
+    int s = pio_claim_unused_sm(pio, false);
+    if (s < 0)
+    {
+        pio_programs_release(pio, &logic_analyzer_program);
+        return false;
+    }
+    dma_chan = dma_claim_unused_channel(false);
+    if (dma_chan < 0)
+    {
+        pio_sm_unclaim(pio, (uint)s);
+        pio_programs_release(pio, &logic_analyzer_program);
+        return false;
+    }
+    sm = (uint)s;
+    ready = true;
+    return true;
+}
+
+void logic_analyzer_arm(bool trigger)
+{
+    if (!ready)
+        return;
+    last = (logic_capture_t){
+        .words = buffer,
+        .sys_clk_hz = clock_get_hz(clk_sys),
+        .triggered = trigger,
+    };
+
+    // Pin hanya dibaca lewat in_base: fungsi GPIO (PIO generator) tetap
+    pio_sm_config c = logic_analyzer_program_get_default_config(offset);
+    sm_config_set_in_pins(&c, pin_base);
+    sm_config_set_in_shift(&c, true, true, 32);
+    sm_config_set_fifo_join(&c, PIO_FIFO_JOIN_RX);
+    pio_sm_init(pio, sm, offset + (trigger ? logic_analyzer_offset_trigger : logic_analyzer_offset_sample), &c);
+
+    dma_channel_config cfg = dma_channel_get_default_config(dma_chan);
+    channel_config_set_transfer_data_size(&cfg, DMA_SIZE_32);
+    channel_config_set_read_increment(&cfg, false);
+    channel_config_set_write_increment(&cfg, true);
+    channel_config_set_dreq(&cfg, pio_get_dreq(pio, sm, false));
+    dma_channel_configure(dma_chan, &cfg, buffer, &pio->rxf[sm], LOGIC_BUFFER_WORDS, true);
+
+    captured = false;
+    armed = true;
+    pio_sm_set_enabled(pio, sm, true);
+}
+
+void logic_analyzer_disarm(void)
+{
+    if (!armed)
+        return;
+    // Sampel di ISR dan RX FIFO yang belum dipindahkan DMA dibuang
+    pio_sm_set_enabled(pio, sm, false);
+    uint32_t remaining = dma_channel_hw_addr(dma_chan)->transfer_count;
+    dma_channel_abort(dma_chan);
+    pio_sm_clear_fifos(pio, sm);
+    last.samples = (LOGIC_BUFFER_WORDS - remaining) * LOGIC_SAMPLES_PER_WORD;
+    armed = false;
+    captured = true;
+}
+
+bool logic_analyzer_capture(logic_capture_t *out)
+{
+    if (!captured)
+        return false;
+    *out = last;
+    return true;
+}
@@ -0,0 +1,43 @@
+#ifndef LOGIC_ANALYZER_H
+#define LOGIC_ANALYZER_H
+
+/**
+ * Penganalisis logika internal (uji mandiri)
+ *
+ * Satu SM cadangan di blok PIO penghitung pulsa menjalankan logic_analyzer
+ * (lihat logic_analyzer.pio): "in pins, 4" pada GP6..GP9, dikuras satu
+ * channel DMA berpacu DREQ RX ke buffer RAM LOGIC_BUFFER_WORDS kata. SM
+ * selalu berjalan pada clkdiv 1: satu sampel = satu siklus clk_sys (8 ns
+ * pada 125 MHz, 4 ns pada 250 MHz), jendela 524/262 us sejak tepi naik CH1
+ * pertama, cukup untuk A..C periode pertama pada lebar dan beda fasa
+ * maksimum. Periode tidak diukur dari jendela ini melainkan dari penghitung
+ * pulsa (lib/pulse_counter.h). Hasil dianalisis dan diekspor sebagai VCD
+ * oleh lib/logic_analysis.h.
+ *
+ * Inisialisasi, arm dan disarm hanya dari core pemilik PIO (core 1, di
+ * dalam mesin pulsa); logic_analyzer_capture() dibaca core 0 setelah proses
+ * selesai. Tanpa SM, program atau channel DMA bebas penganalisis tidak
+ * tersedia dan tangkapan selalu kosong.
+ */
+
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "logic_analysis.h"
+
+#define LOGIC_BUFFER_WORDS 8192 // 32 KB = 65536 sampel
+#define LOGIC_BUFFER_SAMPLES (LOGIC_BUFFER_WORDS * LOGIC_SAMPLES_PER_WORD)
+
+// Klaim SM dan channel DMA, muat program; false bila tidak tersedia
+bool logic_analyzer_init(PIO pio, uint pin_base);
+
+// Sebelum SM generator diaktifkan: mulai DMA dan aktifkan SM. 'trigger':
+// sampel pertama sesudah tepi naik CH1 pertama.
+void logic_analyzer_arm(bool trigger);
+
+// Setelah SM generator dimatikan: hentikan SM dan DMA, catat jumlah sampel
+void logic_analyzer_disarm(void);
+
+// Tangkapan terakhir (core 0, saat mesin pulsa diam); false bila belum ada
+bool logic_analyzer_capture(logic_capture_t *out);
+
+#endif
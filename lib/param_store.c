@@ -0,0 +1,243 @@
+#include "param_store.h"
+#include <stddef.h>
+#include <string.h>
+#include "crc32.h"
+
+#define PARAM_SECTOR_MAGIC 0x4d474353u // "MGCS"
+#define PARAM_RECORD_MAGIC 0x4d474352u // "MGCR"
+#define PARAM_ERASED 0xffffffffu
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t generation;
+    uint32_t erase_count;
+    uint32_t crc;
+} param_sector_header_t;
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t seq;
+    uint16_t slot;
+    uint16_t length;
+    uint32_t reserved;
+    uint8_t payload[PARAM_PAYLOAD_MAX];
+    uint32_t crc; // Atas seluruh byte sebelumnya
+} param_record_t;
+
+_Static_assert(sizeof(param_record_t) == PARAM_PAGE_SIZE, "rekaman harus satu halaman");
+_Static_assert(PARAM_SLOTS + 2 < PARAM_PAGES_PER_SECTOR, "slot hidup harus muat di satu sektor");
+
+static uint32_t sector_offset(uint32_t sector)
+{
+    return sector * PARAM_SECTOR_SIZE;
+}
+
+static const param_record_t *record_at(const param_store_t *st, uint32_t offset)
+{
+    return (const param_record_t *)(st->flash->base + offset);
+}
+
+static bool page_erased(const uint8_t *page)
+{
+    const uint32_t *w = (const uint32_t *)page;
+    for (uint32_t i = 0; i < PARAM_PAGE_SIZE / 4; i++)
+        if (w[i] != PARAM_ERASED)
+            return false;
+    return true;
+}
+
+static bool record_valid(const param_record_t *r)
+{
+    return r->magic == PARAM_RECORD_MAGIC && r->slot < PARAM_SLOTS &&
+           r->length <= PARAM_PAYLOAD_MAX &&
+           r->crc == crc32_update(0, r, offsetof(param_record_t, crc));
+}
+
+static void scan_sector(param_store_t *st, uint32_t sector)
+{
+    const uint8_t *base = st->flash->base + sector_offset(sector);
+    const param_sector_header_t *h = (const param_sector_header_t *)base;
+
+    st->formatted[sector] = h->magic == PARAM_SECTOR_MAGIC &&
+                            h->crc == crc32_update(0, h, offsetof(param_sector_header_t, crc));
+    st->next_page[sector] = PARAM_PAGES_PER_SECTOR;
+    if (!st->formatted[sector])
+    {
+        // Tidak terformat, erase terputus, atau data format lama
+        st->sector_gen[sector] = 0;
+        st->erase_count[sector] = 0;
+        return;
+    }
+    st->sector_gen[sector] = h->generation;
+    st->erase_count[sector] = h->erase_count;
+
+    for (uint32_t page = 1; page < PARAM_PAGES_PER_SECTOR; page++)
+    {
+        const uint8_t *p = base + page * PARAM_PAGE_SIZE;
+        // Cepat: kata pertama terhapus hampir selalu berarti sisa sektor kosong
+        if (*(const uint32_t *)p == PARAM_ERASED && page_erased(p))
+        {
+            st->next_page[sector] = (uint8_t)page;
+            return;
+        }
+
+        const param_record_t *r = (const param_record_t *)p;
+        if (!record_valid(r))
+        {
+            // Tulis terputus: halaman dilewati, rekaman sebelumnya tetap berlaku
+            st->bad_records++;
+            continue;
+        }
+        uint32_t offset = sector_offset(sector) + page * PARAM_PAGE_SIZE;
+        if (st->latest[r->slot] < 0 || r->seq > st->latest_seq[r->slot])
+        {
+            st->latest[r->slot] = (int32_t)offset;
+            st->latest_seq[r->slot] = r->seq;
+        }
+        // 2^32 rekaman jauh melampaui umur flash, tidak perlu perbandingan melingkar
+        if (r->seq >= st->next_seq)
+            st->next_seq = r->seq + 1;
+    }
+}
+
+void param_store_mount(param_store_t *st, const param_flash_t *flash)
+{
+    memset(st, 0, sizeof(*st));
+    st->flash = flash;
+    st->active = -1;
+    for (int i = 0; i < PARAM_SLOTS; i++)
+        st->latest[i] = -1;
+
+    for (uint32_t s = 0; s < flash->sectors; s++)
+    {
+        scan_sector(st, s);
+        if (st->formatted[s] && (st->active < 0 || st->sector_gen[s] > st->generation))
+        {
+            st->active = (int)s;
+            st->generation = st->sector_gen[s];
+        }
+    }
+}
+
+bool param_store_has(const param_store_t *st, uint32_t slot)
+{
+    return slot < PARAM_SLOTS && st->latest[slot] >= 0;
+}
+
+int param_store_read(const param_store_t *st, uint32_t slot, void *out, uint32_t max)
+{
+    if (!param_store_has(st, slot))
+        return -1;
+    const param_record_t *r = record_at(st, (uint32_t)st->latest[slot]);
+    memcpy(out, r->payload, r->length < max ? r->length : max);
+    return r->length;
+}
+
+uint32_t param_store_erase_count(const param_store_t *st, uint32_t sector)
+{
+    return sector < st->flash->sectors ? st->erase_count[sector] : 0;
+}
+
+// Tulis satu rekaman di halaman bebas berikutnya dari sektor aktif
+static void append(param_store_t *st, uint32_t slot, const void *data, uint32_t len)
+{
+    param_record_t rec;
+    memset(&rec, 0xff, sizeof(rec));
+    rec.magic = PARAM_RECORD_MAGIC;
+    rec.seq = st->next_seq++;
+    rec.slot = (uint16_t)slot;
+    rec.length = (uint16_t)len;
+    memcpy(rec.payload, data, len);
+    rec.crc = crc32_update(0, &rec, offsetof(param_record_t, crc));
+
+    uint32_t sector = (uint32_t)st->active;
+    uint32_t offset = sector_offset(sector) + st->next_page[sector] * PARAM_PAGE_SIZE;
+    st->flash->program_page(st->flash->ctx, offset, (const uint8_t *)&rec);
+    st->programs++;
+    st->next_page[sector]++;
+
+    // Hanya dipakai bila benar-benar terbaca valid (daya bisa putus di tengah)
+    if (record_valid(record_at(st, offset)))
+    {
+        st->latest[slot] = (int32_t)offset;
+        st->latest_seq[slot] = rec.seq;
+    }
+}
+
+static uint32_t live_in_sector(const param_store_t *st, uint32_t sector)
+{
+    uint32_t n = 0;
+    for (int i = 0; i < PARAM_SLOTS; i++)
+        n += st->latest[i] >= 0 && (uint32_t)st->latest[i] / PARAM_SECTOR_SIZE == sector;
+    return n;
+}
+
+static void format_sector(param_store_t *st, uint32_t sector)
+{
+    uint32_t erase_count = st->erase_count[sector] + 1;
+    st->flash->erase_sector(st->flash->ctx, sector_offset(sector));
+    st->erases++;
+
+    uint8_t page[PARAM_PAGE_SIZE];
+    memset(page, 0xff, sizeof(page));
+    param_sector_header_t *h = (param_sector_header_t *)page;
+    h->magic = PARAM_SECTOR_MAGIC;
+    h->generation = st->generation + 1;
+    h->erase_count = erase_count;
+    h->crc = crc32_update(0, h, offsetof(param_sector_header_t, crc));
+    st->flash->program_page(st->flash->ctx, sector_offset(sector), page);
+    st->programs++;
+
+    st->formatted[sector] = true;
+    st->sector_gen[sector] = h->generation;
+    st->erase_count[sector] = erase_count;
+    st->next_page[sector] = 1;
+    st->generation = h->generation;
+    st->active = (int)sector;
+}
+
+bool param_store_write(param_store_t *st, uint32_t slot, const void *data, uint32_t len)
+{
+    if (slot >= PARAM_SLOTS || len > PARAM_PAYLOAD_MAX)
+        return false;
+
+    if (st->active < 0)
+        format_sector(st, 0);
+
+    // Sektor berikutnya (tertua) akan dihapus saat sektor aktif penuh.
+    // Sisakan halaman untuk menyalin rekaman hidupnya lebih dulu, ditambah
+    // satu halaman cadangan untuk salinan yang terputus daya.
+    uint32_t victim = ((uint32_t)st->active + 1) % st->flash->sectors;
+    uint32_t free_pages = PARAM_PAGES_PER_SECTOR - st->next_page[st->active];
+    uint32_t live = live_in_sector(st, victim);
+
+    if (free_pages > live + 1)
+    {
+        append(st, slot, data, len);
+        return true;
+    }
+    // Beberapa putus daya beruntun saat menyalin menghabiskan cadangan:
+    // lebih baik menolak simpan daripada menghapus satu-satunya salinan
+    if (free_pages < live)
+        return false;
+
+    // Salin rekaman hidup sektor tertua ke sektor aktif, baru hapus. Slot
+    // yang akan ditulis ikut disalin agar putus daya setelah erase tidak
+    // menghilangkan nilai lamanya.
+    for (uint32_t i = 0; i < PARAM_SLOTS; i++)
+    {
+        if (st->latest[i] < 0 || (uint32_t)st->latest[i] / PARAM_SECTOR_SIZE != victim)
+            continue;
+        param_record_t copy;
+        memcpy(&copy, record_at(st, (uint32_t)st->latest[i]), sizeof(copy));
+        append(st, i, copy.payload, copy.length);
+    }
+    if (live_in_sector(st, victim) != 0)
+        return false; // Salinan gagal diverifikasi: jangan hapus satu-satunya salinan
+
+    format_sector(st, victim);
+    append(st, slot, data, len);
+    return true;
+}
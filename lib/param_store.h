@@ -0,0 +1,75 @@
+#ifndef PARAM_STORE_H
+#define PARAM_STORE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Penyimpanan parameter berbasis log di flash
+ *
+ * Wilayah beberapa sektor 4 KB dipakai bergiliran. Halaman pertama setiap
+ * sektor adalah header (generasi + jumlah erase), halaman sisanya rekaman
+ * 256 byte (nomor urut + slot + CRC32) yang hanya ditambahkan. Sektor
+ * dihapus hanya bila sektor aktif penuh; rekaman hidup di sektor tertua
+ * disalin lebih dulu sehingga putus daya di titik mana pun tidak
+ * menghilangkan nilai terakhir yang sudah selesai ditulis.
+ *
+ * Slot 0 adalah parameter aktif, slot 1..PARAM_SLOTS-1 preset. Akses flash
+ * lewat param_flash_t sehingga modul ini tidak bergantung pada Pico SDK dan
+ * dapat diuji dengan emulator flash di host (mgc_sim flash).
+ */
+
+#define PARAM_SECTOR_SIZE 4096u
+#define PARAM_PAGE_SIZE 256u
+#define PARAM_PAGES_PER_SECTOR (PARAM_SECTOR_SIZE / PARAM_PAGE_SIZE)
+#define PARAM_MAX_SECTORS 8
+
+#define PARAM_SLOTS 9 // Slot 0 + 8 preset; harus < PARAM_PAGES_PER_SECTOR - 2
+#define PARAM_PAYLOAD_MAX (PARAM_PAGE_SIZE - 20u)
+
+typedef struct
+{
+    const uint8_t *base; // Tampilan terpeta memori (XIP atau larik host)
+    uint32_t sectors;    // 2..PARAM_MAX_SECTORS
+    // Offset relatif terhadap awal wilayah; selaras sektor / halaman
+    void (*erase_sector)(void *ctx, uint32_t offset);
+    void (*program_page)(void *ctx, uint32_t offset, const uint8_t *page);
+    void *ctx;
+} param_flash_t;
+
+typedef struct
+{
+    const param_flash_t *flash;
+    int active;           // Sektor tujuan tulis (-1: belum ada sektor terformat)
+    uint32_t generation;  // Generasi sektor aktif
+    uint32_t next_seq;    // Nomor urut rekaman berikutnya
+    uint8_t next_page[PARAM_MAX_SECTORS];
+    bool formatted[PARAM_MAX_SECTORS];
+    uint32_t sector_gen[PARAM_MAX_SECTORS];
+    uint32_t erase_count[PARAM_MAX_SECTORS];
+    int32_t latest[PARAM_SLOTS]; // Offset rekaman terbaru per slot (-1: kosong)
+    uint32_t latest_seq[PARAM_SLOTS];
+
+    // Statistik sejak mount
+    uint32_t erases;
+    uint32_t programs;
+    uint32_t bad_records; // Rekaman rusak (CRC salah, tulis terputus) saat scan
+} param_store_t;
+
+// Pindai wilayah dan temukan rekaman valid terbaru per slot. Tidak menulis.
+void param_store_mount(param_store_t *st, const param_flash_t *flash);
+
+// Salin payload slot ke 'out' (maks. 'max' byte). Mengembalikan panjang
+// payload, atau -1 bila slot belum pernah ditulis.
+int param_store_read(const param_store_t *st, uint32_t slot, void *out, uint32_t max);
+
+bool param_store_has(const param_store_t *st, uint32_t slot);
+
+// Tambahkan rekaman baru untuk slot. Mengembalikan false bila argumen tidak
+// valid. Paling banyak satu erase sektor per panggilan.
+bool param_store_write(param_store_t *st, uint32_t slot, const void *data, uint32_t len);
+
+// Jumlah erase yang tercatat di header sektor
+uint32_t param_store_erase_count(const param_store_t *st, uint32_t sector);
+
+#endif
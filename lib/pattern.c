@@ -0,0 +1,212 @@
+#include "pattern.h"
+
+void pattern_init(pattern_t *p, uint32_t freq_hz)
+{
+    p->count = 0;
+    p->freq_hz = freq_hz;
+}
+
+bool pattern_add(pattern_t *p, uint8_t mask, uint32_t duration_ns)
+{
+    if (mask > PATTERN_MASK_MAX || p->count >= PATTERN_MAX_EVENTS)
+        return false;
+    p->steps[p->count].mask = mask;
+    p->steps[p->count].duration_ns = duration_ns;
+    p->count++;
+    return true;
+}
+
+// Mask 'first' HIGH, dead time, mask 'second' HIGH, sisa periode (diisi compile)
+static timing_status_t bipolar(pattern_t *p, const timing_request_t *req, uint8_t first, uint8_t second)
+{
+    if (req->freq_hz == 0)
+        return TIMING_ERR_FREQ;
+    if (req->phase_ns < req->pulse_width_ns)
+        return TIMING_ERR_PHASE_LT_PULSE;
+
+    pattern_init(p, req->freq_hz);
+    pattern_add(p, first, req->pulse_width_ns);
+    pattern_add(p, 0x0, req->phase_ns - req->pulse_width_ns);
+    pattern_add(p, second, req->pulse_width_ns);
+    pattern_add(p, 0x0, 0);
+    return TIMING_OK;
+}
+
+timing_status_t pattern_bipolar(pattern_t *p, const timing_request_t *req)
+{
+    return bipolar(p, req, 0x9, 0x6); // CH1/CH4 lalu CH2/CH3
+}
+
+timing_status_t pattern_bipolar_pair(pattern_t *p, const timing_request_t *req)
+{
+    return bipolar(p, req, 0x1, 0x2);
+}
+
+// Penyusun tabel satu lintasan: event ditulis begitu mask berganti sehingga
+// tidak ada larik sementara sebesar pola di stack (stack core 1 hanya 2 KB)
+typedef struct
+{
+    pattern_table_t *table;
+    uint32_t event_overhead;
+    uint64_t total;
+    uint64_t longest;
+    bool too_short, out_of_range;
+} builder_t;
+
+static void emit(builder_t *b, uint32_t index, uint8_t mask, uint64_t cycles)
+{
+    b->total += cycles;
+    if (cycles > b->longest)
+        b->longest = cycles;
+    if (cycles < b->event_overhead)
+        b->too_short = true;
+    else if (cycles - b->event_overhead > PATTERN_COUNT_MAX)
+        b->out_of_range = true;
+    else
+        b->table->words[index] = PATTERN_WORD(mask, cycles - b->event_overhead);
+}
+
+static timing_status_t build(const pattern_t *p, uint32_t sys_clk_hz, uint32_t clkdiv_fixed,
+                             builder_t *b)
+{
+    if (p->count == 0 || p->count > PATTERN_MAX_EVENTS || (p->freq_hz != 0 && p->count < 2))
+        return TIMING_ERR_PATTERN;
+
+    // Langkah terakhir pola berperiode diisi sisa periode
+    uint32_t fixed_steps = p->freq_hz != 0 ? p->count - 1 : p->count;
+    uint64_t used = 0;
+    uint8_t first_mask = 0, cur_mask = 0;
+    uint64_t first_cycles = 0, cur_cycles = 0;
+    uint32_t n = 0;
+
+    for (uint32_t i = 0; i < p->count; i++)
+    {
+        const pattern_step_t *s = &p->steps[i];
+        if (s->mask > PATTERN_MASK_MAX)
+            return TIMING_ERR_PATTERN;
+
+        uint64_t c;
+        if (i < fixed_steps)
+        {
+            c = timing_ns_to_cycles(s->duration_ns, sys_clk_hz, clkdiv_fixed);
+            used += c;
+        }
+        else
+        {
+            // Periode dari frekuensi, sama seperti timing_compile()
+            uint64_t den = (uint64_t)p->freq_hz * clkdiv_fixed;
+            uint64_t period = ((uint64_t)sys_clk_hz * TIMING_CLKDIV_ONE + den / 2) / den;
+            if (period < used + b->event_overhead)
+                return TIMING_ERR_PERIOD_TOO_SHORT;
+            c = period - used;
+        }
+
+        // Mask yang sama dengan event sebelumnya tidak menghasilkan tepi:
+        // gabungkan agar tabel sekecil mungkin
+        if (n > 0 && s->mask == cur_mask)
+        {
+            cur_cycles += c;
+            continue;
+        }
+        if (n == 1)
+        {
+            first_mask = cur_mask; // Ditulis terakhir, mungkin digabung di bawah
+            first_cycles = cur_cycles;
+        }
+        else if (n > 1)
+        {
+            emit(b, n - 1, cur_mask, cur_cycles);
+        }
+        cur_mask = s->mask;
+        cur_cycles = c;
+        n++;
+    }
+
+    // Putaran tabel menyambung event terakhir ke event pertama; mask yang
+    // sama di kedua ujung juga tidak menghasilkan tepi
+    if (n == 1)
+    {
+        first_mask = cur_mask;
+        first_cycles = cur_cycles;
+    }
+    else if (cur_mask == first_mask)
+    {
+        first_cycles += cur_cycles;
+        n--;
+    }
+    else
+    {
+        emit(b, n - 1, cur_mask, cur_cycles);
+    }
+    emit(b, 0, first_mask, first_cycles);
+
+    b->table->length = n;
+    if (b->too_short)
+        return TIMING_ERR_EVENT_TOO_SHORT;
+    if (b->out_of_range || b->total > UINT32_MAX)
+        return TIMING_ERR_RANGE;
+    b->table->period_cycles = (uint32_t)b->total;
+    return TIMING_OK;
+}
+
+timing_status_t pattern_compile(const pattern_t *p, uint32_t sys_clk_hz, uint32_t clkdiv_fixed,
+                                uint32_t event_overhead, pattern_table_t *table)
+{
+    builder_t b = {table, event_overhead, 0, 0, false, false};
+    return build(p, sys_clk_hz, clkdiv_fixed, &b);
+}
+
+timing_status_t pattern_compile_auto(const pattern_t *p, uint32_t sys_clk_hz,
+                                     uint32_t event_overhead, uint32_t *clkdiv_fixed,
+                                     pattern_table_t *table)
+{
+    // Event terpanjang pada clkdiv 1 menentukan divider integer minimum
+    builder_t probe = {table, event_overhead, 0, 0, false, false};
+    timing_status_t status = build(p, sys_clk_hz, TIMING_CLKDIV_ONE, &probe);
+    if (status != TIMING_OK && status != TIMING_ERR_RANGE)
+        return status;
+
+    uint64_t div = probe.longest / ((uint64_t)PATTERN_COUNT_MAX + event_overhead) + 1;
+
+    // Pembulatan per langkah dapat menggeser event gabungan beberapa siklus,
+    // jadi divider dinaikkan bila hasilnya masih tepat di batas rentang
+    for (int attempt = 0; attempt < 4 && div <= (TIMING_CLKDIV_MAX >> 8); attempt++, div++)
+    {
+        *clkdiv_fixed = (uint32_t)(div << 8);
+        status = pattern_compile(p, sys_clk_hz, *clkdiv_fixed, event_overhead, table);
+        if (status != TIMING_ERR_RANGE)
+            return status;
+    }
+    return TIMING_ERR_RANGE;
+}
+
+bool pattern_table_pad_pow2(pattern_table_t *table, uint32_t event_overhead, uint32_t max_words)
+{
+    if (max_words > PATTERN_MAX_EVENTS)
+        max_words = PATTERN_MAX_EVENTS;
+
+    while (table->length & (table->length - 1))
+    {
+        if (table->length >= max_words)
+            return false;
+
+        // Event terpanjang paling mungkin masih >= 2x overhead
+        uint32_t longest = 0;
+        for (uint32_t i = 1; i < table->length; i++)
+            if (pattern_word_count(table->words[i]) > pattern_word_count(table->words[longest]))
+                longest = i;
+
+        uint32_t word = table->words[longest];
+        uint32_t cycles = pattern_word_count(word) + event_overhead;
+        uint32_t first = cycles / 2;
+        if (first < event_overhead)
+            return false;
+
+        for (uint32_t i = table->length; i > longest + 1; i--)
+            table->words[i] = table->words[i - 1];
+        table->words[longest] = PATTERN_WORD(pattern_word_mask(word), first - event_overhead);
+        table->words[longest + 1] = PATTERN_WORD(pattern_word_mask(word), cycles - first - event_overhead);
+        table->length++;
+    }
+    return true;
+}
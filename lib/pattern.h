@@ -0,0 +1,78 @@
+#ifndef PATTERN_H
+#define PATTERN_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "signal_timing.h"
+
+// Pembangun pola N-event untuk program PIO pattern_engine. Sebuah pola adalah
+// deretan langkah (mask pin GP6..GP9, durasi); kompiler mengubahnya menjadi
+// tabel RAM satu kata per event yang dialirkan DMA ke TX FIFO tanpa CPU.
+// Seperti signal_timing.h, hanya aritmetika integer dan tanpa Pico SDK.
+
+#define PATTERN_MAX_EVENTS 256
+#define PATTERN_MASK_BITS 4 // Sama dengan pattern_engine_MASK_BITS
+#define PATTERN_MASK_MAX ((1u << PATTERN_MASK_BITS) - 1u)
+#define PATTERN_COUNT_MAX ((1u << (32 - PATTERN_MASK_BITS)) - 1u) // N maksimum (28 bit)
+
+// Satu kata tabel: mask di bit bawah (out pins dahulu), N di bit atas (out x)
+#define PATTERN_WORD(mask, n) ((uint32_t)(mask) | ((uint32_t)(n) << PATTERN_MASK_BITS))
+
+typedef struct
+{
+    uint8_t mask;         // Bit 0 = CH1 (GP6) ... bit 3 = CH4 (GP9)
+    uint32_t duration_ns;
+} pattern_step_t;
+
+typedef struct
+{
+    pattern_step_t steps[PATTERN_MAX_EVENTS];
+    uint32_t count;
+    // Bila tidak nol, periode dikunci ke frekuensi ini: durasi langkah
+    // terakhir diabaikan dan diisi sisa periode (seperti event D)
+    uint32_t freq_hz;
+} pattern_t;
+
+typedef struct
+{
+    uint32_t words[PATTERN_MAX_EVENTS];
+    uint32_t length;        // Jumlah kata (event setelah penggabungan)
+    uint32_t period_cycles; // Satu putaran tabel dalam siklus PIO
+} pattern_table_t;
+
+void pattern_init(pattern_t *p, uint32_t freq_hz);
+
+// false bila mask di luar GP6..GP9 atau pola sudah penuh
+bool pattern_add(pattern_t *p, uint8_t mask, uint32_t duration_ns);
+
+// Preset: gelombang bipolar empat event (1001, 0000, 0110, 0000) dari
+// parameter UI, setara dengan timing_compile()
+timing_status_t pattern_bipolar(pattern_t *p, const timing_request_t *req);
+
+// Preset yang sama untuk satu pasangan elektroda dua pin (10, 00, 01, 00):
+// pola kanal grup dengan pin_count 2 (lib/channel_group.h)
+timing_status_t pattern_bipolar_pair(pattern_t *p, const timing_request_t *req);
+
+// Susun tabel untuk divider 16.8 tertentu. Setiap durasi dibulatkan sendiri
+// ke siklus terdekat (langkah dengan ns sama selalu sama panjang), langkah
+// berurutan dengan mask sama digabung, dan setiap event harus >= overhead
+// instruksi (N = 0). Pola tidak valid -> TIMING_ERR_PATTERN.
+timing_status_t pattern_compile(const pattern_t *p, uint32_t sys_clk_hz, uint32_t clkdiv_fixed,
+                                uint32_t event_overhead, pattern_table_t *table);
+
+// Pilih divider integer terkecil yang memuat event terpanjang dalam N 28 bit
+timing_status_t pattern_compile_auto(const pattern_t *p, uint32_t sys_clk_hz,
+                                     uint32_t event_overhead, uint32_t *clkdiv_fixed,
+                                     pattern_table_t *table);
+
+// Pecah event terpanjang menjadi dua event bermask sama (tanpa tepi baru)
+// sampai panjang tabel pangkat dua, agar tabel dapat diputar oleh satu
+// channel DMA mode ring. false bila melebihi max_words atau event terlalu
+// pendek untuk dipecah; gelombang keluaran identik.
+bool pattern_table_pad_pow2(pattern_table_t *table, uint32_t event_overhead, uint32_t max_words);
+
+// Uraikan satu kata tabel: mask pin dan N (durasi = N + overhead siklus PIO)
+static inline uint8_t pattern_word_mask(uint32_t word) { return word & PATTERN_MASK_MAX; }
+static inline uint32_t pattern_word_count(uint32_t word) { return word >> PATTERN_MASK_BITS; }
+
+#endif
@@ -0,0 +1,121 @@
+#include "perf_counters.h"
+#include <string.h>
+#include "hardware/clocks.h"
+
+#define SYSTICK_MASK 0x00ffffffu
+
+// Hanya loop core 0 yang menulis dan membaca (tidak dari interupsi), jadi
+// tidak ada kunci
+static perf_hist_t hists[PERF_HIST_COUNT];
+static uint32_t clk_mhz = 125;
+static uint32_t clk_hz = 125000000u;
+static uint32_t systick_wrap_us; // Selisih timer di atas ini: SysTick mungkin sudah berputar
+static uint32_t max_us;          // Di atas ini siklus jenuh di UINT32_MAX
+static uint32_t fifo_samples, fifo_underruns;
+
+void perf_reset(void)
+{
+    memset(hists, 0, sizeof(hists));
+    fifo_samples = fifo_underruns = 0;
+}
+
+void perf_set_clock(uint32_t sys_clk_hz)
+{
+    clk_hz = sys_clk_hz;
+    clk_mhz = sys_clk_hz / 1000000u;
+    if (clk_mhz == 0)
+        clk_mhz = 1;
+    // Timer 1 MHz hanya akurat +-1 us: sisakan satu us sebelum batas putaran
+    systick_wrap_us = (SYSTICK_MASK + 1u) / clk_mhz - 1u;
+    max_us = UINT32_MAX / clk_mhz;
+    perf_reset();
+}
+
+void perf_init(void)
+{
+    systick_hw->csr = 0;
+    systick_hw->rvr = SYSTICK_MASK;
+    systick_hw->cvr = 0;
+    systick_hw->csr = M0PLUS_SYST_CSR_CLKSOURCE_BITS | M0PLUS_SYST_CSR_ENABLE_BITS;
+    perf_set_clock(clock_get_hz(clk_sys));
+}
+
+void __not_in_flash_func(perf_end)(perf_hist_id_t id, perf_stamp_t start)
+{
+    perf_stamp_t now = perf_begin();
+    uint32_t du = now.us - start.us;
+    uint32_t cycles;
+    if (du < systick_wrap_us)
+        cycles = (start.tick - now.tick) & SYSTICK_MASK;
+    else
+        cycles = du >= max_us ? UINT32_MAX : du * clk_mhz;
+
+    // Tanpa pembagian dan CLZ: keduanya rutin libgcc di flash pada Cortex-M0+
+    uint32_t b = 0;
+    for (uint32_t v = cycles >> 1; v; v >>= 1)
+        b++;
+
+    perf_hist_t *h = &hists[id];
+    h->count++;
+    h->total_cycles += cycles;
+    if (cycles > h->max_cycles)
+        h->max_cycles = cycles;
+    h->bucket[b]++;
+}
+
+void perf_snapshot(perf_hist_id_t id, perf_hist_t *out)
+{
+    *out = hists[id];
+}
+
+void perf_note_fifo(uint32_t samples, uint32_t underruns)
+{
+    fifo_samples += samples;
+    fifo_underruns += underruns;
+}
+
+void perf_fifo(uint32_t *samples, uint32_t *underruns)
+{
+    *samples = fifo_samples;
+    *underruns = fifo_underruns;
+}
+
+uint32_t perf_sys_clk_hz(void)
+{
+    return clk_hz;
+}
+
+uint32_t perf_cycles_to_us(uint32_t cycles)
+{
+    return cycles / clk_mhz + (cycles % clk_mhz != 0);
+}
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+size_t perf_page(perf_hist_id_t id, uint8_t page, uint8_t *out)
+{
+    if ((unsigned)id >= PERF_HIST_COUNT || page > PERF_BUCKET_PAGES)
+        return 0;
+    const perf_hist_t *h = &hists[id];
+    if (page == 0)
+    {
+        put_u32(out, clk_hz);
+        put_u32(out + 4, h->count);
+        put_u32(out + 8, h->max_cycles);
+        put_u32(out + 12, (uint32_t)h->total_cycles);
+        put_u32(out + 16, (uint32_t)(h->total_cycles >> 32));
+        put_u32(out + 20, fifo_samples);
+        put_u32(out + 24, fifo_underruns);
+        return 28;
+    }
+    const uint32_t *b = &h->bucket[(page - 1) * PERF_BUCKETS_PER_PAGE];
+    for (int i = 0; i < PERF_BUCKETS_PER_PAGE; i++)
+        put_u32(out + 4 * i, b[i]);
+    return PERF_PAGE_MAX;
+}
@@ -0,0 +1,93 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+/**
+ * Penghitung kinerja core 0
+ *
+ * Histogram log2 (dalam siklus clk_sys) untuk durasi yang dapat menahan loop
+ * UI: satu putaran loop utama, flush LCD, jendela interupsi mati, dan commit
+ * flash. Waktu diambil dari SysTick core 0 (24 bit, satu siklus clk_sys)
+ * untuk durasi di bawah satu putaran SysTick dan dari timer 1 MHz untuk yang
+ * lebih panjang, sehingga perekaman hanya dua baca register, satu loop log2
+ * dan beberapa penjumlahan; cukup murah untuk dibiarkan aktif di build
+ * produksi. Semua fungsi perekam berada di RAM agar aman dipanggil di
+ * sekitar operasi flash.
+ *
+ * Underrun FIFO TX PIO diukur core 1 (lib/pulse_engine.c) dan dilaporkan
+ * lewat pulse_engine_status_t, bukan di sini.
+ */
+
+#include "pico/stdlib.h"
+#include "hardware/timer.h"
+#include "hardware/structs/systick.h"
+
+typedef enum
+{
+    PERF_LOOP = 0, // Satu putaran app_loop() tanpa waktu tidur WFE
+    PERF_LCD,      // lcd_fb_flush(): encode + antre batch I2C
+    PERF_IRQ_OFF,  // Interupsi core 0 mati (flash erase/program, lcd_kick dari loop UI)
+    PERF_FLASH,    // Commit parameter/preset: parkir core 1 sampai unpark
+    PERF_HIST_COUNT,
+} perf_hist_id_t;
+
+// Bucket b berisi durasi [2^b, 2^(b+1)) siklus; bucket 0 juga durasi 0
+#define PERF_BUCKETS 32
+
+typedef struct
+{
+    uint32_t count;
+    uint32_t max_cycles;
+    uint64_t total_cycles;
+    uint32_t bucket[PERF_BUCKETS];
+} perf_hist_t;
+
+typedef struct
+{
+    uint32_t us;   // timer_hw->timerawl
+    uint32_t tick; // SysTick CVR (menghitung turun)
+} perf_stamp_t;
+
+// Nyalakan SysTick core 0 (sumber clk_sys, reload 2^24 - 1) dan kosongkan
+// histogram. Dipanggil dari core 0.
+void perf_init(void);
+
+// clk_sys berganti: histogram dikosongkan agar satuan siklusnya tetap satu
+void perf_set_clock(uint32_t sys_clk_hz);
+
+void perf_reset(void);
+
+static inline perf_stamp_t perf_begin(void)
+{
+    perf_stamp_t s;
+    s.us = timer_hw->timerawl;
+    s.tick = systick_hw->cvr;
+    return s;
+}
+
+// Catat durasi sejak 'start' ke histogram 'id'. Boleh dipanggil dengan
+// interupsi mati; pemanggil dari interupsi tidak didukung.
+void perf_end(perf_hist_id_t id, perf_stamp_t start);
+
+// Salinan konsisten satu histogram
+void perf_snapshot(perf_hist_id_t id, perf_hist_t *out);
+
+// Underrun FIFO TX yang dilaporkan core 1 di akhir setiap proses
+void perf_note_fifo(uint32_t samples, uint32_t underruns);
+void perf_fifo(uint32_t *samples, uint32_t *underruns);
+
+uint32_t perf_sys_clk_hz(void);
+
+// Siklus -> us dibulatkan ke atas pada clk_sys saat ini
+uint32_t perf_cycles_to_us(uint32_t cycles);
+
+// Dump biner untuk REMOTE_CMD_PERF (semua u32 LE). Halaman 0: clk_sys Hz,
+// jumlah, maks. siklus, total siklus (lo, hi), sampel FIFO, underrun FIFO.
+// Halaman 1..PERF_BUCKET_PAGES: masing-masing PERF_BUCKETS_PER_PAGE bucket.
+// Mengembalikan jumlah byte di 'out' (maks. PERF_PAGE_MAX), 0 bila id atau
+// halaman tidak dikenal.
+#define PERF_BUCKETS_PER_PAGE 8
+#define PERF_BUCKET_PAGES (PERF_BUCKETS / PERF_BUCKETS_PER_PAGE)
+#define PERF_PAGE_MAX (PERF_BUCKETS_PER_PAGE * 4)
+size_t perf_page(perf_hist_id_t id, uint8_t page, uint8_t *out);
+
+#endif
@@ -0,0 +1,59 @@
+#include "pio_programs.h"
+#include <string.h>
+
+// Dua blok PIO x beberapa program; cukup kecil untuk dicari linear
+#define PIO_PROGRAMS_MAX 8
+
+static struct
+{
+    PIO pio;
+    const pio_program_t *program;
+    uint offset;
+    uint refs;
+} loaded[PIO_PROGRAMS_MAX];
+
+// Header pioasm mendefinisikan program sebagai static const: setiap unit
+// kompilasi punya salinan sendiri, jadi program dibandingkan isinya
+static bool same_program(const pio_program_t *a, const pio_program_t *b)
+{
+    return a == b || (a->length == b->length && a->origin == b->origin &&
+                      memcmp(a->instructions, b->instructions, a->length * sizeof(uint16_t)) == 0);
+}
+
+bool pio_programs_acquire(PIO pio, const pio_program_t *program, uint *offset)
+{
+    int free_slot = -1;
+    for (int i = 0; i < PIO_PROGRAMS_MAX; i++)
+    {
+        if (loaded[i].refs && loaded[i].pio == pio && same_program(loaded[i].program, program))
+        {
+            loaded[i].refs++;
+            *offset = loaded[i].offset;
+            return true;
+        }
+        if (!loaded[i].refs && free_slot < 0)
+            free_slot = i;
+    }
+
+    if (free_slot < 0 || !pio_can_add_program(pio, program))
+        return false;
+    loaded[free_slot].pio = pio;
+    loaded[free_slot].program = program;
+    loaded[free_slot].offset = pio_add_program(pio, program);
+    loaded[free_slot].refs = 1;
+    *offset = loaded[free_slot].offset;
+    return true;
+}
+
+void pio_programs_release(PIO pio, const pio_program_t *program)
+{
+    for (int i = 0; i < PIO_PROGRAMS_MAX; i++)
+    {
+        if (loaded[i].refs && loaded[i].pio == pio && same_program(loaded[i].program, program))
+        {
+            if (--loaded[i].refs == 0)
+                pio_remove_program(pio, program, loaded[i].offset);
+            return;
+        }
+    }
+}
@@ -0,0 +1,23 @@
+#ifndef PIO_PROGRAMS_H
+#define PIO_PROGRAMS_H
+
+/**
+ * Program PIO bersama
+ *
+ * Program yang dipakai beberapa pemilik (mesin pulsa, grup kanal) dimuat
+ * sekali per blok PIO dan dihitung pemakainya, sehingga memori instruksi
+ * (32 slot per blok) tidak terisi salinan yang sama. Tidak thread-safe:
+ * hanya dipanggil dari core pemilik PIO (core 1).
+ */
+
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+
+// Offset program di blok 'pio'; dimuat bila belum ada. false bila memori
+// instruksi tidak cukup.
+bool pio_programs_acquire(PIO pio, const pio_program_t *program, uint *offset);
+
+// Lepas satu pemakai; program dihapus saat pemakai terakhir dilepas
+void pio_programs_release(PIO pio, const pio_program_t *program);
+
+#endif
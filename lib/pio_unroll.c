@@ -0,0 +1,131 @@
+#include "pio_unroll.h"
+
+// Kode mesin PIO (RP2040 datasheet 3.4); delay di bit 12..8 tanpa side-set
+#define INSTR_JMP_X_DEC 0x0040u
+#define INSTR_JMP_Y_DEC 0x0080u
+#define INSTR_WAIT_1_PIN 0x20a0u
+#define INSTR_PULL_BLOCK 0x80a0u
+#define INSTR_MOV_Y_OSR 0xa047u
+#define INSTR_NOP 0xa042u // mov y, y
+#define INSTR_IRQ_WAIT_REL 0xc030u
+#define INSTR_SET_PINS 0xe000u
+#define INSTR_SET_X 0xe020u
+#define DELAY(d) ((uint16_t)((d) << 8))
+
+// Mask set pins event A..D, sama dengan signal_generator_counted
+static const uint8_t event_mask[4] = {0x19, 0x00, 0x06, 0x00};
+
+typedef struct
+{
+    uint32_t fixed; // "set pins" (+ "jmp y--" untuk event D)
+    uint32_t loops;
+    uint32_t nops;
+} event_shape_t;
+
+static uint32_t shape_length(const event_shape_t *s)
+{
+    return s->fixed + 2 * s->loops + s->nops;
+}
+
+// Bentuk dengan instruksi paling sedikit untuk 'cycles' siklus. Setiap
+// instruksi tetap dan nop memuat 1..32 siklus, setiap loop 2..UNROLL_LOOP_MAX.
+static uint32_t shape_event(uint32_t cycles, uint32_t fixed, event_shape_t *shape)
+{
+    uint32_t best = UINT32_MAX;
+    for (uint32_t loops = 0; loops <= UNROLL_MAX_INSTRUCTIONS / 2; loops++)
+    {
+        if (cycles < fixed + 2 * loops)
+            break;
+        uint64_t cap = (uint64_t)fixed * UNROLL_INSTR_CYCLES_MAX + (uint64_t)loops * UNROLL_LOOP_MAX;
+        uint64_t rest = cycles > cap ? cycles - cap : 0;
+        uint64_t nops = (rest + UNROLL_INSTR_CYCLES_MAX - 1) / UNROLL_INSTR_CYCLES_MAX;
+        uint64_t n = fixed + 2 * loops + nops;
+        if (n < best)
+        {
+            best = (uint32_t)n;
+            *shape = (event_shape_t){fixed, loops, (uint32_t)nops};
+        }
+        if (rest == 0)
+            break;
+    }
+    return best;
+}
+
+static uint32_t take(uint32_t *extra, uint32_t max)
+{
+    uint32_t n = *extra < max ? *extra : max;
+    *extra -= n;
+    return n;
+}
+
+static void emit(unroll_program_t *p, uint16_t instr)
+{
+    p->instructions[p->length++] = instr;
+}
+
+// Loop tepat 'cycles' siklus (2..UNROLL_LOOP_MAX):
+// (1 + d1) + (n + 1) x (1 + d2)
+static void emit_loop(unroll_program_t *p, uint32_t cycles)
+{
+    uint32_t self = p->length + 1;
+    if (cycles <= UNROLL_INSTR_CYCLES_MAX + 1)
+    {
+        emit(p, INSTR_SET_X | DELAY(cycles - 2));
+        emit(p, INSTR_JMP_X_DEC | self);
+        return;
+    }
+    uint32_t q = (cycles - UNROLL_INSTR_CYCLES_MAX + UNROLL_INSTR_CYCLES_MAX - 1) / UNROLL_INSTR_CYCLES_MAX;
+    emit(p, INSTR_SET_X | 31u | DELAY(cycles - UNROLL_INSTR_CYCLES_MAX * q - 1));
+    emit(p, INSTR_JMP_X_DEC | self | DELAY(q - 1));
+}
+
+// Siklus minimum tiap bagian, sisanya dibagikan berurutan sampai maksimum
+static void emit_event(unroll_program_t *p, uint32_t cycles, uint8_t mask, const event_shape_t *s, bool last)
+{
+    uint32_t extra = cycles - shape_length(s);
+    emit(p, INSTR_SET_PINS | mask | DELAY(take(&extra, UNROLL_DELAY_MAX)));
+    for (uint32_t i = 0; i < s->loops; i++)
+        emit_loop(p, 2 + take(&extra, UNROLL_LOOP_MAX - 2));
+    for (uint32_t i = 0; i < s->nops; i++)
+        emit(p, INSTR_NOP | DELAY(take(&extra, UNROLL_DELAY_MAX)));
+    if (last)
+        emit(p, INSTR_JMP_Y_DEC | UNROLL_PROLOG | DELAY(take(&extra, UNROLL_DELAY_MAX)));
+}
+
+timing_status_t unroll_compile(const timing_request_t *req, uint32_t sys_clk_hz, uint32_t max_instructions,
+                               timing_plan_t *plan, unroll_program_t *prog)
+{
+    timing_status_t status = timing_compile(req, sys_clk_hz, TIMING_CLKDIV_ONE, UNROLL_EVENT_OVERHEAD, plan);
+    if (status != TIMING_OK)
+        return status;
+    if (plan->event_cycles[3] < UNROLL_D_MIN)
+        return TIMING_ERR_PERIOD_TOO_SHORT;
+
+    event_shape_t shape[4];
+    uint32_t total = UNROLL_PROLOG + 1;
+    for (int i = 0; i < 4; i++)
+    {
+        uint32_t n = shape_event(plan->event_cycles[i], i == 3 ? 2 : 1, &shape[i]);
+        if (n > UNROLL_MAX_INSTRUCTIONS)
+            return TIMING_ERR_RANGE;
+        total += n;
+    }
+    if (total > max_instructions || total > UNROLL_MAX_INSTRUCTIONS)
+        return TIMING_ERR_RANGE;
+
+    prog->length = 0;
+    emit(prog, INSTR_WAIT_1_PIN);
+    emit(prog, INSTR_PULL_BLOCK);
+    emit(prog, INSTR_MOV_Y_OSR);
+    for (int i = 0; i < 4; i++)
+    {
+        uint32_t first = prog->length;
+        emit_event(prog, plan->event_cycles[i], event_mask[i], &shape[i], i == 3);
+        prog->event_instructions[i] = (uint8_t)(prog->length - first);
+    }
+    // Setelah periode terakhir "jmp y--" jatuh ke sini; wrap ke dirinya sendiri
+    // agar SM tetap parkir bila flag dilepas sebelum SM dimatikan
+    emit(prog, INSTR_IRQ_WAIT_REL);
+    prog->wrap_target = prog->wrap = prog->length - 1;
+    return TIMING_OK;
+}
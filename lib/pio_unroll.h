@@ -0,0 +1,63 @@
+#ifndef PIO_UNROLL_H
+#define PIO_UNROLL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "signal_timing.h"
+
+// Generator program PIO terurai untuk frekuensi tinggi. Satu periode bipolar
+// (1001, 0000, 0110, 0000, picu keluar HIGH bersama CH1, sama seperti
+// signal_generator_counted) ditulis langsung sebagai instruksi "set pins"
+// dengan durasi di field [delay]. Tidak ada pull/mov per event, jadi event
+// terpendek satu siklus PIO dan tidak ada trafik FIFO/DMA selama proses.
+// Event yang lebih panjang dari satu instruksi memakai nop [d] atau loop
+// "set x, n [d]" + "jmp x-- <diri sendiri> [d]" (maks. UNROLL_LOOP_MAX siklus
+// per dua instruksi). Seperti signal_timing.h, hanya aritmetika integer dan
+// tanpa Pico SDK: kode mesin disusun di sini dan diperiksa terhadap keluaran
+// pioasm di host (mgc_sim unroll).
+//
+// Tata letak (alamat relatif; JMP direlokasi oleh pio_add_program()):
+//   0       wait 1 pin 0     picu eksternal (in_base = picu masuk)
+//   1       pull block       UNROLL_OFFSET_START, tanpa picu
+//   2       mov y, osr       Y = jumlah periode - 1 (satu kata dari CPU)
+//   3 ...   event A..D       event D diakhiri "jmp y-- 3"
+//   akhir   irq wait 0 rel   parkir dengan pin LOW tepat di batas periode
+//                            (wrap ke dirinya sendiri)
+// Hitungan periode ada di register Y, jadi proses berhenti sendiri seperti
+// program terhitung tanpa satu kata FIFO pun per periode.
+//
+// Side-set tidak dipakai: CH1/CH4 dan CH2/CH3 tidak bersebelahan di
+// GP6..GP9, sehingga side-set butuh kelima pin (termasuk picu keluar) dan
+// menghabiskan seluruh 5 bit field delay.
+
+#define UNROLL_MAX_INSTRUCTIONS 32 // Memori instruksi satu blok PIO
+#define UNROLL_EVENT_OVERHEAD 1    // Event terpendek: satu "set pins"
+#define UNROLL_D_MIN 2             // Event D: "set pins" + "jmp y--"
+#define UNROLL_OFFSET_START 1
+#define UNROLL_PROLOG 3 // wait, pull, mov
+#define UNROLL_SET_PINS 5 // GP6..GP9 + picu keluar (GP10)
+// Siklus SM dari "wait 1 pin 0" terpenuhi ke tepi naik CH1 pertama
+// (pull, mov, set pins)
+#define UNROLL_TRIGGER_LATENCY 3
+#define UNROLL_DELAY_MAX 31
+#define UNROLL_INSTR_CYCLES_MAX (UNROLL_DELAY_MAX + 1)
+// set x, 31 [31] + 32 x jmp x-- [31]
+#define UNROLL_LOOP_MAX (UNROLL_INSTR_CYCLES_MAX * (1 + 32))
+
+typedef struct
+{
+    uint16_t instructions[UNROLL_MAX_INSTRUCTIONS];
+    uint32_t length;
+    uint32_t wrap_target, wrap; // Relatif terhadap awal program
+    uint8_t event_instructions[4]; // Instruksi yang dipakai event A..D
+} unroll_program_t;
+
+// Susun rencana pada clkdiv 1 (setiap event minimal UNROLL_EVENT_OVERHEAD
+// siklus, event D minimal UNROLL_D_MIN) lalu programnya. 'plan' sama dengan
+// timing_compile() dengan overhead itu (delay[] = siklus event - 1).
+// TIMING_ERR_RANGE bila program melebihi 'max_instructions'; 'plan' tetap
+// terisi sehingga pemanggil dapat jatuh ke program loop.
+timing_status_t unroll_compile(const timing_request_t *req, uint32_t sys_clk_hz, uint32_t max_instructions,
+                               timing_plan_t *plan, unroll_program_t *prog);
+
+#endif
@@ -0,0 +1,159 @@
+#include "pulse_capture.h"
+#include "hardware/adc.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "signal_generator.pio.h"
+
+static PIO pio;
+static uint sm;
+static int dma_chan = -1;
+static uint32_t pairs;
+static capture_ring_t ring;
+
+// Slot yang sedang diisi burst (NULL: ADC diam). Hanya disentuh handler
+// IRQ core 1 dan disarm di core 1.
+static capture_slot_t *volatile active;
+static uint32_t periods_seen; // Event A sejak arm
+static uint32_t arm_us;
+
+// "irq nowait n rel": flag (n + sm) mod 4, sama seperti perangkat keras
+static uint capture_flag(uint index)
+{
+    return (index + sm) & 3u;
+}
+
+static void begin_burst(capture_event_t event)
+{
+    // Event C milik periode yang sama dengan event A terakhir
+    uint32_t pulse = event == CAPTURE_EVENT_A ? periods_seen++ : periods_seen - 1;
+    if (active != NULL)
+    {
+        ring.dropped_busy++;
+        return;
+    }
+    capture_slot_t *s = capture_ring_claim(&ring);
+    if (s == NULL)
+        return;
+
+    uint32_t dropped = capture_ring_dropped(&ring);
+    s->pulse = pulse;
+    s->t_us = time_us_32() - arm_us;
+    s->event = (uint8_t)event;
+    s->pairs = (uint8_t)pairs;
+    s->dropped = dropped > 0xffff ? 0xffff : (uint16_t)dropped;
+    active = s;
+
+    // Round-robin mulai lagi dari kanal arus; sisa konversi burst lalu dibuang
+    adc_select_input(CAPTURE_CURRENT_GPIO - 26);
+    adc_fifo_drain();
+    dma_channel_set_write_addr(dma_chan, s->samples, false);
+    dma_channel_set_trans_count(dma_chan, pairs * CAPTURE_CHANNELS, true);
+    adc_run(true);
+}
+
+static void capture_pio_irq(void)
+{
+    // Dalam satu periode A selalu mendahului C
+    uint flag_a = capture_flag(signal_generator_counted_CAPTURE_IRQ_A);
+    uint flag_c = capture_flag(signal_generator_counted_CAPTURE_IRQ_C);
+    if (pio_interrupt_get(pio, flag_a))
+    {
+        pio_interrupt_clear(pio, flag_a);
+        begin_burst(CAPTURE_EVENT_A);
+    }
+    if (pio_interrupt_get(pio, flag_c))
+    {
+        pio_interrupt_clear(pio, flag_c);
+        begin_burst(CAPTURE_EVENT_C);
+    }
+}
+
+// Burst lengkap: ADC berhenti, slot terlihat core 0 dan WFE-nya dibangunkan
+static void capture_dma_irq(void)
+{
+    if (!dma_channel_get_irq1_status(dma_chan))
+        return;
+    dma_channel_acknowledge_irq1(dma_chan);
+    adc_run(false);
+    active = NULL;
+    capture_ring_commit(&ring);
+    __sev();
+}
+
+static void set_pio_sources(bool enabled)
+{
+    pio_set_irq1_source_enabled(pio, (pio_interrupt_source_t)(pis_interrupt0 +
+                                capture_flag(signal_generator_counted_CAPTURE_IRQ_A)), enabled);
+    pio_set_irq1_source_enabled(pio, (pio_interrupt_source_t)(pis_interrupt0 +
+                                capture_flag(signal_generator_counted_CAPTURE_IRQ_C)), enabled);
+}
+
+void pulse_capture_init(PIO pio_instance, uint sm_index)
+{
+    pio = pio_instance;
+    sm = sm_index;
+    capture_ring_init(&ring);
+    adc_gpio_init(CAPTURE_CURRENT_GPIO);
+    adc_gpio_init(CAPTURE_VOLTAGE_GPIO);
+    dma_chan = dma_claim_unused_channel(true);
+
+    // FIFO ADC -> slot, 16 bit; alamat tulis dan transfer count diisi per burst
+    dma_channel_config c = dma_channel_get_default_config(dma_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, false);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_dreq(&c, DREQ_ADC);
+    dma_channel_configure(dma_chan, &c, ring.slot[0].samples, &adc_hw->fifo, 0, false);
+    dma_channel_set_irq1_enabled(dma_chan, true);
+
+    // NVIC per core: kedua IRQ dilayani core 1, yang memanggil fungsi ini
+    irq_set_exclusive_handler(DMA_IRQ_1, capture_dma_irq);
+    irq_set_enabled(DMA_IRQ_1, true);
+    uint irq = pio_get_index(pio) ? PIO1_IRQ_1 : PIO0_IRQ_1;
+    irq_set_exclusive_handler(irq, capture_pio_irq);
+    irq_set_enabled(irq, true);
+}
+
+void pulse_capture_arm(uint32_t pairs_per_event)
+{
+    pairs = pairs_per_event > CAPTURE_MAX_PAIRS ? CAPTURE_MAX_PAIRS : pairs_per_event;
+    if (pairs == 0)
+        return;
+
+    // Indeks ring milik kedua core dan tidak dinolkan; core 0 sudah
+    // mengirim semua bingkai proses sebelumnya sebelum START berikutnya
+    ring.captured = ring.dropped_busy = ring.dropped_full = 0;
+    periods_seen = 0;
+    active = NULL;
+
+    // Konfigurasi ADC lengkap: pemantau bank memakai kanal dan laju lain
+    adc_run(false);
+    adc_set_round_robin((1u << (CAPTURE_CURRENT_GPIO - 26)) | (1u << (CAPTURE_VOLTAGE_GPIO - 26)));
+    adc_fifo_setup(true, true, 1, false, false);
+    adc_hw->div = 0; // Konversi berurutan tanpa jeda: 500 kS/s
+    adc_fifo_drain();
+
+    pio_interrupt_clear(pio, capture_flag(signal_generator_counted_CAPTURE_IRQ_A));
+    pio_interrupt_clear(pio, capture_flag(signal_generator_counted_CAPTURE_IRQ_C));
+    arm_us = time_us_32();
+    set_pio_sources(true);
+}
+
+void pulse_capture_disarm(void)
+{
+    if (pairs == 0)
+        return;
+    set_pio_sources(false);
+    // IRQ DMA (core ini) menutup burst terakhir
+    while (active != NULL)
+        tight_loop_contents();
+    adc_set_round_robin(0);
+    adc_fifo_drain();
+    pairs = 0;
+}
+
+capture_ring_t *pulse_capture_ring(void)
+{
+    return &ring;
+}
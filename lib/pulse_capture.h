@@ -0,0 +1,50 @@
+#ifndef PULSE_CAPTURE_H
+#define PULSE_CAPTURE_H
+
+/**
+ * Tangkapan arus/tegangan per pulsa
+ *
+ * signal_generator_counted menyetel flag IRQ CAPTURE_IRQ_A / CAPTURE_IRQ_C
+ * (relatif terhadap SM) satu siklus SM setelah tepi naik CH1 dan CH2. Flag
+ * itu dirutekan ke IRQ_1 blok PIO dan ditangani core 1: handler memulai
+ * burst ADC round-robin (arus ADC1, tegangan ADC2; 96 siklus clk_adc = 2 us
+ * per sampel) yang dikuras satu channel DMA berpacu DREQ_ADC ke slot ring
+ * lib/capture_frame.h. IRQ selesai DMA mematikan ADC dan menerbitkan slot;
+ * core 0 mengirimnya lewat CDC. Tepi yang tiba saat burst sebelumnya masih
+ * berjalan atau saat ring penuh dihitung sebagai bingkai hilang, tidak
+ * ditunda, sehingga bentuk gelombang tidak pernah bergantung pada tangkapan.
+ *
+ * Sampel pertama keluar satu konversi (2 us) ditambah latensi IRQ core 1
+ * setelah tepi. ADC dipakai bergantian dengan pemantau bank
+ * (lib/bank_adc.c): proses dan pengosongan tidak pernah berjalan bersamaan
+ * dan keduanya mengatur ulang ADC saat mulai. Hanya program statis yang
+ * punya instruksi IRQ tangkapan; mesin pola tidak ditangkap.
+ *
+ * Semua fungsi dipanggil dari core 1 kecuali pulse_capture_ring() (core 0,
+ * konsumen ring).
+ */
+
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "capture_frame.h"
+
+#define CAPTURE_CURRENT_GPIO 27 // ADC1: sensor arus (tengah skala = 0 A)
+#define CAPTURE_VOLTAGE_GPIO 28 // ADC2: pembagi tegangan beban
+#define CAPTURE_SAMPLE_US 2     // Satu konversi; satu pasangan I/V = 4 us
+
+// Klaim channel DMA, siapkan pin ADC dan handler IRQ_1 PIO + DMA_IRQ_1 di
+// core 1. 'sm' adalah SM generator (flag IRQ relatif terhadapnya).
+void pulse_capture_init(PIO pio, uint sm);
+
+// Sebelum SM diaktifkan: nolkan statistik ring dan aktifkan IRQ tangkapan
+// dengan 'pairs' pasangan I/V per event (0: mati, maks. CAPTURE_MAX_PAIRS)
+void pulse_capture_arm(uint32_t pairs);
+
+// Setelah SM dimatikan: burst yang sedang berjalan diselesaikan (maks.
+// CAPTURE_MAX_PAIRS x 4 us) lalu IRQ tangkapan dimatikan
+void pulse_capture_disarm(void);
+
+// Ring bingkai untuk konsumen di core 0
+capture_ring_t *pulse_capture_ring(void);
+
+#endif
@@ -0,0 +1,94 @@
+#include "pulse_counter.h"
+#include "pulse_counter.pio.h"
+#include "pio_programs.h"
+
+static PIO pio;
+static uint pin_base;
+static uint count_sm, span_sm;
+static uint count_offset, span_offset;
+static uint32_t counter_div = 1;
+static bool ready;
+
+bool pulse_counter_init(PIO pio_instance, uint pin)
+{
+    pio = pio_instance;
+    pin_base = pin;
+    if (!pio_programs_acquire(pio, &pulse_counter_program, &count_offset))
+        return false;
+    if (!pio_programs_acquire(pio, &pulse_span_program, &span_offset))
+    {
+        pio_programs_release(pio, &pulse_counter_program);
+        return false;
+    }
+    int a = pio_claim_unused_sm(pio, false);
+    int b = a < 0 ? -1 : pio_claim_unused_sm(pio, false);
+    if (b < 0)
+    {
+        if (a >= 0)
+            pio_sm_unclaim(pio, (uint)a);
+        pio_programs_release(pio, &pulse_span_program);
+        pio_programs_release(pio, &pulse_counter_program);
+        return false;
+    }
+    count_sm = (uint)a;
+    span_sm = (uint)b;
+    ready = true;
+    return true;
+}
+
+static void init_sm(uint sm, uint entry, pio_sm_config c)
+{
+    // Pin hanya dibaca: in_base untuk wait, jmp_pin untuk jmp pin. Fungsi
+    // GPIO (PIO0) dan arah pin tidak diubah.
+    sm_config_set_in_pins(&c, pin_base);
+    sm_config_set_jmp_pin(&c, pin_base);
+    sm_config_set_clkdiv_int_frac8(&c, counter_div, 0);
+    pio_sm_init(pio, sm, entry, &c);
+
+    // Hitungan mundur dari 0xFFFFFFFF
+    pio_sm_exec(pio, sm, pio_encode_mov_not(pio_x, pio_null));
+    pio_sm_exec(pio, sm, pio_encode_mov_not(pio_y, pio_null));
+}
+
+void pulse_counter_arm(uint32_t duration_ms, uint32_t sys_clk_hz)
+{
+    if (!ready)
+        return;
+    counter_div = pulse_stats_counter_div(duration_ms, sys_clk_hz);
+    init_sm(count_sm, count_offset + pulse_counter_offset_start,
+            pulse_counter_program_get_default_config(count_offset));
+    init_sm(span_sm, span_offset, pulse_span_program_get_default_config(span_offset));
+    pio_enable_sm_mask_in_sync(pio, (1u << count_sm) | (1u << span_sm));
+}
+
+static uint32_t read_reg(uint sm, enum pio_src_dest reg)
+{
+    // SM yang dimatikan masih menjalankan instruksi lewat exec: salin
+    // register ke ISR lalu dorong ke RX FIFO
+    pio_sm_exec(pio, sm, pio_encode_in(reg, 32));
+    pio_sm_exec(pio, sm, pio_encode_push(false, false));
+    return UINT32_MAX - pio_sm_get(pio, sm);
+}
+
+void pulse_counter_read(pulse_raw_t *raw)
+{
+    *raw = (pulse_raw_t){0};
+    if (!ready)
+        return;
+
+    // Beri waktu SM melihat tepi turun terakhir: 16 siklus penghitung
+    // (0.13 us per divider pada 125 MHz)
+    busy_wait_us(1 + counter_div / 4u);
+    pio_set_sm_mask_enabled(pio, (1u << count_sm) | (1u << span_sm), false);
+    pio_sm_clear_fifos(pio, count_sm);
+    pio_sm_clear_fifos(pio, span_sm);
+
+    raw->pulses = read_reg(count_sm, pio_y);
+    raw->high_dec = read_reg(count_sm, pio_x);
+    raw->span_dec = read_reg(span_sm, pio_y);
+}
+
+uint32_t pulse_counter_div(void)
+{
+    return counter_div;
+}
@@ -0,0 +1,33 @@
+#ifndef PULSE_COUNTER_H
+#define PULSE_COUNTER_H
+
+/**
+ * Penghitung pulsa CH1 di PIO1
+ *
+ * Dua SM (pulse_counter dan pulse_span, lihat pulse_counter.pio) mengamati
+ * pin CH1 lewat jalur input selama mesin pulsa berjalan, sehingga jumlah
+ * pulsa, waktu ON dan rentang tepi naik diukur dari pin itu sendiri, bukan
+ * dari perhitungan waktu. PWM tidak dipakai: GP6 adalah kanal A slice 3,
+ * sedangkan penghitung tepi PWM hanya membaca kanal B. Hanya dipanggil dari
+ * core pemilik PIO (core 1).
+ */
+
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "pulse_stats.h"
+
+// Klaim dua SM dan muat kedua program; false bila PIO tidak punya ruang
+bool pulse_counter_init(PIO pio, uint pin);
+
+// Isi ulang hitungan dan aktifkan kedua SM. 'duration_ms' menentukan divider
+// agar register tidak habis selama jalan.
+void pulse_counter_arm(uint32_t duration_ms, uint32_t sys_clk_hz);
+
+// Matikan SM dan baca hitungan mentah. Dipanggil setelah pin CH1 dipaksa LOW
+// agar pulsa terakhir yang terpotong ikut tertutup.
+void pulse_counter_read(pulse_raw_t *raw);
+
+// Divider yang dipakai pada arm terakhir (masukan pulse_stats_decode)
+uint32_t pulse_counter_div(void);
+
+#endif
@@ -0,0 +1,859 @@
+#include "pulse_engine.h"
+#include <string.h>
+#include "pico/multicore.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "signal_generator.pio.h"
+#include "pattern_engine.pio.h"
+#include "pio_programs.h"
+#include "pio_unroll.h"
+#include "pulse_counter.h"
+#include "pulse_capture.h"
+#include "logic_analyzer.h"
+#include "channel_group.h"
+
+// ===================== STATE MILIK CORE 1 =====================
+static PIO pio;
+static uint sm;
+static uint pin_base;
+
+// Kedua program menetap di memori instruksi PIO (25 + 4 dari 32 instruksi),
+// jadi pergantian mode tidak lagi menghapus dan memuat ulang program. Mesin
+// pola dibagi dengan grup kanal lewat pio_programs. Program terurai
+// (lib/pio_unroll.h) menempati ruang signal_generator_counted selama
+// terkonfigurasi; keduanya tidak pernah dimuat bersamaan.
+static uint counted_offset, pattern_offset;
+static bool counted_loaded;
+static unroll_program_t unrolled;
+static pio_program_t unrolled_program; // length 0: tidak dimuat
+static uint unrolled_offset;
+
+// Tabel pola yang sedang dialirkan (satu kata per event, lihat lib/pattern.h).
+// Proses terhitung: tabel dipadatkan ke 2^n kata dan diputar channel data
+// mode ring (karena itu tabel disejajarkan ke ukuran maksimumnya) dengan
+// transfer count = panjang x periode, lalu chain ke channel kontrol yang
+// mengirim satu kata henti. Bila tabel tidak dapat dipadatkan, channel
+// kontrol menulis ulang alamat awal tabel lewat alias READ_ADDR_TRIG
+// sehingga tabel berputar tanpa batas dan proses dihentikan menurut waktu.
+static pattern_table_t pattern_table __attribute__((aligned(PATTERN_MAX_EVENTS * sizeof(uint32_t))));
+static pattern_t preset_pattern; // Preset bipolar; terlalu besar untuk stack core 1
+static const uint32_t *pattern_table_addr = pattern_table.words;
+static int feed_dma_chan = -1;  // Channel data: tabel -> TX FIFO, dipacu DREQ SM
+static int feed_ctrl_chan = -1; // Channel kontrol: memuat ulang alamat baca + trigger / kata henti
+static bool pattern_ring;       // Tabel 2^n kata: proses mesin pola dihitung per periode
+
+// Mesin pola berhenti di "out pins" dengan keempat pin LOW setelah kata ini
+static const uint32_t pattern_stop_word = PATTERN_WORD(0, 0);
+// Program terhitung: ~V event D, dibaca berulang oleh DMA (satu per periode)
+static uint32_t counted_word;
+// Pasangan I/V per event yang ditangkap (program statis saja, 0: mati)
+static uint32_t capture_pairs;
+// Penganalisis logika dipersenjatai pada START berikutnya (uji mandiri)
+static bool logic_capture;
+// Pasangan independen: SM, DMA dan tabel diklaim saat konfigurasi dan
+// dilepas di engine_halt() atau konfigurasi berikutnya
+static channel_group_t pair_group;
+
+// Disetel handler IRQ PIO (atau deteksi akhir mesin pola) saat SM berhenti
+// sendiri di batas periode
+static volatile bool run_complete;
+
+// Salinan kerja status; hanya core 1 yang menulis
+static pulse_engine_status_t st;
+
+// ===================== MAILBOX =====================
+// Konfigurasi ditulis core 0 sebelum PE_CMD_CONFIGURE dikirim dan tidak
+// disentuh lagi sampai core 1 membalas, jadi cukup dibatasi barrier.
+static pulse_engine_config_t pending_config;
+
+// Status: seqlock dengan satu penulis (core 1). Nilai seq ganjil berarti
+// sedang ditulis; pembaca mengulang bila seq berubah selama menyalin.
+static struct
+{
+    volatile uint32_t seq;
+    pulse_engine_status_t status;
+} mailbox;
+
+static void publish(void)
+{
+    mailbox.seq++;
+    __dmb();
+    mailbox.status = st;
+    __dmb();
+    mailbox.seq++;
+}
+
+void pulse_engine_status(pulse_engine_status_t *out)
+{
+    uint32_t seq;
+    do
+    {
+        while ((seq = mailbox.seq) & 1u)
+            tight_loop_contents();
+        __dmb();
+        *out = mailbox.status;
+        __dmb();
+    } while (mailbox.seq != seq);
+}
+
+// ===================== PIO DAN DMA (CORE 1) =====================
+static void select_program(bool constant_params)
+{
+    // Parameter konstan tidak membutuhkan umpan FIFO sama sekali: pakai program
+    // statis. Pola apa pun (termasuk preset bipolar) memakai mesin pola + DMA.
+    st.static_program = constant_params;
+    st.unrolled = false;
+    st.program_length = 0;
+    st.event_overhead = constant_params ? signal_generator_counted_EVENT_OVERHEAD
+                                        : pattern_engine_EVENT_OVERHEAD;
+}
+
+static void unload_unrolled(void)
+{
+    if (unrolled_program.length == 0)
+        return;
+    pio_remove_program(pio, &unrolled_program, unrolled_offset);
+    unrolled_program.length = 0;
+}
+
+static void load_counted(void)
+{
+    unload_unrolled();
+    if (!counted_loaded)
+        counted_loaded = pio_programs_acquire(pio, &signal_generator_counted_program, &counted_offset);
+}
+
+// Ganti program terurai yang dimuat dengan 'next'; signal_generator_counted
+// dilepas untuk memberi tempat. false (program terhitung dimuat kembali)
+// bila tidak muat di memori instruksi yang tersisa.
+static bool load_unrolled(const unroll_program_t *next)
+{
+    unload_unrolled();
+    if (counted_loaded)
+    {
+        pio_programs_release(pio, &signal_generator_counted_program);
+        counted_loaded = false;
+    }
+    unrolled = *next;
+    pio_program_t prog = {.instructions = unrolled.instructions, .length = (uint8_t)unrolled.length, .origin = -1};
+    if (!pio_can_add_program(pio, &prog))
+    {
+        load_counted();
+        return false;
+    }
+    unrolled_program = prog;
+    unrolled_offset = pio_add_program(pio, &unrolled_program);
+    return true;
+}
+
+// Alamat "wait 1 pin 0" program aktif: SM yang masih di sini belum dipicu
+static uint trigger_wait_pc(void)
+{
+    if (st.unrolled)
+        return unrolled_offset;
+    return st.static_program ? counted_offset : pattern_offset;
+}
+
+// Alamat awal SM: tanpa picu eksternal kedua program melewati "wait 1 pin 0"
+static uint program_entry(void)
+{
+    if (st.external_trigger)
+        return trigger_wait_pc();
+    if (st.unrolled)
+        return unrolled_offset + UNROLL_OFFSET_START;
+    return st.static_program ? counted_offset + signal_generator_counted_offset_start
+                             : pattern_offset + pattern_engine_offset_start;
+}
+
+static pio_sm_config get_program_config(void)
+{
+    pio_sm_config c;
+    if (st.unrolled)
+    {
+        // Tanpa pull selama berjalan: FIFO hanya membawa hitungan periode
+        c = pio_get_default_sm_config();
+        sm_config_set_wrap(&c, unrolled_offset + unrolled.wrap_target, unrolled_offset + unrolled.wrap);
+    }
+    else if (st.static_program)
+    {
+        c = signal_generator_counted_program_get_default_config(counted_offset);
+    }
+    else
+    {
+        // Autopull 32 bit: satu kata (mask | N << 4) per event. TX FIFO
+        // digabung menjadi 8 kata agar DMA punya cadangan saat bus sibuk.
+        c = pattern_engine_program_get_default_config(pattern_offset);
+        sm_config_set_out_pins(&c, pin_base, pattern_engine_MASK_BITS);
+        sm_config_set_out_shift(&c, true, true, 32);
+        sm_config_set_fifo_join(&c, PIO_FIFO_JOIN_TX);
+    }
+    // Set pins juga untuk mesin pola: engine_halt() memakai "set pins, 0".
+    // Program statis menyertakan pin picu keluar (bit 4).
+    sm_config_set_set_pins(&c, pin_base, st.static_program ? PE_TRIGGER_OUT_OFFSET + 1 : 4);
+    sm_config_set_in_pins(&c, pin_base + PE_TRIGGER_IN_OFFSET);
+    return c;
+}
+
+static void start_counted_dma(void)
+{
+    // Satu kata per periode tanpa increment; setelah kata terakhir FIFO
+    // kosong dan SM berhenti sendiri di akhir periode itu
+    dma_channel_config cfg = dma_channel_get_default_config(feed_dma_chan);
+    channel_config_set_transfer_data_size(&cfg, DMA_SIZE_32);
+    channel_config_set_read_increment(&cfg, false);
+    channel_config_set_write_increment(&cfg, false);
+    channel_config_set_dreq(&cfg, pio_get_dreq(pio, sm, true));
+    dma_channel_configure(feed_dma_chan, &cfg, &pio->txf[sm], &counted_word, st.periods, true);
+}
+
+// Umpan mesin pola. Preset bipolar (REMOTE_PARAM_PROGRAM = 1 di main.c)
+// selalu dapat dipadatkan ke 2^n kata sehingga memakai cabang ring; cabang
+// chain dengan re-trigger AL3_READ_ADDR_TRIG untuk pola bebas (cfg->pattern)
+// yang tabelnya tidak dapat dipadatkan, dihentikan menurut waktu.
+static void start_feed_dma(void)
+{
+    // Channel data: baca tabel secara berurutan, tulis ke TX FIFO SM, dipacu
+    // DREQ TX sehingga hanya mengirim saat FIFO punya ruang
+    dma_channel_config data_cfg = dma_channel_get_default_config(feed_dma_chan);
+    channel_config_set_transfer_data_size(&data_cfg, DMA_SIZE_32);
+    channel_config_set_read_increment(&data_cfg, true);
+    channel_config_set_write_increment(&data_cfg, false);
+    channel_config_set_dreq(&data_cfg, pio_get_dreq(pio, sm, true));
+    channel_config_set_chain_to(&data_cfg, feed_ctrl_chan);
+
+    if (pattern_ring)
+    {
+        // Alamat baca membungkus di batas 2^n byte tabel; transfer count
+        // menghitung periode, lalu channel kontrol mengirim kata henti
+        uint ring_bits = 2;
+        while ((1u << ring_bits) < pattern_table.length * sizeof(uint32_t))
+            ring_bits++;
+        channel_config_set_ring(&data_cfg, false, ring_bits);
+
+        dma_channel_config tail_cfg = dma_channel_get_default_config(feed_ctrl_chan);
+        channel_config_set_transfer_data_size(&tail_cfg, DMA_SIZE_32);
+        channel_config_set_read_increment(&tail_cfg, false);
+        channel_config_set_write_increment(&tail_cfg, false);
+        channel_config_set_dreq(&tail_cfg, pio_get_dreq(pio, sm, true));
+        dma_channel_configure(feed_ctrl_chan, &tail_cfg, &pio->txf[sm], &pattern_stop_word, 1, false);
+
+        dma_channel_configure(feed_dma_chan, &data_cfg, &pio->txf[sm], pattern_table.words,
+                              pattern_table.length * st.periods, true);
+        return;
+    }
+
+    // Channel kontrol: satu transfer yang menulis alamat awal tabel ke alias
+    // READ_ADDR_TRIG channel data. Transfer count channel data dimuat ulang
+    // dari nilai reload (panjang tabel) setiap kali dipicu.
+    dma_channel_config ctrl_cfg = dma_channel_get_default_config(feed_ctrl_chan);
+    channel_config_set_transfer_data_size(&ctrl_cfg, DMA_SIZE_32);
+    channel_config_set_read_increment(&ctrl_cfg, false);
+    channel_config_set_write_increment(&ctrl_cfg, false);
+    dma_channel_configure(feed_ctrl_chan, &ctrl_cfg,
+                          &dma_hw->ch[feed_dma_chan].al3_read_addr_trig,
+                          &pattern_table_addr,
+                          1, false);
+
+    dma_channel_configure(feed_dma_chan, &data_cfg,
+                          &pio->txf[sm],
+                          pattern_table.words,
+                          pattern_table.length, true);
+}
+
+static void stop_feed_dma(void)
+{
+    // Channel kontrol dihentikan lebih dulu agar tidak memicu ulang channel
+    // data yang sedang di-abort, lalu diulang untuk menutup celah chain.
+    dma_channel_abort(feed_ctrl_chan);
+    dma_channel_abort(feed_dma_chan);
+    dma_channel_abort(feed_ctrl_chan);
+}
+
+// Mesin pola terhitung sudah berhenti: kedua channel selesai, FIFO kosong
+// dan SM menunggu kata berikutnya di "out pins" (kata henti sudah keluar)
+static bool pattern_drained(void)
+{
+    return !dma_channel_is_busy(feed_dma_chan) && !dma_channel_is_busy(feed_ctrl_chan) &&
+           pio_sm_is_tx_fifo_empty(pio, sm) &&
+           pio_sm_get_pc(pio, sm) == pattern_offset + pattern_engine_offset_start;
+}
+
+// Periode yang sudah dimulai SM: kata yang dikirim DMA dikurangi sisa di
+// FIFO (kata henti mesin pola tidak dihitung). Dibaca sebelum FIFO dibuang.
+static uint32_t periods_started(uint32_t dma_remaining)
+{
+    if (st.periods == 0)
+        return 0;
+    if (st.unrolled)
+    {
+        // Program terurai: Y = periode tersisa - 1, dibaca lewat RX FIFO.
+        // Setelah periode terakhir Y sudah melewati nol.
+        pio_sm_exec(pio, sm, pio_encode_mov(pio_isr, pio_y));
+        pio_sm_exec(pio, sm, pio_encode_push(false, false));
+        uint32_t y = pio_sm_get(pio, sm);
+        return y < st.periods ? st.periods - y : st.periods;
+    }
+    uint32_t per_period = st.static_program ? 1u : pattern_table.length;
+    uint32_t queued = pio_sm_get_tx_fifo_level(pio, sm);
+    if (!st.static_program && dma_remaining == 0 && !dma_channel_is_busy(feed_ctrl_chan) && queued > 0)
+        queued--;
+    uint32_t taken = per_period * st.periods - dma_remaining - queued;
+    return (taken + per_period - 1) / per_period;
+}
+
+// FDEBUG.TXSTALL lengket: SM sempat tertahan "pull block"/autopull dengan
+// FIFO TX kosong sejak bit dihapus. "pull noblock" program terhitung tidak
+// menyetelnya; underrun di sana terlihat sebagai akhir proses yang terlalu dini.
+static bool tx_stalled(void)
+{
+    uint32_t bit = 1u << (PIO_FDEBUG_TXSTALL_LSB + sm);
+    if (!(pio->fdebug & bit))
+        return false;
+    pio->fdebug = bit; // Tulis 1 untuk menghapus
+    return true;
+}
+
+static void sample_fifo(void)
+{
+    st.fifo_samples++;
+    if (tx_stalled())
+        st.fifo_underruns++;
+}
+
+// Flag IRQ SM (irq wait 0 rel): program terhitung parkir dengan pin LOW di
+// batas periode. SM dimatikan di sini lalu flag dilepas agar IRQ tidak
+// berulang; __sev() membangunkan loop tunggu engine_run().
+static void engine_irq_handler(void)
+{
+    pio_sm_set_enabled(pio, sm, false);
+    pio_interrupt_clear(pio, sm);
+    st.stop_us = time_us_64();
+    run_complete = true;
+    __sev();
+}
+
+// Tepi naik CH1 yang seharusnya keluar selama 'run_cycles' siklus PIO sejak
+// SM diaktifkan. Program statis dan preset bipolar naik sekali di awal
+// periode; pola bebas ditelusuri per event karena tepi naiknya bisa di mana
+// saja dalam periode.
+static uint32_t expected_pulses(uint64_t run_cycles)
+{
+    if (st.plan.period_cycles == 0)
+        return 0;
+    uint64_t periods = run_cycles / st.plan.period_cycles;
+    uint64_t rest = run_cycles % st.plan.period_cycles;
+    if (st.static_program)
+        return (uint32_t)(periods + (rest > 0));
+
+    uint32_t rises = 0, rises_in_rest = 0;
+    uint64_t t = 0;
+    bool prev = pattern_word_mask(pattern_table.words[pattern_table.length - 1]) & 1u;
+    for (uint32_t i = 0; i < pattern_table.length; i++)
+    {
+        uint32_t w = pattern_table.words[i];
+        bool high = pattern_word_mask(w) & 1u;
+        if (high && !prev)
+        {
+            rises++;
+            rises_in_rest += t < rest;
+        }
+        prev = high;
+        t += pattern_word_count(w) + st.event_overhead;
+    }
+    return (uint32_t)(periods * rises + rises_in_rest);
+}
+
+static void engine_init_hw(void)
+{
+    counted_loaded = pio_programs_acquire(pio, &signal_generator_counted_program, &counted_offset);
+    pio_programs_acquire(pio, &pattern_engine_program, &pattern_offset);
+    sm = pio_claim_unused_sm(pio, true);
+
+    // Default: parameter konstan -> program statis
+    select_program(true);
+    pio_sm_config c = get_program_config();
+    for (uint i = 0; i <= PE_TRIGGER_OUT_OFFSET; ++i)
+        pio_gpio_init(pio, pin_base + i);
+    pio_sm_set_consecutive_pindirs(pio, sm, pin_base, PE_TRIGGER_OUT_OFFSET + 1, true);
+    // Picu masuk tanpa sumber tetap LOW: SM tetap menunggu
+    gpio_init(pin_base + PE_TRIGGER_IN_OFFSET);
+    gpio_pull_down(pin_base + PE_TRIGGER_IN_OFFSET);
+    pio_sm_init(pio, sm, program_entry(), &c);
+
+    feed_dma_chan = dma_claim_unused_channel(true);
+    feed_ctrl_chan = dma_claim_unused_channel(true);
+
+    // IRQ_0 blok ini ditangani core 1 (NVIC per core)
+    uint irq = pio_get_index(pio) ? PIO1_IRQ_0 : PIO0_IRQ_0;
+    pio_set_irq0_source_enabled(pio, (pio_interrupt_source_t)(pis_interrupt0 + sm), true);
+    irq_set_exclusive_handler(irq, engine_irq_handler);
+    irq_set_enabled(irq, true);
+
+    // Penghitung di blok PIO lain: memori instruksi blok ini hampir penuh
+    pulse_counter_init(pio == pio0 ? pio1 : pio0, pin_base);
+    logic_analyzer_init(pio == pio0 ? pio1 : pio0, pin_base);
+    pulse_capture_init(pio, sm);
+}
+
+static void release_pairs(void)
+{
+    if (pair_group.count == 0)
+        return;
+    channel_group_release(&pair_group);
+    // Kanal grup bisa jatuh di blok PIO lain: fungsi pin kembali ke mesin pulsa
+    for (uint i = 0; i < PE_MAX_PAIRS * 2; i++)
+        pio_gpio_init(pio, pin_base + i);
+}
+
+static void engine_halt(void)
+{
+    // Grup lebih dulu: SM pasangan menggerakkan pin yang sama dengan SM mesin
+    // pulsa; channel_group_stop() memaksa pin pasangan LOW
+    if (pair_group.count > 0)
+    {
+        channel_group_stop(&pair_group);
+        release_pairs();
+    }
+    uint32_t dma_remaining = dma_channel_hw_addr(feed_dma_chan)->transfer_count;
+    stop_feed_dma();
+    pio_sm_set_enabled(pio, sm, false);
+    if (!run_complete)
+        st.stop_us = time_us_64();
+    if (st.state == PE_STATE_ARMED)
+    {
+        // Picu tidak pernah datang: kata prolog masih di FIFO, tidak ada
+        // periode yang dimulai dan tidak ada pulsa yang diharapkan
+        st.start_us = st.stop_us;
+        st.periods_done = 0;
+    }
+    else
+    {
+        st.periods_done = periods_started(dma_remaining);
+    }
+    if (run_complete && st.static_program && st.periods_done < st.periods)
+        st.fifo_underruns++;
+
+    // SM yang dimatikan di tengah pulsa membiarkan pin tetap HIGH: paksa
+    // keempat kanal LOW dan buang sisa kata di FIFO. Setelah selesai sendiri
+    // pin sudah LOW dan perintah ini tidak mengubah apa pun.
+    pio_sm_exec(pio, sm, pio_encode_set(pio_pins, 0));
+    pio_sm_clear_fifos(pio, sm);
+    pio_interrupt_clear(pio, sm);
+    irq_clear(pio_get_index(pio) ? PIO1_IRQ_0 : PIO0_IRQ_0);
+    pulse_capture_disarm();
+    if (logic_capture)
+        logic_analyzer_disarm();
+
+    // Telemetri dosis: pulsa yang benar-benar keluar di CH1 dibandingkan
+    // dengan jumlah yang seharusnya keluar selama SM aktif
+    pulse_raw_t raw;
+    pulse_counter_read(&raw);
+    pulse_stats_decode(&raw, st.sys_clk_hz, pulse_counter_div(), &st.delivered);
+    if (run_complete)
+    {
+        // Berhenti sendiri: tepat st.periods periode, tanpa bergantung jam CPU
+        st.delivered.expected = expected_pulses((uint64_t)st.periods * st.plan.period_cycles);
+        return;
+    }
+    uint64_t run_sys = (st.stop_us - st.start_us) * st.sys_clk_hz / 1000000u;
+    st.delivered.expected = expected_pulses(run_sys * TIMING_CLKDIV_ONE / st.clkdiv_fixed);
+}
+
+static timing_status_t compile_pattern(const pulse_engine_config_t *cfg)
+{
+    if (cfg->pattern != NULL)
+    {
+        // Pola bebas dari core 0: tidak ada rencana A..D, hanya periode tabel
+        timing_status_t status = pattern_compile_auto(cfg->pattern, st.sys_clk_hz, st.event_overhead,
+                                                      &st.clkdiv_fixed, &pattern_table);
+        st.plan = (timing_plan_t){0};
+        st.plan.period_cycles = pattern_table.period_cycles;
+        st.plan.period_ns = (uint32_t)timing_cycles_to_ns(pattern_table.period_cycles,
+                                                          st.sys_clk_hz, st.clkdiv_fixed);
+        return status;
+    }
+
+    // Preset bipolar: rencana A..D tetap disusun untuk validasi dan tampilan,
+    // lalu pola disusun pada divider yang sama
+    timing_status_t status = timing_compile_auto(&cfg->timing, st.sys_clk_hz, st.event_overhead,
+                                                 &st.clkdiv_fixed, &st.plan);
+    if (status != TIMING_OK)
+        return status;
+    status = pattern_bipolar(&preset_pattern, &cfg->timing);
+    if (status != TIMING_OK)
+        return status;
+    return pattern_compile(&preset_pattern, st.sys_clk_hz, st.clkdiv_fixed, st.event_overhead,
+                           &pattern_table);
+}
+
+// Satu kanal grup per pasangan. Tabel pasangan pertama disalin ke
+// pattern_table untuk pulsa CH1 yang diharapkan dan tampilan periode.
+static timing_status_t configure_pairs(const pulse_engine_config_t *cfg)
+{
+    timing_status_t status = channel_group_init(&pair_group, PE_GROUP_SYNC_PIN, cfg->pair_count);
+    for (uint i = 0; status == TIMING_OK && i < cfg->pair_count; i++)
+        status = channel_group_add(&pair_group, pin_base + 2 * i, 2, cfg->pairs[i]);
+    st.pairs = pair_group.count;
+    if (status != TIMING_OK)
+    {
+        release_pairs();
+        return status;
+    }
+
+    pattern_table.length = pair_group.ch[0].length;
+    pattern_table.period_cycles = pair_group.ch[0].period_cycles;
+    memcpy(pattern_table.words, pair_group.tables[0], pattern_table.length * sizeof(uint32_t));
+    st.pattern_events = pattern_table.length;
+    st.clkdiv_fixed = pair_group.clkdiv_fixed;
+    st.plan = (timing_plan_t){0};
+    st.plan.period_cycles = pattern_table.period_cycles;
+    st.plan.period_ns = (uint32_t)timing_cycles_to_ns(pattern_table.period_cycles, st.sys_clk_hz,
+                                                      st.clkdiv_fixed);
+    return TIMING_OK;
+}
+
+static void engine_configure(void)
+{
+    pulse_engine_config_t cfg = pending_config;
+    release_pairs();
+    st.pairs = 0;
+
+    // Pilih program lebih dulu: overhead per event dibutuhkan perencana
+    select_program(cfg.constant_params && cfg.pair_count == 0);
+    st.external_trigger = cfg.external_trigger && cfg.pair_count == 0;
+
+    st.sys_clk_hz = clock_get_hz(clk_sys);
+    st.duration_ms = cfg.duration_ms;
+    st.pattern_events = 0;
+    st.periods = st.periods_done = 0;
+    pattern_ring = false;
+    capture_pairs = 0;
+    logic_capture = cfg.logic_capture && cfg.pair_count == 0;
+
+    // Parameter konstan tanpa tangkapan: program terurai bila muat di memori
+    // instruksi yang tersisa bersama mesin pola; selain itu program loop
+    unroll_program_t next;
+    timing_plan_t unrolled_plan;
+    if (cfg.pair_count > 0)
+    {
+        // Dihentikan menurut waktu: transfer count ring DMA grup maksimum
+        st.timing_status = configure_pairs(&cfg);
+    }
+    else if (st.static_program && cfg.capture_pairs == 0 &&
+        unroll_compile(&cfg.timing, st.sys_clk_hz, UNROLL_MAX_INSTRUCTIONS - pattern_engine_program.length,
+                       &unrolled_plan, &next) == TIMING_OK &&
+        load_unrolled(&next))
+    {
+        // Event minimal satu siklus, tanpa FIFO/DMA per periode, clkdiv 1
+        st.unrolled = true;
+        st.program_length = unrolled.length;
+        st.event_overhead = UNROLL_EVENT_OVERHEAD;
+        st.clkdiv_fixed = TIMING_CLKDIV_ONE;
+        st.plan = unrolled_plan;
+        st.timing_status = TIMING_OK;
+    }
+    else if (st.static_program)
+    {
+        load_counted();
+        st.timing_status = timing_compile_auto(&cfg.timing, st.sys_clk_hz, st.event_overhead,
+                                               &st.clkdiv_fixed, &st.plan);
+        // Event A dan C membawa "irq" tangkapan: Y = N pulsa - PULSE_EXTRA
+        if (st.timing_status == TIMING_OK && st.plan.delay[0] < signal_generator_counted_PULSE_EXTRA)
+            st.timing_status = TIMING_ERR_EVENT_TOO_SHORT;
+        // Event D program terhitung membawa pull/mov/jmp tambahan
+        if (st.timing_status == TIMING_OK && st.plan.delay[3] <= signal_generator_counted_D_EXTRA)
+            st.timing_status = TIMING_ERR_PERIOD_TOO_SHORT;
+        counted_word = ~(st.plan.delay[3] - signal_generator_counted_D_EXTRA);
+        capture_pairs = cfg.capture_pairs;
+    }
+    else
+    {
+        st.timing_status = compile_pattern(&cfg);
+        if (st.timing_status == TIMING_OK)
+            pattern_ring = pattern_table_pad_pow2(&pattern_table, st.event_overhead, PATTERN_MAX_EVENTS);
+        if (st.timing_status == TIMING_OK)
+            st.pattern_events = pattern_table.length;
+    }
+    st.resolution_ps = timing_resolution_ps(st.sys_clk_hz, st.clkdiv_fixed);
+
+    // Durasi -> jumlah periode utuh; 0 = dihentikan menurut waktu (tabel pola
+    // tidak dapat dipadatkan atau transfer count DMA tidak cukup)
+    if (st.timing_status == TIMING_OK)
+    {
+        uint32_t periods = timing_periods_for_duration(st.duration_ms, st.sys_clk_hz, st.clkdiv_fixed,
+                                                       st.plan.period_cycles);
+        if (st.static_program)
+            st.periods = periods;
+        else if (st.pairs == 0 && pattern_ring && (uint64_t)periods * pattern_table.length <= UINT32_MAX)
+            st.periods = periods;
+        pattern_ring = !st.static_program && st.periods > 0;
+    }
+
+    if (st.timing_status == TIMING_OK)
+    {
+        pio_sm_config c = get_program_config();
+        sm_config_set_clkdiv_int_frac8(&c, st.clkdiv_fixed >> 8, st.clkdiv_fixed & 0xff);
+        pio_sm_init(pio, sm, program_entry(), &c);
+        st.state = PE_STATE_CONFIGURED;
+    }
+    else
+    {
+        st.state = PE_STATE_ERROR;
+    }
+    publish();
+    multicore_fifo_push_blocking(st.timing_status);
+}
+
+static void __not_in_flash_func(engine_park)(void)
+{
+    // Seluruh loop ini berjalan dari RAM dengan interupsi mati sehingga core 0
+    // bebas menghapus/memprogram flash atau mengganti clk_sys. Versi inline
+    // FIFO SDK tidak memanggil kode di flash; push juga menjalankan __sev().
+    uint32_t ints = save_and_disable_interrupts();
+    multicore_fifo_push_blocking_inline(PE_STATE_PARKED);
+    while (multicore_fifo_pop_blocking_inline() != PE_CMD_UNPARK)
+        tight_loop_contents();
+    restore_interrupts(ints);
+}
+
+// Picu eksternal: SM sudah aktif di "wait 1 pin 0". Core 1 memantau PC SM
+// dalam loop sibuk (tanpa WFE: tidak ada kejadian yang membangunkan saat
+// pin berubah) sambil tetap melayani perintah; waktu mulai dicatat saat SM
+// meninggalkan instruksi tunggu, dengan resolusi satu putaran loop. Hanya
+// start_us yang bergantung pada loop ini; tepi pulsa sepenuhnya diatur SM.
+// Mengembalikan false bila proses dibatalkan sebelum picu datang.
+static bool engine_wait_trigger(void)
+{
+    uint wait_pc = trigger_wait_pc();
+    for (;;)
+    {
+        if (pio_sm_get_pc(pio, sm) != wait_pc)
+        {
+            st.start_us = time_us_64();
+            return true;
+        }
+        if (!multicore_fifo_rvalid())
+            continue;
+        uint32_t cmd = multicore_fifo_pop_blocking();
+        if (cmd == PE_CMD_QUERY || cmd == PE_CMD_PARK)
+        {
+            // Parkir juga ditolak: picu bisa datang kapan saja
+            multicore_fifo_push_blocking(PE_STATE_ARMED);
+        }
+        else if (cmd == PE_CMD_STOP || cmd == PE_CMD_CONFIGURE)
+        {
+            engine_halt();
+            st.state = PE_STATE_ABORTED;
+            publish();
+            if (cmd == PE_CMD_CONFIGURE)
+                engine_configure();
+            return false;
+        }
+    }
+}
+
+static void engine_run(void)
+{
+    if (st.state != PE_STATE_CONFIGURED)
+        return;
+
+    if (st.unrolled)
+    {
+        // Program terurai: satu kata hitungan periode untuk Y, tanpa DMA
+        pio_sm_put(pio, sm, st.periods - 1);
+    }
+    else if (st.static_program)
+    {
+        // Program terhitung: N pulsa dan N dead time dimuat sekali, lalu DMA
+        // mengirim satu kata sisa periode per periode
+        pio_sm_put(pio, sm, st.plan.delay[0] - signal_generator_counted_PULSE_EXTRA);
+        pio_sm_put(pio, sm, st.plan.delay[1]);
+        start_counted_dma();
+        pulse_capture_arm(capture_pairs);
+    }
+    else if (st.pairs == 0)
+    {
+        // Tabel pola sudah disusun saat konfigurasi: mulai umpan lebih dulu
+        // agar TX FIFO sudah terisi saat SM berjalan
+        start_feed_dma();
+    }
+
+    // Penghitung aktif sebelum SM agar tepi naik pertama tidak terlewat
+    run_complete = false;
+    st.periods_done = 0;
+    st.delivered = (pulse_report_t){0};
+    st.fifo_samples = st.fifo_underruns = 0;
+    tx_stalled();
+    pulse_counter_arm(st.duration_ms, st.sys_clk_hz);
+    if (logic_capture)
+        logic_analyzer_arm(true);
+    st.start_us = time_us_64();
+    if (st.pairs > 0)
+        channel_group_start(&pair_group); // SM mesin pulsa tetap diam
+    else
+        pio_sm_set_enabled(pio, sm, true);
+    st.stop_us = 0;
+    if (st.external_trigger)
+    {
+        st.state = PE_STATE_ARMED;
+        publish();
+        if (!engine_wait_trigger())
+            return;
+        // Sampel TXSTALL pertama tidak boleh menghitung waktu tunggu picu
+        tx_stalled();
+    }
+    st.state = PE_STATE_RUNNING;
+    publish();
+
+    // Proses terhitung berakhir sendiri di batas periode (IRQ PIO, atau kata
+    // henti mesin pola yang diperiksa setiap 10 us setelah perkiraan akhir).
+    // Tenggat waktu hanya cadangan; tanpa hitungan periode tenggat itulah
+    // yang menghentikan proses. Core 0 dan handler IRQ membangunkan WFE.
+    uint64_t run_us = (uint64_t)st.periods * st.plan.period_ns / 1000u;
+    uint64_t end_us = st.start_us + run_us;
+    uint64_t deadline = st.periods ? end_us + st.plan.period_ns / 1000u + 10000u
+                                   : st.start_us + (uint64_t)st.duration_ms * 1000u;
+    uint64_t next_sample = st.start_us + PE_FIFO_SAMPLE_US;
+    for (;;)
+    {
+        uint64_t now = time_us_64();
+        // Mesin pola terhitung tertahan di FIFO kosong setelah kata henti:
+        // sampel berhenti di perkiraan akhir
+        bool sampling = !pattern_ring || now < end_us;
+        if (sampling && now >= next_sample)
+        {
+            sample_fifo();
+            next_sample = now + PE_FIFO_SAMPLE_US;
+        }
+        if (pattern_ring && now >= end_us && !run_complete && pattern_drained())
+        {
+            st.stop_us = now;
+            run_complete = true;
+        }
+        if (run_complete || now >= deadline)
+        {
+            if (!run_complete && sampling)
+                sample_fifo();
+            engine_halt();
+            st.state = PE_STATE_DONE;
+            break;
+        }
+
+        if (!multicore_fifo_rvalid())
+        {
+            uint64_t wake = deadline;
+            if (pattern_ring)
+                wake = now < end_us ? end_us : now + 10u;
+            if (sampling && next_sample < wake)
+                wake = next_sample;
+            best_effort_wfe_or_timeout(from_us_since_boot(wake));
+            continue;
+        }
+        uint32_t cmd = multicore_fifo_pop_blocking();
+
+        if (cmd == PE_CMD_STOP)
+        {
+            if (sampling)
+                sample_fifo();
+            engine_halt();
+            st.state = PE_STATE_ABORTED;
+            break;
+        }
+        if (cmd == PE_CMD_QUERY || cmd == PE_CMD_PARK)
+        {
+            // Parkir ditolak selama berjalan: balasan bukan PE_STATE_PARKED
+            multicore_fifo_push_blocking(PE_STATE_RUNNING);
+        }
+        else if (cmd == PE_CMD_CONFIGURE)
+        {
+            // Konfigurasi ulang selama berjalan menghentikan proses lebih dulu
+            engine_halt();
+            st.state = PE_STATE_ABORTED;
+            publish();
+            engine_configure();
+            return;
+        }
+    }
+    publish();
+}
+
+static void core1_main(void)
+{
+    engine_init_hw();
+    st.state = PE_STATE_IDLE;
+    publish();
+
+    for (;;)
+    {
+        uint32_t cmd = multicore_fifo_pop_blocking();
+        switch (cmd)
+        {
+        case PE_CMD_CONFIGURE:
+            engine_configure();
+            break;
+        case PE_CMD_START:
+            engine_run();
+            break;
+        case PE_CMD_QUERY:
+            multicore_fifo_push_blocking(st.state);
+            break;
+        case PE_CMD_PARK:
+        {
+            pe_state_t prev = st.state;
+            st.state = PE_STATE_PARKED;
+            publish();
+            engine_park();
+            st.state = prev;
+            publish();
+            break;
+        }
+        default: // PE_CMD_STOP/UNPARK saat diam: tidak ada yang dilakukan
+            break;
+        }
+    }
+}
+
+// ===================== API CORE 0 =====================
+void pulse_engine_launch(PIO pio_instance, uint pin)
+{
+    pio = pio_instance;
+    pin_base = pin;
+    multicore_launch_core1(core1_main);
+}
+
+timing_status_t pulse_engine_configure(const pulse_engine_config_t *cfg)
+{
+    pending_config = *cfg;
+    __dmb();
+    multicore_fifo_push_blocking(PE_CMD_CONFIGURE);
+    return (timing_status_t)multicore_fifo_pop_blocking();
+}
+
+void pulse_engine_start(void)
+{
+    multicore_fifo_push_blocking(PE_CMD_START);
+}
+
+void pulse_engine_stop(void)
+{
+    multicore_fifo_push_blocking(PE_CMD_STOP);
+}
+
+pe_state_t pulse_engine_query(void)
+{
+    multicore_fifo_push_blocking(PE_CMD_QUERY);
+    return (pe_state_t)multicore_fifo_pop_blocking();
+}
+
+bool pulse_engine_park(void)
+{
+    multicore_fifo_push_blocking(PE_CMD_PARK);
+    return multicore_fifo_pop_blocking() == PE_STATE_PARKED;
+}
+
+void pulse_engine_unpark(void)
+{
+    multicore_fifo_push_blocking(PE_CMD_UNPARK);
+}
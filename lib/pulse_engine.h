@@ -0,0 +1,158 @@
+#ifndef PULSE_ENGINE_H
+#define PULSE_ENGINE_H
+
+/**
+ * Mesin pulsa di core 1
+ *
+ * Core 1 memiliki PIO (signal_generator_counted dan pattern_engine) dan channel
+ * DMA umpan FIFO sepenuhnya. Core 0 (UI, LCD, flash) hanya berbicara lewat FIFO
+ * multicore dengan perintah di bawah, dan membaca status lewat mailbox
+ * seqlock yang hanya ditulis core 1, sehingga tidak ada variabel bersama
+ * yang dibaca setengah jadi. Pulsa CH1 yang benar-benar keluar dihitung di
+ * blok PIO lain (pulse_counter) dan dilaporkan saat SM dimatikan.
+ *
+ * Durasi diubah menjadi jumlah periode utuh saat konfigurasi. SM berhenti
+ * sendiri setelah periode terakhir dengan keempat pin LOW di batas periode,
+ * sehingga proses tidak pernah terpotong di tengah pulsa; hanya STOP (dan
+ * tabel pola yang tidak dapat dipadatkan ke 2^n kata) yang memotong SM.
+ *
+ * Picu eksternal: dengan external_trigger SM diaktifkan di instruksi
+ * "wait 1 pin 0" dan proses baru dimulai pada tepi naik pin picu masuk,
+ * sehingga beberapa pengendali yang berbagi satu sinyal picu mulai dalam
+ * selisih sub-mikrodetik. Latensi tepi picu -> tepi naik CH1 pertama tetap:
+ * 2 siklus clk_sys sinkronisasi input GPIO + TRIGGER_LATENCY siklus SM
+ * (signal_generator_counted), dengan jitter satu siklus SM (clkdiv siklus
+ * clk_sys) karena tepi picu asinkron terhadap jam SM. Program statis
+ * menyalakan pin picu keluar bersama CH1 setiap periode (lebar = lebar
+ * pulsa) untuk memicu unit berikutnya atau osiloskop; mesin pola tidak
+ * punya bit mask untuk pin itu. Picu hanya menyelaraskan awal proses:
+ * sesudahnya tiap unit berjalan dengan kristalnya sendiri. Lihat
+ * "mgc_sim trigger" untuk hasil pengukuran di simulator.
+ *
+ * Program terurai: untuk parameter konstan tanpa tangkapan, core 1 lebih
+ * dulu mencoba program yang disusun lib/pio_unroll.h pada clkdiv 1 (event
+ * minimal satu siklus, tanpa FIFO/DMA per periode). Program itu menggantikan
+ * signal_generator_counted di memori instruksi selama terkonfigurasi, jadi
+ * hanya dipakai bila muat di ruang yang tersisa bersama mesin pola; bila
+ * tidak (periode panjang di frekuensi rendah) dipakai program loop seperti
+ * sebelumnya. Lihat "mgc_sim unroll".
+ *
+ * Uji mandiri: dengan logic_capture penganalisis logika di blok PIO
+ * penghitung dipersenjatai bersama penghitung pulsa dan dihentikan di
+ * engine_halt(); core 0 membaca tangkapannya setelah proses selesai.
+ *
+ * Pasangan independen: dengan pair_count > 0 keempat kanal dibagi menjadi
+ * pasangan elektroda GP6/GP7 dan GP8/GP9, masing-masing dengan pola dan
+ * frekuensi sendiri, sebagai grup kanal (lib/channel_group.h) dengan start
+ * sinkron pada PE_GROUP_SYNC_PIN. SM mesin pulsa diam; proses dihentikan
+ * menurut waktu dan penghitung pulsa mengamati CH1 milik pasangan pertama.
+ * Underrun FIFO TX hanya disampel untuk SM mesin pulsa, jadi tetap 0.
+ */
+
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "signal_timing.h"
+#include "pattern.h"
+#include "pulse_stats.h"
+
+// Perintah FIFO multicore (core 0 -> core 1). Balasan (core 1 -> core 0)
+// hanya untuk PE_CMD_CONFIGURE, PE_CMD_QUERY dan PE_CMD_PARK.
+typedef enum
+{
+    PE_CMD_CONFIGURE = 1, // Baca pulse_engine_config_t, susun rencana; balas timing_status_t
+    PE_CMD_START,         // Mulai rencana yang sudah dikonfigurasi
+    PE_CMD_STOP,          // Hentikan segera (abort)
+    PE_CMD_QUERY,         // Balas pe_state_t terkini
+    PE_CMD_PARK,          // Core 1 menunggu di RAM selama flash ditulis/clock diubah
+    PE_CMD_UNPARK,
+} pe_cmd_t;
+
+typedef enum
+{
+    PE_STATE_IDLE = 0,
+    PE_STATE_CONFIGURED, // Rencana valid, siap dimulai
+    PE_STATE_RUNNING,
+    PE_STATE_DONE,    // Selesai: jumlah periode tercapai (atau durasi habis)
+    PE_STATE_ABORTED, // Dihentikan oleh PE_CMD_STOP
+    PE_STATE_ERROR,   // Konfigurasi terakhir ditolak (lihat timing_status)
+    PE_STATE_PARKED,
+    PE_STATE_ARMED, // SM aktif, menunggu tepi naik pin picu masuk
+} pe_state_t;
+
+// Pin picu relatif terhadap pin_base pulse_engine_launch()
+#define PE_TRIGGER_OUT_OFFSET 4 // GP10: HIGH bersama pulsa CH1 (program statis)
+#define PE_TRIGGER_IN_OFFSET 5  // GP11: pull-down, tepi naik memulai proses
+
+// Pasangan independen: dua pin per pasangan mulai dari pin_base
+#define PE_MAX_PAIRS 2
+#define PE_GROUP_SYNC_PIN 22 // Pin sinkron grup kanal (SIO, tidak perlu tersambung)
+
+typedef struct
+{
+    timing_request_t timing;
+    uint32_t duration_ms;
+    bool constant_params; // true: program statis, false: mesin pola + DMA
+    // Mesin pola saja: pola bebas yang disusun core 1 saat konfigurasi (harus
+    // tetap valid sampai pulse_engine_configure() kembali). NULL: preset
+    // bipolar dari 'timing'.
+    const pattern_t *pattern;
+    bool external_trigger; // START mempersenjatai SM; proses mulai pada tepi picu
+    // Program statis saja: pasangan arus/tegangan yang ditangkap per event A
+    // dan C (0: mati, maks. CAPTURE_MAX_PAIRS; lihat lib/pulse_capture.h)
+    uint8_t capture_pairs;
+    // Uji mandiri: penganalisis logika (lib/logic_analyzer.h) merekam GP6..GP9
+    // sejak tepi naik CH1 pertama pada clkdiv 1 (A..C periode pertama)
+    bool logic_capture;
+    // Pasangan independen: pola dua pin per pasangan (harus tetap valid sampai
+    // pulse_engine_configure() kembali). 0: mesin pulsa tunggal; 'timing',
+    // 'pattern', picu dan tangkapan diabaikan bila > 0.
+    uint8_t pair_count;
+    const pattern_t *pairs[PE_MAX_PAIRS];
+} pulse_engine_config_t;
+
+typedef struct
+{
+    pe_state_t state;
+    timing_status_t timing_status;
+    timing_plan_t plan;
+    uint32_t sys_clk_hz;
+    uint32_t clkdiv_fixed;
+    uint32_t resolution_ps;
+    uint32_t event_overhead;
+    bool static_program;
+    bool unrolled;           // Program statis terurai (lib/pio_unroll.h)
+    uint32_t program_length; // Instruksi program terurai (0 untuk program lain)
+    uint32_t pattern_events; // Panjang tabel pola (0 untuk program statis)
+    uint32_t pairs;          // Pasangan independen yang berjalan (0: mesin pulsa tunggal)
+    uint32_t duration_ms;
+    uint32_t periods;      // Periode yang dijalankan (0: dihentikan menurut waktu)
+    uint32_t periods_done; // Periode yang sudah dimulai SM saat berhenti
+    bool external_trigger;
+    uint64_t start_us; // time_us_64() saat SM diaktifkan (picu: saat picu terlihat)
+    uint64_t stop_us;  // time_us_64() saat SM dimatikan (selesai/abort)
+    pulse_report_t delivered; // Pulsa CH1 terukur vs diharapkan, diisi saat SM dimatikan
+    // Underrun FIFO TX: FDEBUG.TXSTALL disampel tiap PE_FIFO_SAMPLE_US selama
+    // berjalan. Satu underrun = satu sampel yang menemukan SM pernah tertahan
+    // FIFO kosong (event memanjang), ditambah satu bila program terhitung
+    // berhenti sebelum periode terakhir karena DMA terlambat.
+    uint32_t fifo_samples;
+    uint32_t fifo_underruns;
+} pulse_engine_status_t;
+
+#define PE_FIFO_SAMPLE_US 1000u
+
+// Jalankan core 1 dan inisialisasi PIO/DMA di sana. Dipanggil sekali dari core 0.
+void pulse_engine_launch(PIO pio, uint pin_base);
+
+// API core 0. configure/query/park menunggu balasan core 1.
+timing_status_t pulse_engine_configure(const pulse_engine_config_t *cfg);
+void pulse_engine_start(void);
+void pulse_engine_stop(void);
+pe_state_t pulse_engine_query(void);
+bool pulse_engine_park(void); // false bila sedang berjalan (tidak diparkir)
+void pulse_engine_unpark(void);
+
+// Salinan status yang konsisten (seqlock, tanpa kunci)
+void pulse_engine_status(pulse_engine_status_t *out);
+
+#endif
@@ -0,0 +1,56 @@
+#include "pulse_stats.h"
+
+uint32_t pulse_stats_counter_div(uint64_t duration_ms, uint32_t sys_clk_hz)
+{
+    // Siklus yang dapat dihitung X pada divider 1 sebelum habis
+    uint64_t capacity = (uint64_t)UINT32_MAX * PULSE_COUNTER_CYCLES_PER_DEC;
+    uint64_t cycles = duration_ms * sys_clk_hz / 1000u;
+    uint64_t div = cycles / capacity + 1;
+    return div > 65535u ? 65535u : (uint32_t)div;
+}
+
+static uint64_t cycles_to_ns(uint64_t cycles, uint32_t sys_clk_hz)
+{
+    // Dipecah agar tidak melimpah untuk jalan puluhan detik pada 250 MHz
+    return cycles / sys_clk_hz * 1000000000ull + (cycles % sys_clk_hz) * 1000000000ull / sys_clk_hz;
+}
+
+void pulse_stats_decode(const pulse_raw_t *raw, uint32_t sys_clk_hz, uint32_t counter_div,
+                        pulse_report_t *out)
+{
+    out->pulses = raw->pulses;
+
+    // Loop HIGH mengambil sampel tiap 2 siklus mulai 2 siklus setelah tepi
+    // naik: pulsa h siklus menghasilkan floor(h / 2) decrement. Setengah
+    // siklus per pulsa ditambahkan agar galat terpusat (+-0.5 siklus/pulsa).
+    uint64_t high = ((uint64_t)raw->high_dec * PULSE_COUNTER_CYCLES_PER_DEC + raw->pulses / 2) * counter_div;
+    out->on_time_ns = cycles_to_ns(high, sys_clk_hz);
+
+    // Rentang: galat maks. 1 siklus penghitung total (bukan per pulsa)
+    out->mean_period_ns = 0;
+    if (raw->pulses >= 2)
+    {
+        uint64_t span = ((uint64_t)raw->span_dec * PULSE_COUNTER_CYCLES_PER_DEC +
+                         2ull * (raw->pulses - 1)) * counter_div;
+        out->mean_period_ns = (uint32_t)(cycles_to_ns(span, sys_clk_hz) / (raw->pulses - 1));
+    }
+}
+
+uint32_t pulse_stats_period_error_ns(uint32_t pulses, uint32_t sys_clk_hz, uint32_t counter_div)
+{
+    if (pulses < 2)
+        return 0;
+    // Rentang +-1 siklus penghitung total (lihat pulse_stats_decode), dibagi
+    // rata ke interval, ditambah pembulatan ke bawah ke ns
+    uint64_t ns = ((uint64_t)counter_div * 1000000000ull + sys_clk_hz - 1) / sys_clk_hz;
+    return (uint32_t)((ns + pulses - 2) / (pulses - 1)) + 1;
+}
+
+uint32_t pulse_stats_expected(uint64_t run_ns, uint32_t period_ns, uint32_t rises_per_period)
+{
+    if (period_ns == 0)
+        return 0;
+    // Pola dimulai dengan tepi naik: setiap periode yang dimulai terhitung
+    uint64_t periods = (run_ns + period_ns - 1) / period_ns;
+    return (uint32_t)(periods * rises_per_period);
+}
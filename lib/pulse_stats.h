@@ -0,0 +1,44 @@
+#ifndef PULSE_STATS_H
+#define PULSE_STATS_H
+
+#include <stdint.h>
+
+// Telemetri dosis: mengubah hitungan mentah SM pulse_counter/pulse_span
+// (pulse_counter.pio) menjadi jumlah pulsa, waktu ON dan periode rata-rata,
+// lalu membandingkannya dengan jumlah yang diharapkan dari parameter. Tidak
+// bergantung pada Pico SDK sehingga dikalibrasi terhadap simulator PIO
+// (mgc_sim counter).
+
+// Setiap decrement X mewakili 2 siklus SM penghitung
+#define PULSE_COUNTER_CYCLES_PER_DEC 2u
+
+typedef struct
+{
+    uint32_t pulses;   // pulse_counter: 0xFFFFFFFF - Y
+    uint32_t high_dec; // pulse_counter: 0xFFFFFFFF - X
+    uint32_t span_dec; // pulse_span: 0xFFFFFFFF - Y (salinan X di tepi naik terakhir)
+} pulse_raw_t;
+
+typedef struct
+{
+    uint32_t pulses;         // Tepi naik CH1 yang benar-benar keluar
+    uint32_t expected;       // Dari periode dan lama jalan sebenarnya
+    uint64_t on_time_ns;     // Total waktu CH1 HIGH
+    uint32_t mean_period_ns; // Tepi naik pertama -> terakhir / (pulsa - 1); 0 bila < 2 pulsa
+} pulse_report_t;
+
+// Divider integer SM penghitung agar X tidak habis selama 'duration_ms'
+// (resolusi = 2 x divider siklus clk_sys per pulsa)
+uint32_t pulse_stats_counter_div(uint64_t duration_ms, uint32_t sys_clk_hz);
+
+void pulse_stats_decode(const pulse_raw_t *raw, uint32_t sys_clk_hz, uint32_t counter_div,
+                        pulse_report_t *out);
+
+// Galat maks. mean_period_ns (ns, dibulatkan ke atas) untuk 'pulses' pulsa
+uint32_t pulse_stats_period_error_ns(uint32_t pulses, uint32_t sys_clk_hz, uint32_t counter_div);
+
+// Tepi naik CH1 yang diharapkan selama 'run_ns' bila pola dimulai dengan
+// tepi naik di t = 0 dan memiliki 'rises_per_period' tepi naik per periode
+uint32_t pulse_stats_expected(uint64_t run_ns, uint32_t period_ns, uint32_t rises_per_period);
+
+#endif
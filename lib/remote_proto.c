@@ -0,0 +1,413 @@
+#include "remote_proto.h"
+#include <string.h>
+#include "crc32.h"
+
+// ===================== COBS =====================
+// Penulis bertahap: pesan dikodekan langsung dari potongannya (kepala,
+// payload, CRC) tanpa disalin dulu ke satu buffer pesan
+typedef struct
+{
+    uint8_t *dst;
+    size_t code_at, out;
+    uint8_t code;
+} cobs_writer_t;
+
+static void cobs_begin(cobs_writer_t *w, uint8_t *dst)
+{
+    w->dst = dst;
+    w->code_at = 0;
+    w->out = 1;
+    w->code = 1;
+}
+
+static void cobs_put(cobs_writer_t *w, const uint8_t *src, size_t len)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        if (src[i] != 0)
+        {
+            w->dst[w->out++] = src[i];
+            w->code++;
+        }
+        if (src[i] == 0 || w->code == 0xff)
+        {
+            // Tutup blok: byte kode = jarak ke nol (atau blok penuh 254 byte)
+            w->dst[w->code_at] = w->code;
+            w->code_at = w->out++;
+            w->code = 1;
+        }
+    }
+}
+
+static size_t cobs_end(cobs_writer_t *w)
+{
+    w->dst[w->code_at] = w->code;
+    return w->out;
+}
+
+size_t cobs_encode(const uint8_t *src, size_t len, uint8_t *dst)
+{
+    cobs_writer_t w;
+    cobs_begin(&w, dst);
+    cobs_put(&w, src, len);
+    return cobs_end(&w);
+}
+
+size_t cobs_decode(const uint8_t *src, size_t len, uint8_t *dst)
+{
+    size_t in = 0, out = 0;
+    while (in < len)
+    {
+        uint8_t code = src[in++];
+        if (code == 0 || in + code - 1 > len)
+            return 0;
+        for (uint8_t i = 1; i < code; i++)
+        {
+            if (src[in] == 0)
+                return 0;
+            dst[out++] = src[in++];
+        }
+        // Blok pendek diikuti nol, kecuali di akhir bingkai
+        if (code != 0xff && in < len)
+            dst[out++] = 0;
+    }
+    return out;
+}
+
+// ===================== PESAN =====================
+static void put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    put_u16(p, (uint16_t)v);
+    put_u16(p + 2, (uint16_t)(v >> 16));
+}
+
+static uint16_t get_u16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t *p)
+{
+    return get_u16(p) | ((uint32_t)get_u16(p + 2) << 16);
+}
+
+static size_t encode_message(uint8_t cmd, uint8_t seq, const uint8_t *payload, size_t len, uint8_t *out)
+{
+    uint8_t head[2] = {cmd, seq}, crc[4];
+    put_u32(crc, crc32_update(crc32_update(0, head, 2), payload, len));
+
+    // Pembatas di depan menutup sisa teks printf yang belum diakhiri nol
+    cobs_writer_t w;
+    out[0] = 0;
+    cobs_begin(&w, out + 1);
+    cobs_put(&w, head, 2);
+    cobs_put(&w, payload, len);
+    cobs_put(&w, crc, 4);
+    size_t n = cobs_end(&w);
+    out[1 + n] = 0;
+    return n + 2;
+}
+
+size_t remote_encode(uint8_t cmd, uint8_t seq, const uint8_t *payload, size_t len, uint8_t *out)
+{
+    if (len > REMOTE_PAYLOAD_MAX)
+        len = REMOTE_PAYLOAD_MAX;
+    return encode_message(cmd, seq, payload, len, out);
+}
+
+// Pesan terpendek: perintah + seq + CRC. Hasil decode selalu lebih pendek
+// dari masukannya sehingga 'msg' cukup 'msg_max'.
+static bool decode_message(const uint8_t *frame, size_t len, uint8_t *msg, size_t *msg_len, size_t msg_max)
+{
+    if (len < 7 || len > msg_max + msg_max / 254 + 1)
+        return false;
+    size_t n = cobs_decode(frame, len, msg);
+    if (n < 6 || n > msg_max)
+        return false;
+    if (crc32_update(0, msg, n - 4) != get_u32(msg + n - 4))
+        return false;
+    *msg_len = n - 4;
+    return true;
+}
+
+bool remote_decode(const uint8_t *frame, size_t len, uint8_t *msg, size_t *msg_len)
+{
+    return decode_message(frame, len, msg, msg_len, REMOTE_MSG_MAX);
+}
+
+bool remote_decode_capture(const uint8_t *frame, size_t len, uint8_t *msg, size_t *msg_len)
+{
+    return decode_message(frame, len, msg, msg_len, REMOTE_CAPTURE_MSG_MAX);
+}
+
+void remote_put_status(const remote_status_t *st, uint8_t *out)
+{
+    out[0] = st->state;
+    out[1] = st->timing_status;
+    put_u32(out + 2, st->elapsed_ms);
+    put_u32(out + 6, st->duration_ms);
+    put_u32(out + 10, st->pulses);
+    put_u32(out + 14, st->expected);
+    put_u32(out + 18, st->mean_period_ns);
+    put_u32(out + 22, (uint32_t)st->on_time_ns);
+    put_u32(out + 26, (uint32_t)(st->on_time_ns >> 32));
+}
+
+bool remote_get_status(const uint8_t *in, size_t len, remote_status_t *st)
+{
+    if (len < REMOTE_STATUS_BYTES)
+        return false;
+    st->state = in[0];
+    st->timing_status = in[1];
+    st->elapsed_ms = get_u32(in + 2);
+    st->duration_ms = get_u32(in + 6);
+    st->pulses = get_u32(in + 10);
+    st->expected = get_u32(in + 14);
+    st->mean_period_ns = get_u32(in + 18);
+    st->on_time_ns = get_u32(in + 22) | ((uint64_t)get_u32(in + 26) << 32);
+    return true;
+}
+
+// ===================== PARAMETER =====================
+static const int32_t param_range[REMOTE_PARAM_COUNT][2] = {
+    [REMOTE_PARAM_FREQ_HZ] = {10, 500000},
+    [REMOTE_PARAM_PULSE_NS] = {10, 50000},
+    [REMOTE_PARAM_DURATION_S] = {1, 30},
+    [REMOTE_PARAM_PHASE_NS] = {10, 10000},
+    [REMOTE_PARAM_PRECISION] = {0, 1},
+    [REMOTE_PARAM_TRIGGER] = {0, 1},
+    [REMOTE_PARAM_CAPTURE] = {0, CAPTURE_MAX_PAIRS},
+    [REMOTE_PARAM_PROGRAM] = {0, 2},
+};
+
+bool remote_param_range(remote_param_t id, int32_t *min, int32_t *max)
+{
+    if ((unsigned)id >= REMOTE_PARAM_COUNT)
+        return false;
+    *min = param_range[id][0];
+    *max = param_range[id][1];
+    return true;
+}
+
+// ===================== DISPATCHER =====================
+void remote_init(remote_t *r, const remote_ops_t *ops)
+{
+    memset(r, 0, sizeof(*r));
+    r->ops = ops;
+}
+
+// Jalankan satu pesan; 'reply' diisi [hasil][data]
+static size_t dispatch(remote_t *r, uint8_t cmd, const uint8_t *p, size_t len, uint8_t *reply)
+{
+    const remote_ops_t *ops = r->ops;
+    remote_result_t res = REMOTE_OK;
+    size_t n = 1;
+
+    switch (cmd)
+    {
+    case REMOTE_CMD_PING:
+        if (len > REMOTE_PAYLOAD_MAX - 1)
+            len = REMOTE_PAYLOAD_MAX - 1;
+        memcpy(reply + 1, p, len);
+        n += len;
+        break;
+    case REMOTE_CMD_GET:
+    case REMOTE_CMD_SET:
+    {
+        if (len != (cmd == REMOTE_CMD_GET ? 1u : 5u))
+        {
+            res = REMOTE_ERR_LEN;
+            break;
+        }
+        if (p[0] >= REMOTE_PARAM_COUNT)
+        {
+            res = REMOTE_ERR_PARAM;
+            break;
+        }
+        remote_param_t id = (remote_param_t)p[0];
+        int32_t value = 0;
+        if (cmd == REMOTE_CMD_SET)
+        {
+            int32_t set = (int32_t)get_u32(p + 1), min, max;
+            remote_param_range(id, &min, &max);
+            res = set < min || set > max ? REMOTE_ERR_RANGE : ops->set_param(ops->ctx, id, set);
+        }
+        // SET membalas nilai yang kini berlaku
+        if (res == REMOTE_OK)
+            res = ops->get_param(ops->ctx, id, &value);
+        if (res == REMOTE_OK)
+        {
+            reply[1] = (uint8_t)id;
+            put_u32(reply + 2, (uint32_t)value);
+            n += 5;
+        }
+        break;
+    }
+    case REMOTE_CMD_START:
+    case REMOTE_CMD_SELFTEST:
+    {
+        uint8_t timing = 0;
+        if (cmd == REMOTE_CMD_SELFTEST && ops->selftest == NULL)
+        {
+            res = REMOTE_ERR_CMD;
+            break;
+        }
+        if (len != 0)
+            res = REMOTE_ERR_LEN;
+        else
+            res = cmd == REMOTE_CMD_START ? ops->start(ops->ctx, &timing) : ops->selftest(ops->ctx, &timing);
+        if (res == REMOTE_OK || res == REMOTE_ERR_TIMING)
+            reply[n++] = timing;
+        break;
+    }
+    case REMOTE_CMD_ABORT:
+        res = len == 0 ? ops->abort(ops->ctx) : REMOTE_ERR_LEN;
+        break;
+    case REMOTE_CMD_STATUS:
+    {
+        if (len != 0)
+        {
+            res = REMOTE_ERR_LEN;
+            break;
+        }
+        remote_status_t st;
+        ops->status(ops->ctx, &st);
+        remote_put_status(&st, reply + 1);
+        n += REMOTE_STATUS_BYTES;
+        break;
+    }
+    case REMOTE_CMD_STREAM:
+        if (len == 2)
+            r->stream_ms = get_u16(p);
+        else
+            res = REMOTE_ERR_LEN;
+        break;
+    case REMOTE_CMD_PERF:
+    {
+        if (ops->perf == NULL)
+        {
+            res = REMOTE_ERR_CMD;
+            break;
+        }
+        if (len != 2)
+        {
+            res = REMOTE_ERR_LEN;
+            break;
+        }
+        size_t data_len = 0;
+        res = ops->perf(ops->ctx, p[0], p[1], reply + 3, &data_len);
+        if (res == REMOTE_OK)
+        {
+            reply[1] = p[0];
+            reply[2] = p[1];
+            n += 2 + (data_len > REMOTE_PERF_DATA_MAX ? REMOTE_PERF_DATA_MAX : data_len);
+        }
+        break;
+    }
+    case REMOTE_CMD_TASKS:
+    {
+        if (ops->tasks == NULL)
+        {
+            res = REMOTE_ERR_CMD;
+            break;
+        }
+        if (len != 1)
+        {
+            res = REMOTE_ERR_LEN;
+            break;
+        }
+        size_t data_len = 0;
+        res = ops->tasks(ops->ctx, p[0], reply + 2, &data_len);
+        if (res == REMOTE_OK)
+        {
+            reply[1] = p[0];
+            n += 1 + (data_len > REMOTE_TASKS_DATA_MAX ? REMOTE_TASKS_DATA_MAX : data_len);
+        }
+        break;
+    }
+    default:
+        res = REMOTE_ERR_CMD;
+        break;
+    }
+
+    reply[0] = (uint8_t)res;
+    return res == REMOTE_OK || res == REMOTE_ERR_TIMING ? n : 1;
+}
+
+size_t remote_feed(remote_t *r, uint8_t byte, uint8_t *out)
+{
+    if (byte != 0)
+    {
+        if (r->rx_len < sizeof(r->rx))
+            r->rx[r->rx_len++] = byte;
+        else
+            r->rx_overflow = true;
+        return 0;
+    }
+
+    // Pembatas: proses isi bingkai (pembatas berurutan = bingkai kosong)
+    size_t len = r->rx_len;
+    bool overflow = r->rx_overflow;
+    r->rx_len = 0;
+    r->rx_overflow = false;
+    if (len == 0)
+        return 0;
+
+    uint8_t msg[REMOTE_MSG_MAX];
+    size_t msg_len;
+    if (overflow || !remote_decode(r->rx, len, msg, &msg_len))
+    {
+        r->dropped++;
+        return 0;
+    }
+    r->frames++;
+
+    uint8_t reply[REMOTE_PAYLOAD_MAX];
+    size_t n = dispatch(r, msg[0], msg + 2, msg_len - 2, reply);
+    return remote_encode(msg[0] | REMOTE_REPLY, msg[1], reply, n, out);
+}
+
+size_t remote_telemetry(remote_t *r, const remote_status_t *st, uint8_t *out)
+{
+    uint8_t payload[REMOTE_STATUS_BYTES];
+    remote_put_status(st, payload);
+    return remote_encode(REMOTE_EV_TELEMETRY, r->event_seq++, payload, sizeof(payload), out);
+}
+
+size_t remote_capture(remote_t *r, const uint8_t *payload, size_t len, uint8_t *out)
+{
+    if (len > CAPTURE_PAYLOAD_MAX)
+        len = CAPTURE_PAYLOAD_MAX;
+    return encode_message(REMOTE_EV_CAPTURE, r->event_seq++, payload, len, out);
+}
+
+// Event jejak memakai batas bingkai event tangkapan
+_Static_assert(TRACE_PAYLOAD_MAX <= CAPTURE_PAYLOAD_MAX, "payload jejak melebihi bingkai tangkapan");
+
+size_t remote_trace(remote_t *r, const uint8_t *payload, size_t len, uint8_t *out)
+{
+    if (len > TRACE_PAYLOAD_MAX)
+        len = TRACE_PAYLOAD_MAX;
+    return encode_message(REMOTE_EV_TRACE, r->event_seq++, payload, len, out);
+}
+
+_Static_assert(REMOTE_LOGIC_HEADER_BYTES + REMOTE_LOGIC_TEXT_MAX <= CAPTURE_PAYLOAD_MAX,
+               "payload uji mandiri melebihi bingkai tangkapan");
+
+size_t remote_logic(remote_t *r, uint32_t offset, remote_logic_status_t status, const char *text, size_t len,
+                    uint8_t *out)
+{
+    uint8_t payload[REMOTE_LOGIC_HEADER_BYTES + REMOTE_LOGIC_TEXT_MAX];
+    if (len > REMOTE_LOGIC_TEXT_MAX)
+        len = REMOTE_LOGIC_TEXT_MAX;
+    put_u32(payload, offset);
+    payload[4] = (uint8_t)status;
+    memcpy(payload + REMOTE_LOGIC_HEADER_BYTES, text, len);
+    return encode_message(REMOTE_EV_LOGIC, r->event_seq++, payload, REMOTE_LOGIC_HEADER_BYTES + len, out);
+}
@@ -0,0 +1,200 @@
+#ifndef REMOTE_PROTO_H
+#define REMOTE_PROTO_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "capture_frame.h"
+#include "trace_log.h"
+
+/**
+ * Protokol kendali biner lewat CDC USB
+ *
+ * Berbagi port CDC dengan printf (stdio USB). Setiap pesan berbentuk
+ * [perintah][seq][payload][CRC32 LE], dikodekan COBS lalu diapit byte 0x00.
+ * Teks printf tidak pernah mengandung 0x00, sehingga potongan di antara dua
+ * pembatas yang gagal CRC cukup dibuang oleh penerima (klien host
+ * menampilkannya sebagai log). Bilangan multi-byte little-endian.
+ *
+ * Parser berjalan per byte tanpa blok dan tanpa alokasi; perangkat diakses
+ * lewat remote_ops_t sehingga modul ini tidak bergantung pada Pico SDK dan
+ * diuji di host (mgc_sim remote, stand-in pty mgc_sim remote-pty).
+ */
+
+#define REMOTE_PAYLOAD_MAX 40
+#define REMOTE_MSG_MAX (2 + REMOTE_PAYLOAD_MAX + 4)
+// COBS menambah 1 byte per 254 byte data, ditambah dua pembatas 0x00
+#define REMOTE_FRAME_MAX (REMOTE_MSG_MAX + REMOTE_MSG_MAX / 254 + 3)
+
+// Event tangkapan membawa bingkai lib/capture_frame.h, jauh lebih panjang
+// dari perintah; hanya perangkat yang mengirimnya
+#define REMOTE_CAPTURE_MSG_MAX (2 + CAPTURE_PAYLOAD_MAX + 4)
+#define REMOTE_CAPTURE_FRAME_MAX (REMOTE_CAPTURE_MSG_MAX + REMOTE_CAPTURE_MSG_MAX / 254 + 3)
+
+typedef enum
+{
+    REMOTE_CMD_PING = 0x01, // payload dikembalikan apa adanya (ukur latensi)
+    REMOTE_CMD_GET,         // [id] -> [id][i32]
+    REMOTE_CMD_SET,         // [id][i32] -> [id][i32]
+    REMOTE_CMD_START,       // -> [timing_status_t]
+    REMOTE_CMD_ABORT,       // -> []
+    REMOTE_CMD_STATUS,      // -> remote_status_t
+    REMOTE_CMD_STREAM,      // [u16 interval ms, 0 = mati] -> []
+    REMOTE_CMD_PERF,        // [histogram][halaman] -> [histogram][halaman][data] (lib/perf_counters.h)
+    REMOTE_CMD_TASKS,       // [tugas] -> [tugas][data] (lib/scheduler.h)
+    REMOTE_CMD_SELFTEST,    // -> [timing_status_t]; hasil lewat REMOTE_EV_LOGIC
+} remote_cmd_t;
+
+// Data satu halaman REMOTE_CMD_PERF / REMOTE_CMD_TASKS maksimal
+#define REMOTE_PERF_DATA_MAX (REMOTE_PAYLOAD_MAX - 3)
+#define REMOTE_TASKS_DATA_MAX (REMOTE_PAYLOAD_MAX - 2)
+
+// Balasan: perintah | REMOTE_REPLY dengan seq yang sama; byte payload
+// pertama remote_result_t, data balasan hanya bila REMOTE_OK (START juga
+// menyertakan timing_status_t saat REMOTE_ERR_TIMING)
+#define REMOTE_REPLY 0x80
+// Event tanpa diminta: remote_status_t berkala selama berjalan (STREAM) dan
+// sekali saat proses berakhir. seq = nomor urut event.
+#define REMOTE_EV_TELEMETRY 0x40
+// Event tangkapan: satu bingkai arus/tegangan per event A/C selama proses
+// dengan REMOTE_PARAM_CAPTURE > 0 (payload capture_encode()). seq = nomor
+// urut event, berbagi penghitung dengan telemetri.
+#define REMOTE_EV_CAPTURE 0x41
+// Event jejak: rekaman log biner (payload trace_encode(), lib/trace_log.h)
+// yang dikuras saat mesin pulsa diam. seq = nomor urut event.
+#define REMOTE_EV_TRACE 0x42
+// Event uji mandiri: berkas VCD tangkapan penganalisis logika
+// (lib/logic_analysis.h) dalam potongan [offset u32][status u8][teks].
+// Potongan terakhir membawa hasil uji; offset = posisi teks dalam berkas.
+#define REMOTE_EV_LOGIC 0x43
+#define REMOTE_LOGIC_HEADER_BYTES 5
+#define REMOTE_LOGIC_TEXT_MAX (CAPTURE_PAYLOAD_MAX - REMOTE_LOGIC_HEADER_BYTES)
+
+typedef enum
+{
+    REMOTE_LOGIC_MORE = 0, // Berkas berlanjut di potongan berikutnya
+    REMOTE_LOGIC_PASS,
+    REMOTE_LOGIC_FAIL,
+} remote_logic_status_t;
+
+typedef enum
+{
+    REMOTE_OK = 0,
+    REMOTE_ERR_CMD,    // Perintah tidak dikenal
+    REMOTE_ERR_LEN,    // Panjang payload salah
+    REMOTE_ERR_PARAM,  // ID parameter tidak dikenal
+    REMOTE_ERR_RANGE,  // Nilai di luar rentang UI
+    REMOTE_ERR_BUSY,   // Proses sedang berjalan / tidak sedang berjalan
+    REMOTE_ERR_TIMING, // Parameter ditolak perencana waktu
+} remote_result_t;
+
+// Field ConfigData (tanpa magic)
+typedef enum
+{
+    REMOTE_PARAM_FREQ_HZ = 0,
+    REMOTE_PARAM_PULSE_NS,
+    REMOTE_PARAM_DURATION_S,
+    REMOTE_PARAM_PHASE_NS,
+    REMOTE_PARAM_PRECISION, // 0: 125 MHz, 1: 250 MHz
+    REMOTE_PARAM_TRIGGER,   // 0: mulai segera, 1: tunggu tepi naik picu masuk (GP11)
+    REMOTE_PARAM_CAPTURE,   // Pasangan sampel I/V per pulsa, 0: mati (tidak disimpan ke flash)
+    REMOTE_PARAM_PROGRAM,   // 0: program statis, 1: mesin pola + DMA, 2: pasangan independen
+                            // (GP6/GP7 parameter aktif, GP8/GP9 preset 1), tidak disimpan ke flash
+    REMOTE_PARAM_COUNT,
+} remote_param_t;
+
+// Rentang nilai yang diterima SET, sama dengan batas menu UI
+bool remote_param_range(remote_param_t id, int32_t *min, int32_t *max);
+
+typedef struct
+{
+    uint8_t state;         // pe_state_t
+    uint8_t timing_status; // timing_status_t konfigurasi terakhir
+    uint32_t elapsed_ms;
+    uint32_t duration_ms;
+    // Telemetri dosis (lib/pulse_stats.h); nol selama berjalan
+    uint32_t pulses;
+    uint32_t expected;
+    uint32_t mean_period_ns;
+    uint64_t on_time_ns;
+} remote_status_t;
+
+#define REMOTE_STATUS_BYTES 30
+
+// Perangkat di balik protokol (firmware: main.c, host: stand-in pty)
+typedef struct
+{
+    remote_result_t (*get_param)(void *ctx, remote_param_t id, int32_t *value);
+    remote_result_t (*set_param)(void *ctx, remote_param_t id, int32_t value);
+    remote_result_t (*start)(void *ctx, uint8_t *timing_status);
+    remote_result_t (*abort)(void *ctx);
+    void (*status)(void *ctx, remote_status_t *out);
+    // Opsional (NULL: REMOTE_ERR_CMD). Isi 'data' dan '*len'; REMOTE_ERR_PARAM
+    // bila histogram atau halaman tidak dikenal.
+    remote_result_t (*perf)(void *ctx, uint8_t hist, uint8_t page, uint8_t *data, size_t *len);
+    // Opsional seperti perf: statistik satu tugas penjadwal, REMOTE_ERR_PARAM
+    // setelah tugas terakhir
+    remote_result_t (*tasks)(void *ctx, uint8_t task, uint8_t *data, size_t *len);
+    // Opsional seperti perf: mulai uji mandiri, balasan seperti start
+    remote_result_t (*selftest)(void *ctx, uint8_t *timing_status);
+    void *ctx;
+} remote_ops_t;
+
+typedef struct
+{
+    const remote_ops_t *ops;
+    uint8_t rx[REMOTE_FRAME_MAX]; // Bingkai COBS yang sedang diterima
+    size_t rx_len;
+    bool rx_overflow; // Buang sampai pembatas berikutnya
+    uint16_t stream_ms;
+    uint8_t event_seq;
+
+    // Statistik
+    uint32_t frames;  // Pesan valid yang ditangani
+    uint32_t dropped; // Potongan gagal COBS/CRC (termasuk teks) atau terlalu panjang
+} remote_t;
+
+void remote_init(remote_t *r, const remote_ops_t *ops);
+
+// Umpankan satu byte yang diterima. Bila byte ini menutup pesan valid,
+// perintah dijalankan dan balasan berbingkai ditulis ke 'out' (minimal
+// REMOTE_FRAME_MAX byte); mengembalikan panjangnya, 0 bila tidak ada balasan.
+size_t remote_feed(remote_t *r, uint8_t byte, uint8_t *out);
+
+// Bingkai event telemetri berikutnya ke 'out'
+size_t remote_telemetry(remote_t *r, const remote_status_t *st, uint8_t *out);
+
+// Bingkai event tangkapan ke 'out' (minimal REMOTE_CAPTURE_FRAME_MAX byte);
+// 'len' maks. CAPTURE_PAYLOAD_MAX
+size_t remote_capture(remote_t *r, const uint8_t *payload, size_t len, uint8_t *out);
+
+// Bingkai event jejak ke 'out' (minimal REMOTE_CAPTURE_FRAME_MAX byte);
+// 'len' maks. TRACE_PAYLOAD_MAX
+size_t remote_trace(remote_t *r, const uint8_t *payload, size_t len, uint8_t *out);
+
+// Bingkai event uji mandiri ke 'out' (minimal REMOTE_CAPTURE_FRAME_MAX
+// byte); 'len' maks. REMOTE_LOGIC_TEXT_MAX
+size_t remote_logic(remote_t *r, uint32_t offset, remote_logic_status_t status, const char *text, size_t len,
+                    uint8_t *out);
+
+// Pesan lengkap -> bingkai berpembatas. 'len' maks. REMOTE_PAYLOAD_MAX.
+size_t remote_encode(uint8_t cmd, uint8_t seq, const uint8_t *payload, size_t len, uint8_t *out);
+
+// Isi satu bingkai (tanpa pembatas) -> pesan tanpa CRC. false bila COBS
+// rusak atau CRC salah.
+bool remote_decode(const uint8_t *frame, size_t len, uint8_t *msg, size_t *msg_len);
+
+// Seperti remote_decode() tetapi menerima juga event tangkapan, jejak dan
+// uji mandiri;
+// 'msg' minimal REMOTE_CAPTURE_MSG_MAX byte
+bool remote_decode_capture(const uint8_t *frame, size_t len, uint8_t *msg, size_t *msg_len);
+
+void remote_put_status(const remote_status_t *st, uint8_t *out);
+bool remote_get_status(const uint8_t *in, size_t len, remote_status_t *st);
+
+// COBS (Cheshire & Baker): hasil encode tanpa byte 0x00. decode
+// mengembalikan 0 bila masukan tidak valid.
+size_t cobs_encode(const uint8_t *src, size_t len, uint8_t *dst);
+size_t cobs_decode(const uint8_t *src, size_t len, uint8_t *dst);
+
+#endif
@@ -0,0 +1,147 @@
+#include "scheduler.h"
+
+void sched_init(sched_t *s, sched_task_t *tasks, uint32_t count, uint64_t (*clock_us)(void))
+{
+    s->task = tasks;
+    s->count = count;
+    s->clock_us = clock_us;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        tasks[i].deadline_us = SCHED_NEVER;
+        tasks[i].post_seq = tasks[i].seen_seq = 0;
+        tasks[i].posted_us = 0;
+    }
+    sched_reset_stats(s);
+}
+
+void sched_at(sched_t *s, uint32_t id, uint64_t at_us)
+{
+    if (id < s->count)
+        s->task[id].deadline_us = at_us;
+}
+
+void sched_cancel(sched_t *s, uint32_t id)
+{
+    sched_at(s, id, SCHED_NEVER);
+}
+
+void sched_post(sched_t *s, uint32_t id, uint64_t now_us)
+{
+    if (id >= s->count)
+        return;
+    sched_task_t *t = &s->task[id];
+    // Belum ada post yang menunggu: catat waktunya sebelum nomor urut naik
+    if (t->post_seq == __atomic_load_n(&t->seen_seq, __ATOMIC_RELAXED))
+        t->posted_us = now_us;
+    __atomic_store_n(&t->post_seq, t->post_seq + 1, __ATOMIC_RELEASE);
+}
+
+// Post -> tenggat. Interupsi di antara baca post_seq dan tulis seen_seq
+// tidak menimpa posted_us (masih terlihat menunggu), jadi post itu dilayani
+// lagi pada pengumpulan berikutnya dengan waktu post yang lebih awal.
+static void collect_posts(sched_t *s)
+{
+    for (uint32_t i = 0; i < s->count; i++)
+    {
+        sched_task_t *t = &s->task[i];
+        uint32_t seq = __atomic_load_n(&t->post_seq, __ATOMIC_ACQUIRE);
+        if (seq == t->seen_seq)
+            continue;
+        if (t->posted_us < t->deadline_us)
+            t->deadline_us = t->posted_us;
+        __atomic_store_n(&t->seen_seq, seq, __ATOMIC_RELAXED);
+    }
+}
+
+uint64_t sched_next(sched_t *s)
+{
+    collect_posts(s);
+    uint64_t next = SCHED_NEVER;
+    for (uint32_t i = 0; i < s->count; i++)
+        if (s->task[i].deadline_us < next)
+            next = s->task[i].deadline_us;
+    return next;
+}
+
+static uint32_t clamp_u32(uint64_t v)
+{
+    return v > UINT32_MAX ? UINT32_MAX : (uint32_t)v;
+}
+
+bool sched_dispatch(sched_t *s)
+{
+    collect_posts(s);
+    uint64_t now = s->clock_us();
+    sched_task_t *due = NULL;
+    uint32_t due_id = 0;
+    for (uint32_t i = 0; i < s->count; i++)
+    {
+        sched_task_t *t = &s->task[i];
+        if (t->deadline_us <= now && (due == NULL || t->deadline_us < due->deadline_us))
+        {
+            due = t;
+            due_id = i;
+        }
+    }
+    if (due == NULL)
+        return false;
+
+    uint32_t latency = clamp_u32(now - due->deadline_us);
+    if (latency > due->latency_max_us)
+        due->latency_max_us = latency;
+    if (latency > s->latency_max_us)
+    {
+        s->latency_max_us = latency;
+        s->latency_max_task = due_id;
+    }
+
+    due->deadline_us = SCHED_NEVER;
+    due->run(now);
+
+    uint32_t run = clamp_u32(s->clock_us() - now);
+    due->runs++;
+    due->run_total_us += run;
+    if (run > due->run_max_us)
+        due->run_max_us = run;
+    return true;
+}
+
+void sched_reset_stats(sched_t *s)
+{
+    for (uint32_t i = 0; i < s->count; i++)
+    {
+        sched_task_t *t = &s->task[i];
+        t->runs = 0;
+        t->run_max_us = 0;
+        t->run_total_us = 0;
+        t->latency_max_us = 0;
+    }
+    s->latency_max_us = 0;
+    s->latency_max_task = 0;
+}
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+size_t sched_page(const sched_t *s, uint32_t id, uint8_t *out)
+{
+    if (id >= s->count)
+        return 0;
+    const sched_task_t *t = &s->task[id];
+    size_t i = 0;
+    for (; i < SCHED_NAME_MAX && t->name && t->name[i]; i++)
+        out[i] = (uint8_t)t->name[i];
+    for (; i < SCHED_NAME_MAX; i++)
+        out[i] = 0;
+    put_u32(out + 8, t->runs);
+    put_u32(out + 12, t->run_max_us);
+    put_u32(out + 16, (uint32_t)t->run_total_us);
+    put_u32(out + 20, (uint32_t)(t->run_total_us >> 32));
+    put_u32(out + 24, t->latency_max_us);
+    return SCHED_PAGE_BYTES;
+}
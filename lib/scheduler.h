@@ -0,0 +1,89 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Penjadwal kooperatif berbasis tenggat untuk loop core 0
+ *
+ * Tabel tugas dialokasikan statis oleh pemanggil. Setiap tugas punya satu
+ * tenggat (SCHED_NEVER: tidak terjadwal); sched_dispatch() menjalankan tugas
+ * jatuh tempo dengan tenggat paling awal (seri: indeks terkecil lebih dulu)
+ * dan tenggatnya dihapus sebelum tugas dipanggil, sehingga tugas periodik
+ * menjadwalkan ulang dirinya sendiri dan keadaan menunggu menjadi tenggat,
+ * bukan sleep. Di antara tugas inti tidur (WFE) sampai sched_next().
+ *
+ * Interupsi tidak memanggil tugas: sched_post() hanya menandai tugas jatuh
+ * tempo sejak waktu post, lalu interupsi membangunkan loop (__sev). Post
+ * memakai pasangan nomor urut dengan satu penulis per field (interupsi
+ * menulis post_seq, loop menulis seen_seq), sehingga tidak butuh operasi
+ * atomik baca-ubah-tulis yang tidak ada di Cortex-M0+. Post yang tiba
+ * tepat saat dikumpulkan paling buruk menjalankan tugas sekali lagi.
+ *
+ * Per tugas dicatat jumlah jalan, waktu jalan (total dan terlama) dan
+ * latensi dispatch terburuk: jarak dari tenggat atau waktu post ke mulai
+ * jalan, yaitu waktu tugas lain yang sedang berjalan ditambah biaya
+ * bangun. Waktu diambil dari 'clock_us' sehingga modul ini tidak bergantung
+ * pada Pico SDK dan diuji di host dengan jam virtual (mgc_sim sched).
+ */
+
+#define SCHED_NEVER UINT64_MAX
+#define SCHED_NAME_MAX 8 // Karakter nama di halaman statistik
+
+typedef void (*sched_fn_t)(uint64_t now_us);
+
+typedef struct
+{
+    const char *name;
+    sched_fn_t run;
+    uint64_t deadline_us;
+
+    // Post dari interupsi (lihat atas)
+    volatile uint32_t post_seq;
+    volatile uint64_t posted_us; // Post pertama yang belum dikumpulkan
+    uint32_t seen_seq;
+
+    // Statistik
+    uint32_t runs;
+    uint32_t run_max_us;
+    uint64_t run_total_us;
+    uint32_t latency_max_us;
+} sched_task_t;
+
+typedef struct
+{
+    sched_task_t *task;
+    uint32_t count;
+    uint64_t (*clock_us)(void);
+    uint32_t latency_max_us; // Terburuk semua tugas
+    uint32_t latency_max_task;
+} sched_t;
+
+// 'tasks' berisi name dan run; tenggat dan statistik dikosongkan
+void sched_init(sched_t *s, sched_task_t *tasks, uint32_t count, uint64_t (*clock_us)(void));
+
+// Tenggat baru menggantikan yang lama
+void sched_at(sched_t *s, uint32_t id, uint64_t at_us);
+void sched_cancel(sched_t *s, uint32_t id);
+
+// Dari interupsi di inti yang sama dengan loop: tugas jatuh tempo sejak
+// 'now_us'. Post berulang sebelum tugas berjalan digabung.
+void sched_post(sched_t *s, uint32_t id, uint64_t now_us);
+
+// Tenggat terdekat termasuk post (SCHED_NEVER bila tidak ada)
+uint64_t sched_next(sched_t *s);
+
+// Jalankan satu tugas yang jatuh tempo; false bila tidak ada
+bool sched_dispatch(sched_t *s);
+
+void sched_reset_stats(sched_t *s);
+
+// Halaman statistik untuk REMOTE_CMD_TASKS (u32/u64 LE): nama (8 byte,
+// diisi 0), jumlah jalan, waktu jalan maks. us, total us (u64), latensi
+// maks. us. Mengembalikan jumlah byte, 0 bila id tidak dikenal.
+#define SCHED_PAGE_BYTES (SCHED_NAME_MAX + 4 + 4 + 8 + 4)
+size_t sched_page(const sched_t *s, uint32_t id, uint8_t *out);
+
+#endif
@@ -0,0 +1,175 @@
+#include "signal_timing.h"
+
+// 1e9 / 256: faktor ns per siklus untuk clock divider 16.8 tanpa overflow
+#define NS_PER_FIXED_DIV 3906250ull
+
+uint32_t timing_clkdiv_for_resolution(uint32_t sys_clk_hz, uint32_t resolution_ns)
+{
+    uint64_t fixed = ((uint64_t)sys_clk_hz * resolution_ns + NS_PER_FIXED_DIV / 2) / NS_PER_FIXED_DIV;
+
+    // Batasi clock divider dalam rentang yang valid
+    if (fixed < TIMING_CLKDIV_ONE)
+        fixed = TIMING_CLKDIV_ONE;
+    if (fixed > TIMING_CLKDIV_MAX)
+        fixed = TIMING_CLKDIV_MAX;
+    return (uint32_t)fixed;
+}
+
+uint64_t timing_ns_to_cycles(uint64_t ns, uint32_t sys_clk_hz, uint32_t clkdiv_fixed)
+{
+    // siklus = ns * f_sys * 256 / (1e9 * clkdiv_fixed)
+    uint64_t num = ns * sys_clk_hz;
+    uint64_t den = NS_PER_FIXED_DIV * clkdiv_fixed;
+    return (num + den / 2) / den;
+}
+
+uint64_t timing_cycles_to_ns(uint64_t cycles, uint32_t sys_clk_hz, uint32_t clkdiv_fixed)
+{
+    // ns = siklus * clkdiv_fixed * 1e9 / (256 * f_sys)
+    uint64_t q = cycles * clkdiv_fixed;
+    uint64_t whole = q / sys_clk_hz;
+    uint64_t rem = q % sys_clk_hz;
+    return whole * NS_PER_FIXED_DIV + (rem * NS_PER_FIXED_DIV + sys_clk_hz / 2) / sys_clk_hz;
+}
+
+uint32_t timing_periods_for_duration(uint32_t duration_ms, uint32_t sys_clk_hz, uint32_t clkdiv_fixed,
+                                    uint32_t period_cycles)
+{
+    if (period_cycles == 0)
+        return 0;
+    // periode = ms * f_sys * 256 / (1000 * clkdiv_fixed * periode_siklus),
+    // dibulatkan ke terdekat; pembilang maks. ~2e15 untuk 30 s pada 250 MHz
+    uint64_t num = (uint64_t)duration_ms * sys_clk_hz * TIMING_CLKDIV_ONE;
+    uint64_t den = 1000ull * clkdiv_fixed * period_cycles;
+    uint64_t periods = (num + den / 2) / den;
+    if (periods == 0)
+        periods = 1;
+    return periods > UINT32_MAX ? UINT32_MAX : (uint32_t)periods;
+}
+
+timing_status_t timing_compile(const timing_request_t *req, uint32_t sys_clk_hz,
+                               uint32_t clkdiv_fixed, uint32_t event_overhead,
+                               timing_plan_t *plan)
+{
+    timing_status_t status = TIMING_OK;
+
+    if (req->freq_hz == 0)
+        return TIMING_ERR_FREQ;
+
+    // Periode dihitung langsung dari frekuensi agar tidak ada galat ganda
+    uint64_t den = (uint64_t)req->freq_hz * clkdiv_fixed;
+    uint64_t period = ((uint64_t)sys_clk_hz * TIMING_CLKDIV_ONE + den / 2) / den;
+
+    // Setiap tepi dibulatkan ke siklus terdekat dari awal periode: CH1 naik di
+    // 0, CH1 turun di A, CH2 naik di round(phase), CH2 turun di round(phase) + A
+    uint64_t pulse = timing_ns_to_cycles(req->pulse_width_ns, sys_clk_hz, clkdiv_fixed);
+    uint64_t phase = timing_ns_to_cycles(req->phase_ns, sys_clk_hz, clkdiv_fixed);
+
+    if (req->phase_ns < req->pulse_width_ns)
+        status = TIMING_ERR_PHASE_LT_PULSE;
+
+    uint64_t ev_a = pulse;
+    uint64_t ev_b = phase > pulse ? phase - pulse : 0;
+    uint64_t ev_c = pulse;
+
+    // Setiap event minimal sepanjang overhead instruksinya (N = 0)
+    if (ev_a < event_overhead)
+    {
+        ev_a = ev_c = event_overhead;
+        if (status == TIMING_OK)
+            status = TIMING_ERR_EVENT_TOO_SHORT;
+    }
+    if (ev_b < event_overhead)
+    {
+        ev_b = event_overhead;
+        if (status == TIMING_OK)
+            status = TIMING_ERR_EVENT_TOO_SHORT;
+    }
+
+    uint64_t used = ev_a + ev_b + ev_c;
+    uint64_t ev_d;
+    if (period < used + event_overhead)
+    {
+        ev_d = event_overhead;
+        if (status == TIMING_OK)
+            status = TIMING_ERR_PERIOD_TOO_SHORT;
+    }
+    else
+    {
+        ev_d = period - used;
+    }
+
+    uint64_t ev[4] = {ev_a, ev_b, ev_c, ev_d};
+    for (int i = 0; i < 4; i++)
+    {
+        if (ev[i] > UINT32_MAX)
+            return TIMING_ERR_RANGE;
+        plan->event_cycles[i] = (uint32_t)ev[i];
+        plan->delay[i] = (uint32_t)(ev[i] - event_overhead);
+    }
+    uint64_t total = ev_a + ev_b + ev_c + ev_d;
+    if (total > UINT32_MAX)
+        return TIMING_ERR_RANGE;
+    plan->period_cycles = (uint32_t)total;
+
+    plan->period_ns = (uint32_t)timing_cycles_to_ns(total, sys_clk_hz, clkdiv_fixed);
+    plan->pulse_width_ns = (uint32_t)timing_cycles_to_ns(ev_a, sys_clk_hz, clkdiv_fixed);
+    plan->dead_time_ns = (uint32_t)timing_cycles_to_ns(ev_b, sys_clk_hz, clkdiv_fixed);
+
+    return status;
+}
+
+uint32_t timing_resolution_ps(uint32_t sys_clk_hz, uint32_t clkdiv_fixed)
+{
+    // ps = clkdiv_fixed * 1e12 / (256 * f_sys)
+    uint64_t num = (uint64_t)clkdiv_fixed * (NS_PER_FIXED_DIV * 1000u);
+    return (uint32_t)((num + sys_clk_hz / 2) / sys_clk_hz);
+}
+
+timing_status_t timing_compile_auto(const timing_request_t *req, uint32_t sys_clk_hz,
+                                    uint32_t event_overhead, uint32_t *clkdiv_fixed,
+                                    timing_plan_t *plan)
+{
+    if (req->freq_hz == 0)
+        return TIMING_ERR_FREQ;
+
+    // Divider minimum agar satu periode muat di register X 32-bit
+    uint64_t den = (uint64_t)req->freq_hz * UINT32_MAX;
+    uint64_t fixed = ((uint64_t)sys_clk_hz * TIMING_CLKDIV_ONE + den - 1) / den;
+
+    // Bulatkan ke atas ke divider integer. Divider pecahan menggeser setiap
+    // tepi +-1 siklus clk_sys (jitter) dan tidak pernah diperlukan agar muat,
+    // kecuali di atas divider integer maksimum.
+    fixed = (fixed + TIMING_CLKDIV_ONE - 1) & ~(uint64_t)(TIMING_CLKDIV_ONE - 1);
+    if (fixed < TIMING_CLKDIV_ONE)
+        fixed = TIMING_CLKDIV_ONE;
+    if (fixed > TIMING_CLKDIV_MAX)
+        fixed = TIMING_CLKDIV_MAX;
+
+    // Pulsa dan beda fasa yang lebih panjang dari periode tidak dapat
+    // dipenuhi di divider mana pun, jadi tidak perlu dicoba lebih besar
+    *clkdiv_fixed = (uint32_t)fixed;
+    return timing_compile(req, sys_clk_hz, (uint32_t)fixed, event_overhead, plan);
+}
+
+const char *timing_status_str(timing_status_t status)
+{
+    switch (status)
+    {
+    case TIMING_OK:
+        return "OK";
+    case TIMING_ERR_FREQ:
+        return "FREKUENSI NOL";
+    case TIMING_ERR_PHASE_LT_PULSE:
+        return "FASA < PULSA";
+    case TIMING_ERR_EVENT_TOO_SHORT:
+        return "PULSA TRLL PNDK";
+    case TIMING_ERR_PERIOD_TOO_SHORT:
+        return "PERIODE PENDEK";
+    case TIMING_ERR_RANGE:
+        return "DILUAR RENTANG";
+    case TIMING_ERR_PATTERN:
+        return "POLA TDK VALID";
+    }
+    return "?";
+}
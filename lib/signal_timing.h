@@ -0,0 +1,79 @@
+#ifndef SIGNAL_TIMING_H
+#define SIGNAL_TIMING_H
+
+#include <stdint.h>
+
+// Kompiler waktu generator sinyal: mengubah parameter UI menjadi hitungan N
+// loop PIO dalam siklus PIO yang eksak. Hanya aritmetika integer (RP2040 tidak
+// punya FPU) dan tidak bergantung pada Pico SDK sehingga dapat dipakai juga
+// oleh simulator host (host/).
+
+// Clock divider PIO dalam format 16.8 (256 = bagi 1), sama seperti register
+// SMx_CLKDIV dan sm_config_set_clkdiv_int_frac8()
+#define TIMING_CLKDIV_ONE 256u
+#define TIMING_CLKDIV_MAX ((65535u << 8) | 0xffu)
+
+typedef enum
+{
+    TIMING_OK = 0,
+    TIMING_ERR_FREQ,             // Frekuensi nol
+    TIMING_ERR_PHASE_LT_PULSE,   // Beda fasa < lebar pulsa (dead time negatif)
+    TIMING_ERR_EVENT_TOO_SHORT,  // Event lebih pendek dari overhead instruksi PIO
+    TIMING_ERR_PERIOD_TOO_SHORT, // Periode < A + B + C + event D minimum
+    TIMING_ERR_RANGE,            // Hitungan melebihi register X 32-bit
+    TIMING_ERR_PATTERN,          // Pola kosong/terlalu panjang atau mask di luar GP6..GP9
+} timing_status_t;
+
+typedef struct
+{
+    uint32_t freq_hz;
+    uint32_t pulse_width_ns; // Lebar pulsa CH1/CH4 dan CH2/CH3
+    uint32_t phase_ns;       // Beda fasa: awal pulsa CH1 -> awal pulsa CH2
+} timing_request_t;
+
+typedef struct
+{
+    uint32_t delay[4];        // Nilai N untuk event A..D (masuk ke register X)
+    uint32_t event_cycles[4]; // Durasi event A..D dalam siklus PIO (N + overhead)
+    uint32_t period_cycles;
+    // Nilai yang benar-benar dihasilkan (dibulatkan ke ns terdekat)
+    uint32_t period_ns;
+    uint32_t pulse_width_ns;
+    uint32_t dead_time_ns;
+} timing_plan_t;
+
+// Clock divider 16.8 terdekat untuk resolusi yang diinginkan (dibatasi 1 - 65535.996)
+uint32_t timing_clkdiv_for_resolution(uint32_t sys_clk_hz, uint32_t resolution_ns);
+
+// Konversi dengan pembulatan ke terdekat; siklus = siklus PIO setelah clkdiv
+uint64_t timing_ns_to_cycles(uint64_t ns, uint32_t sys_clk_hz, uint32_t clkdiv_fixed);
+uint64_t timing_cycles_to_ns(uint64_t cycles, uint32_t sys_clk_hz, uint32_t clkdiv_fixed);
+
+// Durasi proses -> jumlah periode utuh terdekat (minimal satu), sehingga
+// proses selalu berakhir di batas periode
+uint32_t timing_periods_for_duration(uint32_t duration_ms, uint32_t sys_clk_hz, uint32_t clkdiv_fixed,
+                                    uint32_t period_cycles);
+
+// Susun rencana event A..D (sekuens 1001, 0000, 0110, 0000). event_overhead
+// adalah biaya instruksi tetap per event dari program PIO yang dipakai
+// (signal_generator_counted_EVENT_OVERHEAD / pattern_engine_EVENT_OVERHEAD).
+// Bila permintaan tidak dapat dipenuhi, status != TIMING_OK dan 'plan' tetap
+// berisi rencana terdekat yang dapat dicapai (event dipaksa ke minimum).
+timing_status_t timing_compile(const timing_request_t *req, uint32_t sys_clk_hz,
+                               uint32_t clkdiv_fixed, uint32_t event_overhead,
+                               timing_plan_t *plan);
+
+// Resolusi satu siklus PIO dalam pikodetik (8000 = 8 ns pada 125 MHz, clkdiv 1)
+uint32_t timing_resolution_ps(uint32_t sys_clk_hz, uint32_t clkdiv_fixed);
+
+// Perencana resolusi: pilih clock divider terkecil yang masih memuat seluruh
+// hitungan event dalam register X 32-bit, lalu susun rencananya. Divider yang
+// dipilih dikembalikan lewat 'clkdiv_fixed'.
+timing_status_t timing_compile_auto(const timing_request_t *req, uint32_t sys_clk_hz,
+                                    uint32_t event_overhead, uint32_t *clkdiv_fixed,
+                                    timing_plan_t *plan);
+
+// Teks singkat (maks. 16 karakter) untuk LCD
+const char *timing_status_str(timing_status_t status);
+
+#endif
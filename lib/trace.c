@@ -0,0 +1,45 @@
+#include "trace.h"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+
+static trace_ring_t rings[TRACE_CORES];
+static uint32_t drain_next; // Ring pertama yang diperiksa trace_drain()
+
+void trace_init(void)
+{
+    for (int i = 0; i < TRACE_CORES; i++)
+        trace_ring_init(&rings[i]);
+    drain_next = 0;
+}
+
+void trace_write(const char *fmt, const trace_word_t *args, uint32_t nargs)
+{
+    uint core = get_core_num();
+    trace_ring_t *r = &rings[core];
+    uint32_t t_us = timer_hw->timerawl;
+
+    // Interupsi di core ini bisa menulis ring yang sama di antara baca dan
+    // tulis head; core lain punya ring sendiri
+    uint32_t irq_state = save_and_disable_interrupts();
+    uint32_t n = trace_ring_reserve(r);
+    restore_interrupts(irq_state);
+
+    if (n != TRACE_FULL)
+        trace_ring_fill(r, n, t_us, fmt, args, nargs);
+}
+
+size_t trace_drain(uint8_t *out)
+{
+    // Bergiliran agar core yang sibuk menulis tidak menahan core lain
+    for (int i = 0; i < TRACE_CORES; i++)
+    {
+        uint32_t core = (drain_next + i) % TRACE_CORES;
+        size_t n = trace_encode(&rings[core], (uint8_t)core, out);
+        if (n > 0)
+        {
+            drain_next = core + 1;
+            return n;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,31 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+/**
+ * Log jejak biner di firmware (format dan kode: lib/trace_log.h)
+ *
+ * TRACE() dari core mana pun, termasuk dari interupsi: cap waktu timer
+ * 1 MHz, reservasi slot di ring core pemanggil dengan interupsi mati
+ * beberapa instruksi, lalu salinan argumen. Puluhan siklus per rekaman,
+ * tanpa formatter printf dan tanpa menunggu USB, sehingga aman di jalur
+ * mulai proses. Tidak boleh dipanggil selama flash ditulis (kode di flash).
+ *
+ * Loop core 0 menguras kedua ring dengan trace_drain() saat mesin pulsa
+ * diam; host memformat rekaman dari string di ELF (host/mgc_remote.py
+ * --elf).
+ */
+
+#include "pico/stdlib.h"
+#include "trace_log.h"
+
+#define TRACE_CORES 2
+
+// Sebelum TRACE() pertama
+void trace_init(void);
+
+// Satu payload REMOTE_EV_TRACE (maks. TRACE_PAYLOAD_MAX byte) dari ring
+// berikutnya yang berisi rekaman, 0 bila semua ring kosong. Hanya loop
+// core 0.
+size_t trace_drain(uint8_t *out);
+
+#endif
@@ -0,0 +1,250 @@
+#include "trace_log.h"
+#include <stdio.h>
+#include <string.h>
+
+// ===================== RING =====================
+void trace_ring_init(trace_ring_t *r)
+{
+    memset(r, 0, sizeof(*r));
+}
+
+uint32_t trace_ring_reserve(trace_ring_t *r)
+{
+    uint32_t head = r->head;
+    if (head - __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE) >= TRACE_SLOTS)
+    {
+        r->dropped++;
+        return TRACE_FULL;
+    }
+    r->head = head + 1;
+    return head;
+}
+
+void trace_ring_fill(trace_ring_t *r, uint32_t n, uint32_t t_us, const char *fmt, const trace_word_t *args,
+                     uint32_t nargs)
+{
+    trace_slot_t *s = &r->slot[n % TRACE_SLOTS];
+    if (nargs > TRACE_ARGS_MAX)
+        nargs = TRACE_ARGS_MAX;
+    s->t_us = t_us;
+    s->nargs = nargs;
+    for (uint32_t i = 0; i < nargs; i++)
+        s->arg[i] = args[i];
+    __atomic_store_n(&s->fmt, (trace_word_t)fmt, __ATOMIC_RELEASE);
+}
+
+const trace_slot_t *trace_ring_peek(trace_ring_t *r)
+{
+    const trace_slot_t *s = &r->slot[r->tail % TRACE_SLOTS];
+    if (__atomic_load_n(&s->fmt, __ATOMIC_ACQUIRE) == 0)
+        return NULL;
+    return s;
+}
+
+void trace_ring_release(trace_ring_t *r)
+{
+    // Slot dikosongkan sebelum tail maju: penulis baru boleh memakainya
+    // setelah melihat tail baru
+    __atomic_store_n(&r->slot[r->tail % TRACE_SLOTS].fmt, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&r->tail, r->tail + 1, __ATOMIC_RELEASE);
+}
+
+// ===================== KODE =====================
+static void put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    put_u16(p, (uint16_t)v);
+    put_u16(p + 2, (uint16_t)(v >> 16));
+}
+
+static void put_word(uint8_t *p, trace_word_t v)
+{
+    for (size_t i = 0; i < sizeof(trace_word_t); i++)
+        p[i] = (uint8_t)((uint64_t)v >> (8 * i));
+}
+
+static uint32_t get_u32(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static trace_word_t get_word(const uint8_t *p)
+{
+    uint64_t v = 0;
+    for (size_t i = 0; i < sizeof(trace_word_t); i++)
+        v |= (uint64_t)p[i] << (8 * i);
+    return (trace_word_t)v;
+}
+
+static size_t record_bytes(uint32_t nargs)
+{
+    return 5 + (1 + nargs) * sizeof(trace_word_t);
+}
+
+size_t trace_encode(trace_ring_t *r, uint8_t core, uint8_t *out)
+{
+    uint32_t dropped = __atomic_load_n(&r->dropped, __ATOMIC_RELAXED) - r->dropped_sent;
+    if (dropped > UINT16_MAX)
+        dropped = UINT16_MAX;
+    out[0] = sizeof(trace_word_t);
+    out[1] = core;
+    put_u16(out + 2, (uint16_t)dropped);
+
+    size_t n = TRACE_HEADER_BYTES;
+    const trace_slot_t *s;
+    while ((s = trace_ring_peek(r)) != NULL && n + record_bytes(s->nargs) <= TRACE_PAYLOAD_MAX)
+    {
+        put_u32(out + n, s->t_us);
+        out[n + 4] = (uint8_t)s->nargs;
+        n += 5;
+        put_word(out + n, s->fmt);
+        n += sizeof(trace_word_t);
+        for (uint32_t i = 0; i < s->nargs; i++, n += sizeof(trace_word_t))
+            put_word(out + n, s->arg[i]);
+        trace_ring_release(r);
+    }
+    if (n == TRACE_HEADER_BYTES && dropped == 0)
+        return 0;
+    r->dropped_sent += dropped;
+    return n;
+}
+
+bool trace_reader_init(trace_reader_t *rd, const uint8_t *in, size_t len)
+{
+    if (len < TRACE_HEADER_BYTES || in[0] != sizeof(trace_word_t))
+        return false;
+    rd->core = in[1];
+    rd->dropped = (uint16_t)(in[2] | (in[3] << 8));
+    rd->pos = in + TRACE_HEADER_BYTES;
+    rd->end = in + len;
+    return true;
+}
+
+bool trace_reader_next(trace_reader_t *rd, trace_record_t *rec)
+{
+    size_t left = (size_t)(rd->end - rd->pos);
+    if (left < 5)
+        return false;
+    uint32_t nargs = rd->pos[4];
+    if (nargs > TRACE_ARGS_MAX || left < record_bytes(nargs))
+        return false;
+    rec->t_us = get_u32(rd->pos);
+    rec->nargs = nargs;
+    const uint8_t *p = rd->pos + 5;
+    rec->fmt = get_word(p);
+    for (uint32_t i = 0; i < nargs; i++)
+        rec->arg[i] = get_word(p + (1 + i) * sizeof(trace_word_t));
+    rd->pos += record_bytes(nargs);
+    return rec->fmt != 0;
+}
+
+// ===================== FORMAT =====================
+typedef struct
+{
+    const trace_word_t *arg;
+    uint32_t left;
+} arg_cursor_t;
+
+static trace_word_t next_word(arg_cursor_t *c)
+{
+    if (c->left == 0)
+        return 0;
+    c->left--;
+    return *c->arg++;
+}
+
+// ll: 64 bit dari satu kata atau dua kata (rendah, tinggi)
+static uint64_t next_u64(arg_cursor_t *c)
+{
+    uint64_t v = next_word(c);
+    if (sizeof(trace_word_t) < sizeof(uint64_t))
+        v |= (uint64_t)next_word(c) << 32;
+    return v;
+}
+
+size_t trace_render(const char *fmt, const trace_word_t *args, uint32_t nargs, char *out, size_t cap)
+{
+    arg_cursor_t c = {args, nargs};
+    size_t n = 0;
+    if (cap == 0)
+        return 0;
+    out[0] = 0;
+
+    while (*fmt && n + 1 < cap)
+    {
+        if (*fmt != '%')
+        {
+            out[n++] = *fmt++;
+            continue;
+        }
+        // Spesifikasi disalin tanpa pengubah panjang, lalu "ll" ditambahkan
+        // untuk konversi bilangan
+        const char *start = fmt;
+        char spec[24] = "%";
+        size_t k = 1;
+        const char *p = fmt + 1;
+        while (*p && strchr("-+ 0#", *p) && k < 8)
+            spec[k++] = *p++;
+        while (((*p >= '0' && *p <= '9') || *p == '.') && k < 16)
+            spec[k++] = *p++;
+        int longs = 0;
+        while (*p && strchr("hlzjt", *p))
+            longs += *p++ == 'l';
+        char conv = *p;
+        if (conv == 0)
+            break;
+        fmt = p + 1;
+
+        int w;
+        switch (conv)
+        {
+        case 'd':
+        case 'i':
+        {
+            int64_t v = longs >= 2 ? (int64_t)next_u64(&c) : (int32_t)next_word(&c);
+            memcpy(spec + k, "lld", 4);
+            w = snprintf(out + n, cap - n, spec, (long long)v);
+            break;
+        }
+        case 'u':
+        case 'x':
+        case 'X':
+        {
+            uint64_t v = longs >= 2 ? next_u64(&c) : (uint32_t)next_word(&c);
+            spec[k] = 'l';
+            spec[k + 1] = 'l';
+            spec[k + 2] = conv;
+            spec[k + 3] = 0;
+            w = snprintf(out + n, cap - n, spec, (unsigned long long)v);
+            break;
+        }
+        case 'c':
+            memcpy(spec + k, "c", 2);
+            w = snprintf(out + n, cap - n, spec, (int)next_word(&c));
+            break;
+        case 's':
+        {
+            const char *s = (const char *)next_word(&c);
+            memcpy(spec + k, "s", 2);
+            w = snprintf(out + n, cap - n, spec, s ? s : "(null)");
+            break;
+        }
+        case '%':
+            w = snprintf(out + n, cap - n, "%%");
+            break;
+        default:
+            // Tidak dikenal (mis. float): tampilkan apa adanya
+            w = snprintf(out + n, cap - n, "%.*s", (int)(fmt - start), start);
+            break;
+        }
+        if (w > 0)
+            n += (size_t)w < cap - n ? (size_t)w : cap - n - 1;
+    }
+    out[n] = 0;
+    return n;
+}
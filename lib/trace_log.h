@@ -0,0 +1,134 @@
+#ifndef TRACE_LOG_H
+#define TRACE_LOG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Log jejak biner: pengganti printf diagnostik. Setiap rekaman hanya ID
+// format (alamat string format di flash), cap waktu 1 MHz dan argumen
+// mentah; string format tidak pernah diformat di perangkat. Rekaman dikirim
+// saat mesin pulsa diam sebagai event REMOTE_EV_TRACE dan diformat di host:
+// host/mgc_remote.py membaca string format (dan argumen %s) dari ELF
+// firmware, harness host (host/shim) memformatnya langsung di proses yang
+// sama. Tanpa Pico SDK: ring, kode dan formatter diuji di host (mgc_sim
+// trace); penulis firmware ada di lib/trace.h.
+//
+// Satu ring per core. Penulis di core yang sama (loop dan interupsi)
+// berbagi ring: reservasi slot (baca-tambah head) dilakukan pemanggil
+// dengan interupsi mati beberapa instruksi karena Cortex-M0+ tidak punya
+// LDREX/STREX, lalu slot diisi dengan interupsi hidup dan diterbitkan
+// dengan menulis 'fmt' paling akhir. Pembaca (loop core 0) berhenti di
+// slot pertama yang belum terbit, sehingga interupsi yang menyela penulis
+// di tengah pengisian tidak pernah membuat rekaman setengah jadi terkirim.
+// Tidak ada kunci antar-core; ring penuh membuang rekaman baru (dihitung).
+//
+// Format yang didukung: %d %i %u %x %X %c %s %% dengan flag, lebar dan
+// presisi, pengubah panjang diabaikan kecuali ll (64 bit, lihat
+// TRACE_U64). %s hanya untuk string konstan (alamatnya harus ada di ELF),
+// tanpa float.
+
+#define TRACE_ARGS_MAX 6
+#define TRACE_SLOTS 64 // Per core, pangkat dua
+#define TRACE_FULL UINT32_MAX
+
+// Payload event: [lebar kata][core][hilang u16] lalu rekaman
+// [t_us u32][jumlah argumen u8][fmt][argumen...], fmt dan argumen selebar
+// kata (4 byte di RP2040, 8 di harness host 64 bit)
+#define TRACE_HEADER_BYTES 4
+#define TRACE_RECORD_MAX (5 + (1 + TRACE_ARGS_MAX) * sizeof(trace_word_t))
+#define TRACE_PAYLOAD_MAX 240
+
+// Selebar pointer agar ID format dan argumen %s muat
+typedef uintptr_t trace_word_t;
+
+typedef struct
+{
+    volatile trace_word_t fmt; // 0: belum terbit (ditulis terakhir)
+    uint32_t t_us;
+    uint32_t nargs;
+    trace_word_t arg[TRACE_ARGS_MAX];
+} trace_slot_t;
+
+typedef struct
+{
+    trace_slot_t slot[TRACE_SLOTS];
+    uint32_t head;         // Ditulis penulis (dalam reservasi)
+    uint32_t tail;         // Ditulis pembaca
+    uint32_t dropped;      // Ditulis penulis: ring penuh
+    uint32_t dropped_sent; // Ditulis pembaca: sudah dilaporkan di payload
+} trace_ring_t;
+
+// TRACE("Periode %lu ns", periode): biaya satu reservasi dan salinan
+// argumen, diimplementasikan firmware (lib/trace.c) atau uji host. Setiap
+// argumen dikonversi ke trace_word_t; paling banyak TRACE_ARGS_MAX kata.
+void trace_write(const char *fmt, const trace_word_t *args, uint32_t nargs);
+
+#define TRACE(fmt, ...)                                                                       \
+    do                                                                                        \
+    {                                                                                         \
+        const trace_word_t trace_args_[] = {0, __VA_ARGS__};                                  \
+        _Static_assert(sizeof(trace_args_) / sizeof(trace_word_t) - 1 <= TRACE_ARGS_MAX,      \
+                       "argumen TRACE terlalu banyak");                                       \
+        trace_write(fmt, trace_args_ + 1, sizeof(trace_args_) / sizeof(trace_word_t) - 1);    \
+    } while (0)
+
+// Argumen %s (string konstan)
+#define TRACE_STR(s) ((trace_word_t)(const char *)(s))
+
+// Argumen %llu/%lld: dua kata (rendah, tinggi) bila kata 32 bit
+#if UINTPTR_MAX > UINT32_MAX
+#define TRACE_U64(v) ((trace_word_t)(uint64_t)(v))
+#else
+#define TRACE_U64(v) ((trace_word_t)(uint64_t)(v)), ((trace_word_t)((uint64_t)(v) >> 32))
+#endif
+
+// Sebelum penulis dan pembaca mulai memakai ring
+void trace_ring_init(trace_ring_t *r);
+
+// Penulis, dengan interupsi core ini mati: nomor slot atau TRACE_FULL
+// (dropped bertambah)
+uint32_t trace_ring_reserve(trace_ring_t *r);
+
+// Penulis, interupsi boleh hidup: isi slot hasil reservasi lalu terbitkan
+void trace_ring_fill(trace_ring_t *r, uint32_t n, uint32_t t_us, const char *fmt, const trace_word_t *args,
+                     uint32_t nargs);
+
+// Pembaca: rekaman tertua yang sudah terbit, NULL bila kosong atau rekaman
+// tertua masih diisi
+const trace_slot_t *trace_ring_peek(trace_ring_t *r);
+void trace_ring_release(trace_ring_t *r);
+
+// Pembaca: rekaman terbit berikutnya ke payload event (maks.
+// TRACE_PAYLOAD_MAX byte) sampai ring kosong atau payload penuh.
+// Mengembalikan panjangnya, 0 bila tidak ada rekaman dan tidak ada
+// rekaman hilang yang belum dilaporkan.
+size_t trace_encode(trace_ring_t *r, uint8_t core, uint8_t *out);
+
+typedef struct
+{
+    uint32_t t_us;
+    trace_word_t fmt;
+    uint32_t nargs;
+    trace_word_t arg[TRACE_ARGS_MAX];
+} trace_record_t;
+
+typedef struct
+{
+    uint8_t core;
+    uint16_t dropped; // Hilang sebelum rekaman pertama payload ini
+    const uint8_t *pos, *end;
+} trace_reader_t;
+
+// Payload -> pembaca rekaman; false bila terpotong atau lebar kata berbeda
+// dari trace_word_t (payload dari perangkat lain)
+bool trace_reader_init(trace_reader_t *rd, const uint8_t *in, size_t len);
+// Rekaman berikutnya; false di akhir payload atau bila rekaman rusak
+bool trace_reader_next(trace_reader_t *rd, trace_record_t *rec);
+
+// Format satu rekaman seperti snprintf() (argumen %s dibaca dari alamatnya,
+// hanya untuk harness di proses yang sama). Mengembalikan panjang teks
+// (dipotong pada 'cap').
+size_t trace_render(const char *fmt, const trace_word_t *args, uint32_t nargs, char *out, size_t cap);
+
+#endif
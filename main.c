@@ -5,9 +5,24 @@
  * - LCD I2C: SDA -> GP4, SCL -> GP5
  * - Tombol: SELECT -> GP13, UP -> GP14, DOWN -> GP15
  * - Output Sinyal PIO: GP6, GP7, GP8, GP9
+ *   (REMOTE_PARAM_PROGRAM = 2: pasangan independen GP6/GP7 dan GP8/GP9,
+ *   pin sinkron internal GP22)
+ * - Picu: keluar GP10 (HIGH bersama pulsa CH1), masuk GP11 (pull-down)
+ * - Bank kapasitor: tegangan lewat pembagi ke ADC0 (GP26), saklar resistor
+ *   buang GP12 (aktif HIGH)
+ * - Tangkapan per pulsa: sensor arus ke ADC1 (GP27), tegangan beban ke ADC2
+ *   (GP28), lihat lib/pulse_capture.h
+ * - USB CDC: protokol kendali biner (lib/remote_proto.h, klien
+ *   host/mgc_remote.py) dan log jejak biner (lib/trace.h), diformat di host
+ *   dari ELF (mgc_remote.py --elf)
+ * - Uji mandiri (menu 11): penganalisis logika PIO membaca GP6..GP9 selama
+ *   proses singkat dan membandingkan lebar pulsa, dead time dan periode
+ *   dengan parameter; hasil di LCD, berkas VCD lewat USB (mgc_remote.py
+ *   selftest), lihat lib/logic_analyzer.h
  */
 
 #include <stdio.h>
+#include <stddef.h>
 #include <string.h>
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
@@ -17,12 +32,46 @@
 #include "hardware/pio.h"
 #include "hardware/clocks.h"
 #include "hardware/timer.h"
+#include "hardware/vreg.h"
 #include "lib/lcd_i2c.h"
-#include "signal_generator.pio.h"
+#include "lib/signal_timing.h"
+#include "lib/pulse_engine.h"
+#include "lib/buttons.h"
+#include "lib/param_store.h"
+#include "lib/remote_proto.h"
+#include "lib/perf_counters.h"
+#include "lib/bank_adc.h"
+#include "lib/bank_monitor.h"
+#include "lib/pulse_capture.h"
+#include "lib/scheduler.h"
+#include "lib/trace.h"
+#include "lib/logic_analyzer.h"
 
 // ===================== KONFIGURASI FLASH =====================
+// Log parameter (lib/param_store.c) di sektor-sektor terakhir flash
+#define PARAM_REGION_SECTORS 4
+#define PARAM_REGION_OFFSET (PICO_FLASH_SIZE_BYTES - PARAM_REGION_SECTORS * FLASH_SECTOR_SIZE)
+#define PARAM_SLOT_AKTIF 0 // Slot 1..PARAM_SLOTS-1 adalah preset
+#define JUMLAH_PRESET (PARAM_SLOTS - 1)
+
+// Isi satu rekaman (parameter aktif atau preset)
+typedef struct
+{
+    int32_t frekuensi;
+    int32_t lebarPulsa;
+    int32_t waktuPerlakuan;
+    int32_t bedaFasa;
+    int32_t presisiTinggi;
+    int32_t picuEksternal; // Tidak ada di rekaman lama (dibaca sebagai 0)
+} ParamSet;
+
+// Rekaman sebelum field picuEksternal ditambahkan
+#define PARAM_SET_V1_SIZE offsetof(ParamSet, picuEksternal)
+
+// Format lama (satu sektor, erase tiap simpan), hanya dibaca untuk migrasi
 #define FLASH_TARGET_OFFSET (PICO_FLASH_SIZE_BYTES - FLASH_SECTOR_SIZE)
-#define CONFIG_MAGIC 0xDEADBEEF
+#define CONFIG_MAGIC 0xDEADBEF0    // Versi 2: + presisiTinggi
+#define CONFIG_MAGIC_V1 0xDEADBEEF // Versi 1: tanpa presisiTinggi
 
 typedef struct
 {
@@ -31,6 +80,7 @@ typedef struct
     long lebarPulsa;
     int waktuPerlakuan;
     long bedaFasa;
+    int presisiTinggi;
 } ConfigData;
 
 // ===================== KONFIGURASI PIN DAN LCD =====================
@@ -38,36 +88,153 @@ const uint8_t LCD_ADDRESS = 0x27;
 const uint I2C_SDA_PIN = 4;
 const uint I2C_SCL_PIN = 5;
 i2c_inst_t *i2c_port = i2c0;
+// 400 kHz: driver LCD mengandalkan waktu bus untuk jeda HD44780 (lihat
+// lib/lcd_i2c.c). Turunkan ke 100 kHz bila modul PCF8574 tidak stabil.
+const uint I2C_BAUD_HZ = 400 * 1000;
 
-// Pin Tombol
-const uint SELECT_BUTTON_PIN = 13;
-const uint UP_BUTTON_PIN = 14;
-const uint DOWN_BUTTON_PIN = 15;
+// Pin Tombol (urutan BUTTON_SELECT, BUTTON_UP, BUTTON_DOWN)
+const uint BUTTON_PINS[BUTTON_COUNT] = {13, 14, 15};
 
 // Pin Output PIO
 const uint PIN_CH1_BASE = 6;
 
+// Bank kapasitor: ADC0 dan saklar resistor buang
+const uint BANK_ADC_PIN = 26;
+const uint BANK_DUMP_PIN = 12;
+
+// ===================== KONFIGURASI PENGOSONGAN =====================
+// Skala penuh mengikuti pembagi tegangan yang terpasang (3.3 V x 200)
+#define BANK_SAMPLE_RATE_HZ 500000 // ADC bebas -> ring DMA (lib/bank_adc.h)
+#define BANK_FULL_SCALE_MV 660000
+#define BANK_SAFE_MV 36000      // Tegangan sentuh aman
+#define BANK_FILTER_TAU_US 1000 // IIR: derau ADC dan lonjakan EMI saklar
+#define BANK_HOLD_MS 100        // Terfilter tetap di bawah ambang selama ini
+#define BANK_TIMEOUT_MS 30000   // Lebih lama: saklar atau resistor buang rusak
+
 // ===================== VARIABEL UTAMA =====================
 uint8_t menu = 1;
 volatile long frekuensi = 100;
 volatile long lebarPulsa = 3500;
 volatile int waktuPerlakuan = 3;
 volatile long bedaFasa = 100;
+int presisiTinggi = 0; // 1: clk_sys 250 MHz (resolusi 4 ns), 0: 125 MHz (8 ns)
+int picuEksternal = 0; // 1: proses menunggu tepi naik picu masuk (GP11)
+int tangkapPasangan = 0; // Pasangan I/V per pulsa (REMOTE_PARAM_CAPTURE), tidak disimpan
+int programPola = 0; // REMOTE_PARAM_PROGRAM (1: mesin pola + DMA, 2: pasangan independen), tidak disimpan
+// Program 2: GP6/GP7 dengan parameter aktif, GP8/GP9 dengan preset 1
+pattern_t polaPasangan[PE_MAX_PAIRS];
 bool subMenu = false;
+int presetIndex = 0; // 0: batal, 1..JUMLAH_PRESET
+
+// Frekuensi clk_sys untuk mode normal dan presisi tinggi
+#define SYS_CLK_NORMAL_KHZ 125000
+#define SYS_CLK_PRESISI_KHZ 250000
+
+// Jumlah menu utama (7: MODE PRESISI, 8: SIMPAN PRESET, 9: MUAT PRESET,
+// 10: SUMBER PICU, 11: UJI MANDIRI)
+#define JUMLAH_MENU 11
+
+// Log parameter di flash (slot aktif + preset)
+param_store_t paramStore;
+
+// Cache write-back: SELECT hanya menandai kotor; flash ditulis setelah
+// PARAM_COMMIT_DELAY_MS tanpa edit, tidak pernah selama proses berjalan
+#define PARAM_COMMIT_DELAY_MS 3000
+bool paramDirty = false;
+uint32_t paramLastEditMs = 0;
+
+typedef struct
+{
+    uint32_t commits;        // Rekaman slot aktif yang benar-benar ditulis
+    uint32_t coalesced;      // Simpan yang digabung ke commit berikutnya
+    uint32_t unchanged;      // Simpan tanpa perubahan nilai (tidak ditulis)
+    uint32_t irq_off_max_us; // Interupsi core 0 mati terlama (satu operasi flash)
+    uint32_t park_max_us;    // Core 1 diparkir terlama
+} FlashStats;
+FlashStats flashStats;
 
-// ===================== VARIABEL PIO =====================
+// ===================== VARIABEL PROSES =====================
+// PIO dan DMA dimiliki core 1 (lib/pulse_engine.c); core 0 hanya memantau
 PIO pio = pio0;
-uint sm, offset;
-volatile bool process_complete = false;
-int64_t alarm_callback(alarm_id_t id, void *user_data);
-
-// ===================== DEBOUNCE BUTTON =====================
-uint32_t last_press_time_select = 0, last_press_time_up = 0, last_press_time_down = 0;
-uint8_t selectEvent = 0, upEvent = 0, downEvent = 0;
-const uint DEBOUNCE_DELAY_MS = 50, HOLD_DELAY_MS = 500, REPEAT_DELAY_MS = 200;
-bool select_pressed_flag = false, up_pressed_flag = false, down_pressed_flag = false;
-bool select_held_flag = false, up_held_flag = false, down_held_flag = false;
-uint32_t last_repeat_time_select = 0, last_repeat_time_up = 0, last_repeat_time_down = 0;
+bool prosesBerjalan = false;
+bool stopGagal = false; // STOP tidak dikonfirmasi core 1: pin dipaksa LOW dari core 0
+const uint RUN_SCREEN_INTERVAL_MS = 200;
+
+// Layar pesan sementara (hasil proses, parameter ditolak): menu kembali
+// setelah batas waktu tanpa menahan loop utama
+#define MESSAGE_SCREEN_MS 2000
+bool messageScreen = false;
+uint32_t messageScreenMs = 0;
+
+// Ringkasan kinerja (lib/perf_counters.h) menyusul layar hasil proses.
+// Histogram dikosongkan saat proses dimulai, sehingga ringkasan dan dump
+// REMOTE_CMD_PERF menggambarkan proses terakhir dan waktu sesudahnya.
+bool perfScreenPending = false;
+
+// ===================== VARIABEL PENGOSONGAN =====================
+// Menu 6: saklar buang ditutup dan tegangan dipantau tanpa menahan loop
+// utama sampai bank aman, batas waktu habis atau SELECT ditekan
+bank_monitor_t bankMonitor;
+bool pengosongan = false;
+
+// ===================== PROTOKOL KENDALI USB =====================
+// Bingkai biner (lib/remote_proto.h) di port CDC USB
+remote_t remote;
+uint32_t lastTelemetryMs = 0;
+#define REMOTE_RX_BUDGET 64 // Byte maks. per jalan TASK_USB
+
+// Rekaman TRACE() dikuras hanya saat mesin pulsa diam: selama proses CDC
+// milik bingkai tangkapan dan telemetri, dan ring cukup untuk rekaman awal
+// proses
+#define TRACE_TX_BUDGET 512 // Byte bingkai maks. per jalan TASK_USB
+
+// Bingkai tangkapan (lib/pulse_capture.h) dikirim dari ring core 1. Anggaran
+// per putaran membatasi waktu loop yang tertahan di CDC; ring yang tetap
+// penuh menjadi bingkai hilang, bukan loop yang tersendat.
+#define CAPTURE_TX_BUDGET 512 // Byte bingkai maks. per jalan TASK_USB
+uint32_t tangkapTerkirim = 0; // Bingkai proses terakhir yang sudah dikirim
+
+// ===================== UJI MANDIRI =====================
+// Menu 11: proses singkat dengan parameter aktif (tanpa picu eksternal dan
+// tangkapan I/V) yang direkam penganalisis logika sejak tepi naik CH1
+// pertama. Tangkapan dianalisis di core 0 setelah proses selesai, lalu
+// berkas VCD dikirim saat mesin pulsa diam dalam potongan REMOTE_EV_LOGIC.
+#define SELFTEST_PERIODS 3    // Periode dari penghitung: minimal 2 interval
+#define LOGIC_TX_BUDGET 512   // Byte bingkai maks. per jalan TASK_USB
+bool ujiMandiri = false;      // Proses yang berjalan adalah uji mandiri
+logic_rle_t logicRle;         // Run tangkapan terakhir (sumber VCD)
+logic_vcd_t logicVcd;
+bool logicKirim = false;      // Berkas VCD (atau hasil tanpa tangkapan) belum terkirim
+bool logicAdaTangkapan = false;
+bool logicLulus = false;
+uint32_t logicOffset = 0;     // Byte VCD yang sudah dikirim
+
+// ===================== PENJADWAL =====================
+// Loop core 0 adalah penjadwal kooperatif (lib/scheduler.h): setiap tugas
+// berjalan saat tenggatnya tiba atau saat di-post interupsi, di antaranya
+// inti tidur di WFE. Urutan enum = prioritas bila tenggat sama.
+enum
+{
+    TASK_BUTTONS = 0, // Event tombol, di-post alarm debounce
+    TASK_RUN,         // Status core 1 selama proses
+    TASK_DISCHARGE,   // Ring ADC selama pengosongan
+    TASK_USB,         // Protokol kendali, bingkai tangkapan, telemetri, jejak
+    TASK_LCD,         // Layar berkala dan layar pesan yang habis waktunya
+    TASK_FLASH,       // Commit parameter tertunda
+    TASK_COUNT,
+};
+
+#define RUN_POLL_US 1000       // Status core 1 dan ring tangkapan selama proses
+#define DISCHARGE_POLL_US 1000 // Ring ADC 8 ms pada 500 kS/s
+#define USB_POLL_MS 100        // Cadangan bila tidak ada callback CDC
+#define PARAM_RETRY_MS 100     // Commit gagal (core 1 tidak mau parkir)
+
+// Batas tunggu konfirmasi STOP dari core 1. engine_halt() selesai dalam
+// puluhan mikrodetik; lebih lama berarti core 1 macet dan pin kanal diambil
+// alih core 0.
+#define STOP_CONFIRM_TIMEOUT_US 5000
+
+sched_t scheduler;
 
 // ===================== PROTOTIPE FUNGSI =====================
 void updateMenu();
@@ -75,230 +242,285 @@ void aturFrekuensi();
 void aturLebarPulsa();
 void aturWaktuPerlakuan();
 void aturBedaFasa();
-void handle_buttons();
-void handle_menu();
-void startPulseGeneration();
-void stopPulseGeneration();
+void aturPresisi();
+void aturPreset();
+void aturPicu();
+long stepValue(long value, long delta, long min, long max);
+void handle_menu(const button_event_t *ev);
+timing_status_t startPulseGeneration();
+timing_status_t startSelfTest();
+timing_status_t launchRun(bool selftest);
+void buildPairs(pulse_engine_config_t *cfg);
+void finishSelfTest(const pulse_engine_status_t *s);
+bool stopPulseGeneration();
+void startDischarge();
+void service_discharge(const button_event_t *ev);
+void updateDischargeScreen();
+bool read_param_set(uint32_t slot, ParamSet *p);
 void load_parameters();
 void save_parameters();
-void init_pio_system();
-void configure_pio_parameters(float freq_hz, float pulse_width_ns, float phase_shift_ns);
-void calculate_delays(float sys_clk_hz, float pio_clk_div,
-                      uint32_t *delay_A, uint32_t *delay_B,
-                      uint32_t *delay_C, uint32_t *delay_D,
-                      float freq_hz, float pulse_width_ns, float phase_shift_ns);
+void commit_parameters();
+void service_param_cache();
+void save_preset(int index);
+bool load_preset(int index);
+void handle_run(const button_event_t *ev);
+void updateRunScreen(const pulse_engine_status_t *s);
+void apply_sys_clock();
+long stepParam(long value, long delta, remote_param_t id);
+long stepScaled(long value, long dir, long step, remote_param_t id);
+void showMessageScreen();
+void closeMessageScreen();
+void showPerfScreen();
+void print_perf();
+void service_message_screen();
+bool service_remote();
+void service_capture(bool flush);
+bool service_trace();
+bool service_logic();
+void send_telemetry();
+void refreshRunScreen();
+void schedule_commit();
+void schedule_usb(uint64_t now_us, bool more);
+void task_buttons(uint64_t now_us);
+void task_run(uint64_t now_us);
+void task_discharge(uint64_t now_us);
+void task_usb(uint64_t now_us);
+void task_lcd(uint64_t now_us);
+void task_flash(uint64_t now_us);
+void app_init();
+void app_loop();
 
-// ===================== ALARM CALLBACK =====================
-int64_t alarm_callback(alarm_id_t id, void *user_data)
-{
-    // Hentikan state machine PIO
-    pio_sm_set_enabled(pio, sm, false);
-    process_complete = true;
-    return 0; // Tidak perlu mengulang alarm
-}
+// Tabel tugas statis; nama maks. SCHED_NAME_MAX karakter (REMOTE_CMD_TASKS)
+sched_task_t tasks[TASK_COUNT] = {
+    [TASK_BUTTONS] = {.name = "tombol", .run = task_buttons},
+    [TASK_RUN] = {.name = "proses", .run = task_run},
+    [TASK_DISCHARGE] = {.name = "bank", .run = task_discharge},
+    [TASK_USB] = {.name = "usb", .run = task_usb},
+    [TASK_LCD] = {.name = "layar", .run = task_lcd},
+    [TASK_FLASH] = {.name = "flash", .run = task_flash},
+};
 
 // ===================== FUNGSI TAMPILAN LCD =====================
 void updateMenu()
 {
-    lcd_clear();
+    lcd_fb_clear();
     char buf[17];
 
     switch (menu)
     {
     case 1:
-        lcd_set_cursor(0, 0);
-        lcd_string("FREKUENSI");
-        lcd_set_cursor(1, 0);
-        sprintf(buf, "%ld Hz", frekuensi);
-        lcd_string(buf);
+        lcd_fb_print(0, 0, "FREKUENSI");
+        if (frekuensi >= 1000)
+            sprintf(buf, "%.1f kHz", frekuensi / 1000.0);
+        else
+            sprintf(buf, "%ld Hz", frekuensi);
+        lcd_fb_print(1, 0, buf);
         break;
     case 2:
-        lcd_set_cursor(0, 0);
-        lcd_string("LEBAR PULSA");
-        lcd_set_cursor(1, 0);
+        lcd_fb_print(0, 0, "LEBAR PULSA");
         if (lebarPulsa >= 1000)
             sprintf(buf, "%.1f uS", lebarPulsa / 1000.0);
         else
             sprintf(buf, "%ld nS", lebarPulsa);
-        lcd_string(buf);
+        lcd_fb_print(1, 0, buf);
         break;
     case 3:
-        lcd_set_cursor(0, 0);
-        lcd_string("WAKTU PROSES");
-        lcd_set_cursor(1, 0);
+        lcd_fb_print(0, 0, "WAKTU PROSES");
         sprintf(buf, "%d DETIK", waktuPerlakuan);
-        lcd_string(buf);
+        lcd_fb_print(1, 0, buf);
         break;
     case 4:
-        lcd_set_cursor(0, 0);
-        lcd_string("BEDA FASA");
-        lcd_set_cursor(1, 0);
+        lcd_fb_print(0, 0, "BEDA FASA");
         if (bedaFasa >= 1000)
             sprintf(buf, "%.1f uS", bedaFasa / 1000.0);
         else
             sprintf(buf, "%ld nS", bedaFasa);
-        lcd_string(buf);
+        lcd_fb_print(1, 0, buf);
         break;
     case 5:
-        lcd_set_cursor(0, 0);
-        lcd_string(" MULAI PROSES ");
+        lcd_fb_print(0, 0, " MULAI PROSES ");
         break;
     case 6:
-        lcd_set_cursor(0, 0);
-        lcd_string("KOSONGKAN");
-        lcd_set_cursor(1, 0);
-        lcd_string("KAPASITOR BANK");
+        lcd_fb_print(0, 0, "KOSONGKAN");
+        lcd_fb_print(1, 0, "KAPASITOR BANK");
+        break;
+    case 7:
+        lcd_fb_print(0, 0, "MODE PRESISI");
+        lcd_fb_print(1, 0, presisiTinggi ? "TINGGI 250MHz" : "NORMAL 125MHz");
+        break;
+    case 8:
+        lcd_fb_print(0, 0, "SIMPAN PRESET");
+        break;
+    case 9:
+        lcd_fb_print(0, 0, "MUAT PRESET");
+        break;
+    case 10:
+        lcd_fb_print(0, 0, "SUMBER PICU");
+        lcd_fb_print(1, 0, picuEksternal ? "EKSTERNAL GP11" : "INTERNAL");
+        break;
+    case 11:
+        lcd_fb_print(0, 0, "UJI MANDIRI");
+        lcd_fb_print(1, 0, "PW/DT/PERIODE");
         break;
     }
+    lcd_fb_flush();
 }
 
 void aturFrekuensi()
 {
-    lcd_clear();
+    lcd_fb_clear();
     char buf[17];
-    lcd_set_cursor(0, 0);
-    lcd_string("SET FREKUENSI");
-    lcd_set_cursor(1, 0);
-    sprintf(buf, "%ld Hz ", frekuensi);
-    lcd_string(buf);
+    lcd_fb_print(0, 0, "SET FREKUENSI");
+    if (frekuensi >= 1000)
+        sprintf(buf, "%.1f kHz ", frekuensi / 1000.0);
+    else
+        sprintf(buf, "%ld Hz ", frekuensi);
+    lcd_fb_print(1, 0, buf);
+    lcd_fb_flush();
 }
 
 void aturLebarPulsa()
 {
-    lcd_clear();
+    lcd_fb_clear();
     char buf[17];
-    lcd_set_cursor(0, 0);
-    lcd_string("SET LEBAR PULSA");
-    lcd_set_cursor(1, 0);
+    lcd_fb_print(0, 0, "SET LEBAR PULSA");
     if (lebarPulsa >= 1000)
         sprintf(buf, "%.1f uS ", lebarPulsa / 1000.0);
     else
         sprintf(buf, "%ld nS ", lebarPulsa);
-    lcd_string(buf);
+    lcd_fb_print(1, 0, buf);
+    lcd_fb_flush();
 }
 
 void aturWaktuPerlakuan()
 {
-    lcd_clear();
+    lcd_fb_clear();
     char buf[17];
-    lcd_set_cursor(0, 0);
-    lcd_string("SET WAKTU PROSES");
-    lcd_set_cursor(1, 0);
+    lcd_fb_print(0, 0, "SET WAKTU PROSES");
     sprintf(buf, "%d DETIK ", waktuPerlakuan);
-    lcd_string(buf);
+    lcd_fb_print(1, 0, buf);
+    lcd_fb_flush();
 }
 
 void aturBedaFasa()
 {
-    lcd_clear();
+    lcd_fb_clear();
     char buf[17];
-    lcd_set_cursor(0, 0);
-    lcd_string("SET BEDA FASA");
-    lcd_set_cursor(1, 0);
+    lcd_fb_print(0, 0, "SET BEDA FASA");
     if (bedaFasa >= 1000)
         sprintf(buf, "%.1f uS ", bedaFasa / 1000.0);
     else
         sprintf(buf, "%ld nS ", bedaFasa);
-    lcd_string(buf);
+    lcd_fb_print(1, 0, buf);
+    lcd_fb_flush();
 }
 
-// ===================== FUNGSI LOGIKA BUTTON & MENU =====================
-void handle_buttons()
+void aturPresisi()
 {
-    uint32_t now = to_ms_since_boot(get_absolute_time());
-    selectEvent = 0;
-    upEvent = 0;
-    downEvent = 0;
+    lcd_fb_clear();
+    lcd_fb_print(0, 0, "SET MODE PRESISI");
+    lcd_fb_print(1, 0, presisiTinggi ? "TINGGI 250MHz " : "NORMAL 125MHz ");
+    lcd_fb_flush();
+}
 
-    if (!gpio_get(SELECT_BUTTON_PIN))
-    {
-        if (!select_pressed_flag)
-        {
-            select_pressed_flag = true;
-            last_press_time_select = now;
-            selectEvent = 1;
-        }
-        else if (!select_held_flag && (now - last_press_time_select > HOLD_DELAY_MS))
-        {
-            select_held_flag = true;
-        }
-    }
-    else
+void aturPreset()
+{
+    lcd_fb_clear();
+    char buf[17];
+    lcd_fb_print(0, 0, menu == 8 ? "SIMPAN KE PRESET" : "MUAT PRESET");
+    if (presetIndex == 0)
     {
-        select_pressed_flag = false;
-        select_held_flag = false;
+        lcd_fb_print(1, 0, "BATAL");
+        lcd_fb_flush();
+        return;
     }
 
-    if (!gpio_get(UP_BUTTON_PIN))
-    {
-        if (!up_pressed_flag)
-        {
-            up_pressed_flag = true;
-            last_press_time_up = now;
-            upEvent = 1;
-        }
-        else if (now - last_press_time_up > HOLD_DELAY_MS)
-        {
-            up_held_flag = true;
-            if (now - last_repeat_time_up > REPEAT_DELAY_MS)
-            {
-                upEvent = 2;
-                last_repeat_time_up = now;
-            }
-        }
-    }
+    // Ringkasan isi preset: "3 100Hz 3.5uS" atau "3 KOSONG"
+    ParamSet p;
+    if (read_param_set(presetIndex, &p))
+        snprintf(buf, sizeof(buf), "%d %ldHz %ld.%ldu", presetIndex, (long)p.frekuensi,
+                 (long)p.lebarPulsa / 1000, ((long)p.lebarPulsa % 1000) / 100);
     else
-    {
-        up_pressed_flag = false;
-        up_held_flag = false;
-    }
+        snprintf(buf, sizeof(buf), "%d KOSONG", presetIndex);
+    lcd_fb_print(1, 0, buf);
+    lcd_fb_flush();
+}
 
-    if (!gpio_get(DOWN_BUTTON_PIN))
-    {
-        if (!down_pressed_flag)
-        {
-            down_pressed_flag = true;
-            last_press_time_down = now;
-            downEvent = 1;
-        }
-        else if (now - last_press_time_down > HOLD_DELAY_MS)
-        {
-            down_held_flag = true;
-            if (now - last_repeat_time_down > REPEAT_DELAY_MS)
-            {
-                downEvent = 2;
-                last_repeat_time_down = now;
-            }
-        }
-    }
+void aturPicu()
+{
+    lcd_fb_clear();
+    lcd_fb_print(0, 0, "SET SUMBER PICU");
+    lcd_fb_print(1, 0, picuEksternal ? "EKSTERNAL GP11 " : "INTERNAL       ");
+    lcd_fb_flush();
+}
+
+// ===================== FUNGSI LOGIKA BUTTON & MENU =====================
+// Langkah nilai dengan pengali auto-repeat (x1, x10, x100), dibatasi ke rentang
+long stepValue(long value, long delta, long min, long max)
+{
+    value += delta;
+    if (value < min)
+        value = min;
+    if (value > max)
+        value = max;
+    return value;
+}
+
+// Rentang parameter sama dengan yang diterima protokol kendali
+long stepParam(long value, long delta, remote_param_t id)
+{
+    int32_t min, max;
+    remote_param_range(id, &min, &max);
+    return stepValue(value, delta, min, max);
+}
+
+// Langkah sebanding besaran nilai (frekuensi: 10 Hz di bawah 1 kHz lalu
+// 100 Hz, 1 kHz, 10 kHz per dekade; waktu: 10 ns di bawah 100 ns lalu 100 ns).
+// Saat turun langkah dipilih dari nilai di bawahnya agar 1000 -> 990.
+long stepScaled(long value, long dir, long step, remote_param_t id)
+{
+    long ref = dir < 0 ? value - 1 : value;
+    long unit;
+    if (id == REMOTE_PARAM_FREQ_HZ)
+        unit = ref < 1000 ? 10 : ref < 10000 ? 100 : ref < 100000 ? 1000 : 10000;
     else
-    {
-        down_pressed_flag = false;
-        down_held_flag = false;
-    }
+        unit = ref < 100 ? 10 : 100;
+    return stepParam(value, dir * step * unit, id);
 }
 
-void handle_menu()
+void handle_menu(const button_event_t *ev)
 {
+    // PRESS: tekanan baru; REPEAT: masih ditahan (hanya UP/DOWN di submenu)
+    bool press = ev->type == BUTTON_EV_PRESS;
+    bool adjust = press || ev->type == BUTTON_EV_REPEAT;
+
+    // Tombol apa pun menutup layar pesan lebih awal
+    if (messageScreen)
+    {
+        if (press)
+            closeMessageScreen();
+        return;
+    }
+    int dir = 0;
+    if (ev->button == BUTTON_UP)
+        dir = 1;
+    else if (ev->button == BUTTON_DOWN)
+        dir = -1;
+
     if (!subMenu)
     {
-        if (upEvent == 1)
+        if (press && dir != 0)
         {
-            menu++;
-            if (menu > 6)
+            menu += dir;
+            if (menu > JUMLAH_MENU)
                 menu = 1;
-            updateMenu();
-        }
-        if (downEvent == 1)
-        {
-            menu--;
             if (menu < 1)
-                menu = 6;
+                menu = JUMLAH_MENU;
             updateMenu();
         }
-        if (selectEvent == 1)
+        if (press && ev->button == BUTTON_SELECT)
         {
-            if (menu >= 1 && menu <= 4)
+            if ((menu >= 1 && menu <= 4) || (menu >= 7 && menu <= 10))
             {
                 subMenu = true;
                 if (menu == 1)
@@ -309,6 +531,15 @@ void handle_menu()
                     aturWaktuPerlakuan();
                 if (menu == 4)
                     aturBedaFasa();
+                if (menu == 7)
+                    aturPresisi();
+                if (menu == 10)
+                    aturPicu();
+                if (menu == 8 || menu == 9)
+                {
+                    presetIndex = 0;
+                    aturPreset();
+                }
             }
             else if (menu == 5) // Mulai Proses - TITIK INTEGRASI KRITIS
             {
@@ -316,280 +547,1225 @@ void handle_menu()
             }
             else if (menu == 6)
             {
-                lcd_clear();
-                lcd_set_cursor(0, 0);
-                lcd_string("MENGOSONGKAN...");
-                sleep_ms(2000);
-                updateMenu();
+                startDischarge();
+            }
+            else if (menu == 11)
+            {
+                startSelfTest();
             }
         }
     }
     else
     {
-        if (selectEvent == 1)
+        if (press && ev->button == BUTTON_SELECT)
         {
-            save_parameters();
+            if (menu == 8 && presetIndex > 0)
+            {
+                save_preset(presetIndex);
+            }
+            else if (menu == 9 && presetIndex > 0)
+            {
+                // Resep dipanggil menjadi parameter aktif (termasuk mode clock)
+                if (load_preset(presetIndex))
+                {
+                    save_parameters();
+                    apply_sys_clock();
+                }
+            }
+            else if (menu <= 7 || menu == 10)
+            {
+                save_parameters();
+                if (menu == 7)
+                    apply_sys_clock();
+            }
             subMenu = false;
             updateMenu();
+            return;
         }
+        if (!adjust || dir == 0)
+            return;
+
+        long step = dir * (long)ev->step;
         if (menu == 1)
         {
-            if (upEvent == 1 || upEvent == 2)
-            {
-                if (frekuensi < 1000)
-                    frekuensi += 10;
-                aturFrekuensi();
-            }
-            if (downEvent == 1 || downEvent == 2)
-            {
-                if (frekuensi > 10)
-                    frekuensi -= 10;
-                aturFrekuensi();
-            }
+            frekuensi = stepScaled(frekuensi, dir, ev->step, REMOTE_PARAM_FREQ_HZ);
+            aturFrekuensi();
         }
         else if (menu == 2)
         {
-            if (upEvent == 1 || upEvent == 2)
-            {
-                if (lebarPulsa < 50000)
-                    lebarPulsa += 100;
-                aturLebarPulsa();
-            }
-            if (downEvent == 1 || downEvent == 2)
-            {
-                if (lebarPulsa > 100)
-                    lebarPulsa -= 100;
-                aturLebarPulsa();
-            }
+            lebarPulsa = stepScaled(lebarPulsa, dir, ev->step, REMOTE_PARAM_PULSE_NS);
+            aturLebarPulsa();
         }
         else if (menu == 3)
         {
-            if (upEvent == 1 || upEvent == 2)
-            {
-                if (waktuPerlakuan < 30) // Rentang 1-30 detik
-                    waktuPerlakuan++;
-                aturWaktuPerlakuan();
-            }
-            if (downEvent == 1 || downEvent == 2)
-            {
-                if (waktuPerlakuan > 1)
-                    waktuPerlakuan--;
-                aturWaktuPerlakuan();
-            }
+            waktuPerlakuan = stepParam(waktuPerlakuan, step, REMOTE_PARAM_DURATION_S); // Rentang 1-30 detik
+            aturWaktuPerlakuan();
         }
         else if (menu == 4)
         {
-            if (upEvent == 1 || upEvent == 2)
-            {
-                if (bedaFasa < 10000)
-                    bedaFasa += 100;
-                aturBedaFasa();
-            }
-            if (downEvent == 1 || downEvent == 2)
-            {
-                if (bedaFasa > 100)
-                    bedaFasa -= 100;
-                aturBedaFasa();
-            }
+            bedaFasa = stepScaled(bedaFasa, dir, ev->step, REMOTE_PARAM_PHASE_NS);
+            aturBedaFasa();
+        }
+        else if (menu == 7 && press)
+        {
+            presisiTinggi = !presisiTinggi;
+            aturPresisi();
+        }
+        else if (menu == 10 && press)
+        {
+            picuEksternal = !picuEksternal;
+            aturPicu();
+        }
+        else if ((menu == 8 || menu == 9) && press)
+        {
+            presetIndex = (presetIndex + dir + JUMLAH_PRESET + 1) % (JUMLAH_PRESET + 1);
+            aturPreset();
         }
     }
 }
 
-// ===================== FUNGSI PIO DAN GENERASI SINYAL =====================
-void init_pio_system()
+// ===================== FUNGSI GENERASI SINYAL =====================
+timing_status_t startPulseGeneration()
 {
-    // Muat program PIO dan klaim state machine
-    offset = pio_add_program(pio, &signal_generator_program);
-    sm = pio_claim_unused_sm(pio, true);
+    return launchRun(false);
+}
 
-    // Konfigurasi awal (akan dikonfigurasi ulang setiap kali dimulai)
-    pio_sm_config c = signal_generator_program_get_default_config(offset);
+timing_status_t startSelfTest()
+{
+    return launchRun(true);
+}
 
-    // Konfigurasi pin output
-    sm_config_set_set_pins(&c, PIN_CH1_BASE, 4);
-    for (uint i = 0; i < 4; ++i)
+timing_status_t launchRun(bool selftest)
+{
+    // LOGIKA GEM: Baca parameter dari UI. Beda fasa UI diukur dari awal pulsa
+    // CH1 ke awal pulsa CH2, sehingga dead time = bedaFasa - lebarPulsa.
+    // Salinan ini satu-satunya jalur parameter UI menuju core 1.
+    pulse_engine_config_t cfg = {
+        .timing = {(uint32_t)frekuensi, (uint32_t)lebarPulsa, (uint32_t)bedaFasa},
+        .duration_ms = (uint32_t)waktuPerlakuan * 1000u,
+        // Parameter UI tidak berubah selama proses berjalan: program statis,
+        // kecuali protokol meminta preset bipolar disusun sebagai tabel pola
+        .constant_params = programPola == 0,
+        .external_trigger = picuEksternal != 0,
+        .capture_pairs = (uint8_t)tangkapPasangan,
+    };
+    if (programPola == 2 && !selftest)
+        buildPairs(&cfg);
+    if (selftest)
     {
-        pio_gpio_init(pio, PIN_CH1_BASE + i);
+        // SELFTEST_PERIODS periode (dibulatkan ke atas ke ms), mulai segera
+        cfg.duration_ms = (SELFTEST_PERIODS * 1000u + (uint32_t)frekuensi - 1) / (uint32_t)frekuensi;
+        cfg.external_trigger = false;
+        cfg.capture_pairs = 0;
+        cfg.logic_capture = true;
     }
-    pio_sm_set_consecutive_pindirs(pio, sm, PIN_CH1_BASE, 4, true);
 
-    // Inisialisasi state machine (masih disabled)
-    pio_sm_init(pio, sm, offset, &c);
-}
+    // Resep yang akan dijalankan disimpan lebih dulu; selama proses berjalan
+    // flash tidak pernah ditulis
+    commit_parameters();
 
-void configure_pio_parameters(float freq_hz, float pulse_width_ns, float phase_shift_ns)
-{
-    // LOGIKA GEM: Konversi parameter UI ke konfigurasi PIO
+    // Core 1 memilih program, menjalankan perencana resolusi dan menyiapkan SM
+    timing_status_t status = pulse_engine_configure(&cfg);
 
-    // Hitung clock divider yang optimal untuk resolusi yang diinginkan
-    float sys_clk_hz = clock_get_hz(clk_sys);
-    float target_resolution_ns = 100.0f; // Resolusi 100ns untuk presisi yang baik
-    float pio_clk_div = (sys_clk_hz * target_resolution_ns) / 1e9f;
+    pulse_engine_status_t s;
+    pulse_engine_status(&s);
+    const timing_plan_t *plan = &s.plan;
+    TRACE("Konfigurasi PIO: Freq=%lu Hz, Pulse=%lu ns, Phase=%lu ns -> %s", cfg.timing.freq_hz,
+          cfg.timing.pulse_width_ns, cfg.timing.phase_ns, TRACE_STR(timing_status_str(status)));
+    if (s.pairs > 0)
+        TRACE("Program PIO: %lu pasangan independen, pola %lu event + DMA per pasangan (start sinkron GP%lu)",
+              s.pairs, s.pattern_events, (uint32_t)PE_GROUP_SYNC_PIN);
+    else if (s.unrolled)
+        TRACE("Program PIO: terurai %lu instruksi (tanpa FIFO/DMA, overhead %lu siklus/event)",
+              s.program_length, s.event_overhead);
+    else if (s.static_program)
+        TRACE("Program PIO: statis (overhead %lu siklus/event)", s.event_overhead);
+    else
+        TRACE("Program PIO: pola %lu event + DMA (overhead %lu siklus/event)",
+              s.pattern_events, s.event_overhead);
+    TRACE("Delays: A=%lu, B=%lu, C=%lu, D=%lu cycles",
+          plan->delay[0], plan->delay[1], plan->delay[2], plan->delay[3]);
+    TRACE("Hasil: Periode=%lu ns, Pulse=%lu ns, Dead time=%lu ns",
+          plan->period_ns, plan->pulse_width_ns, plan->dead_time_ns);
+    TRACE("Resolusi: %lu.%03lu ns (clk_sys %lu Hz, clkdiv %lu+%lu/256)",
+          s.resolution_ps / 1000, s.resolution_ps % 1000, s.sys_clk_hz,
+          s.clkdiv_fixed >> 8, s.clkdiv_fixed & 0xff);
+    if (s.periods > 0)
+        TRACE("Durasi: %lu ms -> tepat %lu periode (berhenti di batas periode)", s.duration_ms, s.periods);
+    else
+        TRACE("Durasi: %lu ms (dihentikan menurut waktu)", s.duration_ms);
+    if (s.external_trigger)
+        TRACE("Picu: eksternal, proses mulai pada tepi naik GP11 (SELECT membatalkan)");
 
-    // Batasi clock divider dalam rentang yang valid (1.0 - 65536.0)
-    if (pio_clk_div < 1.0f)
-        pio_clk_div = 1.0f;
-    if (pio_clk_div > 65536.0f)
-        pio_clk_div = 65536.0f;
+    if (status != TIMING_OK)
+    {
+        // Jangan jalankan bentuk gelombang yang berbeda dari yang diminta
+        lcd_fb_clear();
+        lcd_fb_print(0, 0, "PARAM TDK VALID");
+        lcd_fb_print(1, 0, timing_status_str(status));
+        lcd_fb_flush();
+        showMessageScreen();
+        return status;
+    }
+
+    char buf[17];
+    lcd_fb_clear();
+    lcd_fb_print(0, 0, selftest ? "UJI MANDIRI..." : "PROSES DIMULAI");
+    uint32_t resolution_tenth_ns = (s.resolution_ps + 50) / 100;
+    sprintf(buf, "RES %lu.%lu nS", resolution_tenth_ns / 10, resolution_tenth_ns % 10);
+    lcd_fb_print(1, 0, buf);
+    lcd_fb_flush();
 
-    printf("Konfigurasi PIO: Freq=%.1f Hz, Pulse=%.1f ns, Phase=%.1f ns\n",
-           freq_hz, pulse_width_ns, phase_shift_ns);
-    printf("System Clock=%.1f Hz, PIO Clock Div=%.2f\n", sys_clk_hz, pio_clk_div);
+    // Resistor buang dilepas dari bank sebelum pulsa pertama
+    gpio_put(BANK_DUMP_PIN, 0);
 
-    // Rekonfigurasi state machine dengan parameter baru
-    pio_sm_config c = signal_generator_program_get_default_config(offset);
-    sm_config_set_set_pins(&c, PIN_CH1_BASE, 4);
-    sm_config_set_clkdiv(&c, pio_clk_div); // KONEKSI PARAMETER KRITIS
+    // Core 1 menjalankan PIO sampai durasi habis; core 0 tetap melayani tombol
+    perf_reset();
+    sched_reset_stats(&scheduler);
+    tangkapTerkirim = 0;
+    ujiMandiri = selftest;
+    logicKirim = false;
+    pulse_engine_start();
+    prosesBerjalan = true;
+    messageScreen = false;
+    perfScreenPending = false;
+    lastTelemetryMs = to_ms_since_boot(get_absolute_time());
 
-    // Terapkan konfigurasi baru
-    pio_sm_init(pio, sm, offset, &c);
+    // Status core 1 tiap 1 ms, layar tiap RUN_SCREEN_INTERVAL_MS; TASK_USB
+    // menghitung ulang tenggat tangkapan/telemetri
+    uint64_t now = time_us_64();
+    sched_at(&scheduler, TASK_RUN, now + RUN_POLL_US);
+    sched_at(&scheduler, TASK_LCD, now + RUN_SCREEN_INTERVAL_MS * 1000ull);
+    sched_at(&scheduler, TASK_USB, now);
+    return status;
 }
 
-void calculate_delays(float sys_clk_hz, float pio_clk_div,
-                      uint32_t *delay_A, uint32_t *delay_B,
-                      uint32_t *delay_C, uint32_t *delay_D,
-                      float freq_hz, float pulse_width_ns, float phase_shift_ns)
+// Pasangan independen: preset bipolar dua pin per pasangan. Preset 1 kosong
+// atau parameter yang tidak valid meninggalkan pola kosong, yang ditolak
+// core 1 sebagai POLA TDK VALID.
+void buildPairs(pulse_engine_config_t *cfg)
 {
-    float pio_clk_hz = sys_clk_hz / pio_clk_div;
-    float period_s = 1.0f / freq_hz;
-    uint32_t total_pio_cycles = (uint32_t)(period_s * pio_clk_hz);
-    uint32_t pulse_width_cycles = (uint32_t)(pulse_width_ns * 1e-9f * pio_clk_hz);
-    uint32_t phase_shift_cycles = (uint32_t)(phase_shift_ns * 1e-9f * pio_clk_hz);
+    ParamSet preset;
+    timing_request_t second = {0};
+    if (read_param_set(1, &preset))
+        second = (timing_request_t){(uint32_t)preset.frekuensi, (uint32_t)preset.lebarPulsa,
+                                    (uint32_t)preset.bedaFasa};
+    const timing_request_t *req[PE_MAX_PAIRS] = {&cfg->timing, &second};
+    for (int i = 0; i < PE_MAX_PAIRS; i++)
+    {
+        pattern_init(&polaPasangan[i], 0);
+        pattern_bipolar_pair(&polaPasangan[i], req[i]);
+        cfg->pairs[i] = &polaPasangan[i];
+    }
+    cfg->pair_count = PE_MAX_PAIRS;
+}
 
-    // Durasi setiap event dalam siklus PIO (sesuai sekuens 1001, 0000, 0110, 0000)
-    uint32_t event_A_duration = pulse_width_cycles; // CH1/CH4 HIGH
-    uint32_t event_B_duration = phase_shift_cycles; // Dead time
-    uint32_t event_C_duration = pulse_width_cycles; // CH2/CH3 HIGH
-    uint32_t event_D_duration = total_pio_cycles - event_A_duration - event_B_duration - event_C_duration;
+// false bila core 1 tidak mengonfirmasi dalam STOP_CONFIRM_TIMEOUT_US; pin
+// kanal dan picu keluar kemudian sudah dipaksa LOW lewat SIO
+bool stopPulseGeneration()
+{
+    uint64_t requested_us = time_us_64();
+    pulse_engine_stop();
 
-    // Nilai N untuk loop counter PIO (dengan overhead 4 siklus per loop)
-    *delay_A = event_A_duration > 4 ? event_A_duration - 4 : 0;
-    *delay_B = event_B_duration > 4 ? event_B_duration - 4 : 0;
-    *delay_C = event_C_duration > 4 ? event_C_duration - 4 : 0;
-    *delay_D = event_D_duration > 4 ? event_D_duration - 4 : 0;
+    // Tunggu core 1 mengonfirmasi SM sudah dimatikan dan pin LOW
+    pulse_engine_status_t s;
+    pulse_engine_status(&s);
+    while (s.state == PE_STATE_RUNNING || s.state == PE_STATE_ARMED)
+    {
+        if (time_us_64() - requested_us >= STOP_CONFIRM_TIMEOUT_US)
+        {
+            // SM mungkin masih berjalan atau berhenti dengan pin HIGH: lepas
+            // GP6..GP10 dari PIO dan tarik LOW dari core 0
+            for (uint i = 0; i <= PE_TRIGGER_OUT_OFFSET; i++)
+            {
+                gpio_init(PIN_CH1_BASE + i);
+                gpio_set_dir(PIN_CH1_BASE + i, GPIO_OUT);
+                gpio_put(PIN_CH1_BASE + i, 0);
+            }
+            stopGagal = true;
+            TRACE("GALAT: core 1 tidak mengonfirmasi STOP dalam %lu us, GP%lu..GP%lu dipaksa LOW",
+                  (uint32_t)STOP_CONFIRM_TIMEOUT_US, (uint32_t)PIN_CH1_BASE,
+                  (uint32_t)(PIN_CH1_BASE + PE_TRIGGER_OUT_OFFSET));
+            return false;
+        }
+        tight_loop_contents();
+        pulse_engine_status(&s);
+    }
 
-    printf("Delays: A=%lu, B=%lu, C=%lu, D=%lu cycles\n", *delay_A, *delay_B, *delay_C, *delay_D);
+    TRACE("Generasi pulsa dibatalkan (latensi %llu us).",
+          TRACE_U64(s.stop_us > requested_us ? s.stop_us - requested_us : 0));
+    return true;
 }
 
-void startPulseGeneration()
+void updateRunScreen(const pulse_engine_status_t *s)
 {
-    // LOGIKA GEM: Baca parameter dari UI dan konfigurasi PIO
-    float freq_hz = (float)frekuensi;
-    float pulse_width_ns = (float)lebarPulsa;
-    float phase_shift_ns = (float)bedaFasa - (float)lebarPulsa;
-
-    lcd_clear();
-    lcd_set_cursor(0, 0);
-    lcd_string("PROSES DIMULAI");
-
-    // Konfigurasi ulang PIO dengan parameter terkini
-    configure_pio_parameters(freq_hz, pulse_width_ns, phase_shift_ns);
+    // Tanpa lcd_fb_clear(): hanya digit waktu yang berubah yang dikirim
+    char buf[17];
+    uint64_t elapsed_ms = (time_us_64() - s->start_us) / 1000u;
+    if (elapsed_ms > s->duration_ms)
+        elapsed_ms = s->duration_ms;
+    uint64_t remaining_ms = s->duration_ms - elapsed_ms;
 
-    // Hitung delay values
-    uint32_t delay_A, delay_B, delay_C, delay_D;
-    float sys_clk_hz = clock_get_hz(clk_sys);
-    float pio_clk_div = (sys_clk_hz * 100.0f) / 1e9f; // Sesuaikan dengan yang digunakan di configure_pio_parameters
-    if (pio_clk_div < 1.0f)
-        pio_clk_div = 1.0f;
-    if (pio_clk_div > 65536.0f)
-        pio_clk_div = 65536.0f;
+    lcd_fb_print(0, 0, "BERJALAN SEL=STP");
+    snprintf(buf, sizeof(buf), "%2lu.%lus SISA %2lu.%lus",
+             (uint32_t)(elapsed_ms / 1000), (uint32_t)(elapsed_ms % 1000) / 100,
+             (uint32_t)(remaining_ms / 1000), (uint32_t)(remaining_ms % 1000) / 100);
+    lcd_fb_print(1, 0, buf);
+    lcd_fb_flush();
+}
 
-    calculate_delays(sys_clk_hz, pio_clk_div, &delay_A, &delay_B, &delay_C, &delay_D,
-                     freq_hz, pulse_width_ns, phase_shift_ns);
+void handle_run(const button_event_t *ev)
+{
+    pulse_engine_status_t s;
+    pulse_engine_status(&s);
 
-    // Set alarm untuk menghentikan proses
-    process_complete = false;
-    add_alarm_in_ms(waktuPerlakuan * 1000, alarm_callback, NULL, false);
+    // Menunggu picu dihitung berjalan: SELECT membatalkan, tidak ada simpan.
+    // Setelah STOP gagal status core 1 tidak lagi dipercaya.
+    bool aktif = (s.state == PE_STATE_RUNNING || s.state == PE_STATE_ARMED) && !stopGagal;
+    if (aktif && ev && ev->button == BUTTON_SELECT && ev->type == BUTTON_EV_PRESS)
+    {
+        stopPulseGeneration();
+        pulse_engine_status(&s);
+        aktif = false;
+    }
 
-    // Mulai state machine PIO
-    pio_sm_set_enabled(pio, sm, true);
+    // Layar berjalan diperbarui TASK_LCD
+    if (aktif)
+        return;
 
-    // Loop non-blocking untuk memberikan data ke PIO
-    while (!process_complete)
+    // Tampilkan hasil: pulsa CH1 terukur / diharapkan, atau hasil uji mandiri
+    prosesBerjalan = false;
+    const pulse_report_t *d = &s.delivered;
+    if (ujiMandiri)
     {
-        // Kirim delay values ke PIO secara berulang
-        if (!pio_sm_is_tx_fifo_full(pio, sm))
-        {
-            pio_sm_put(pio, sm, delay_A);
-        }
-        if (!pio_sm_is_tx_fifo_full(pio, sm))
+        finishSelfTest(&s);
+    }
+    else
+    {
+        char buf[17];
+        lcd_fb_clear();
+        if (stopGagal)
         {
-            pio_sm_put(pio, sm, delay_B);
+            // Laporan core 1 tidak lengkap: tampilkan galat, bukan hitungan
+            lcd_fb_print(0, 0, "STOP GAGAL!");
+            lcd_fb_print(1, 0, "PIN DIPAKSA LOW");
         }
-        if (!pio_sm_is_tx_fifo_full(pio, sm))
+        else
         {
-            pio_sm_put(pio, sm, delay_C);
+            lcd_fb_print(0, 0, s.state == PE_STATE_ABORTED ? "PROSES DIBATAL" : "PROSES SELESAI!");
+            snprintf(buf, sizeof(buf), "%lu/%lu PLS", d->pulses, d->expected);
+            lcd_fb_print(1, 0, buf);
         }
-        if (!pio_sm_is_tx_fifo_full(pio, sm))
+        lcd_fb_flush();
+    }
+
+    TRACE("Dosis CH1: %lu pulsa (diharapkan %lu, selisih %ld), periode rata-rata %lu ns, "
+          "total ON %llu ns",
+          d->pulses, d->expected, (int32_t)(d->pulses - d->expected), d->mean_period_ns,
+          TRACE_U64(d->on_time_ns));
+    if (s.periods > 0)
+        TRACE("Periode: %lu/%lu dijalankan", s.periods_done, s.periods);
+
+    uint32_t depth, high_water, aborts;
+    lcd_queue_stats(&depth, &high_water, &aborts);
+    TRACE("Antrean LCD: puncak %lu sel/perintah, %lu abort I2C", high_water, aborts);
+    perf_note_fifo(s.fifo_samples, s.fifo_underruns);
+    print_perf();
+
+    // Core 1 sudah menutup burst terakhir: kirim sisa ring sebelum telemetri
+    if (tangkapPasangan > 0)
+    {
+        service_capture(true);
+        const capture_ring_t *r = pulse_capture_ring();
+        TRACE("Tangkapan: %lu bingkai terkirim, %lu hilang (ADC sibuk %lu, ring penuh %lu)",
+              tangkapTerkirim, capture_ring_dropped(r), r->dropped_busy, r->dropped_full);
+    }
+
+    // Telemetri akhir selalu dikirim, tanpa perlu STREAM
+    send_telemetry();
+    showMessageScreen();
+    perfScreenPending = true;
+    schedule_commit();
+}
+
+// Akhir uji mandiri: tangkapan -> run -> pengukuran terhadap parameter UI.
+// Toleransi lebar dan dead time = resolusi mesin pulsa (pembulatan
+// perencana) + satu sampel (tepi jatuh di antara dua sampel); periode dari
+// penghitung pulsa = resolusi mesin pulsa + galat rentang penghitung.
+void finishSelfTest(const pulse_engine_status_t *s)
+{
+    ujiMandiri = false;
+    logic_capture_t cap;
+    logic_result_t r = {0};
+    logic_expect_t e = {
+        .expect_ns = {
+            [LOGIC_PULSE_A] = (uint32_t)lebarPulsa,
+            [LOGIC_PULSE_C] = (uint32_t)lebarPulsa,
+            [LOGIC_DEAD_TIME] = (uint32_t)(bedaFasa - lebarPulsa),
+            [LOGIC_PERIOD] = (uint32_t)((1000000000u + (uint32_t)frekuensi / 2) / (uint32_t)frekuensi),
+        },
+    };
+    logicAdaTangkapan = s->state == PE_STATE_DONE && logic_analyzer_capture(&cap) && cap.samples > 0;
+    logicLulus = false;
+    if (logicAdaTangkapan)
+    {
+        logic_rle_encode(&cap, &logicRle);
+        uint32_t sample_ps = timing_resolution_ps(cap.sys_clk_hz, TIMING_CLKDIV_ONE);
+        uint32_t engine_ns = (s->resolution_ps + 999) / 1000;
+        e.tolerance_ns = engine_ns + (sample_ps + 999) / 1000;
+        e.period_tolerance_ns =
+            engine_ns + pulse_stats_period_error_ns(s->delivered.pulses, s->sys_clk_hz,
+                                                    pulse_stats_counter_div(s->duration_ms, s->sys_clk_hz));
+        logicLulus = logic_analyze(&logicRle, &cap, &s->delivered, &e, &r);
+        logic_vcd_init(&logicVcd, &logicRle, &cap);
+        TRACE("Uji mandiri: %lu sampel x %lu ps, %lu run%s, toleransi %lu ns (periode %lu ns)", logicRle.samples,
+              r.sample_ps, logicRle.count, TRACE_STR(logicRle.truncated ? " (terpotong)" : ""), e.tolerance_ns,
+              e.period_tolerance_ns);
+        for (int m = 0; m < LOGIC_MEASURES; m++)
+            TRACE("Uji %s: %lu interval, %lu..%lu ns (harapan %lu ns) %s",
+                  TRACE_STR(logic_measure_name((logic_measure_t)m)), r.span[m].count, r.span[m].min_ns,
+                  r.span[m].max_ns, e.expect_ns[m], TRACE_STR(r.span[m].ok ? "OK" : "SALAH"));
+        if (r.bad_states > 0 || r.bad_order > 0)
+            TRACE("Uji mandiri: %lu status pin salah, %lu urutan salah (pertama di sampel %lu)", r.bad_states,
+                  r.bad_order, r.first_bad);
+    }
+    else
+    {
+        TRACE("Uji mandiri: tidak ada tangkapan (status mesin %lu)", (uint32_t)s->state);
+    }
+    logicOffset = 0;
+    logicKirim = true;
+
+    // "UJI LULUS 8.0nS" / "PW3500 DT96500" atau besaran yang salah
+    char buf[17];
+    lcd_fb_clear();
+    if (logicAdaTangkapan)
+    {
+        uint32_t tenth_ns = (r.sample_ps + 50) / 100;
+        snprintf(buf, sizeof(buf), "UJI %s %lu.%lunS", logicLulus ? "LULUS" : "GAGAL", tenth_ns / 10, tenth_ns % 10);
+    }
+    else
+    {
+        snprintf(buf, sizeof(buf), "UJI GAGAL");
+    }
+    lcd_fb_print(0, 0, buf);
+    if (!logicAdaTangkapan)
+        snprintf(buf, sizeof(buf), "TANPA TANGKAPAN");
+    else if (r.bad_states > 0 || r.bad_order > 0)
+        snprintf(buf, sizeof(buf), "STATUS PIN SALAH");
+    else if (logicLulus)
+        snprintf(buf, sizeof(buf), "PW%lu DT%lu", r.span[LOGIC_PULSE_A].max_ns, r.span[LOGIC_DEAD_TIME].max_ns);
+    for (int m = 0; logicAdaTangkapan && !logicLulus && m < LOGIC_MEASURES; m++)
+    {
+        if (r.bad_states == 0 && r.bad_order == 0 && !r.span[m].ok)
         {
-            pio_sm_put(pio, sm, delay_D);
+            snprintf(buf, sizeof(buf), "%s SALAH", logic_measure_name((logic_measure_t)m));
+            break;
         }
+    }
+    lcd_fb_print(1, 0, buf);
+    lcd_fb_flush();
+}
 
-        // Biarkan sistem responsif
-        tight_loop_contents();
+// Dipanggil TASK_LCD tiap RUN_SCREEN_INTERVAL_MS selama proses
+void refreshRunScreen()
+{
+    pulse_engine_status_t s;
+    pulse_engine_status(&s);
+    if (s.state == PE_STATE_ARMED)
+    {
+        lcd_fb_print(0, 0, "MENUNGGU PICU   ");
+        lcd_fb_print(1, 0, "GP11  SEL=BATAL ");
+        lcd_fb_flush();
     }
+    else if (s.state == PE_STATE_RUNNING)
+    {
+        updateRunScreen(&s);
+    }
+}
 
-    // Tampilkan hasil
-    lcd_clear();
-    lcd_set_cursor(0, 0);
-    lcd_string("PROSES SELESAI!");
-    sleep_ms(2000);
+// ===================== PENGOSONGAN BANK =====================
+void startDischarge()
+{
+    // Saklar tetap tertutup setelah bank aman (tegangan tidak merayap naik
+    // lagi lewat absorpsi dielektrik) sampai proses berikutnya dimulai
+    gpio_put(BANK_DUMP_PIN, 1);
+    uint32_t rate = bank_adc_start(BANK_SAMPLE_RATE_HZ);
+    bank_monitor_cfg_t cfg = {
+        .full_scale_mv = BANK_FULL_SCALE_MV,
+        .safe_mv = BANK_SAFE_MV,
+        .sample_rate_hz = rate,
+        .tau_us = BANK_FILTER_TAU_US,
+        .hold_us = BANK_HOLD_MS * 1000u,
+        .timeout_ms = BANK_TIMEOUT_MS,
+    };
+    bank_monitor_init(&bankMonitor, &cfg);
+    bank_monitor_start(&bankMonitor);
+    pengosongan = true;
+    TRACE("Pengosongan bank: ADC %lu S/s, filter 2^%u sampel, ambang %lu mV", rate,
+          bankMonitor.shift, (uint32_t)BANK_SAFE_MV);
+
+    lcd_fb_clear();
+    lcd_fb_print(0, 0, "MENGOSONGKAN...");
+    lcd_fb_flush();
+    uint64_t now = time_us_64();
+    sched_at(&scheduler, TASK_DISCHARGE, now + DISCHARGE_POLL_US);
+    sched_at(&scheduler, TASK_LCD, now + RUN_SCREEN_INTERVAL_MS * 1000ull);
+}
+
+void updateDischargeScreen()
+{
+    // "KOSONGKAN   42%" / "123.4 V SEL=BTL"
+    char buf[17];
+    uint32_t mv = bank_monitor_mv(&bankMonitor);
+    snprintf(buf, sizeof(buf), "KOSONGKAN  %3lu%%", bank_monitor_progress(&bankMonitor));
+    lcd_fb_print(0, 0, buf);
+    snprintf(buf, sizeof(buf), "%3lu.%lu V SEL=BTL", mv / 1000, (mv % 1000) / 100);
+    lcd_fb_print(1, 0, buf);
+    lcd_fb_flush();
+}
+
+// Dipanggil TASK_DISCHARGE dan TASK_BUTTONS selama pengosongan: kuras ring
+// ADC ke filter dan tutup dengan layar hasil (layar berjalan: TASK_LCD)
+void service_discharge(const button_event_t *ev)
+{
+    const uint16_t *samples;
+    uint32_t n;
+    bank_state_t state = bankMonitor.state;
+    while (state == BANK_DISCHARGING && (n = bank_adc_next(&samples)) > 0)
+        state = bank_monitor_feed(&bankMonitor, samples, n);
+
+    bool cancel = ev && ev->button == BUTTON_SELECT && ev->type == BUTTON_EV_PRESS;
+    if (state == BANK_DISCHARGING && !cancel)
+        return;
+
+    bank_adc_stop();
+    pengosongan = false;
+    uint32_t mv = bank_monitor_mv(&bankMonitor);
+    uint32_t ms = (uint32_t)(bank_monitor_elapsed_us(&bankMonitor) / 1000u);
+    const char *result = state == BANK_SAFE ? "BANK AMAN" : state == BANK_TIMEOUT ? "GAGAL KOSONGKAN" : "KOSONGKAN BATAL";
+    char buf[17];
+    lcd_fb_clear();
+    lcd_fb_print(0, 0, result);
+    snprintf(buf, sizeof(buf), "%3lu.%lu V %2lu.%lus", mv / 1000, (mv % 1000) / 100, ms / 1000, (ms % 1000) / 100);
+    lcd_fb_print(1, 0, buf);
+    lcd_fb_flush();
+    TRACE("Pengosongan bank: %s, %lu mV setelah %lu ms (%lu sampel terlewat)", TRACE_STR(result), mv, ms,
+          bank_adc_overruns());
+    showMessageScreen();
+    schedule_commit();
+}
+
+// Maksimum durasi tiap histogram dalam us (0 bila belum ada sampel)
+static uint32_t perf_max_us(perf_hist_id_t id)
+{
+    perf_hist_t h;
+    perf_snapshot(id, &h);
+    return perf_cycles_to_us(h.max_cycles);
+}
+
+void showPerfScreen()
+{
+    // "UR0 LP/IRQ/LCD" / "412/38/95 us": underrun FIFO dan durasi terlama
+    uint32_t samples, underruns;
+    perf_fifo(&samples, &underruns);
+    char buf[17];
+    lcd_fb_clear();
+    snprintf(buf, sizeof(buf), "UR%lu LP/IRQ/LCD", underruns);
+    lcd_fb_print(0, 0, buf);
+    snprintf(buf, sizeof(buf), "%lu/%lu/%lu us", perf_max_us(PERF_LOOP), perf_max_us(PERF_IRQ_OFF),
+             perf_max_us(PERF_LCD));
+    lcd_fb_print(1, 0, buf);
+    lcd_fb_flush();
+}
+
+void print_perf()
+{
+    static const char *const names[PERF_HIST_COUNT] = {"loop", "LCD", "IRQ mati", "flash"};
+    uint32_t samples, underruns;
+    perf_fifo(&samples, &underruns);
+    TRACE("FIFO TX: %lu underrun dari %lu sampel", underruns, samples);
+    for (int i = 0; i < PERF_HIST_COUNT; i++)
+    {
+        perf_hist_t h;
+        perf_snapshot((perf_hist_id_t)i, &h);
+        if (h.count == 0)
+            continue;
+        TRACE("Kinerja %s: %lu kali, rata-rata %lu us, maks %lu us", TRACE_STR(names[i]), h.count,
+              perf_cycles_to_us((uint32_t)(h.total_cycles / h.count)), perf_cycles_to_us(h.max_cycles));
+    }
+    for (int i = 0; i < TASK_COUNT; i++)
+    {
+        const sched_task_t *t = &tasks[i];
+        if (t->runs == 0)
+            continue;
+        TRACE("Tugas %s: %lu kali, rata-rata %lu us, maks %lu us, latensi maks %lu us", TRACE_STR(t->name),
+              t->runs, (uint32_t)(t->run_total_us / t->runs), t->run_max_us, t->latency_max_us);
+    }
+    TRACE("Latensi dispatch terburuk: %lu us (tugas %s)", scheduler.latency_max_us,
+          TRACE_STR(tasks[scheduler.latency_max_task].name));
+}
+
+void showMessageScreen()
+{
+    messageScreen = true;
+    messageScreenMs = to_ms_since_boot(get_absolute_time());
+    sched_at(&scheduler, TASK_LCD, time_us_64() + MESSAGE_SCREEN_MS * 1000ull);
+}
+
+// Layar pesan habis atau ditutup tombol: ringkasan kinerja yang tertunda
+// tampil lebih dulu, baru kembali ke menu
+void closeMessageScreen()
+{
+    if (perfScreenPending)
+    {
+        perfScreenPending = false;
+        showPerfScreen();
+        showMessageScreen();
+        return;
+    }
+    messageScreen = false;
     updateMenu();
 }
 
-void stopPulseGeneration()
+// Dipanggil TASK_LCD pada tenggat layar pesan
+void service_message_screen()
 {
-    pio_sm_set_enabled(pio, sm, false);
-    printf("Generasi pulsa berhenti.\n");
+    if (!messageScreen)
+        return;
+    if (to_ms_since_boot(get_absolute_time()) - messageScreenMs >= MESSAGE_SCREEN_MS)
+        closeMessageScreen();
 }
 
 // ===================== FUNGSI PENYIMPANAN FLASH =====================
+// Erase/program satu sektor/halaman dari RAM. Interupsi dimatikan hanya
+// selama satu operasi flash; core 1 sudah diparkir oleh pemanggil
+// param_store_write(). Timer dibaca langsung dari register agar fungsi RAM
+// ini tidak memanggil kode di flash.
+static void __not_in_flash_func(record_irq_off)(perf_stamp_t start)
+{
+    uint32_t us = timer_hw->timerawl - start.us;
+    if (us > flashStats.irq_off_max_us)
+        flashStats.irq_off_max_us = us;
+    perf_end(PERF_IRQ_OFF, start);
+}
+
+static void __not_in_flash_func(flash_erase_sector)(void *ctx, uint32_t offset)
+{
+    uint32_t ints = save_and_disable_interrupts();
+    perf_stamp_t start = perf_begin();
+    flash_range_erase(PARAM_REGION_OFFSET + offset, FLASH_SECTOR_SIZE);
+    record_irq_off(start);
+    restore_interrupts(ints);
+}
+
+static void __not_in_flash_func(flash_program_page)(void *ctx, uint32_t offset, const uint8_t *page)
+{
+    uint32_t ints = save_and_disable_interrupts();
+    perf_stamp_t start = perf_begin();
+    flash_range_program(PARAM_REGION_OFFSET + offset, page, FLASH_PAGE_SIZE);
+    record_irq_off(start);
+    restore_interrupts(ints);
+}
+
+static const param_flash_t paramFlash = {
+    .base = (const uint8_t *)(XIP_BASE + PARAM_REGION_OFFSET),
+    .sectors = PARAM_REGION_SECTORS,
+    .erase_sector = flash_erase_sector,
+    .program_page = flash_program_page,
+};
+
+static void params_to_set(ParamSet *p)
+{
+    p->frekuensi = frekuensi;
+    p->lebarPulsa = lebarPulsa;
+    p->waktuPerlakuan = waktuPerlakuan;
+    p->bedaFasa = bedaFasa;
+    p->presisiTinggi = presisiTinggi;
+    p->picuEksternal = picuEksternal;
+}
+
+static void set_to_params(const ParamSet *p)
+{
+    frekuensi = p->frekuensi;
+    lebarPulsa = p->lebarPulsa;
+    waktuPerlakuan = p->waktuPerlakuan;
+    bedaFasa = p->bedaFasa;
+    presisiTinggi = p->presisiTinggi == 1;
+    picuEksternal = p->picuEksternal == 1;
+}
+
+// Rekaman lama yang lebih pendek dari ParamSet tetap valid; field yang tidak
+// ada dibiarkan 0
+bool read_param_set(uint32_t slot, ParamSet *p)
+{
+    memset(p, 0, sizeof(*p));
+    return param_store_read(&paramStore, slot, p, sizeof(*p)) >= (int)PARAM_SET_V1_SIZE;
+}
+
 void load_parameters()
 {
+    param_store_mount(&paramStore, &paramFlash);
+    TRACE("Log parameter: erase per sektor %lu %lu %lu %lu, %lu rekaman rusak",
+          param_store_erase_count(&paramStore, 0), param_store_erase_count(&paramStore, 1),
+          param_store_erase_count(&paramStore, 2), param_store_erase_count(&paramStore, 3),
+          paramStore.bad_records);
+
+    ParamSet p;
+    if (read_param_set(PARAM_SLOT_AKTIF, &p))
+    {
+        TRACE("Memuat parameter dari flash.");
+        set_to_params(&p);
+        return;
+    }
+
+    // Belum ada log: migrasi dari format lama bila ada. Sektor lama ikut
+    // dipakai log dan baru dihapus saat gilirannya tiba.
     const ConfigData *config = (const ConfigData *)(XIP_BASE + FLASH_TARGET_OFFSET);
-    if (config->magic == CONFIG_MAGIC)
+    if (config->magic == CONFIG_MAGIC || config->magic == CONFIG_MAGIC_V1)
     {
-        printf("Memuat parameter dari flash.\n");
+        TRACE("Memuat parameter dari format lama.");
         frekuensi = config->frekuensi;
         lebarPulsa = config->lebarPulsa;
         waktuPerlakuan = config->waktuPerlakuan;
         bedaFasa = config->bedaFasa;
+        // Data versi 1 tidak memiliki field ini
+        presisiTinggi = config->magic == CONFIG_MAGIC && config->presisiTinggi == 1;
     }
     else
     {
-        printf("Magic number tidak valid. Menggunakan nilai default.\n");
+        TRACE("Parameter tidak ditemukan. Menggunakan nilai default.");
+    }
+}
+
+static bool write_slot(uint32_t slot, const ParamSet *p)
+{
+    // Core 1 berjalan dari flash (XIP): parkir di RAM selama flash ditulis
+    uint64_t park_start = time_us_64();
+    perf_stamp_t start = perf_begin();
+    if (!pulse_engine_park())
+    {
+        TRACE("Mesin pulsa sedang berjalan, parameter tidak disimpan.");
+        return false;
     }
+    bool ok = param_store_write(&paramStore, slot, p, sizeof(*p));
+    pulse_engine_unpark();
+    perf_end(PERF_FLASH, start);
+
+    uint32_t parked_us = (uint32_t)(time_us_64() - park_start);
+    if (parked_us > flashStats.park_max_us)
+        flashStats.park_max_us = parked_us;
+
+    if (!ok)
+        TRACE("Gagal menulis log parameter (slot %lu).", slot);
+    return ok;
 }
 
+static bool params_match_flash(const ParamSet *p)
+{
+    ParamSet stored;
+    return read_param_set(PARAM_SLOT_AKTIF, &stored) && memcmp(p, &stored, sizeof(*p)) == 0;
+}
+
+// Dipanggil dari menu: hanya menandai cache kotor
 void save_parameters()
 {
-    printf("Menyimpan parameter ke flash...\n");
-    ConfigData config;
-    config.magic = CONFIG_MAGIC;
-    config.frekuensi = frekuensi;
-    config.lebarPulsa = lebarPulsa;
-    config.waktuPerlakuan = waktuPerlakuan;
-    config.bedaFasa = bedaFasa;
+    ParamSet p;
+    params_to_set(&p);
 
-    uint8_t buffer[FLASH_SECTOR_SIZE];
-    memcpy(buffer, &config, sizeof(ConfigData));
+    // SELECT tanpa perubahan (atau perubahan yang dikembalikan) tidak
+    // perlu menulis flash sama sekali
+    if (params_match_flash(&p))
+    {
+        flashStats.unchanged++;
+        paramDirty = false;
+        sched_cancel(&scheduler, TASK_FLASH);
+        return;
+    }
+    if (paramDirty)
+        flashStats.coalesced++;
+    paramDirty = true;
+    paramLastEditMs = to_ms_since_boot(get_absolute_time());
+    schedule_commit();
+}
 
-    uint32_t ints = save_and_disable_interrupts();
-    flash_range_erase(FLASH_TARGET_OFFSET, FLASH_SECTOR_SIZE);
-    flash_range_program(FLASH_TARGET_OFFSET, buffer, FLASH_SECTOR_SIZE);
-    restore_interrupts(ints);
+// Tenggat TASK_FLASH: PARAM_COMMIT_DELAY_MS setelah edit terakhir. Selama
+// proses/pengosongan tugas tidak menulis; akhir keduanya menjadwalkan ulang.
+void schedule_commit()
+{
+    if (paramDirty)
+        sched_at(&scheduler, TASK_FLASH, ((uint64_t)paramLastEditMs + PARAM_COMMIT_DELAY_MS) * 1000u);
+}
 
-    printf("Parameter berhasil disimpan.\n");
+void commit_parameters()
+{
+    if (!paramDirty)
+        return;
+
+    ParamSet p;
+    params_to_set(&p);
+    TRACE("Menyimpan parameter ke flash...");
+    if (!write_slot(PARAM_SLOT_AKTIF, &p))
+        return; // Dicoba lagi pada kesempatan berikutnya
+    paramDirty = false;
+    flashStats.commits++;
+    TRACE("Parameter disimpan (commit %lu, digabung %lu, tanpa perubahan %lu, "
+          "IRQ mati maks %lu us, core 1 parkir maks %lu us).",
+          flashStats.commits, flashStats.coalesced, flashStats.unchanged,
+          flashStats.irq_off_max_us, flashStats.park_max_us);
+}
+
+// Dipanggil TASK_FLASH
+void service_param_cache()
+{
+    if (!paramDirty || prosesBerjalan || pengosongan)
+        return;
+    uint32_t now = to_ms_since_boot(get_absolute_time());
+    if (now - paramLastEditMs < PARAM_COMMIT_DELAY_MS)
+    {
+        schedule_commit();
+        return;
+    }
+    commit_parameters();
+    if (paramDirty)
+        sched_at(&scheduler, TASK_FLASH, time_us_64() + PARAM_RETRY_MS * 1000ull);
+}
+
+void save_preset(int index)
+{
+    ParamSet p;
+    params_to_set(&p);
+    if (write_slot((uint32_t)index, &p))
+        TRACE("Preset %d disimpan.", index);
+}
+
+bool load_preset(int index)
+{
+    ParamSet p;
+    if (!read_param_set((uint32_t)index, &p))
+        return false;
+    set_to_params(&p);
+    TRACE("Preset %d dimuat.", index);
+    return true;
+}
+
+// ===================== PROTOKOL KENDALI USB =====================
+static remote_result_t remote_get_param(void *ctx, remote_param_t id, int32_t *value)
+{
+    switch (id)
+    {
+    case REMOTE_PARAM_FREQ_HZ:
+        *value = frekuensi;
+        break;
+    case REMOTE_PARAM_PULSE_NS:
+        *value = lebarPulsa;
+        break;
+    case REMOTE_PARAM_DURATION_S:
+        *value = waktuPerlakuan;
+        break;
+    case REMOTE_PARAM_PHASE_NS:
+        *value = bedaFasa;
+        break;
+    case REMOTE_PARAM_PRECISION:
+        *value = presisiTinggi;
+        break;
+    case REMOTE_PARAM_TRIGGER:
+        *value = picuEksternal;
+        break;
+    case REMOTE_PARAM_CAPTURE:
+        *value = tangkapPasangan;
+        break;
+    case REMOTE_PARAM_PROGRAM:
+        *value = programPola;
+        break;
+    default:
+        return REMOTE_ERR_PARAM;
+    }
+    return REMOTE_OK;
+}
+
+static remote_result_t remote_set_param(void *ctx, remote_param_t id, int32_t value)
+{
+    // Parameter tidak berubah selama proses berjalan, sama seperti menu
+    if (prosesBerjalan || pengosongan)
+        return REMOTE_ERR_BUSY;
+    switch (id)
+    {
+    case REMOTE_PARAM_FREQ_HZ:
+        frekuensi = value;
+        break;
+    case REMOTE_PARAM_PULSE_NS:
+        lebarPulsa = value;
+        break;
+    case REMOTE_PARAM_DURATION_S:
+        waktuPerlakuan = value;
+        break;
+    case REMOTE_PARAM_PHASE_NS:
+        bedaFasa = value;
+        break;
+    case REMOTE_PARAM_PRECISION:
+        presisiTinggi = value;
+        break;
+    case REMOTE_PARAM_TRIGGER:
+        picuEksternal = value;
+        break;
+    case REMOTE_PARAM_CAPTURE:
+        // Hanya untuk sesi USB ini: tidak ke flash dan tidak tampil di menu
+        tangkapPasangan = value;
+        return REMOTE_OK;
+    case REMOTE_PARAM_PROGRAM:
+        // Seperti CAPTURE; tangkapan per pulsa hanya ada di program statis,
+        // picu eksternal tidak berlaku untuk pasangan independen
+        programPola = value;
+        return REMOTE_OK;
+    default:
+        return REMOTE_ERR_PARAM;
+    }
+
+    // Jalur yang sama dengan SELECT di submenu: commit flash ditunda
+    save_parameters();
+    if (id == REMOTE_PARAM_PRECISION)
+        apply_sys_clock();
+    subMenu = false;
+    messageScreen = false;
+    perfScreenPending = false;
+    updateMenu();
+    return REMOTE_OK;
+}
+
+static remote_result_t remote_start(void *ctx, uint8_t *timing_status)
+{
+    if (prosesBerjalan || pengosongan)
+        return REMOTE_ERR_BUSY;
+    subMenu = false;
+    timing_status_t status = startPulseGeneration();
+    *timing_status = (uint8_t)status;
+    return status == TIMING_OK ? REMOTE_OK : REMOTE_ERR_TIMING;
+}
+
+static remote_result_t remote_abort(void *ctx)
+{
+    // Layar hasil dan telemetri akhir menyusul dari handle_run() di TASK_RUN
+    if (!prosesBerjalan)
+        return REMOTE_ERR_BUSY;
+    stopPulseGeneration();
+    sched_at(&scheduler, TASK_RUN, time_us_64());
+    return REMOTE_OK;
+}
+
+static void remote_status(void *ctx, remote_status_t *out)
+{
+    pulse_engine_status_t s;
+    pulse_engine_status(&s);
+    *out = (remote_status_t){
+        .state = (uint8_t)s.state,
+        .timing_status = (uint8_t)s.timing_status,
+        .duration_ms = s.duration_ms,
+    };
+    if (s.state == PE_STATE_RUNNING)
+    {
+        out->elapsed_ms = (uint32_t)((time_us_64() - s.start_us) / 1000u);
+    }
+    else if (s.stop_us > s.start_us)
+    {
+        out->elapsed_ms = (uint32_t)((s.stop_us - s.start_us) / 1000u);
+        out->pulses = s.delivered.pulses;
+        out->expected = s.delivered.expected;
+        out->mean_period_ns = s.delivered.mean_period_ns;
+        out->on_time_ns = s.delivered.on_time_ns;
+    }
+}
+
+_Static_assert(PERF_PAGE_MAX <= REMOTE_PERF_DATA_MAX, "halaman kinerja harus muat di satu balasan");
+
+static remote_result_t remote_perf(void *ctx, uint8_t hist, uint8_t page, uint8_t *data, size_t *len)
+{
+    *len = perf_page((perf_hist_id_t)hist, page, data);
+    return *len > 0 ? REMOTE_OK : REMOTE_ERR_PARAM;
+}
+
+_Static_assert(SCHED_PAGE_BYTES <= REMOTE_TASKS_DATA_MAX, "statistik tugas harus muat di satu balasan");
+
+static remote_result_t remote_tasks(void *ctx, uint8_t task, uint8_t *data, size_t *len)
+{
+    *len = sched_page(&scheduler, task, data);
+    return *len > 0 ? REMOTE_OK : REMOTE_ERR_PARAM;
+}
+
+// Hasil uji menyusul sebagai event REMOTE_EV_LOGIC setelah proses selesai
+static remote_result_t remote_selftest(void *ctx, uint8_t *timing_status)
+{
+    if (prosesBerjalan || pengosongan)
+        return REMOTE_ERR_BUSY;
+    subMenu = false;
+    timing_status_t status = startSelfTest();
+    *timing_status = (uint8_t)status;
+    return status == TIMING_OK ? REMOTE_OK : REMOTE_ERR_TIMING;
+}
+
+static const remote_ops_t remoteOps = {
+    .get_param = remote_get_param,
+    .set_param = remote_set_param,
+    .start = remote_start,
+    .abort = remote_abort,
+    .status = remote_status,
+    .perf = remote_perf,
+    .tasks = remote_tasks,
+    .selftest = remote_selftest,
+};
+
+// Bingkai ditulis utuh tanpa terjemahan CR/LF, hanya dari loop core 0
+static void remote_write(const uint8_t *buf, size_t len)
+{
+    if (len > 0)
+        stdio_put_string((const char *)buf, (int)len, false, false);
+}
+
+// Byte CDC tiba (konteks interupsi USB): post TASK_USB dan bangunkan loop
+// utama dari WFE
+static void remote_chars_available(void *param)
+{
+    sched_post(&scheduler, TASK_USB, time_us_64());
+    __sev();
+}
+
+void send_telemetry()
+{
+    uint8_t out[REMOTE_FRAME_MAX];
+    remote_status_t st;
+    remote_status(NULL, &st);
+    remote_write(out, remote_telemetry(&remote, &st, out));
+    lastTelemetryMs = to_ms_since_boot(get_absolute_time());
+}
+
+// Dipanggil TASK_USB: tidak pernah menunggu byte. true bila anggaran habis
+// dan mungkin masih ada byte yang menunggu.
+bool service_remote()
+{
+    uint8_t out[REMOTE_FRAME_MAX];
+    int i = 0;
+    for (; i < REMOTE_RX_BUDGET; i++)
+    {
+        int c = getchar_timeout_us(0);
+        if (c == PICO_ERROR_TIMEOUT)
+            break;
+        remote_write(out, remote_feed(&remote, (uint8_t)c, out));
+    }
+
+    if (prosesBerjalan && remote.stream_ms != 0 &&
+        to_ms_since_boot(get_absolute_time()) - lastTelemetryMs >= remote.stream_ms)
+        send_telemetry();
+    return i == REMOTE_RX_BUDGET;
+}
+
+// Bingkai tangkapan yang sudah lengkap -> event REMOTE_EV_CAPTURE. 'flush':
+// kirim semua tanpa anggaran (akhir proses).
+void service_capture(bool flush)
+{
+    static uint8_t payload[CAPTURE_PAYLOAD_MAX];
+    static uint8_t out[REMOTE_CAPTURE_FRAME_MAX];
+    capture_ring_t *r = pulse_capture_ring();
+    size_t budget = 0;
+    const capture_slot_t *slot;
+    while ((flush || budget < CAPTURE_TX_BUDGET) && (slot = capture_ring_peek(r)) != NULL)
+    {
+        size_t len = capture_encode(slot, payload);
+        capture_ring_release(r);
+        size_t n = remote_capture(&remote, payload, len, out);
+        remote_write(out, n);
+        budget += n;
+        tangkapTerkirim++;
+    }
+}
+
+// Rekaman jejak kedua core -> event REMOTE_EV_TRACE. true bila anggaran
+// habis sebelum ring kosong.
+bool service_trace()
+{
+    static uint8_t payload[TRACE_PAYLOAD_MAX];
+    static uint8_t out[REMOTE_CAPTURE_FRAME_MAX];
+    size_t budget = 0;
+    while (budget < TRACE_TX_BUDGET)
+    {
+        size_t len = trace_drain(payload);
+        if (len == 0)
+            return false;
+        size_t n = remote_trace(&remote, payload, len, out);
+        remote_write(out, n);
+        budget += n;
+    }
+    return true;
+}
+
+// Berkas VCD uji mandiri terakhir -> event REMOTE_EV_LOGIC; potongan
+// terakhir membawa hasil. true bila anggaran habis sebelum berkas selesai.
+bool service_logic()
+{
+    static char text[REMOTE_LOGIC_TEXT_MAX];
+    static uint8_t out[REMOTE_CAPTURE_FRAME_MAX];
+    size_t budget = 0;
+    while (logicKirim)
+    {
+        if (budget >= LOGIC_TX_BUDGET)
+            return true;
+        size_t len = logicAdaTangkapan ? logic_vcd_next(&logicVcd, text, sizeof(text)) : 0;
+        bool last = !logicAdaTangkapan || logic_vcd_done(&logicVcd);
+        remote_logic_status_t status = !last ? REMOTE_LOGIC_MORE : logicLulus ? REMOTE_LOGIC_PASS : REMOTE_LOGIC_FAIL;
+        size_t n = remote_logic(&remote, logicOffset, status, text, len, out);
+        remote_write(out, n);
+        budget += n;
+        logicOffset += (uint32_t)len;
+        logicKirim = !last;
+    }
+    return false;
+}
+
+// ===================== TUGAS PENJADWAL =====================
+static uint64_t sched_clock(void)
+{
+    return time_us_64();
+}
+
+// Alarm debounce (interupsi): event baru di antrean
+static void buttons_ready(uint64_t now_us)
+{
+    sched_post(&scheduler, TASK_BUTTONS, now_us);
+}
+
+void task_buttons(uint64_t now_us)
+{
+    button_event_t ev;
+    while (buttons_next(&ev))
+    {
+        if (prosesBerjalan)
+            handle_run(&ev);
+        else if (pengosongan)
+            service_discharge(&ev);
+        else
+            handle_menu(&ev);
+    }
+}
+
+void task_run(uint64_t now_us)
+{
+    if (!prosesBerjalan)
+        return;
+    handle_run(NULL);
+    if (prosesBerjalan)
+        sched_at(&scheduler, TASK_RUN, now_us + RUN_POLL_US);
+}
+
+void task_discharge(uint64_t now_us)
+{
+    if (!pengosongan)
+        return;
+    service_discharge(NULL);
+    if (pengosongan)
+        sched_at(&scheduler, TASK_DISCHARGE, now_us + DISCHARGE_POLL_US);
+}
+
+// Tenggat TASK_USB: segera bila anggaran RX atau jejak habis, selama proses
+// tiap 1 ms untuk ring tangkapan dan pada jadwal STREAM, selain itu cadangan
+// USB_POLL_MS (byte CDC biasanya mem-post tugas lewat callback; rekaman jejak
+// baru menunggu paling lama selama ini)
+void schedule_usb(uint64_t now_us, bool more)
+{
+    uint64_t next = more ? now_us : now_us + USB_POLL_MS * 1000ull;
+    if (prosesBerjalan && tangkapPasangan > 0 && now_us + RUN_POLL_US < next)
+        next = now_us + RUN_POLL_US;
+    if (prosesBerjalan && remote.stream_ms != 0)
+    {
+        uint64_t telemetry = ((uint64_t)lastTelemetryMs + remote.stream_ms) * 1000u;
+        if (telemetry < next)
+            next = telemetry;
+    }
+    sched_at(&scheduler, TASK_USB, next);
+}
+
+void task_usb(uint64_t now_us)
+{
+    bool more = service_remote();
+    if (prosesBerjalan && tangkapPasangan > 0)
+        service_capture(false);
+    if (!prosesBerjalan && service_trace())
+        more = true;
+    if (!prosesBerjalan && service_logic())
+        more = true;
+    schedule_usb(now_us, more);
+}
+
+void task_lcd(uint64_t now_us)
+{
+    if (prosesBerjalan || pengosongan)
+    {
+        if (prosesBerjalan)
+            refreshRunScreen();
+        else
+            updateDischargeScreen();
+        sched_at(&scheduler, TASK_LCD, now_us + RUN_SCREEN_INTERVAL_MS * 1000ull);
+        return;
+    }
+    service_message_screen();
+}
+
+void task_flash(uint64_t now_us)
+{
+    service_param_cache();
+}
+
+// ===================== CLOCK SISTEM =====================
+void apply_sys_clock()
+{
+    uint32_t khz = presisiTinggi ? SYS_CLK_PRESISI_KHZ : SYS_CLK_NORMAL_KHZ;
+    if (clock_get_hz(clk_sys) == khz * 1000)
+        return;
+
+    // Batch LCD yang masih di bus harus selesai sebelum baud I2C berubah
+    lcd_wait_idle();
+
+    // Core 1 menunggu di RAM selama PLL dan XIP berganti clock
+    if (!pulse_engine_park())
+        return;
+
+    // 250 MHz membutuhkan tegangan inti lebih tinggi; naikkan sebelum clock
+    // dinaikkan dan turunkan setelah clock diturunkan
+    if (presisiTinggi)
+    {
+        vreg_set_voltage(VREG_VOLTAGE_1_20);
+        sleep_ms(10);
+    }
+    set_sys_clock_khz(khz, true);
+    if (!presisiTinggi)
+        vreg_set_voltage(VREG_VOLTAGE_DEFAULT);
+    pulse_engine_unpark();
+
+    // clk_peri mengikuti clk_sys sehingga baud I2C dan UART harus dihitung
+    // ulang. USB memakai PLL_USB (48 MHz) dan timer memakai clk_ref, keduanya
+    // tidak terpengaruh.
+    i2c_set_baudrate(i2c_port, I2C_BAUD_HZ);
+#if LIB_PICO_STDIO_UART
+    setup_default_uart();
+#endif
+    perf_set_clock(clock_get_hz(clk_sys));
+
+    TRACE("clk_sys = %lu Hz", clock_get_hz(clk_sys));
 }
 
 // ===================== FUNGSI UTAMA =====================
-int main()
+// Inisialisasi dan satu putaran loop utama dipisah agar harness host
+// (host/mgc_app.c) dapat menjalankan firmware yang sama di atas shim HAL
+void app_init()
 {
+    // Ring jejak sebelum TRACE() pertama (load_parameters)
+    trace_init();
     stdio_init_all();
     sleep_ms(1000);
 
+    // SysTick core 0 untuk histogram kinerja, sebelum LCD mulai dipakai
+    perf_init();
+
     // Inisialisasi I2C untuk LCD
-    i2c_init(i2c_port, 100 * 1000);
+    i2c_init(i2c_port, I2C_BAUD_HZ);
     gpio_set_function(I2C_SDA_PIN, GPIO_FUNC_I2C);
     gpio_set_function(I2C_SCL_PIN, GPIO_FUNC_I2C);
     gpio_pull_up(I2C_SDA_PIN);
@@ -597,40 +1773,54 @@ int main()
 
     lcd_init(i2c_port, LCD_ADDRESS);
 
-    // Inisialisasi tombol
-    gpio_init(SELECT_BUTTON_PIN);
-    gpio_set_dir(SELECT_BUTTON_PIN, GPIO_IN);
-    gpio_pull_up(SELECT_BUTTON_PIN);
-    gpio_init(UP_BUTTON_PIN);
-    gpio_set_dir(UP_BUTTON_PIN, GPIO_IN);
-    gpio_pull_up(UP_BUTTON_PIN);
-    gpio_init(DOWN_BUTTON_PIN);
-    gpio_set_dir(DOWN_BUTTON_PIN, GPIO_IN);
-    gpio_pull_up(DOWN_BUTTON_PIN);
+    // Penjadwal sebelum sumber post pertama (tombol, CDC)
+    sched_init(&scheduler, tasks, TASK_COUNT, sched_clock);
+
+    // Inisialisasi tombol (interupsi GPIO + debounce alarm). SELECT tanpa
+    // auto-repeat agar menahannya tidak memulai/membatalkan proses berulang.
+    buttons_set_notify(buttons_ready);
+    buttons_init(BUTTON_PINS, (1u << BUTTON_UP) | (1u << BUTTON_DOWN));
+
+    // Jalankan mesin pulsa di core 1 (PIO + DMA umpan FIFO)
+    pulse_engine_launch(pio, PIN_CH1_BASE);
 
-    // Inisialisasi sistem PIO
-    init_pio_system();
+    // Saklar buang terbuka saat boot; ADC + DMA baru berjalan di menu 6
+    gpio_init(BANK_DUMP_PIN);
+    gpio_set_dir(BANK_DUMP_PIN, GPIO_OUT);
+    gpio_put(BANK_DUMP_PIN, 0);
+    bank_adc_init(BANK_ADC_PIN);
+
+    // Protokol kendali biner di port CDC USB
+    remote_init(&remote, &remoteOps);
+    stdio_set_chars_available_callback(remote_chars_available, NULL);
 
     // Muat parameter dari flash dan tampilkan menu
     load_parameters();
+    apply_sys_clock();
     updateMenu();
+    sched_at(&scheduler, TASK_USB, time_us_64());
+}
 
-    // Loop utama - tetap responsif
-    while (true)
-    {
-        handle_buttons();
-        handle_menu();
+// Satu putaran loop utama: tugas yang jatuh tempo (maks. TASK_COUNT dispatch
+// agar tugas yang menjadwalkan dirinya segera tidak memonopoli putaran),
+// lalu tidur sampai tenggat berikutnya atau interupsi tombol/CDC (post + __sev)
+void app_loop()
+{
+    perf_stamp_t loop_start = perf_begin();
+    for (int i = 0; i < TASK_COUNT && sched_dispatch(&scheduler); i++)
+        ;
+    perf_end(PERF_LOOP, loop_start);
 
-        // Proses callback alarm jika ada
-        if (process_complete)
-        {
-            // Flag sudah di-handle di startPulseGeneration()
-            // Reset untuk siklus berikutnya
-            process_complete = false;
-        }
+    uint64_t next = sched_next(&scheduler);
+    if (next > time_us_64())
+        best_effort_wfe_or_timeout(from_us_since_boot(next));
+}
 
-        sleep_ms(DEBOUNCE_DELAY_MS);
-    }
+int main()
+{
+    app_init();
+    while (true)
+        app_loop();
 
     return 0;
-}
\ No newline at end of file
+}